@@ -62,6 +62,9 @@ internal object TelemetryParser {
             if (scopedV2) root.optLong("totalInstallEvents", 0L).coerceAtLeast(0L) else 0L
         val totalInstallFailures =
             if (scopedV2) root.optLong("totalInstallFailures", 0L).coerceAtLeast(0L) else 0L
+        // schema-v4 aggregate; 0 for a snapshot built from v3-or-older frames.
+        val totalContended =
+            if (scopedV2) root.optLong("totalContended", 0L).coerceAtLeast(0L) else 0L
         val anyRouteInstalled = scopedV2 && root.optBoolean("anyRouteInstalled", false)
 
         return TelemetrySnapshot(
@@ -86,6 +89,7 @@ internal object TelemetryParser {
             totalBypasses = totalBypasses,
             totalInstallEvents = totalInstallEvents,
             totalInstallFailures = totalInstallFailures,
+            totalContended = totalContended,
             anyRouteInstalled = anyRouteInstalled,
         )
     }
@@ -253,6 +257,7 @@ internal object TelemetryParser {
                 bypasses = item.optLong("bypasses", 0L).coerceAtLeast(0L),
                 installEvents = item.optLong("installEvents", 0L).coerceAtLeast(0L),
                 installFailures = item.optLong("installFailures", 0L).coerceAtLeast(0L),
+                contended = item.optLong("contended", 0L).coerceAtLeast(0L),
                 installed = item.optBoolean("installed", false),
                 verification = routeVerification,
             )
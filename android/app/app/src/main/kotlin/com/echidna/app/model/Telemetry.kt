@@ -36,6 +36,8 @@ data class RuntimeRouteTelemetry(
     val bypasses: Long = 0L,
     val installEvents: Long = 0L,
     val installFailures: Long = 0L,
+    // schema-v4 counter; 0 when the producer emits v3 or older.
+    val contended: Long = 0L,
     val installed: Boolean = false,
     val verification: String = TELEMETRY_VERIFICATION_UNVERIFIED,
 )
@@ -63,6 +65,7 @@ data class TelemetrySnapshot(
     val totalBypasses: Long = 0L,
     val totalInstallEvents: Long = 0L,
     val totalInstallFailures: Long = 0L,
+    val totalContended: Long = 0L,
     val anyRouteInstalled: Boolean = false,
 ) {
     val hasVerifiedRuntimeTelemetry: Boolean
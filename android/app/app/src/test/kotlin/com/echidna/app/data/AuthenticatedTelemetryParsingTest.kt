@@ -188,6 +188,7 @@ class AuthenticatedTelemetryParsingTest {
                   "totalBypasses":2,
                   "totalInstallEvents":4,
                   "totalInstallFailures":5,
+                  "totalContended":6,
                   "anyRouteInstalled":true,
                   "routes":[{
                     "process":"com.example.voice",
@@ -204,6 +205,7 @@ class AuthenticatedTelemetryParsingTest {
                     "bypasses":2,
                     "installEvents":4,
                     "installFailures":5,
+                    "contended":6,
                     "installed":true,
                     "verification":"authenticated_socket_v2"
                   }]
@@ -214,11 +216,13 @@ class AuthenticatedTelemetryParsingTest {
         assertEquals(2L, snapshot.totalBypasses)
         assertEquals(4L, snapshot.totalInstallEvents)
         assertEquals(5L, snapshot.totalInstallFailures)
+        assertEquals(6L, snapshot.totalContended)
         assertTrue(snapshot.anyRouteInstalled)
         val route = snapshot.routes.single()
         assertEquals(2L, route.bypasses)
         assertEquals(4L, route.installEvents)
         assertEquals(5L, route.installFailures)
+        assertEquals(6L, route.contended)
         assertTrue(route.installed)
         // v3 additive fields must not disturb the existing verified-processing proof.
         assertTrue(snapshot.isVerifiedProcessing)
@@ -239,6 +243,7 @@ class AuthenticatedTelemetryParsingTest {
         assertEquals(0L, snapshot.totalBypasses)
         assertEquals(0L, snapshot.totalInstallEvents)
         assertEquals(0L, snapshot.totalInstallFailures)
+        assertEquals(0L, snapshot.totalContended)
         assertFalse(snapshot.anyRouteInstalled)
         assertEquals(0L, snapshot.routes.single().bypasses)
         assertFalse(snapshot.routes.single().installed)
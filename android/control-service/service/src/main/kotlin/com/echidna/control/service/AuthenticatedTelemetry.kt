@@ -40,6 +40,11 @@ private val TELEMETRY_ROOT_KEYS_V3 = TELEMETRY_ROOT_KEYS + "installed"
 private val TELEMETRY_DELTA_KEYS_V3 =
     TELEMETRY_DELTA_KEYS + setOf("bypasses", "installEvents", "installFailures")
 
+// Schema v4 adds one edge to v3: `contended`, the blocks that arrived while
+// another block was already in flight on the legacy engine lanes. The root
+// key-set is unchanged from v3.
+private val TELEMETRY_DELTA_KEYS_V4 = TELEMETRY_DELTA_KEYS_V3 + "contended"
+
 internal enum class AuthenticatedTelemetryRoute(val wireName: String) {
     AAUDIO("aaudio"),
     AUDIORECORD("audiorecord"),
@@ -87,6 +92,8 @@ internal data class AuthenticatedTelemetryDeltas(
     val bypasses: Long = 0L,
     val installEvents: Long = 0L,
     val installFailures: Long = 0L,
+    // v4-only edge; default 0 for a v2 or v3 frame.
+    val contended: Long = 0L,
 )
 
 internal data class AuthenticatedTelemetryFrame(
@@ -138,11 +145,12 @@ internal object AuthenticatedTelemetryWire {
     fun parse(json: String): AuthenticatedTelemetryFrame? {
         if (!StrictJsonValidator.isValid(json)) return null
         val root = runCatching { JSONObject(json) }.getOrNull() ?: return null
-        // Accept v2 (back-compat) and v3, each against its OWN exact key-set. This
-        // is safe schema evolution: v2's validation is byte-for-byte unchanged and
-        // v3 is an equally strict validator, so no path tolerates unknown keys.
-        val schemaVersion = strictLong(root, "schemaVersion", 2L, 3L) ?: return null
-        val isV3 = schemaVersion == 3L
+        // Accept v2 (back-compat), v3 and v4, each against its OWN exact key-set.
+        // This is safe schema evolution: v2's validation is byte-for-byte unchanged
+        // and v3/v4 are equally strict validators, so no path tolerates unknown keys.
+        val schemaVersion = strictLong(root, "schemaVersion", 2L, 4L) ?: return null
+        val isV3 = schemaVersion >= 3L
+        val isV4 = schemaVersion == 4L
         val expectedRootKeys = if (isV3) TELEMETRY_ROOT_KEYS_V3 else TELEMETRY_ROOT_KEYS
         if (root.keysSet() != expectedRootKeys) return null
         if (root.optString("type", "") != "telemetry") return null
@@ -163,7 +171,11 @@ internal object AuthenticatedTelemetryWire {
             ?: return null
         val installed = if (isV3) strictBoolean(root, "installed") ?: return null else false
         val deltasObject = root.optJSONObject("deltas") ?: return null
-        val expectedDeltaKeys = if (isV3) TELEMETRY_DELTA_KEYS_V3 else TELEMETRY_DELTA_KEYS
+        val expectedDeltaKeys = when {
+            isV4 -> TELEMETRY_DELTA_KEYS_V4
+            isV3 -> TELEMETRY_DELTA_KEYS_V3
+            else -> TELEMETRY_DELTA_KEYS
+        }
         if (deltasObject.keysSet() != expectedDeltaKeys) return null
         val deltas = AuthenticatedTelemetryDeltas(
             blocks = strictLong(deltasObject, "blocks", 0L, UINT32_MAX) ?: return null,
@@ -185,6 +197,11 @@ internal object AuthenticatedTelemetryWire {
             } else {
                 0L
             },
+            contended = if (isV4) {
+                strictLong(deltasObject, "contended", 0L, UINT32_MAX) ?: return null
+            } else {
+                0L
+            },
         )
         if (state == AuthenticatedTelemetryState.PROCESSING) {
             if (deltas.mutations == 0L || deltas.blocks == 0L || deltas.frames == 0L) return null
@@ -197,6 +214,9 @@ internal object AuthenticatedTelemetryWire {
         // installFailures is an attach-level edge, NOT a block outcome, so it is
         // deliberately excluded from this bound.
         if (deltas.mutations + deltas.bypasses + deltas.failures > deltas.blocks) return null
+        // `contended` is recorded just before its block's outcome, so a frame
+        // drained between the two may carry it without the block: it is not
+        // bounded by `blocks`.
         return AuthenticatedTelemetryFrame(
             sequence = sequence,
             senderMonotonicMs = senderMonotonicMs,
@@ -437,6 +457,7 @@ private data class MutableTelemetryEntry(
     var bypasses: Long,
     var installEvents: Long,
     var installFailures: Long,
+    var contended: Long,
     var installed: Boolean,
 )
 
@@ -458,6 +479,7 @@ internal data class AuthenticatedTelemetryEntry(
     val bypasses: Long,
     val installEvents: Long,
     val installFailures: Long,
+    val contended: Long,
     val installed: Boolean,
     val audioSessionId: Int,
     val verification: String,
@@ -487,6 +509,7 @@ internal data class AuthenticatedTelemetrySnapshot(
     val totalBypasses: Long get() = entries.saturatingSum { it.bypasses }
     val totalInstallEvents: Long get() = entries.saturatingSum { it.installEvents }
     val totalInstallFailures: Long get() = entries.saturatingSum { it.installFailures }
+    val totalContended: Long get() = entries.saturatingSum { it.contended }
     val anyInstalled: Boolean get() = entries.any { it.installed }
 
     fun toLiveJson(legacy: TelemetrySnapshot?): String {
@@ -554,6 +577,7 @@ internal data class AuthenticatedTelemetrySnapshot(
             .put("totalBypasses", totalBypasses)
             .put("totalInstallEvents", totalInstallEvents)
             .put("totalInstallFailures", totalInstallFailures)
+            .put("totalContended", totalContended)
             .put("anyRouteInstalled", anyInstalled)
         val routes = JSONArray()
         entries.forEach { entry ->
@@ -572,6 +596,7 @@ internal data class AuthenticatedTelemetrySnapshot(
                 .put("bypasses", entry.bypasses)
                 .put("installEvents", entry.installEvents)
                 .put("installFailures", entry.installFailures)
+                .put("contended", entry.contended)
                 .put("installed", entry.installed)
                 .put("verification", entry.verification)
             if (includeIdentities) {
@@ -682,6 +707,7 @@ internal class AuthenticatedTelemetryStore(
             bypasses = 0L,
             installEvents = 0L,
             installFailures = 0L,
+            contended = 0L,
             installed = false,
         )
         next.state = frame.state
@@ -696,6 +722,7 @@ internal class AuthenticatedTelemetryStore(
         next.bypasses = saturatingAdd(next.bypasses, frame.deltas.bypasses)
         next.installEvents = saturatingAdd(next.installEvents, frame.deltas.installEvents)
         next.installFailures = saturatingAdd(next.installFailures, frame.deltas.installFailures)
+        next.contended = saturatingAdd(next.contended, frame.deltas.contended)
         // `installed` is a latched level, not an edge: take the newest frame's value.
         next.installed = frame.installed
         entries[key] = next
@@ -726,6 +753,7 @@ internal class AuthenticatedTelemetryStore(
                 bypasses = value.bypasses,
                 installEvents = value.installEvents,
                 installFailures = value.installFailures,
+                contended = value.contended,
                 installed = value.installed,
                 audioSessionId = key.audioSessionId,
                 verification = key.verification.wireName,
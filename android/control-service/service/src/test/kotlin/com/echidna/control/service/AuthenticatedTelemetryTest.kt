@@ -144,8 +144,12 @@ class AuthenticatedTelemetryWireTest {
                     ),
             ),
         )
-        // An unsupported future version is rejected outright.
+        // schemaVersion 3 carrying the v4 contended key is rejected.
+        assertNull(AuthenticatedTelemetryWire.parse(validJsonV3(extraDelta = ",\"contended\":1")))
+        // schemaVersion 4 without it is rejected.
         assertNull(AuthenticatedTelemetryWire.parse(validJsonV3().replace("\"schemaVersion\":3", "\"schemaVersion\":4")))
+        // An unsupported future version is rejected outright.
+        assertNull(AuthenticatedTelemetryWire.parse(validJsonV4().replace("\"schemaVersion\":4", "\"schemaVersion\":5")))
     }
 
     @Test
@@ -171,9 +175,29 @@ class AuthenticatedTelemetryWireTest {
         assertEquals(0L, parsed?.deltas?.bypasses)
         assertEquals(0L, parsed?.deltas?.installEvents)
         assertEquals(0L, parsed?.deltas?.installFailures)
+        assertEquals(0L, parsed?.deltas?.contended)
         assertEquals(false, parsed?.installed)
     }
 
+    // --- Schema v4 -------------------------------------------------------------
+
+    @Test
+    fun `strict parser accepts v4 and threads the contended edge`() {
+        val parsed = AuthenticatedTelemetryWire.parse(validJsonV4(contended = 3L, installFailures = 5L))
+
+        assertEquals(3L, parsed?.deltas?.contended)
+        assertEquals(5L, parsed?.deltas?.installFailures)
+        assertEquals(0L, AuthenticatedTelemetryWire.parse(validJsonV3())?.deltas?.contended)
+        // Contention is not a block outcome and may outrun `blocks` in one frame.
+        assertEquals(
+            1L,
+            AuthenticatedTelemetryWire.parse(
+                validJsonV4(state = "installed", blocks = 0L, frames = 0L, mutations = 0L, contended = 1L),
+            )?.deltas?.contended,
+        )
+        assertNull(AuthenticatedTelemetryWire.parse(validJsonV4(extraDelta = ",\"attacker\":1")))
+    }
+
     private fun assertThrowsIOException(block: () -> Unit) {
         try {
             block()
@@ -319,6 +343,28 @@ class AuthenticatedTelemetryStoreTest {
         assertTrue(json.contains("\"installed\":true"))
     }
 
+    @Test
+    fun `v4 contention aggregates into the entry and snapshot json`() {
+        val store = AuthenticatedTelemetryStore(clockMs = { 6_000L })
+        val peer = AuthenticatedPeer(uid = 10_056, pid = 203)
+
+        assertEquals(
+            TelemetryRecordResult.ACCEPTED,
+            store.record(AuthenticatedTelemetryWire.parse(validJsonV4(sequence = 1L, contended = 2L))!!, peer, 7L),
+        )
+        assertEquals(
+            TelemetryRecordResult.ACCEPTED,
+            store.record(AuthenticatedTelemetryWire.parse(validJsonV4(sequence = 2L, contended = 3L))!!, peer, 7L),
+        )
+
+        val snapshot = store.snapshot(7L)
+        assertEquals(5L, snapshot.entries.single().contended)
+        assertEquals(5L, snapshot.totalContended)
+        val json = snapshot.toDiagnosticsJson(includeTrends = false, legacy = null).toString()
+        assertTrue(json.contains("\"totalContended\":5"))
+        assertTrue(json.contains("\"contended\":5"))
+    }
+
     @Test
     fun `caller attested routes remain diagnostic while mixed trusted routes retain proof`() {
         var now = 5_000L
@@ -430,6 +476,25 @@ private fun validJsonV3(
     }
 """.trimIndent()
 
+private fun validJsonV4(
+    sequence: Long = 1L,
+    state: String = "processing",
+    blocks: Long = 9L,
+    frames: Long = 1728L,
+    mutations: Long = 1L,
+    installFailures: Long = 0L,
+    contended: Long = 0L,
+    extraDelta: String = "",
+): String = validJsonV3(
+    sequence = sequence,
+    state = state,
+    blocks = blocks,
+    frames = frames,
+    mutations = mutations,
+    installFailures = installFailures,
+    extraDelta = ",\"contended\":$contended$extraDelta",
+).replace("\"schemaVersion\":3", "\"schemaVersion\":4")
+
 private fun v3Frame(
     sequence: Long,
     process: String = "com.example.voice",
@@ -78,6 +78,19 @@ extern "C"
                                            float *output,
                                            size_t frames);
 
+    /**
+     * @brief Reports the fixed delay the active processing mode adds.
+     *
+     * Synchronous presets add no delay. Hybrid presets are pipelined: the call
+     * that submits block N returns block N - k, where k is reported through
+     * latency_blocks. A block size change keeps the stream continuous, so
+     * latency_frames is k times the largest block seen since the pipeline was
+     * last armed (zero until the first hybrid block). Either output may be
+     * null, not both.
+     */
+    ech_dsp_status_t ech_dsp_get_latency(uint32_t *latency_blocks,
+                                         size_t *latency_frames);
+
     /**
      * @brief Builds one independent, callback-prepared DSP engine.
      *
@@ -93,12 +106,31 @@ extern "C"
                                            size_t config_length,
                                            ech_dsp_engine_t **engine);
 
-    /** Processes one block without allocation or internal locking. */
+    /**
+     * @brief Processes one block without allocation or internal locking.
+     *
+     * Input and output may be the same buffer. A disjoint input is left
+     * untouched and read as the dry signal without an internal copy.
+     */
     ech_dsp_status_t ech_dsp_engine_process(ech_dsp_engine_t *engine,
                                             const float *input,
                                             float *output,
                                             size_t frames);
 
+    /** Reports an independent engine's processing delay; see ech_dsp_get_latency. */
+    ech_dsp_status_t ech_dsp_engine_get_latency(ech_dsp_engine_t *engine,
+                                                uint32_t *latency_blocks,
+                                                size_t *latency_frames);
+
+    /**
+     * @brief Clears an independent engine's audio history, keeping its preset.
+     *
+     * Callback-safe and lock-free: the next processed block starts from
+     * cleared effect state, and a hybrid engine drops the output it still
+     * holds from earlier blocks. Used when an engine passes to a new stream.
+     */
+    ech_dsp_status_t ech_dsp_engine_reset(ech_dsp_engine_t *engine);
+
     /** Destroys an engine after its owner has quiesced all callbacks. */
     void ech_dsp_engine_destroy(ech_dsp_engine_t *engine);
 
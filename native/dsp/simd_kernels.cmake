@@ -0,0 +1,31 @@
+# Runtime-dispatched SIMD kernels (src/runtime/simd*.cpp) as their own static
+# library. The DSP core links it, and so does the Zygisk module: libechidna.so
+# only dlopens libech_dsp.so, so its capture-side conversion and level loops
+# need their own copy of the kernels. Include-guarded because the super-build
+# reaches this file from both native/dsp and native/zygisk.
+if(NOT TARGET ech_dsp_simd)
+  add_library(ech_dsp_simd STATIC
+      ${CMAKE_CURRENT_LIST_DIR}/src/runtime/simd.cpp
+      ${CMAKE_CURRENT_LIST_DIR}/src/runtime/simd_x86.cpp
+      ${CMAKE_CURRENT_LIST_DIR}/src/runtime/simd_neon.cpp)
+  # Linked into two shared objects; keep the kernel symbols out of both
+  # dynamic symbol tables so each library binds to its own copy.
+  set_target_properties(ech_dsp_simd PROPERTIES
+      POSITION_INDEPENDENT_CODE ON
+      CXX_VISIBILITY_PRESET hidden
+      VISIBILITY_INLINES_HIDDEN ON)
+  target_include_directories(ech_dsp_simd
+      PUBLIC $<BUILD_INTERFACE:${CMAKE_CURRENT_LIST_DIR}/src>)
+  target_compile_features(ech_dsp_simd PUBLIC cxx_std_20)
+  # Every vector kernel must round exactly like its scalar twin, here and in
+  # the lane loops of ech_dsp_core. Public so the scalar references those
+  # are tested against are not fused into multiply-adds either.
+  if(CMAKE_CXX_COMPILER_ID MATCHES "GNU|Clang")
+    target_compile_options(ech_dsp_simd PUBLIC -ffp-contract=off)
+  endif()
+  if(CMAKE_SYSTEM_PROCESSOR MATCHES "(arm64|aarch64)")
+    target_compile_definitions(ech_dsp_simd PRIVATE ECHIDNA_DSP_HAS_NEON=1)
+  elseif(CMAKE_SYSTEM_PROCESSOR MATCHES "(x86_64|AMD64)")
+    target_compile_definitions(ech_dsp_simd PRIVATE ECHIDNA_DSP_HAS_AVX=1)
+  endif()
+endif()
@@ -8,6 +8,7 @@
 #include <memory>
 #include <mutex>
 #include <new>
+#include <shared_mutex>
 #include <string>
 #include <string_view>
 
@@ -16,7 +17,9 @@
 
 namespace
 {
-    std::mutex g_engine_mutex;
+    // Shared for every call that only reads g_engine, so configuration calls
+    // never make a concurrent process_block fail its try-lock.
+    std::shared_mutex g_engine_mutex;
     std::shared_ptr<echidna::dsp::DspEngine> g_engine;
     constexpr uint32_t kMaxChannels = 8;
 
@@ -41,7 +44,7 @@ namespace echidna::dsp
      */
     std::shared_ptr<DspEngine> acquire_engine()
     {
-        std::lock_guard<std::mutex> lock(g_engine_mutex);
+        std::shared_lock lock(g_engine_mutex);
         return g_engine;
     }
 
@@ -78,7 +81,7 @@ extern "C"
             IsValidQualityMode(quality_mode) ? quality_mode : ECH_DSP_QUALITY_BALANCED;
         try
         {
-            std::lock_guard<std::mutex> lock(g_engine_mutex);
+            std::lock_guard<std::shared_mutex> lock(g_engine_mutex);
             g_engine = std::make_shared<echidna::dsp::DspEngine>(sample_rate, channels,
                                                                  safe_quality);
             return ECH_DSP_STATUS_OK;
@@ -108,7 +111,7 @@ extern "C"
         }
         std::shared_ptr<echidna::dsp::DspEngine> engine;
         {
-            std::lock_guard<std::mutex> lock(g_engine_mutex);
+            std::shared_lock lock(g_engine_mutex);
             engine = g_engine;
         }
         if (!engine)
@@ -143,7 +146,7 @@ extern "C"
         }
         std::shared_ptr<echidna::dsp::DspEngine> engine;
         {
-            std::lock_guard<std::mutex> lock(g_engine_mutex);
+            std::shared_lock lock(g_engine_mutex);
             engine = g_engine;
         }
         if (!engine)
@@ -166,7 +169,7 @@ extern "C"
         }
         std::shared_ptr<echidna::dsp::DspEngine> engine;
         {
-            std::unique_lock lock(g_engine_mutex, std::try_to_lock);
+            std::shared_lock lock(g_engine_mutex, std::try_to_lock);
             if (!lock.owns_lock())
             {
                 return ECH_DSP_STATUS_ERROR;
@@ -191,6 +194,35 @@ extern "C"
         }
     }
 
+    /**
+     * @brief Report the global engine's processing delay.
+     */
+    ech_dsp_status_t ech_dsp_get_latency(uint32_t *latency_blocks,
+                                         size_t *latency_frames)
+    {
+        if (!latency_blocks && !latency_frames)
+        {
+            return ECH_DSP_STATUS_INVALID_ARGUMENT;
+        }
+        std::shared_ptr<echidna::dsp::DspEngine> engine;
+        {
+            std::shared_lock lock(g_engine_mutex);
+            engine = g_engine;
+        }
+        if (!engine)
+        {
+            return ECH_DSP_STATUS_NOT_INITIALISED;
+        }
+        try
+        {
+            return engine->GetLatency(latency_blocks, latency_frames);
+        }
+        catch (...)
+        {
+            return ECH_DSP_STATUS_ERROR;
+        }
+    }
+
     ech_dsp_status_t ech_dsp_engine_create(uint32_t sample_rate,
                                            uint32_t channels,
                                            ech_dsp_quality_mode_t quality_mode,
@@ -260,6 +292,34 @@ extern "C"
         }
     }
 
+    ech_dsp_status_t ech_dsp_engine_get_latency(ech_dsp_engine_t *engine,
+                                                uint32_t *latency_blocks,
+                                                size_t *latency_frames)
+    {
+        if (!engine || !engine->implementation)
+        {
+            return ECH_DSP_STATUS_INVALID_ARGUMENT;
+        }
+        try
+        {
+            return engine->implementation->GetLatency(latency_blocks, latency_frames);
+        }
+        catch (...)
+        {
+            return ECH_DSP_STATUS_ERROR;
+        }
+    }
+
+    ech_dsp_status_t ech_dsp_engine_reset(ech_dsp_engine_t *engine)
+    {
+        if (!engine || !engine->implementation)
+        {
+            return ECH_DSP_STATUS_INVALID_ARGUMENT;
+        }
+        engine->implementation->Reset();
+        return ECH_DSP_STATUS_OK;
+    }
+
     void ech_dsp_engine_destroy(ech_dsp_engine_t *engine)
     {
         try
@@ -278,7 +338,7 @@ extern "C"
     {
         try
         {
-            std::lock_guard<std::mutex> lock(g_engine_mutex);
+            std::lock_guard<std::shared_mutex> lock(g_engine_mutex);
             g_engine.reset();
         }
         catch (...)
@@ -12,6 +12,8 @@
 #include <sstream>
 #include <stdexcept>
 
+#include "../runtime/impulse_response.h"
+
 namespace echidna::dsp::config
 {
     namespace
@@ -382,12 +384,86 @@ namespace echidna::dsp::config
             return true;
         }
 
+        std::optional<EffectStage> ParseEffectStage(const std::string &id)
+        {
+            if (id == "gate")
+            {
+                return EffectStage::kGate;
+            }
+            if (id == "eq")
+            {
+                return EffectStage::kEq;
+            }
+            if (id == "comp")
+            {
+                return EffectStage::kCompressor;
+            }
+            if (id == "pitch")
+            {
+                return EffectStage::kPitch;
+            }
+            if (id == "formant")
+            {
+                return EffectStage::kFormant;
+            }
+            if (id == "autotune")
+            {
+                return EffectStage::kAutoTune;
+            }
+            if (id == "reverb")
+            {
+                return EffectStage::kReverb;
+            }
+            return std::nullopt;
+        }
+
+        /**
+         * Parse `engine.order`: distinct effect ids that run first, in the given
+         * order. Unlisted stages follow in their default order.
+         */
+        bool ParseStageOrder(const JsonValue &value,
+                             std::array<EffectStage, kEffectStageCount> *order)
+        {
+            if (value.type != JsonType::kArray || value.array_value.size() > kEffectStageCount)
+            {
+                return false;
+            }
+            std::array<bool, kEffectStageCount> listed{};
+            size_t count = 0;
+            for (const JsonValue &entry : value.array_value)
+            {
+                if (entry.type != JsonType::kString)
+                {
+                    return false;
+                }
+                auto stage = ParseEffectStage(entry.string_value);
+                if (!stage || listed[static_cast<size_t>(*stage)])
+                {
+                    return false;
+                }
+                listed[static_cast<size_t>(*stage)] = true;
+                (*order)[count++] = *stage;
+            }
+            for (EffectStage stage : kDefaultStageOrder)
+            {
+                if (!listed[static_cast<size_t>(stage)])
+                {
+                    (*order)[count++] = stage;
+                }
+            }
+            return true;
+        }
+
         std::optional<effects::PitchQuality> ParsePitchQuality(const std::string &value)
         {
             if (value == "LL")
             {
                 return effects::PitchQuality::kLowLatency;
             }
+            if (value == "Balanced")
+            {
+                return effects::PitchQuality::kBalanced;
+            }
             if (value == "HQ")
             {
                 return effects::PitchQuality::kHighQuality;
@@ -553,6 +629,15 @@ namespace echidna::dsp::config
                         result.preset.block_ms = static_cast<uint32_t>(*block);
                     }
                 }
+                if (const JsonValue *order = FindMember(*engine_config, "order"))
+                {
+                    if (!ParseStageOrder(*order, &result.preset.stage_order))
+                    {
+                        result.ok = false;
+                        result.error = "engine.order must list distinct effect ids";
+                        return result;
+                    }
+                }
             }
 
             if (const JsonValue *module_list = FindMember(root, "modules"))
@@ -718,6 +803,10 @@ namespace echidna::dsp::config
                                 params.makeup_gain_db = static_cast<float>(*makeup);
                             }
                         }
+                        if (auto link = GetBool(module, "stereoLink"))
+                        {
+                            params.stereo_link = *link;
+                        }
                     }
                     else if (*id == "pitch")
                     {
@@ -801,6 +890,36 @@ namespace echidna::dsp::config
                                 params.mix = static_cast<float>(*mix);
                             }
                         }
+                        if (auto mode = GetString(module, "mode"))
+                        {
+                            if (*mode == "convolution")
+                            {
+                                result.preset.reverb.mode = ReverbMode::kConvolution;
+                            }
+                            else if (*mode != "algorithmic")
+                            {
+                                result.ok = false;
+                                result.error = "reverb.mode must be algorithmic or convolution";
+                                return result;
+                            }
+                        }
+                        if (auto ir = GetString(module, "ir"))
+                        {
+                            if (ir->empty() || ir->size() > runtime::ImpulseResponseLibrary::kMaxIdLength)
+                            {
+                                result.ok = false;
+                                result.error = "reverb.ir must be 1 to 64 characters";
+                                return result;
+                            }
+                            result.preset.reverb.impulse_response = *ir;
+                        }
+                        if (result.preset.reverb.mode == ReverbMode::kConvolution &&
+                            result.preset.reverb.impulse_response.empty())
+                        {
+                            result.ok = false;
+                            result.error = "reverb.ir is required in convolution mode";
+                            return result;
+                        }
                     }
                     else if (*id == "mix")
                     {
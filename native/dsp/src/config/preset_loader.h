@@ -6,6 +6,9 @@
  * PresetDefinition structs used by the DSP engine.
  */
 
+#include <array>
+#include <cstddef>
+#include <cstdint>
 #include <optional>
 #include <string>
 #include <string_view>
@@ -38,51 +41,103 @@ namespace echidna::dsp::config
         kHighQuality
     };
 
+    /** Built-in effect stages a preset can reorder; the mix bus always runs last. */
+    enum class EffectStage : uint32_t
+    {
+        kGate,
+        kEq,
+        kCompressor,
+        kPitch,
+        kFormant,
+        kAutoTune,
+        kReverb
+    };
+
+    inline constexpr size_t kEffectStageCount = 7;
+
+    /** Processing order used when a preset does not set `engine.order`. */
+    inline constexpr std::array<EffectStage, kEffectStageCount> kDefaultStageOrder{
+        EffectStage::kGate,
+        EffectStage::kEq,
+        EffectStage::kCompressor,
+        EffectStage::kPitch,
+        EffectStage::kFormant,
+        EffectStage::kAutoTune,
+        EffectStage::kReverb};
+
     struct GateConfig
     {
         bool enabled{false};
         echidna::dsp::effects::GateParameters params;
+
+        bool operator==(const GateConfig &) const = default;
     };
 
     struct EqConfig
     {
         bool enabled{false};
         std::vector<echidna::dsp::effects::EqBand> bands;
+
+        bool operator==(const EqConfig &) const = default;
     };
 
     struct CompressorConfig
     {
         bool enabled{false};
         echidna::dsp::effects::CompressorParameters params;
+
+        bool operator==(const CompressorConfig &) const = default;
     };
 
     struct PitchConfig
     {
         bool enabled{false};
         echidna::dsp::effects::PitchParameters params;
+
+        bool operator==(const PitchConfig &) const = default;
     };
 
     struct FormantConfig
     {
         bool enabled{false};
         echidna::dsp::effects::FormantParameters params;
+
+        bool operator==(const FormantConfig &) const = default;
     };
 
     struct AutoTuneConfig
     {
         bool enabled{false};
         echidna::dsp::effects::AutoTuneParameters params;
+
+        bool operator==(const AutoTuneConfig &) const = default;
+    };
+
+    /** Reverb implementation a preset selects. */
+    enum class ReverbMode
+    {
+        /** effects::Reverb, shaped by room size and damping. */
+        kAlgorithmic,
+        /** effects::ConvolutionReverb with a named impulse response. */
+        kConvolution
     };
 
     struct ReverbConfig
     {
         bool enabled{false};
         echidna::dsp::effects::ReverbParameters params;
+        ReverbMode mode{ReverbMode::kAlgorithmic};
+        /** runtime::ImpulseResponseLibrary id; convolution mode only. */
+        std::string impulse_response;
+
+        bool operator==(const ReverbConfig &) const = default;
     };
 
     struct MixConfig
     {
         echidna::dsp::effects::MixParameters params;
+
+        bool operator==(const MixConfig &) const = default;
     };
 
     struct PresetDefinition
@@ -91,6 +146,8 @@ namespace echidna::dsp::config
         ProcessingMode processing_mode{ProcessingMode::kSynchronous};
         QualityPreference quality{QualityPreference::kLowLatency};
         uint32_t block_ms{15};
+        /** Every EffectStage exactly once, in processing order. */
+        std::array<EffectStage, kEffectStageCount> stage_order{kDefaultStageOrder};
         GateConfig gate;
         EqConfig eq;
         CompressorConfig compressor;
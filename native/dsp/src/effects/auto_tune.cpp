@@ -10,6 +10,8 @@
 #include <limits>
 #include <numeric>
 
+#include "../runtime/spectral_analysis.h"
+
 namespace echidna::dsp::effects
 {
     namespace
@@ -64,19 +66,19 @@ namespace echidna::dsp::effects
     void AutoTune::prepare(uint32_t sample_rate, uint32_t channels)
     {
         EffectProcessor::prepare(sample_rate, channels);
-        last_pitch_.assign(channels, 1.0f);
-        detected_pitch_.assign(channels, 0.0f);
-        const size_t max_period = sample_rate == 0 ? 0 : sample_rate / 60;
-        analysis_window_frames_ = std::max<size_t>(max_period * 2, 1);
-        analysis_history_.assign(analysis_window_frames_ * channels, 0.0f);
-        analysis_scratch_.assign(analysis_window_frames_, 0.0f);
-        analysis_write_frame_ = 0;
-        analysis_frames_ = 0;
+        if (!detector_)
+        {
+            detector_ = std::make_unique<runtime::YinPitchDetector>();
+        }
+        detector_->prepare(sample_rate, detector_settings_);
+        detected_pitch_ = 0.0f;
+        smoothed_ratio_ = 1.0f;
         analysis_frames_since_detection_ = 0;
         analysis_hop_frames_ = std::max<size_t>(sample_rate / 100, 1);
 
         max_block_frames_ = std::max(max_block_frames_, kDefaultMaxBlockFrames);
         scratch_.assign(max_block_frames_ * channels, 0.0f);
+        mixdown_.assign(max_block_frames_, 0.0f);
 
         PitchParameters pitch_parameters;
         pitch_parameters.quality = PitchQuality::kLowLatency;
@@ -90,12 +92,13 @@ namespace echidna::dsp::effects
     /** Reset last pitch tracking state to defaults. */
     void AutoTune::reset()
     {
-        std::fill(last_pitch_.begin(), last_pitch_.end(), 1.0f);
-        std::fill(detected_pitch_.begin(), detected_pitch_.end(), 0.0f);
-        std::fill(analysis_history_.begin(), analysis_history_.end(), 0.0f);
-        analysis_write_frame_ = 0;
-        analysis_frames_ = 0;
+        detected_pitch_ = 0.0f;
+        smoothed_ratio_ = 1.0f;
         analysis_frames_since_detection_ = 0;
+        if (detector_)
+        {
+            detector_->reset();
+        }
         correction_shifter_.reset();
     }
 
@@ -107,123 +110,20 @@ namespace echidna::dsp::effects
         }
         max_block_frames_ = max_frames;
         scratch_.resize(max_block_frames_ * channels_);
+        mixdown_.resize(max_block_frames_);
         correction_shifter_.prepare_realtime(max_block_frames_);
     }
 
-    void AutoTune::append_analysis_history(const float *samples, size_t frames)
+    void AutoTune::set_pitch_detector(std::unique_ptr<runtime::PitchDetector> detector,
+                                      const runtime::PitchDetectorSettings &settings)
     {
-        if (analysis_window_frames_ == 0 || channels_ == 0)
-        {
-            return;
-        }
-        for (size_t frame = 0; frame < frames; ++frame)
-        {
-            const size_t history_offset = analysis_write_frame_ * channels_;
-            const size_t input_offset = frame * channels_;
-            for (uint32_t channel = 0; channel < channels_; ++channel)
-            {
-                analysis_history_[history_offset + channel] = samples[input_offset + channel];
-            }
-            analysis_write_frame_ = (analysis_write_frame_ + 1) % analysis_window_frames_;
-            analysis_frames_ = std::min(analysis_frames_ + 1, analysis_window_frames_);
-        }
+        detector_ = std::move(detector);
+        detector_settings_ = settings;
     }
 
-    size_t AutoTune::copy_analysis_channel(uint32_t channel)
+    uint32_t AutoTune::analysis_features() const
     {
-        if (channel >= channels_ || analysis_frames_ == 0)
-        {
-            return 0;
-        }
-        const size_t oldest_frame = analysis_frames_ == analysis_window_frames_
-                                        ? analysis_write_frame_
-                                        : 0;
-        for (size_t frame = 0; frame < analysis_frames_; ++frame)
-        {
-            const size_t history_frame = (oldest_frame + frame) % analysis_window_frames_;
-            analysis_scratch_[frame] = analysis_history_[history_frame * channels_ + channel];
-        }
-        return analysis_frames_;
-    }
-
-    /** Estimate the fundamental frequency from the provided mono samples. */
-    float AutoTune::detect_pitch(const float *samples, size_t frames, uint32_t channel)
-    {
-        (void)channel;
-        const size_t min_period = static_cast<size_t>(sample_rate_ / 1000.0f);
-        const size_t max_period = static_cast<size_t>(sample_rate_ / 60.0f);
-        if (max_period >= frames || min_period == 0)
-        {
-            return 0.0f;
-        }
-
-        const float mean =
-            std::accumulate(samples, samples + frames, 0.0f) / static_cast<float>(frames);
-        float signal_energy = 0.0f;
-        for (size_t frame = 0; frame < frames; ++frame)
-        {
-            const float centered = samples[frame] - mean;
-            signal_energy += centered * centered;
-        }
-        if (signal_energy / static_cast<float>(frames) < 1.0e-8f)
-        {
-            return 0.0f;
-        }
-
-        auto correlation_at = [&](size_t period)
-        {
-            float correlation = 0.0f;
-            for (size_t frame = 0; frame + period < frames; ++frame)
-            {
-                correlation += (samples[frame] - mean) * (samples[frame + period] - mean);
-            }
-            return correlation;
-        };
-
-        float best_corr = 0.0f;
-        size_t best_period = 0;
-        for (size_t period = min_period; period <= max_period; ++period)
-        {
-            const float corr = correlation_at(period);
-            if (corr > best_corr)
-            {
-                best_corr = corr;
-                best_period = period;
-            }
-        }
-        if (best_period == 0)
-        {
-            return 0.0f;
-        }
-
-        float leading_energy = 0.0f;
-        float trailing_energy = 0.0f;
-        for (size_t frame = 0; frame + best_period < frames; ++frame)
-        {
-            const float leading = samples[frame] - mean;
-            const float trailing = samples[frame + best_period] - mean;
-            leading_energy += leading * leading;
-            trailing_energy += trailing * trailing;
-        }
-        const float normalization = std::sqrt(leading_energy * trailing_energy);
-        if (normalization <= 0.0f || best_corr / normalization < 0.65f)
-        {
-            return 0.0f;
-        }
-
-        float refined_period = static_cast<float>(best_period);
-        if (best_period > min_period && best_period < max_period)
-        {
-            const float previous = correlation_at(best_period - 1);
-            const float next = correlation_at(best_period + 1);
-            const float denominator = previous - 2.0f * best_corr + next;
-            if (std::abs(denominator) > 1.0e-12f)
-            {
-                const float offset = 0.5f * (previous - next) / denominator;
-                refined_period += std::clamp(offset, -0.5f, 0.5f);
-            }
-        }
-        return static_cast<float>(sample_rate_) / refined_period;
+        return runtime::SpectralAnalysis::kPitch;
     }
 
     /** Compute the nearest target pitch (Hz) from input frequency using
@@ -285,6 +185,33 @@ namespace echidna::dsp::effects
         return clamp_frequency(midi_to_hz(best_midi));
     }
 
+    /** Feed the internal detector a mixdown of `ctx` and update the pitch every hop. */
+    void AutoTune::detect_pitch(const ProcessContext &ctx)
+    {
+        // One detection on the channel average drives every channel.
+        const float channel_scale = 1.0f / static_cast<float>(channels_);
+        auto mix_down = [&](auto sample)
+        {
+            for (size_t frame = 0; frame < ctx.frames; ++frame)
+            {
+                float sum = 0.0f;
+                for (uint32_t channel = 0; channel < channels_; ++channel)
+                {
+                    sum += sample(frame, channel);
+                }
+                mixdown_[frame] = sum * channel_scale;
+            }
+        };
+        with_layout(ctx, mix_down);
+        detector_->push(mixdown_.data(), ctx.frames);
+        analysis_frames_since_detection_ += ctx.frames;
+        if (analysis_frames_since_detection_ >= analysis_hop_frames_)
+        {
+            analysis_frames_since_detection_ %= analysis_hop_frames_;
+            detected_pitch_ = detector_->estimate();
+        }
+    }
+
     /** Run pitch detection + correction across ctx.frames for each channel. */
     void AutoTune::process(ProcessContext &ctx)
     {
@@ -292,20 +219,19 @@ namespace echidna::dsp::effects
         {
             return;
         }
-        if (ctx.buffer == nullptr || ctx.frames == 0 || ctx.channels != channels_ ||
+        if (!ctx.has_audio() || ctx.frames == 0 || ctx.channels != channels_ ||
             ctx.frames > max_block_frames_)
         {
             return;
         }
 
-        append_analysis_history(ctx.buffer, ctx.frames);
-        analysis_frames_since_detection_ += ctx.frames;
-        const size_t required_history = sample_rate_ / 60 + 1;
-        const bool update_detection = analysis_frames_ >= required_history &&
-                                      analysis_frames_since_detection_ >= analysis_hop_frames_;
-        if (update_detection)
+        if (ctx.analysis != nullptr)
         {
-            analysis_frames_since_detection_ %= analysis_hop_frames_;
+            detected_pitch_ = ctx.analysis->pitch_hz();
+        }
+        else
+        {
+            detect_pitch(ctx);
         }
         const float snap = std::clamp(params_.snap_strength, 0.0f, 100.0f) / 100.0f;
         const float flex = std::clamp(params_.flex_tune, 0.0f, 100.0f) / 100.0f;
@@ -316,23 +242,11 @@ namespace echidna::dsp::effects
         const float coeff = std::exp(-static_cast<float>(ctx.frames) /
                                      std::max(retune_frames, 1.0f));
 
-        float correction_ratio = 0.0f;
-        uint32_t voiced_channels = 0;
-        for (uint32_t ch = 0; ch < channels_; ++ch)
+        float correction_ratio = 1.0f;
+        if (detected_pitch_ > 0.0f)
         {
-            if (update_detection)
-            {
-                const size_t analysis_frames = copy_analysis_channel(ch);
-                detected_pitch_[ch] =
-                    detect_pitch(analysis_scratch_.data(), analysis_frames, ch);
-            }
-            const float detected = detected_pitch_[ch];
-            if (detected <= 0.0f)
-            {
-                continue;
-            }
-            const float target = target_pitch(detected);
-            float ratio = target / detected;
+            const float target = target_pitch(detected_pitch_);
+            float ratio = target / detected_pitch_;
             const float correction_cents = 1200.0f * std::log2(ratio);
             if (std::abs(correction_cents) <= 10.0f)
             {
@@ -341,29 +255,37 @@ namespace echidna::dsp::effects
             ratio = 1.0f + (ratio - 1.0f) * snap;
             ratio = ratio * (1.0f - flex) + 1.0f * flex;
             ratio = ratio * (1.0f - humanize) + 1.0f * humanize;
-            float smoothed = last_pitch_[ch];
-            smoothed += (ratio - smoothed) * (1.0f - coeff);
-            last_pitch_[ch] = smoothed;
-            correction_ratio += smoothed;
-            ++voiced_channels;
+            smoothed_ratio_ += (ratio - smoothed_ratio_) * (1.0f - coeff);
+            correction_ratio = smoothed_ratio_;
         }
 
-        correction_ratio = voiced_channels == 0
-                               ? 1.0f
-                               : correction_ratio / static_cast<float>(voiced_channels);
+        // scratch_ keeps the uncorrected block, one channel after another.
+        const size_t frames = ctx.frames;
         if (params_.formant_preserve)
         {
-            std::copy_n(ctx.buffer, ctx.frames * ctx.channels, scratch_.data());
+            auto keep_channel = [&](uint32_t ch, auto span)
+            {
+                float *kept = scratch_.data() + ch * frames;
+                for (size_t frame = 0; frame < frames; ++frame)
+                {
+                    kept[frame] = span[frame];
+                }
+            };
+            for_each_channel(ctx, keep_channel);
         }
         correction_shifter_.set_realtime_ratio(correction_ratio);
         correction_shifter_.process(ctx);
         if (params_.formant_preserve)
         {
-            const size_t samples = ctx.frames * ctx.channels;
-            for (size_t sample = 0; sample < samples; ++sample)
+            auto blend_channel = [&](uint32_t ch, auto span)
             {
-                ctx.buffer[sample] = ctx.buffer[sample] * 0.85f + scratch_[sample] * 0.15f;
-            }
+                const float *kept = scratch_.data() + ch * frames;
+                for (size_t frame = 0; frame < frames; ++frame)
+                {
+                    span[frame] = span[frame] * 0.85f + kept[frame] * 0.15f;
+                }
+            };
+            for_each_channel(ctx, blend_channel);
         }
     }
 
@@ -8,10 +8,12 @@
 
 #include <array>
 #include <cstdint>
+#include <memory>
 #include <vector>
 
 #include "effect_base.h"
 #include "pitch_shifter.h"
+#include "../runtime/pitch_detector.h"
 
 namespace echidna::dsp::effects
 {
@@ -57,9 +59,18 @@ namespace echidna::dsp::effects
         float flex_tune{0.0f};
         bool formant_preserve{false};
         float snap_strength{100.0f};
+
+        bool operator==(const AutoTuneParameters &) const = default;
     };
 
-    /** AutoTune effect implementation. */
+    /**
+     * @brief AutoTune effect implementation.
+     *
+     * Pitch is detected once per 10 ms hop on a mono mixdown of all channels
+     * and the same correction is applied to every channel, so the stereo
+     * image is kept. When the host passes the shared analysis bus, its pitch
+     * is used and the internal detector is not fed.
+     */
     class AutoTune : public EffectProcessor
     {
     public:
@@ -74,27 +85,30 @@ namespace echidna::dsp::effects
         void prepare_realtime(size_t max_frames);
         /** Perform pitch detection + correction across `ctx.frames`. */
         void process(ProcessContext &ctx) override;
+        /** Subscribes to the bus pitch. */
+        uint32_t analysis_features() const override;
+        /**
+         * Replace the pitch detector (YIN at a 12 kHz analysis rate by
+         * default). Call before prepare(), which prepares it.
+         */
+        void set_pitch_detector(std::unique_ptr<runtime::PitchDetector> detector,
+                                const runtime::PitchDetectorSettings &settings);
 
     private:
-        /** Detect the dominant pitch (Hz) from samples for a given channel. */
-        float detect_pitch(const float *samples, size_t frames, uint32_t channel);
-        /** Append an interleaved callback to the preallocated analysis ring. */
-        void append_analysis_history(const float *samples, size_t frames);
-        /** Copy one channel's available history into chronological order. */
-        size_t copy_analysis_channel(uint32_t channel);
+        /** Update detected_pitch_ from the internal detector. */
+        void detect_pitch(const ProcessContext &ctx);
         /** Map an input frequency to a target pitch based on selected key/scale. */
         float target_pitch(float input_hz) const;
 
         AutoTuneParameters params_{};
         std::vector<float> scratch_;
-        std::vector<float> analysis_history_;
-        std::vector<float> analysis_scratch_;
-        std::vector<float> last_pitch_;
-        std::vector<float> detected_pitch_;
+        /** Mono mixdown of the current block, fed to the detector. */
+        std::vector<float> mixdown_;
+        std::unique_ptr<runtime::PitchDetector> detector_;
+        runtime::PitchDetectorSettings detector_settings_{};
         PitchShifter correction_shifter_;
-        size_t analysis_window_frames_{0};
-        size_t analysis_write_frame_{0};
-        size_t analysis_frames_{0};
+        float detected_pitch_{0.0f};
+        float smoothed_ratio_{1.0f};
         size_t analysis_frames_since_detection_{0};
         size_t analysis_hop_frames_{1};
         size_t max_block_frames_{0};
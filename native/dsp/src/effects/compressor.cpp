@@ -10,55 +10,50 @@
 
 namespace echidna::dsp::effects
 {
-    namespace
-    {
-        constexpr float kEpsilon = 1e-8f;
-
-        float linear_to_db(float value)
-        {
-            return 20.0f * std::log10(std::max(value, kEpsilon));
-        }
-
-        float db_to_linear(float db) { return std::pow(10.0f, db / 20.0f); }
-
-        float ms_to_coeff(float ms, uint32_t sr)
-        {
-            const float samples = (ms / 1000.0f) * static_cast<float>(sr);
-            if (samples <= 1.0f)
-            {
-                return 0.0f;
-            }
-            return std::exp(-1.0f / samples);
-        }
-    } // namespace
-
     /** Set compressor configuration parameters. */
     void Compressor::set_parameters(const CompressorParameters &params)
     {
+        const bool relink = sample_rate_ != 0 && params.stereo_link != params_.stereo_link;
         params_ = params;
+        if (relink)
+        {
+            dynamics_.prepare(channels_, params_.stereo_link);
+            dynamics_.reset(1.0f);
+        }
+        // Once prepared, a parameter change only recomputes coefficients.
+        update_coefficients();
     }
 
     /** Initialize coefficients for attack/release and makeup gains. */
     void Compressor::prepare(uint32_t sample_rate, uint32_t channels)
     {
         EffectProcessor::prepare(sample_rate, channels);
-        attack_coeff_ = ms_to_coeff(params_.attack_ms, sample_rate);
-        release_coeff_ = ms_to_coeff(params_.release_ms, sample_rate);
+        dynamics_.prepare(channels, params_.stereo_link);
+        update_coefficients();
+        dynamics_.reset(1.0f);
+    }
+
+    void Compressor::update_coefficients()
+    {
+        // The envelope advances once per sub-block.
+        const float update_rate =
+            static_cast<float>(sample_rate_) / static_cast<float>(runtime::kDynamicsSubBlock);
+        attack_coeff_ = runtime::smoothing_coefficient(params_.attack_ms, update_rate);
+        release_coeff_ = runtime::smoothing_coefficient(params_.release_ms, update_rate);
         if (params_.mode == CompressorMode::kAuto)
         {
             // Estimate makeup gain so average level near threshold remains stable.
             const float auto_makeup = -params_.threshold_db / 4.0f;
-            makeup_gain_ = db_to_linear(auto_makeup);
+            makeup_gain_ = std::pow(10.0f, auto_makeup / 20.0f);
         }
         else
         {
-            makeup_gain_ = db_to_linear(params_.makeup_gain_db);
+            makeup_gain_ = std::pow(10.0f, params_.makeup_gain_db / 20.0f);
         }
-        envelope_ = 1.0f;
     }
 
     /** Reset envelope to unity gain. */
-    void Compressor::reset() { envelope_ = 1.0f; }
+    void Compressor::reset() { dynamics_.reset(1.0f); }
 
     /** Compute the per-sample dB gain-reduction according to the current
      * compressor curve. */
@@ -91,31 +86,29 @@ namespace echidna::dsp::effects
         return compressed - input_db;
     }
 
-    /** Perform per-sample compression on ctx.buffer for ctx.frames frames. */
+    /** Compress ctx.frames frames in place, evaluating gain per sub-block. */
     void Compressor::process(ProcessContext &ctx)
     {
-        if (!enabled_)
+        if (!enabled_ || !ctx.has_audio() || ctx.channels != dynamics_.channels())
         {
             return;
         }
 
-        float *buffer = ctx.buffer;
-        const size_t total = ctx.frames * ctx.channels;
-        for (size_t i = 0; i < total; ++i)
+        auto next_gain = [this](uint32_t, float peak, float gain)
         {
-            const float sample = buffer[i];
-            const float level_db = linear_to_db(std::abs(sample));
-            float gain_db = compute_gain_reduction(level_db);
-            float target = db_to_linear(gain_db) * makeup_gain_;
-            if (target < envelope_)
-            {
-                envelope_ += (target - envelope_) * (1.0f - attack_coeff_);
-            }
-            else
-            {
-                envelope_ += (target - envelope_) * (1.0f - release_coeff_);
-            }
-            buffer[i] = sample * envelope_;
+            const float level_db = runtime::fast_linear_to_db(peak);
+            const float target =
+                runtime::fast_db_to_linear(compute_gain_reduction(level_db)) * makeup_gain_;
+            const float coeff = target < gain ? attack_coeff_ : release_coeff_;
+            return gain + (target - gain) * (1.0f - coeff);
+        };
+        if (ctx.planar != nullptr)
+        {
+            dynamics_.process(ctx.planar, ctx.frames, next_gain);
+        }
+        else
+        {
+            dynamics_.process_interleaved(ctx.buffer, ctx.frames, next_gain);
         }
     }
 
@@ -6,6 +6,7 @@
  */
 
 #include "effect_base.h"
+#include "../runtime/dynamics.h"
 
 namespace echidna::dsp::effects
 {
@@ -35,9 +36,19 @@ namespace echidna::dsp::effects
         float attack_ms{5.0f};
         float release_ms{120.0f};
         float makeup_gain_db{0.0f};
+        /** Drive every channel from one detector (true) or one per channel. */
+        bool stereo_link{true};
+
+        bool operator==(const CompressorParameters &) const = default;
     };
 
-    /** Per-sample compressor implementation applying smooth attack/release. */
+    /**
+     * @brief Feed-forward compressor with attack/release smoothing.
+     *
+     * The gain computer runs once per runtime::kDynamicsSubBlock frames on
+     * the sub-block peak, using the fast log2/exp2 approximations, and the
+     * resulting gain is interpolated per frame.
+     */
     class Compressor : public EffectProcessor
     {
     public:
@@ -54,9 +65,11 @@ namespace echidna::dsp::effects
     private:
         /** Compute the required gain reduction in decibels for a given input dB. */
         float compute_gain_reduction(float input_db);
+        /** Derive attack/release coefficients and makeup gain from params_. */
+        void update_coefficients();
 
         CompressorParameters params_{};
-        float envelope_{0.0f};
+        runtime::SubBlockDynamics dynamics_{};
         float attack_coeff_{0.0f};
         float release_coeff_{0.0f};
         float makeup_gain_{1.0f};
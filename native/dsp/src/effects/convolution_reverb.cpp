@@ -0,0 +1,229 @@
+#include "convolution_reverb.h"
+
+/**
+ * @file convolution_reverb.cpp
+ * @brief Implementation of the partitioned convolution reverb.
+ */
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+
+#include "../runtime/simd_lanes.h"
+
+namespace echidna::dsp::effects
+{
+    namespace
+    {
+        namespace lanes = runtime::lanes;
+
+        /** sum += x * h for `count` complex values in planar form. */
+        void multiply_accumulate(float *sum_re,
+                                 float *sum_im,
+                                 const float *x_re,
+                                 const float *x_im,
+                                 const float *h_re,
+                                 const float *h_im,
+                                 size_t count)
+        {
+            size_t k = 0;
+            for (; k + lanes::kWidth <= count; k += lanes::kWidth)
+            {
+                const lanes::Lanes xr = lanes::load(x_re + k);
+                const lanes::Lanes xi = lanes::load(x_im + k);
+                const lanes::Lanes hr = lanes::load(h_re + k);
+                const lanes::Lanes hi = lanes::load(h_im + k);
+                const lanes::Lanes re = lanes::sub(lanes::mul(xr, hr), lanes::mul(xi, hi));
+                const lanes::Lanes im = lanes::add(lanes::mul(xr, hi), lanes::mul(xi, hr));
+                lanes::store(sum_re + k, lanes::add(lanes::load(sum_re + k), re));
+                lanes::store(sum_im + k, lanes::add(lanes::load(sum_im + k), im));
+            }
+            for (; k < count; ++k)
+            {
+                sum_re[k] += x_re[k] * h_re[k] - x_im[k] * h_im[k];
+                sum_im[k] += x_re[k] * h_im[k] + x_im[k] * h_re[k];
+            }
+        }
+    } // namespace
+
+    size_t ConvolutionReverb::partition_frames(uint32_t sample_rate)
+    {
+        return std::clamp<size_t>(std::bit_ceil(std::max<size_t>(1, sample_rate / 200)),
+                                  runtime::RealFft::kMinSize / 2,
+                                  runtime::RealFft::kMaxSize / 2);
+    }
+
+    void ConvolutionReverb::set_parameters(const ReverbParameters &params)
+    {
+        params_ = params;
+        if (partition_ != 0)
+        {
+            ensure_buffers();
+        }
+    }
+
+    void ConvolutionReverb::set_impulse_response(
+        std::shared_ptr<const runtime::PartitionedImpulseResponse> response)
+    {
+        response_ = std::move(response);
+        if (partition_ == 0)
+        {
+            return;
+        }
+        if (response_ && response_->partition_frames != partition_)
+        {
+            response_.reset();
+        }
+        ensure_buffers();
+        reset();
+    }
+
+    void ConvolutionReverb::prepare(uint32_t sample_rate, uint32_t channels)
+    {
+        EffectProcessor::prepare(sample_rate, channels);
+        partition_ = partition_frames(sample_rate);
+        if (sample_rate == 0 || !fft_.prepare(2 * partition_))
+        {
+            partition_ = 0;
+            return;
+        }
+        window_.ensure(channels, 2 * partition_);
+        output_.ensure(channels, partition_);
+        frame_.assign(2 * partition_, 0.0f);
+        if (response_ && response_->partition_frames != partition_)
+        {
+            response_.reset();
+        }
+        ensure_buffers();
+        reset();
+    }
+
+    void ConvolutionReverb::ensure_buffers()
+    {
+        const float pre_delay_ms = std::isfinite(params_.pre_delay_ms) ? std::max(0.0f, params_.pre_delay_ms) : 0.0f;
+        const auto total = static_cast<size_t>(pre_delay_ms * static_cast<float>(sample_rate_) / 1000.0f);
+        const size_t predelay = total > partition_ ? total - partition_ : 0;
+        const size_t capacity = std::bit_ceil(predelay + 1);
+        predelay_.ensure(channels_, capacity);
+        if (predelay != predelay_frames_ || capacity != predelay_mask_ + 1)
+        {
+            for (uint32_t ch = 0; ch < channels_; ++ch)
+            {
+                std::fill_n(predelay_.channel(ch), capacity, 0.0f);
+            }
+            predelay_frames_ = predelay;
+            predelay_mask_ = capacity - 1;
+        }
+        if (response_)
+        {
+            line_re_.ensure(channels_, response_->partitions * response_->stride);
+            line_im_.ensure(channels_, response_->partitions * response_->stride);
+            if (sum_re_.size() < response_->stride)
+            {
+                sum_re_.resize(response_->stride);
+                sum_im_.resize(response_->stride);
+            }
+        }
+    }
+
+    void ConvolutionReverb::reset()
+    {
+        if (partition_ == 0)
+        {
+            return;
+        }
+        for (uint32_t ch = 0; ch < channels_; ++ch)
+        {
+            std::fill_n(window_.channel(ch), 2 * partition_, 0.0f);
+            std::fill_n(output_.channel(ch), partition_, 0.0f);
+            std::fill_n(predelay_.channel(ch), predelay_mask_ + 1, 0.0f);
+            if (response_)
+            {
+                std::fill_n(line_re_.channel(ch), response_->partitions * response_->stride, 0.0f);
+                std::fill_n(line_im_.channel(ch), response_->partitions * response_->stride, 0.0f);
+            }
+        }
+        fill_ = 0;
+        head_ = 0;
+        write_ = 0;
+    }
+
+    /**
+     * @brief Overlap-save step: the newest input spectrum enters the delay
+     * line and partition p of the response meets the spectrum p partitions
+     * older.
+     */
+    void ConvolutionReverb::process_partition()
+    {
+        const runtime::PartitionedImpulseResponse &response = *response_;
+        const size_t partitions = response.partitions;
+        const size_t stride = response.stride;
+        head_ = head_ == 0 ? partitions - 1 : head_ - 1;
+        for (uint32_t ch = 0; ch < channels_; ++ch)
+        {
+            float *window = window_.channel(ch);
+            float *line_re = line_re_.channel(ch);
+            float *line_im = line_im_.channel(ch);
+            fft_.forward(window, line_re + head_ * stride, line_im + head_ * stride);
+
+            std::fill_n(sum_re_.data(), stride, 0.0f);
+            std::fill_n(sum_im_.data(), stride, 0.0f);
+            for (size_t p = 0; p < partitions; ++p)
+            {
+                const size_t slot = head_ + p < partitions ? head_ + p : head_ + p - partitions;
+                multiply_accumulate(sum_re_.data(),
+                                    sum_im_.data(),
+                                    line_re + slot * stride,
+                                    line_im + slot * stride,
+                                    response.re.data() + p * stride,
+                                    response.im.data() + p * stride,
+                                    stride);
+            }
+            fft_.inverse(sum_re_.data(), sum_im_.data(), frame_.data());
+            // The first half wrapped around; the second is the linear convolution.
+            std::copy_n(frame_.data() + partition_, partition_, output_.channel(ch));
+            std::copy_n(window + partition_, partition_, window);
+        }
+    }
+
+    void ConvolutionReverb::process(ProcessContext &ctx)
+    {
+        if (!enabled_ || !response_ || partition_ == 0)
+        {
+            return;
+        }
+        if (!ctx.has_audio() || ctx.channels != channels_)
+        {
+            return;
+        }
+        const float wet = std::clamp(params_.mix, 0.0f, 50.0f) / 100.0f;
+        auto run = [&](auto sample)
+        {
+            for (size_t frame = 0; frame < ctx.frames; ++frame)
+            {
+                for (uint32_t ch = 0; ch < channels_; ++ch)
+                {
+                    float &value = sample(frame, ch);
+                    const float in = value;
+                    float delayed = in;
+                    if (predelay_frames_ != 0)
+                    {
+                        float *ring = predelay_.channel(ch);
+                        delayed = ring[(write_ - predelay_frames_) & predelay_mask_];
+                        ring[write_ & predelay_mask_] = in;
+                    }
+                    window_.channel(ch)[partition_ + fill_] = delayed;
+                    value = in * (1.0f - wet) + output_.channel(ch)[fill_] * wet;
+                }
+                ++write_;
+                if (++fill_ == partition_)
+                {
+                    process_partition();
+                    fill_ = 0;
+                }
+            }
+        };
+        with_layout(ctx, run);
+    }
+
+} // namespace echidna::dsp::effects
@@ -0,0 +1,95 @@
+#pragma once
+
+/**
+ * @file convolution_reverb.h
+ * @brief Reverb that convolves with a sampled impulse response.
+ */
+
+#include <memory>
+
+#include "effect_base.h"
+#include "reverb.h"
+#include "../runtime/fft.h"
+#include "../runtime/impulse_response.h"
+#include "../runtime/planar_buffer.h"
+
+namespace echidna::dsp::effects
+{
+
+    /**
+     * @brief Uniformly partitioned overlap-save convolution reverb.
+     *
+     * Each channel is convolved with the same mono impulse response, split
+     * into partitions of partition_frames(). Every partition_frames() frames
+     * the latest two partitions of input are transformed into a
+     * frequency-domain delay line. That line is multiplied bin by bin with
+     * the response spectra and summed, and one inverse transform yields the
+     * next partition of output. The wet signal therefore trails the input by
+     * one partition, which counts towards the pre-delay. Dry samples pass
+     * without delay.
+     *
+     * Of ReverbParameters only pre-delay and mix apply; room size and
+     * damping are properties of the response. Without a response the effect
+     * passes its input through.
+     */
+    class ConvolutionReverb : public EffectProcessor
+    {
+    public:
+        /** Partition length used at `sample_rate`: about 5 ms, a power of two. */
+        static size_t partition_frames(uint32_t sample_rate);
+
+        /**
+         * @brief Set pre-delay and mix. A longer pre-delay than any before
+         * grows its buffer, so call this off the audio thread.
+         */
+        void set_parameters(const ReverbParameters &params);
+        /**
+         * @brief Use `response`, or none. Sizes the frequency-domain delay
+         * line for it and clears it (may allocate). A response partitioned
+         * for another rate is ignored.
+         */
+        void set_impulse_response(std::shared_ptr<const runtime::PartitionedImpulseResponse> response);
+
+        /** Size the transform and per-channel buffers. */
+        void prepare(uint32_t sample_rate, uint32_t channels) override;
+        /** Clear the delay lines; the tail restarts from silence. */
+        void reset() override;
+        /** Mix the convolved input into ctx in-place. */
+        void process(ProcessContext &ctx) override;
+
+        /** Partitions of the current response, or 0 without one. */
+        size_t partitions() const { return response_ ? response_->partitions : 0; }
+        /** Frames from an input sample to its first wet output. */
+        size_t wet_delay_frames() const { return partition_ + predelay_frames_; }
+
+    private:
+        /** Size the pre-delay ring and frequency-domain delay line. */
+        void ensure_buffers();
+        /** Transform the completed partition of every channel and convolve it. */
+        void process_partition();
+
+        ReverbParameters params_{};
+        std::shared_ptr<const runtime::PartitionedImpulseResponse> response_{};
+        size_t partition_{0};
+        size_t fill_{0};
+        /** Slot of the delay line holding the newest input spectrum. */
+        size_t head_{0};
+        /** Pre-delay beyond the one partition the convolution already adds. */
+        size_t predelay_frames_{0};
+        size_t predelay_mask_{0};
+        size_t write_{0};
+        runtime::RealFft fft_{};
+        /** Per channel: the previous and the current input partition. */
+        runtime::PlanarBuffer window_{};
+        /** Per channel: the partition of wet output being played out. */
+        runtime::PlanarBuffer output_{};
+        /** Per channel: partitions() input spectra, stride floats apart. */
+        runtime::PlanarBuffer line_re_{};
+        runtime::PlanarBuffer line_im_{};
+        runtime::PlanarBuffer predelay_{};
+        std::vector<float, runtime::AlignedAllocator<float>> sum_re_{};
+        std::vector<float, runtime::AlignedAllocator<float>> sum_im_{};
+        std::vector<float> frame_{};
+    };
+
+} // namespace echidna::dsp::effects
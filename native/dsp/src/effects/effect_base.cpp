@@ -2,10 +2,39 @@
 
 /**
  * @file effect_base.cpp
- * @brief Trivial translation unit for effect base classes (mostly header-only
- * definitions). This file exists to provide a compilation unit when needed.
+ * @brief Layout conversion helpers for effects whose kernels need
+ * interleaved samples.
  */
 
+#include <cstring>
+
+#include "../runtime/simd.h"
+
 namespace echidna::dsp::effects
 {
+
+    void copy_to_interleaved(const ProcessContext &ctx, float *interleaved)
+    {
+        if (ctx.planar != nullptr)
+        {
+            runtime::interleave(ctx.planar, interleaved, ctx.frames, ctx.channels);
+        }
+        else if (ctx.buffer != interleaved)
+        {
+            std::memcpy(interleaved, ctx.buffer, sizeof(float) * ctx.frames * ctx.channels);
+        }
+    }
+
+    void copy_from_interleaved(const float *interleaved, ProcessContext &ctx)
+    {
+        if (ctx.planar != nullptr)
+        {
+            runtime::deinterleave(interleaved, ctx.planar, ctx.frames, ctx.channels);
+        }
+        else if (ctx.buffer != interleaved)
+        {
+            std::memcpy(ctx.buffer, interleaved, sizeof(float) * ctx.frames * ctx.channels);
+        }
+    }
+
 } // namespace echidna::dsp::effects
@@ -8,11 +8,25 @@
 #include <cstddef>
 #include <cstdint>
 
+namespace echidna::dsp::runtime
+{
+    class SpectralAnalysis;
+} // namespace echidna::dsp::runtime
+
 namespace echidna::dsp::effects
 {
 
     /**
      * @brief Context passed to effect processors during `process()` calls.
+     *
+     * Audio is either interleaved in `buffer` or, when `planar` is set, held
+     * in `channels` contiguous spans of `frames` samples (and `buffer` is
+     * unused). Effects should reach samples through for_each_channel() or
+     * with_layout() so both layouts work.
+     *
+     * `analysis` is set by a host that runs the shared analysis bus ahead of
+     * this effect; it then describes the signal the effect receives, up to
+     * the spectral changes of stages in between that keep the pitch.
      */
     struct ProcessContext
     {
@@ -20,8 +34,80 @@ namespace echidna::dsp::effects
         size_t frames{0};
         uint32_t channels{0};
         uint32_t sample_rate{0};
+        float *const *planar{nullptr};
+        const runtime::SpectralAnalysis *analysis{nullptr};
+
+        /** True if the context carries samples in either layout. */
+        bool has_audio() const { return buffer != nullptr || planar != nullptr; }
+    };
+
+    /** One channel stored contiguously (planar layout). */
+    struct ContiguousChannel
+    {
+        float *samples;
+
+        float &operator[](size_t frame) const { return samples[frame]; }
+    };
+
+    /** One channel of an interleaved buffer. */
+    struct StridedChannel
+    {
+        float *samples;
+        uint32_t stride;
+
+        float &operator[](size_t frame) const { return samples[frame * stride]; }
     };
 
+    /**
+     * @brief Call `fn(channel, span)` for every channel of `ctx`.
+     *
+     * `span[frame]` addresses one sample. Planar contexts pass a
+     * ContiguousChannel, so a generic `fn` is instantiated with unit stride
+     * and its per-sample loop can be vectorized.
+     */
+    template <typename Fn>
+    void for_each_channel(const ProcessContext &ctx, Fn &&fn)
+    {
+        for (uint32_t ch = 0; ch < ctx.channels; ++ch)
+        {
+            if (ctx.planar != nullptr)
+            {
+                fn(ch, ContiguousChannel{ctx.planar[ch]});
+            }
+            else
+            {
+                fn(ch, StridedChannel{ctx.buffer + ch, ctx.channels});
+            }
+        }
+    }
+
+    /**
+     * @brief Call `fn(sample)` once with an accessor `sample(frame, channel)`
+     * for the layout of `ctx`, for effects that link channels frame by frame.
+     */
+    template <typename Fn>
+    void with_layout(const ProcessContext &ctx, Fn &&fn)
+    {
+        if (ctx.planar != nullptr)
+        {
+            float *const *planar = ctx.planar;
+            fn([planar](size_t frame, uint32_t channel) -> float &
+               { return planar[channel][frame]; });
+        }
+        else
+        {
+            float *buffer = ctx.buffer;
+            const uint32_t channels = ctx.channels;
+            fn([buffer, channels](size_t frame, uint32_t channel) -> float &
+               { return buffer[frame * channels + channel]; });
+        }
+    }
+
+    /** Copy the audio of `ctx` into `interleaved` (frames * channels floats). */
+    void copy_to_interleaved(const ProcessContext &ctx, float *interleaved);
+    /** Overwrite the audio of `ctx` from `interleaved` (frames * channels floats). */
+    void copy_from_interleaved(const float *interleaved, ProcessContext &ctx);
+
     /**
      * @brief Abstract base class for an effect processor instance.
      *
@@ -54,6 +140,15 @@ namespace echidna::dsp::effects
          */
         virtual void process(ProcessContext &ctx) = 0;
 
+        /**
+         * @brief runtime::SpectralAnalysis features this effect reads from
+         * ProcessContext::analysis when the host provides them; 0 if none.
+         *
+         * A host that sets the bus computes every feature named here. Effects
+         * must still work without it.
+         */
+        virtual uint32_t analysis_features() const { return 0; }
+
         /**
          * @brief Enable or disable the effect.
          */
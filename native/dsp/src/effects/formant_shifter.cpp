@@ -6,65 +6,285 @@
  */
 
 #include <algorithm>
+#include <bit>
 #include <cmath>
 
+#include "../runtime/simd_lanes.h"
+
 namespace echidna::dsp::effects
 {
+    namespace
+    {
+        namespace lanes = runtime::lanes;
+
+        /** Largest boost the warp applies to one bin (+18 dB). */
+        constexpr float kMaxGain = 8.0f;
+        /** Intelligibility assist fades the shift out across this band. */
+        constexpr float kAssistStartHz = 3000.0f;
+        constexpr float kAssistEndHz = 5000.0f;
+
+        /** dst[k] *= gain[k] for `count` values. */
+        void scale(float *dst, const float *gain, size_t count)
+        {
+            size_t k = 0;
+            for (; k + lanes::kWidth <= count; k += lanes::kWidth)
+            {
+                lanes::store(dst + k, lanes::mul(lanes::load(dst + k), lanes::load(gain + k)));
+            }
+            for (; k < count; ++k)
+            {
+                dst[k] *= gain[k];
+            }
+        }
+
+        /** dst[k] = a[k] * b[k] for `count` values. */
+        void multiply(float *dst, const float *a, const float *b, size_t count)
+        {
+            size_t k = 0;
+            for (; k + lanes::kWidth <= count; k += lanes::kWidth)
+            {
+                lanes::store(dst + k, lanes::mul(lanes::load(a + k), lanes::load(b + k)));
+            }
+            for (; k < count; ++k)
+            {
+                dst[k] = a[k] * b[k];
+            }
+        }
+
+        /** acc[k] += a[k] * b[k] * gain for `count` values. */
+        void multiply_add(float *acc, const float *a, const float *b, float gain, size_t count)
+        {
+            const lanes::Lanes g = lanes::splat(gain);
+            size_t k = 0;
+            for (; k + lanes::kWidth <= count; k += lanes::kWidth)
+            {
+                const lanes::Lanes product = lanes::mul(lanes::mul(lanes::load(a + k), lanes::load(b + k)), g);
+                lanes::store(acc + k, lanes::add(lanes::load(acc + k), product));
+            }
+            for (; k < count; ++k)
+            {
+                acc[k] += a[k] * b[k] * gain;
+            }
+        }
+    } // namespace
 
     /** Set new formant shifter parameters. */
     void FormantShifter::set_parameters(const FormantParameters &params)
     {
         params_ = params;
+        envelope_countdown_ = 0;
+        const float cents = std::isfinite(params.cents) ? std::clamp(params.cents, -600.0f, 600.0f) : 0.0f;
+        ratio_ = std::exp2(cents / 1200.0f);
+        gain_hop_ = ~uint64_t{0};
     }
 
-    /** Prepare internal per-channel buffers. */
+    /** Size the per-channel STFT buffers. */
     void FormantShifter::prepare(uint32_t sample_rate, uint32_t channels)
     {
         EffectProcessor::prepare(sample_rate, channels);
-        delay_state_.assign(channels, 0.0f);
-        tilt_state_.assign(channels, 0.0f);
+        // About 10 ms frames keep the added latency near one callback while
+        // resolving the envelope, which is smooth by construction.
+        const size_t fft_size = std::clamp<size_t>(std::bit_ceil(static_cast<size_t>(sample_rate) / 100),
+                                                   256,
+                                                   runtime::RealFft::kMaxSize);
+        if (sample_rate == 0 || !fft_.prepare(fft_size) || !cepstral_.prepare(sample_rate, fft_size))
+        {
+            hop_ = 0;
+            return;
+        }
+        hop_ = fft_size / 4;
+        latency_ = fft_size - hop_;
+        bins_ = fft_.bins();
+        bin_hz_ = static_cast<float>(sample_rate) / static_cast<float>(fft_size);
+        envelope_interval_ = std::max<size_t>(1, sample_rate / 100 / hop_);
+        // Hann analysis and synthesis windows at 75 % overlap sum to 1.5.
+        synthesis_gain_ = 1.0f / 1.5f;
+
+        constexpr double kPi = 3.14159265358979323846;
+        window_.resize(fft_size);
+        for (size_t n = 0; n < fft_size; ++n)
+        {
+            window_[n] = static_cast<float>(
+                0.5 - 0.5 * std::cos(2.0 * kPi * static_cast<double>(n) / static_cast<double>(fft_size)));
+        }
+        gain_.assign(bins_, 1.0f);
+        frame_.assign(fft_size, 0.0f);
+        magnitude_.assign(bins_, 0.0f);
+        envelope_.assign(bins_, 0.0f);
+        input_.ensure(channels, fft_size);
+        output_.ensure(channels, hop_);
+        accumulator_.ensure(channels, fft_size);
+        spectrum_re_.ensure(channels, bins_);
+        spectrum_im_.ensure(channels, bins_);
+        reset();
     }
 
-    /** Reset internal state buffers to zero. */
+    /** Clear the STFT history; output restarts after latency_frames() of silence. */
     void FormantShifter::reset()
     {
-        std::fill(delay_state_.begin(), delay_state_.end(), 0.0f);
-        std::fill(tilt_state_.begin(), tilt_state_.end(), 0.0f);
+        if (hop_ == 0)
+        {
+            return;
+        }
+        for (uint32_t ch = 0; ch < channels_; ++ch)
+        {
+            std::fill_n(input_.channel(ch), fft_.size(), 0.0f);
+            std::fill_n(output_.channel(ch), hop_, 0.0f);
+            std::fill_n(accumulator_.channel(ch), fft_.size(), 0.0f);
+        }
+        std::fill(gain_.begin(), gain_.end(), 1.0f);
+        gain_hop_ = ~uint64_t{0};
+        envelope_countdown_ = 0;
+        fill_ = latency_;
+    }
+
+    uint32_t FormantShifter::analysis_features() const
+    {
+        return ratio_ == 1.0f ? 0U : runtime::SpectralAnalysis::kEnvelope;
     }
 
-    /** Perform in-place formant shifting across the buffer. */
-    void FormantShifter::process(ProcessContext &ctx)
+    /** gain[k] = E(f_k / r) / E(f_k), with E read by linear interpolation. */
+    void FormantShifter::update_gain(const float *envelope, size_t bins, float bin_hz)
     {
-        if (!enabled_)
+        constexpr float kFloor = 1.0e-9f;
+        const float inverse_ratio = 1.0f / ratio_;
+        const float step = bin_hz_ / bin_hz;
+        const float last = static_cast<float>(bins - 1);
+        auto sample = [&](float position)
         {
-            return;
+            position = std::min(position, last);
+            const size_t index = static_cast<size_t>(position);
+            const size_t next = std::min(index + 1, bins - 1);
+            const float fraction = position - static_cast<float>(index);
+            return envelope[index] + (envelope[next] - envelope[index]) * fraction;
+        };
+        // Envelope power before and after the warp, to normalise it below.
+        double power_in = 0.0;
+        double power_out = 0.0;
+        for (size_t k = 0; k < bins_; ++k)
+        {
+            const float position = static_cast<float>(k) * step;
+            const float here = sample(position);
+            float gain = here > kFloor ? std::min(sample(position * inverse_ratio) / here, kMaxGain) : 1.0f;
+            if (params_.intelligibility_assist)
+            {
+                const float hz = static_cast<float>(k) * bin_hz_;
+                const float keep =
+                    std::clamp((kAssistEndHz - hz) / (kAssistEndHz - kAssistStartHz), 0.0f, 1.0f);
+                gain = 1.0f + (gain - 1.0f) * keep;
+            }
+            gain_[k] = gain;
+            const double weighted = static_cast<double>(here) * here;
+            power_in += weighted;
+            power_out += weighted * gain * gain;
+        }
+
+        // The warp moves energy between bands; it should not change the
+        // loudness. Rescale so the warped envelope carries the same power.
+        if (power_out > 0.0 && power_in > 0.0)
+        {
+            const float normalise = std::clamp(static_cast<float>(std::sqrt(power_in / power_out)),
+                                               1.0f / kMaxGain,
+                                               kMaxGain);
+            for (size_t k = 0; k < bins_; ++k)
+            {
+                gain_[k] = std::min(gain_[k] * normalise, kMaxGain);
+            }
         }
-        const float cents = std::clamp(params_.cents, -600.0f, 600.0f);
-        const float ratio = std::pow(2.0f, cents / 1200.0f);
-        const float allpass_coeff = (ratio - 1.0f) / (ratio + 1.0f);
-        const float intelligibility_mix = params_.intelligibility_assist ? 0.25f : 0.0f;
+    }
 
+    /** Analyse one hop of every channel, warp the envelope and overlap-add. */
+    void FormantShifter::process_frame(const runtime::SpectralAnalysis *analysis)
+    {
+        const size_t size = fft_.size();
         for (uint32_t ch = 0; ch < channels_; ++ch)
         {
-            float prev_x = delay_state_[ch];
-            float prev_y = tilt_state_[ch];
-            for (size_t frame = 0; frame < ctx.frames; ++frame)
+            multiply(frame_.data(), input_.channel(ch), window_.data(), size);
+            fft_.forward(frame_.data(), spectrum_re_.channel(ch), spectrum_im_.channel(ch));
+        }
+
+        if (analysis != nullptr)
+        {
+            // The bus envelope changes once per bus hop.
+            if (analysis->hop_count() != gain_hop_ && analysis->bins() > 1)
+            {
+                update_gain(analysis->envelope(), analysis->bins(), analysis->bin_hz());
+                gain_hop_ = analysis->hop_count();
+            }
+        }
+        else
+        {
+            // Envelope of the channel average, as the bus would see it, at
+            // about the bus's 10 ms cadence.
+            if (envelope_countdown_ == 0)
             {
-                const size_t idx = frame * channels_ + ch;
-                const float x = ctx.buffer[idx];
-                float y = -allpass_coeff * x + prev_x + allpass_coeff * prev_y;
-                prev_x = x;
-                prev_y = y;
-                if (intelligibility_mix > 0.0f)
+                const float channel_scale = 1.0f / static_cast<float>(channels_);
+                for (size_t k = 0; k < bins_; ++k)
                 {
-                    const float high = y - ctx.buffer[idx > channels_ ? idx - channels_ : idx];
-                    y = y * (1.0f - intelligibility_mix) + high * intelligibility_mix;
+                    float re = 0.0f;
+                    float im = 0.0f;
+                    for (uint32_t ch = 0; ch < channels_; ++ch)
+                    {
+                        re += spectrum_re_.channel(ch)[k];
+                        im += spectrum_im_.channel(ch)[k];
+                    }
+                    magnitude_[k] = std::sqrt(re * re + im * im) * channel_scale;
                 }
-                ctx.buffer[idx] = y;
+                cepstral_.compute(magnitude_.data(), envelope_.data());
+                update_gain(envelope_.data(), bins_, bin_hz_);
+                gain_hop_ = ~uint64_t{0};
+                envelope_countdown_ = envelope_interval_;
             }
-            delay_state_[ch] = prev_x;
-            tilt_state_[ch] = prev_y;
+            --envelope_countdown_;
+        }
+
+        for (uint32_t ch = 0; ch < channels_; ++ch)
+        {
+            scale(spectrum_re_.channel(ch), gain_.data(), bins_);
+            scale(spectrum_im_.channel(ch), gain_.data(), bins_);
+            fft_.inverse(spectrum_re_.channel(ch), spectrum_im_.channel(ch), frame_.data());
+            float *accumulator = accumulator_.channel(ch);
+            multiply_add(accumulator, frame_.data(), window_.data(), synthesis_gain_, size);
+            std::copy_n(accumulator, hop_, output_.channel(ch));
+            std::copy(accumulator + hop_, accumulator + size, accumulator);
+            std::fill(accumulator + size - hop_, accumulator + size, 0.0f);
+            float *input = input_.channel(ch);
+            std::copy(input + hop_, input + size, input);
+        }
+    }
+
+    /** Stream ctx through the STFT; every channel completes frames together. */
+    void FormantShifter::process(ProcessContext &ctx)
+    {
+        if (!enabled_ || hop_ == 0 || ratio_ == 1.0f)
+        {
+            return;
+        }
+        if (!ctx.has_audio() || ctx.channels != channels_)
+        {
+            return;
         }
+        const runtime::SpectralAnalysis *analysis = ctx.analysis;
+        const size_t size = fft_.size();
+        auto run = [&](auto sample)
+        {
+            for (size_t frame = 0; frame < ctx.frames; ++frame)
+            {
+                for (uint32_t ch = 0; ch < channels_; ++ch)
+                {
+                    float &value = sample(frame, ch);
+                    const float in = value;
+                    value = output_.channel(ch)[fill_ - latency_];
+                    input_.channel(ch)[fill_] = in;
+                }
+                if (++fill_ == size)
+                {
+                    process_frame(analysis);
+                    fill_ = latency_;
+                }
+            }
+        };
+        with_layout(ctx, run);
     }
 
 } // namespace echidna::dsp::effects
@@ -9,6 +9,9 @@
 #include <vector>
 
 #include "effect_base.h"
+#include "../runtime/fft.h"
+#include "../runtime/planar_buffer.h"
+#include "../runtime/spectral_analysis.h"
 
 namespace echidna::dsp::effects
 {
@@ -21,26 +24,79 @@ namespace echidna::dsp::effects
     {
         float cents{0.0f};
         bool intelligibility_assist{false};
+
+        bool operator==(const FormantParameters &) const = default;
     };
 
-    /** Formant shifter implementation. */
+    /**
+     * @brief Spectral-envelope formant shifter.
+     *
+     * Each channel runs through a Hann-windowed STFT of about 10 ms frames at
+     * 75 % overlap, so the stage adds fft_size() - fft_size() / 4 frames of
+     * latency. Every frame is multiplied by E(f / r) / E(f), where E is the
+     * cepstral spectral envelope and r = 2^(cents / 1200). That moves the
+     * formants and leaves the harmonics, and so the pitch, in place.
+     *
+     * The envelope comes from the shared analysis bus when the host passes
+     * it, and is then rebuilt into a gain curve only when the bus completes
+     * a hop. Otherwise the envelope of the channel average is computed
+     * itself, at about the same 10 ms cadence. Intelligibility assist fades the shift out between 3 and 5 kHz
+     * so fricatives keep their place. Zero cents is an exact bypass.
+     */
     class FormantShifter : public EffectProcessor
     {
     public:
         /** Update formant parameters. */
         void set_parameters(const FormantParameters &params);
 
-        /** Prepare per-channel delay and tilt buffers. */
+        /** Size the STFT state for the sample rate and channels. */
         void prepare(uint32_t sample_rate, uint32_t channels) override;
         /** Reset internal states to silence. */
         void reset() override;
-        /** Run the per-sample formant-shifting algorithm in-place. */
+        /** Run the STFT formant shift in-place. */
         void process(ProcessContext &ctx) override;
+        /** Subscribes to the bus envelope unless the shift is zero. */
+        uint32_t analysis_features() const override;
+
+        /** STFT frame length, or 0 before prepare(). */
+        size_t fft_size() const { return fft_.size(); }
+        /** Frames of delay the stage adds. */
+        size_t latency_frames() const { return latency_; }
 
     private:
+        /** Rebuild gain_ from an envelope of `bins` values spaced `bin_hz` apart. */
+        void update_gain(const float *envelope, size_t bins, float bin_hz);
+        /** Transform the completed frame of every channel and overlap-add it. */
+        void process_frame(const runtime::SpectralAnalysis *analysis);
+
         FormantParameters params_{};
-        std::vector<float> delay_state_;
-        std::vector<float> tilt_state_;
+        /** Formant frequency ratio, 2^(cents / 1200); 1 bypasses. */
+        float ratio_{1.0f};
+        size_t hop_{0};
+        size_t latency_{0};
+        size_t bins_{0};
+        size_t fill_{0};
+        /** Hops between envelope updates without the bus, and hops left. */
+        size_t envelope_interval_{1};
+        size_t envelope_countdown_{0};
+        float bin_hz_{0.0f};
+        float synthesis_gain_{1.0f};
+        /** Bus hop the current gain_ was built from; ~0 when it is stale. */
+        uint64_t gain_hop_{~uint64_t{0}};
+        runtime::RealFft fft_{};
+        runtime::CepstralEnvelope cepstral_{};
+        std::vector<float> window_{};
+        std::vector<float> gain_{};
+        std::vector<float> frame_{};
+        std::vector<float> magnitude_{};
+        std::vector<float> envelope_{};
+        /** Per channel: analysis FIFO whose first fill_ samples are valid. */
+        runtime::PlanarBuffer input_{};
+        /** Per channel: the hop of synthesized samples being played out. */
+        runtime::PlanarBuffer output_{};
+        runtime::PlanarBuffer accumulator_{};
+        runtime::PlanarBuffer spectrum_re_{};
+        runtime::PlanarBuffer spectrum_im_{};
     };
 
 } // namespace echidna::dsp::effects
@@ -6,6 +6,7 @@
  */
 
 #include "effect_base.h"
+#include "../runtime/dynamics.h"
 
 namespace echidna::dsp::effects
 {
@@ -17,9 +18,18 @@ namespace echidna::dsp::effects
         float attack_ms{5.0f};
         float release_ms{80.0f};
         float hysteresis_db{3.0f};
+
+        bool operator==(const GateParameters &) const = default;
     };
 
-    /** Gate effect processor implementing soft attack/release and hysteresis. */
+    /**
+     * @brief Gate effect processor implementing soft attack/release and
+     * hysteresis.
+     *
+     * All channels share one detector. The envelope and the open/closed
+     * decision advance once per runtime::kDynamicsSubBlock frames on the
+     * sub-block peak, and the gain is interpolated per frame.
+     */
     class GateProcessor : public EffectProcessor
     {
     public:
@@ -34,9 +44,14 @@ namespace echidna::dsp::effects
         void process(ProcessContext &ctx) override;
 
     private:
+        /** Derive coefficients and thresholds from params_ and sample_rate_. */
+        void update_coefficients();
+
         GateParameters params_{};
+        runtime::SubBlockDynamics dynamics_{};
         float envelope_{0.0f};
-        float gain_{1.0f};
+        float open_amp_{0.0f};
+        float close_amp_{0.0f};
         float attack_coeff_{0.0f};
         float release_coeff_{0.0f};
         bool gate_open_{false};
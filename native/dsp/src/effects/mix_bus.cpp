@@ -33,7 +33,15 @@ namespace echidna::dsp::effects
     /** Apply the configured output gain to the active buffer. */
     void MixBus::process(ProcessContext &ctx)
     {
-        runtime::apply_gain(ctx.buffer, ctx.frames * ctx.channels, output_gain_);
+        if (ctx.planar == nullptr)
+        {
+            runtime::apply_gain(ctx.buffer, ctx.frames * ctx.channels, output_gain_);
+            return;
+        }
+        for (uint32_t ch = 0; ch < ctx.channels; ++ch)
+        {
+            runtime::apply_gain(ctx.planar[ch], ctx.frames, output_gain_);
+        }
     }
 
     /** Mix dry + wet into output and apply output gain. */
@@ -42,12 +50,7 @@ namespace echidna::dsp::effects
                                  float *output,
                                  size_t frames)
     {
-        const size_t samples = frames * channels_;
-        for (size_t i = 0; i < samples; ++i)
-        {
-            output[i] = dry[i] * dry_gain_ + wet[i] * wet_gain_;
-        }
-        runtime::apply_gain(output, samples, output_gain_);
+        runtime::crossfade(dry, wet, output, frames * channels_, dry_gain_, wet_gain_, output_gain_);
     }
 
 } // namespace echidna::dsp::effects
@@ -17,6 +17,8 @@ namespace echidna::dsp::effects
     {
         float dry_wet{50.0f};
         float output_gain_db{0.0f};
+
+        bool operator==(const MixParameters &) const = default;
     };
 
     /**
@@ -40,6 +42,13 @@ namespace echidna::dsp::effects
                              const float *wet,
                              float *output,
                              size_t frames);
+        /** True when the dry signal does not reach the output. */
+        bool wet_only() const { return dry_gain_ == 0.0f; }
+        /** True when process_buffers() would copy the wet buffer unchanged. */
+        bool is_identity() const
+        {
+            return dry_gain_ == 0.0f && wet_gain_ == 1.0f && output_gain_ == 1.0f;
+        }
 
     private:
         MixParameters params_{};
@@ -16,67 +16,57 @@ namespace echidna::dsp::effects
     void ParametricEQ::set_bands(std::vector<EqBand> bands)
     {
         bands_ = std::move(bands);
-        update_coefficients();
+        update_coefficients(true);
     }
 
     /** Prepare filters for sample-rate and channel count. */
     void ParametricEQ::prepare(uint32_t sample_rate, uint32_t channels)
     {
         EffectProcessor::prepare(sample_rate, channels);
-        filters_.resize(bands_.size() * channels);
-        update_coefficients();
+        cascade_.configure(channels, bands_.size());
+        update_coefficients(false);
     }
 
     /** Reset internal filter delays to zero. */
     void ParametricEQ::reset()
     {
-        for (auto &f : filters_)
-        {
-            f.z1 = 0.0f;
-            f.z2 = 0.0f;
-        }
+        cascade_.reset();
     }
 
-    /** Run processing across all configured bands for each channel. */
+    /** Run the band cascade over the block in either layout. */
     void ParametricEQ::process(ProcessContext &ctx)
     {
-        if (!enabled_)
+        if (!enabled_ || ctx.channels != cascade_.channels())
         {
             return;
         }
-        for (size_t band = 0; band < bands_.size(); ++band)
+        if (ctx.planar != nullptr)
+        {
+            cascade_.process(ctx.planar, ctx.frames);
+        }
+        else
         {
-            for (uint32_t ch = 0; ch < channels_; ++ch)
-            {
-                Biquad &f = filters_[band * channels_ + ch];
-                float z1 = f.z1;
-                float z2 = f.z2;
-                for (size_t frame = 0; frame < ctx.frames; ++frame)
-                {
-                    const size_t idx = frame * channels_ + ch;
-                    const float x = ctx.buffer[idx];
-                    float y = f.a0 * x + z1;
-                    z1 = f.a1 * x - f.b1 * y + z2;
-                    z2 = f.a2 * x - f.b2 * y;
-                    ctx.buffer[idx] = y;
-                }
-                f.z1 = z1;
-                f.z2 = z2;
-            }
+            cascade_.process_interleaved(ctx.buffer, ctx.frames);
         }
     }
 
     /** Recompute biquad coefficients for the active band list. */
-    void ParametricEQ::update_coefficients()
+    void ParametricEQ::update_coefficients(bool glide)
     {
         if (sample_rate_ == 0 || channels_ == 0)
         {
             return;
         }
-        if (filters_.size() != bands_.size() * channels_)
+        // A new band count rebuilds the cascade from silence; otherwise
+        // the running filters glide to the new response.
+        size_t ramp_frames =
+            glide ? static_cast<size_t>(sample_rate_) * kCoefficientRampMs / 1000 : 0;
+        if (cascade_.stages() != bands_.size() || cascade_.channels() != channels_)
         {
-            filters_.assign(bands_.size() * channels_, {});
+            cascade_.configure(channels_, bands_.size());
+            ramp_frames = 0;
         }
+        coefficients_.resize(bands_.size());
         const float sr = static_cast<float>(sample_rate_);
         for (size_t band = 0; band < bands_.size(); ++band)
         {
@@ -99,18 +89,13 @@ namespace echidna::dsp::effects
 
             const float inv_a0 = 1.0f / a0;
 
-            for (uint32_t ch = 0; ch < channels_; ++ch)
-            {
-                Biquad &f = filters_[band * channels_ + ch];
-                f.a0 = b0 * inv_a0;
-                f.a1 = b1 * inv_a0;
-                f.a2 = b2 * inv_a0;
-                f.b1 = a1 * inv_a0;
-                f.b2 = a2 * inv_a0;
-                f.z1 = 0.0f;
-                f.z2 = 0.0f;
-            }
+            coefficients_[band] = {b0 * inv_a0,
+                                   b1 * inv_a0,
+                                   b2 * inv_a0,
+                                   a1 * inv_a0,
+                                   a2 * inv_a0};
         }
+        cascade_.set_coefficients(coefficients_.data(), ramp_frames);
     }
 
 } // namespace echidna::dsp::effects
@@ -9,6 +9,7 @@
 #include <vector>
 
 #include "effect_base.h"
+#include "../runtime/biquad_cascade.h"
 
 namespace echidna::dsp::effects
 {
@@ -21,15 +22,25 @@ namespace echidna::dsp::effects
         float frequency_hz{1000.0f};
         float gain_db{0.0f};
         float q{1.0f};
+
+        bool operator==(const EqBand &) const = default;
     };
 
     /**
      * @brief Parametric equalizer that maintains per-band biquad filters
      * and processes audio in-place.
+     *
+     * All bands run as one runtime::BiquadCascade pass over the block.
+     * Changing the band parameters on a prepared instance (same band count)
+     * glides the coefficients over kCoefficientRampMs instead of resetting
+     * the filters.
      */
     class ParametricEQ : public EffectProcessor
     {
     public:
+        /** Length of the coefficient glide after a parameter change. */
+        static constexpr uint32_t kCoefficientRampMs = 10;
+
         /** Set EQ bands and recompute filter coefficients. */
         void set_bands(std::vector<EqBand> bands);
 
@@ -37,26 +48,20 @@ namespace echidna::dsp::effects
         void prepare(uint32_t sample_rate, uint32_t channels) override;
         /** Reset filter internal state. */
         void reset() override;
-        /** Process frames through each configured biquad band in sequence. */
+        /** Process frames through every configured band in one pass. */
         void process(ProcessContext &ctx) override;
 
     private:
-        struct Biquad
-        {
-            float a0{1.0f};
-            float a1{0.0f};
-            float a2{0.0f};
-            float b1{0.0f};
-            float b2{0.0f};
-            float z1{0.0f};
-            float z2{0.0f};
-        };
-
-        /** Update internal biquad coefficients from configured bands. */
-        void update_coefficients();
+        /**
+         * Update internal biquad coefficients from configured bands, gliding
+         * from the running response when `glide` is set and the cascade
+         * layout is unchanged.
+         */
+        void update_coefficients(bool glide);
 
         std::vector<EqBand> bands_{};
-        std::vector<Biquad> filters_{};
+        std::vector<runtime::BiquadCoefficients> coefficients_{};
+        runtime::BiquadCascade cascade_{};
     };
 
 } // namespace echidna::dsp::effects
@@ -6,15 +6,18 @@
  */
 
 #include <algorithm>
+#include <array>
+#include <bit>
 #include <cmath>
 #include <cstdint>
 #include <cstring>
+#include <limits>
 #include <memory>
 #include <vector>
 
-#if defined(__ANDROID__) || defined(__linux__)
-#include <dlfcn.h>
-#endif
+#include "../runtime/correlation.h"
+#include "../runtime/fft.h"
+#include "../runtime/simd_lanes.h"
 
 namespace echidna::dsp::effects
 {
@@ -22,6 +25,39 @@ namespace echidna::dsp::effects
     {
         constexpr size_t kDefaultRealtimeFrames = 8192;
 
+        /** Segments in the raised-cosine crossfade table. */
+        constexpr size_t kCrossfadeTableSize = 1024;
+
+        /**
+         * @brief 0.5 - 0.5 * cos(2 * pi * i / kCrossfadeTableSize) for
+         * i in [0, kCrossfadeTableSize], built once and shared. Linear
+         * interpolation between entries stays within 3e-6 of the cosine.
+         */
+        const std::array<float, kCrossfadeTableSize + 1> &crossfade_table()
+        {
+            static const std::array<float, kCrossfadeTableSize + 1> table = []()
+            {
+                constexpr double kPi = 3.14159265358979323846;
+                std::array<float, kCrossfadeTableSize + 1> values{};
+                for (size_t i = 0; i <= kCrossfadeTableSize; ++i)
+                {
+                    values[i] = static_cast<float>(
+                        0.5 - 0.5 * std::cos(2.0 * kPi * static_cast<double>(i) /
+                                             static_cast<double>(kCrossfadeTableSize)));
+                }
+                return values;
+            }();
+            return table;
+        }
+
+        /**
+         * @brief Granular backend for low-latency presets and real-time ratios.
+         *
+         * A static preset resamples within each block. Real-time ratios drive
+         * a two-tap delay line of about 10 ms whose crossfaded taps carry
+         * across blocks, so Auto-Tune output does not depend on the callback
+         * size.
+         */
         class GranularBackend : public PitchBackend
         {
         public:
@@ -35,11 +71,15 @@ namespace echidna::dsp::effects
                 ratio_ = std::isfinite(ratio) ? std::clamp(ratio, 0.5f, 2.0f) : 1.0f;
                 realtime_ratio_mode_ = false;
                 delay_span_frames_ = std::max<size_t>(64, sample_rate / 100);
-                delay_capacity_frames_ = delay_span_frames_ + 4;
+                // Power-of-two capacity so ring positions wrap with a mask.
+                // A batch writes kWidth frames before reading any of them.
+                delay_capacity_frames_ = std::bit_ceil(delay_span_frames_ + 4 + runtime::lanes::kWidth);
+                delay_mask_ = delay_capacity_frames_ - 1;
                 delay_buffer_.assign(delay_capacity_frames_ * channels_, 0.0f);
                 phases_.assign(channels_, 0.0f);
                 wet_step_ = 1.0f /
                             std::max(1.0f, static_cast<float>(sample_rate) * 0.005f);
+                crossfade_ = crossfade_table().data();
                 reset();
             }
 
@@ -53,6 +93,7 @@ namespace echidna::dsp::effects
             {
                 std::fill(delay_buffer_.begin(), delay_buffer_.end(), 0.0f);
                 std::fill(phases_.begin(), phases_.end(), 0.0f);
+                tap_phase_ = 0.0f;
                 write_frame_ = 0;
                 wet_mix_ = 0.0f;
             }
@@ -72,68 +113,237 @@ namespace echidna::dsp::effects
                     return;
                 }
 
-                constexpr double kPi = 3.14159265358979323846;
                 const bool active = std::abs(ratio_ - 1.0f) >= 1.0e-4f;
                 const double phase_step =
                     (1.0 - static_cast<double>(ratio_)) /
                     static_cast<double>(delay_span_frames_);
+                const size_t channels = channels_;
+                // With fewer channels than lanes a frame cannot fill a vector,
+                // so runs of kWidth frames are mixed together instead.
+                const bool batch = channels < runtime::lanes::kWidth;
 
-                for (size_t frame = 0; frame < frames; ++frame)
+                size_t frame = 0;
+                while (frame < frames)
                 {
-                    const size_t write_index =
-                        static_cast<size_t>(write_frame_ % delay_capacity_frames_);
-                    for (uint32_t channel = 0; channel < channels_; ++channel)
-                    {
-                        delay_buffer_[write_index * channels_ + channel] =
-                            input[frame * channels_ + channel];
-                    }
-
+                    const float *in = input + frame * channels;
+                    float *out = output + frame * channels;
                     const bool history_ready = write_frame_ > delay_span_frames_ + 2;
-                    if (!active || !history_ready)
+                    if (batch && active && history_ready && frames - frame >= runtime::lanes::kWidth)
                     {
-                        for (uint32_t channel = 0; channel < channels_; ++channel)
+                        switch (channels)
                         {
-                            output[frame * channels_ + channel] =
-                                input[frame * channels_ + channel];
+                        case 1:
+                            mix_frames<1>(in, out, phase_step);
+                            break;
+                        case 2:
+                            mix_frames<2>(in, out, phase_step);
+                            break;
+                        default:
+                            mix_frames<3>(in, out, phase_step);
+                            break;
                         }
-                        wet_mix_ = 0.0f;
+                        frame += runtime::lanes::kWidth;
+                        continue;
                     }
-                    else
+
+                    const size_t write_index = static_cast<size_t>(write_frame_) & delay_mask_;
+                    std::copy_n(in, channels, &delay_buffer_[write_index * channels]);
+                    if (!active || !history_ready)
                     {
-                        wet_mix_ = std::min(1.0f, wet_mix_ + wet_step_);
-                        for (uint32_t channel = 0; channel < channels_; ++channel)
-                        {
-                            double phase_a = phases_[channel];
-                            double phase_b = phase_a + 0.5;
-                            if (phase_b >= 1.0)
-                            {
-                                phase_b -= 1.0;
-                            }
-
-                            const double delay_a = 2.0 +
-                                                   phase_a * delay_span_frames_;
-                            const double delay_b = 2.0 +
-                                                   phase_b * delay_span_frames_;
-                            const float sample_a = read_delayed(delay_a, channel);
-                            const float sample_b = read_delayed(delay_b, channel);
-                            const float weight_a = static_cast<float>(
-                                0.5 - 0.5 * std::cos(2.0 * kPi * phase_a));
-                            const float shifted = sample_a * weight_a +
-                                                  sample_b * (1.0f - weight_a);
-                            const float dry = input[frame * channels_ + channel];
-                            output[frame * channels_ + channel] =
-                                dry + (shifted - dry) * wet_mix_;
-
-                            phase_a += phase_step;
-                            phase_a -= std::floor(phase_a);
-                            phases_[channel] = static_cast<float>(phase_a);
-                        }
+                        std::copy_n(in, channels, out);
+                        wet_mix_ = 0.0f;
+                        ++write_frame_;
+                        ++frame;
+                        continue;
                     }
+                    wet_mix_ = std::min(1.0f, wet_mix_ + wet_step_);
+                    mix_channels(in, out, resolve_frame(tap_phase_, write_frame_), wet_mix_);
+                    tap_phase_ = next_phase(tap_phase_, phase_step);
                     ++write_frame_;
+                    ++frame;
                 }
             }
 
         private:
+            /** One interpolated read: frames `newer` and newer - 1 of the ring. */
+            struct Tap
+            {
+                const float *newer;
+                const float *older;
+                float fraction;
+            };
+
+            /** Both reads of the newest frame and the weight of the first. */
+            struct FrameTaps
+            {
+                Tap a;
+                Tap b;
+                float weight_a;
+            };
+
+            /** Locate the read `delay_frames` (> 1) behind frame `write`. */
+            Tap resolve_tap(uint64_t write, float delay_frames) const
+            {
+                // Truncated through int32_t: a direct float to 64-bit unsigned
+                // conversion branches on x86-64.
+                const auto whole = static_cast<size_t>(static_cast<int32_t>(delay_frames));
+                const size_t newer = static_cast<size_t>(write - whole) & delay_mask_;
+                const size_t older = (newer - 1) & delay_mask_;
+                return Tap{&delay_buffer_[newer * channels_],
+                           &delay_buffer_[older * channels_],
+                           delay_frames - static_cast<float>(whole)};
+            }
+
+            /**
+             * Both taps of frame `write` and their crossfade weight depend only
+             * on the frame, so they are resolved once and shared by every
+             * channel.
+             */
+            FrameTaps resolve_frame(float phase, uint64_t write) const
+            {
+                const float span = static_cast<float>(delay_span_frames_);
+                const float phase_a = phase;
+                const float phase_b = phase_a + 0.5f >= 1.0f ? phase_a - 0.5f : phase_a + 0.5f;
+                const float table_position = phase_a * static_cast<float>(kCrossfadeTableSize);
+                const size_t table_index =
+                    std::min(static_cast<size_t>(static_cast<int32_t>(table_position)), kCrossfadeTableSize - 1);
+                const float table_fraction = table_position - static_cast<float>(table_index);
+                const float weight_a =
+                    crossfade_[table_index] +
+                    (crossfade_[table_index + 1] - crossfade_[table_index]) * table_fraction;
+                return FrameTaps{resolve_tap(write, 2.0f + phase_a * span),
+                                 resolve_tap(write, 2.0f + phase_b * span),
+                                 weight_a};
+            }
+
+            /** The tap phase one frame on, wrapped into [0, 1). */
+            static float next_phase(float phase, double phase_step)
+            {
+                double next = static_cast<double>(phase) + phase_step;
+                if (next >= 1.0)
+                {
+                    next -= 1.0;
+                }
+                else if (next < 0.0)
+                {
+                    next += 1.0;
+                }
+                return static_cast<float>(next);
+            }
+
+            /**
+             * out = dry + (crossfaded taps - dry) * wet for every channel of one
+             * frame; four channels per vector, scalar for the rest.
+             */
+            void mix_channels(const float *in, float *out, const FrameTaps &taps, float wet) const
+            {
+                const Tap &a = taps.a;
+                const Tap &b = taps.b;
+                const float weight_a = taps.weight_a;
+                const float weight_b = 1.0f - weight_a;
+                uint32_t ch = 0;
+                if (channels_ >= runtime::lanes::kWidth)
+                {
+                    namespace lanes = runtime::lanes;
+                    const lanes::Lanes fraction_a = lanes::splat(a.fraction);
+                    const lanes::Lanes fraction_b = lanes::splat(b.fraction);
+                    const lanes::Lanes wa = lanes::splat(weight_a);
+                    const lanes::Lanes wb = lanes::splat(weight_b);
+                    const lanes::Lanes wet_lanes = lanes::splat(wet);
+                    for (; ch + lanes::kWidth <= channels_; ch += lanes::kWidth)
+                    {
+                        const lanes::Lanes newer_a = lanes::load(a.newer + ch);
+                        const lanes::Lanes newer_b = lanes::load(b.newer + ch);
+                        const lanes::Lanes sample_a = lanes::add(
+                            newer_a, lanes::mul(lanes::sub(lanes::load(a.older + ch), newer_a), fraction_a));
+                        const lanes::Lanes sample_b = lanes::add(
+                            newer_b, lanes::mul(lanes::sub(lanes::load(b.older + ch), newer_b), fraction_b));
+                        const lanes::Lanes shifted =
+                            lanes::add(lanes::mul(sample_a, wa), lanes::mul(sample_b, wb));
+                        const lanes::Lanes dry = lanes::load(in + ch);
+                        lanes::store(out + ch,
+                                     lanes::add(dry, lanes::mul(lanes::sub(shifted, dry), wet_lanes)));
+                    }
+                }
+                for (; ch < channels_; ++ch)
+                {
+                    const float sample_a = a.newer[ch] + (a.older[ch] - a.newer[ch]) * a.fraction;
+                    const float sample_b = b.newer[ch] + (b.older[ch] - b.newer[ch]) * b.fraction;
+                    const float shifted = sample_a * weight_a + sample_b * weight_b;
+                    const float dry = in[ch];
+                    out[ch] = dry + (shifted - dry) * wet;
+                }
+            }
+
+            /**
+             * Shift kWidth frames of kChannels (< kWidth) channels. The frames
+             * go into the ring first, which is safe because every tap reads at
+             * least two frames back. Lane j of each vector then holds sample j
+             * of the run, so kChannels vectors cover its kWidth frames. The
+             * lanes are gathered in registers: staging them through memory
+             * stalls each vector load on the scalar stores before it.
+             */
+            template <uint32_t kChannels>
+            void mix_frames(const float *in, float *out, double phase_step)
+            {
+                namespace lanes = runtime::lanes;
+                constexpr size_t kFrames = lanes::kWidth;
+                for (size_t f = 0; f < kFrames; ++f)
+                {
+                    const size_t write_index = static_cast<size_t>(write_frame_ + f) & delay_mask_;
+                    std::copy_n(in + f * kChannels, kChannels, &delay_buffer_[write_index * kChannels]);
+                }
+
+                // The per-frame state stays in registers until the run is done.
+                std::array<FrameTaps, kFrames> taps;
+                std::array<float, kFrames> wet;
+                float phase = tap_phase_;
+                float wet_mix = wet_mix_;
+                uint64_t write = write_frame_;
+                for (size_t f = 0; f < kFrames; ++f)
+                {
+                    wet_mix = std::min(1.0f, wet_mix + wet_step_);
+                    wet[f] = wet_mix;
+                    taps[f] = resolve_frame(phase, write);
+                    phase = next_phase(phase, phase_step);
+                    ++write;
+                }
+                tap_phase_ = phase;
+                wet_mix_ = wet_mix;
+                write_frame_ = write;
+
+                const lanes::Lanes one = lanes::splat(1.0f);
+                for (size_t base = 0; base < kFrames * kChannels; base += lanes::kWidth)
+                {
+                    auto gather = [&](auto pick)
+                    {
+                        return lanes::set(pick(base), pick(base + 1), pick(base + 2), pick(base + 3));
+                    };
+                    const lanes::Lanes newer_a =
+                        gather([&](size_t i) { return taps[i / kChannels].a.newer[i % kChannels]; });
+                    const lanes::Lanes older_a =
+                        gather([&](size_t i) { return taps[i / kChannels].a.older[i % kChannels]; });
+                    const lanes::Lanes newer_b =
+                        gather([&](size_t i) { return taps[i / kChannels].b.newer[i % kChannels]; });
+                    const lanes::Lanes older_b =
+                        gather([&](size_t i) { return taps[i / kChannels].b.older[i % kChannels]; });
+                    const lanes::Lanes fraction_a = gather([&](size_t i) { return taps[i / kChannels].a.fraction; });
+                    const lanes::Lanes fraction_b = gather([&](size_t i) { return taps[i / kChannels].b.fraction; });
+                    const lanes::Lanes wa = gather([&](size_t i) { return taps[i / kChannels].weight_a; });
+                    const lanes::Lanes wet_lanes = gather([&](size_t i) { return wet[i / kChannels]; });
+
+                    const lanes::Lanes sample_a =
+                        lanes::add(newer_a, lanes::mul(lanes::sub(older_a, newer_a), fraction_a));
+                    const lanes::Lanes sample_b =
+                        lanes::add(newer_b, lanes::mul(lanes::sub(older_b, newer_b), fraction_b));
+                    const lanes::Lanes shifted =
+                        lanes::add(lanes::mul(sample_a, wa), lanes::mul(sample_b, lanes::sub(one, wa)));
+                    const lanes::Lanes dry = lanes::load(in + base);
+                    lanes::store(out + base,
+                                 lanes::add(dry, lanes::mul(lanes::sub(shifted, dry), wet_lanes)));
+                }
+            }
+
             void process_legacy(const float *input, float *output, size_t frames)
             {
                 if (frames == 1)
@@ -169,31 +379,36 @@ namespace echidna::dsp::effects
                 }
             }
 
-            float read_delayed(double delay_frames, uint32_t channel) const
-            {
-                const double position = static_cast<double>(write_frame_) - delay_frames;
-                const auto frame0 = static_cast<uint64_t>(std::floor(position));
-                const auto frame1 = frame0 + 1;
-                const float fraction = static_cast<float>(position - std::floor(position));
-                const size_t index0 = static_cast<size_t>(frame0 % delay_capacity_frames_);
-                const size_t index1 = static_cast<size_t>(frame1 % delay_capacity_frames_);
-                const float sample0 = delay_buffer_[index0 * channels_ + channel];
-                const float sample1 = delay_buffer_[index1 * channels_ + channel];
-                return sample0 + (sample1 - sample0) * fraction;
-            }
-
             uint32_t channels_{1};
             float ratio_{1.0f};
             size_t delay_span_frames_{0};
             size_t delay_capacity_frames_{0};
+            size_t delay_mask_{0};
             uint64_t write_frame_{0};
             float wet_mix_{0.0f};
             float wet_step_{1.0f};
             bool realtime_ratio_mode_{false};
+            /** Delay-line tap phase in [0, 1); shared by all channels. */
+            float tap_phase_{0.0f};
+            const float *crossfade_{nullptr};
             std::vector<float> delay_buffer_;
+            /** Per-channel read positions of the within-block resampler. */
             std::vector<float> phases_;
         };
 
+        /**
+         * @brief STFT phase vocoder that shifts pitch in the frequency domain
+         * with identity phase locking (Laroche & Dolson peak shifting).
+         *
+         * Every hop (a quarter of the FFT size) the last fft_size_ input
+         * samples are windowed and transformed. Each spectral peak, together
+         * with the bins of its region of influence, moves to the bin of its
+         * shifted frequency and is rotated by a phase that advances by
+         * (ratio - 1) * omega * hop per frame, so the bins around a peak
+         * keep their relative phases. The shifted spectrum is resynthesized
+         * and overlap-added. Output lags input by fft_size_ - hop_ frames.
+         * All state is sized in configure(); process() never allocates.
+         */
         class PhaseVocoderBackend : public PitchBackend
         {
         public:
@@ -202,16 +417,64 @@ namespace echidna::dsp::effects
                            float ratio,
                            bool preserve_formants) override
             {
-                sample_rate_ = sample_rate;
+                // Formant preservation is the formant stage's job; shifting
+                // peaks moves the spectral envelope with them.
+                (void)preserve_formants;
                 channels_ = channels;
-                ratio_ = ratio;
-                preserve_formants_ = preserve_formants;
-                previous_.assign(channels_, 0.0f);
+                ratio_ = std::isfinite(ratio) ? std::clamp(ratio, 0.5f, 2.0f) : 1.0f;
+                // About 40 ms of analysis resolves voice harmonics down to
+                // roughly 100 Hz.
+                fft_size_ = std::clamp<size_t>(std::bit_ceil(static_cast<size_t>(sample_rate) / 25),
+                                               256,
+                                               runtime::RealFft::kMaxSize);
+                hop_ = fft_size_ / 4;
+                latency_ = fft_size_ - hop_;
+                bins_ = fft_size_ / 2 + 1;
+                fft_.prepare(fft_size_);
+
+                constexpr double kPi = 3.14159265358979323846;
+                window_.resize(fft_size_);
+                for (size_t n = 0; n < fft_size_; ++n)
+                {
+                    window_[n] = static_cast<float>(
+                        0.5 - 0.5 * std::cos(2.0 * kPi * static_cast<double>(n) / static_cast<double>(fft_size_)));
+                }
+                // Hann analysis and synthesis windows at 75 % overlap sum to 1.5.
+                synthesis_gain_ = 1.0f / 1.5f;
+
+                states_.assign(channels_, {});
+                for (ChannelState &state : states_)
+                {
+                    state.input.resize(fft_size_);
+                    state.output.resize(hop_);
+                    state.accumulator.resize(fft_size_);
+                    state.previous_re.resize(bins_);
+                    state.previous_im.resize(bins_);
+                    state.rotation.resize(bins_);
+                    state.next_rotation.resize(bins_);
+                }
+                frame_.resize(fft_size_);
+                spectrum_re_.resize(bins_);
+                spectrum_im_.resize(bins_);
+                shifted_re_.resize(bins_);
+                shifted_im_.resize(bins_);
+                power_.resize(bins_);
+                peaks_.resize(bins_);
+                reset();
             }
 
             void reset() override
             {
-                std::fill(previous_.begin(), previous_.end(), 0.0f);
+                for (ChannelState &state : states_)
+                {
+                    std::fill(state.input.begin(), state.input.end(), 0.0f);
+                    std::fill(state.output.begin(), state.output.end(), 0.0f);
+                    std::fill(state.accumulator.begin(), state.accumulator.end(), 0.0f);
+                    std::fill(state.previous_re.begin(), state.previous_re.end(), 0.0f);
+                    std::fill(state.previous_im.begin(), state.previous_im.end(), 0.0f);
+                    std::fill(state.rotation.begin(), state.rotation.end(), 0.0f);
+                    state.fill = latency_;
+                }
             }
 
             void set_realtime_ratio(float ratio) override
@@ -223,177 +486,352 @@ namespace echidna::dsp::effects
                          float *output,
                          size_t frames) override
             {
-                if (std::abs(ratio_ - 1.0f) < 1e-4f)
+                if (fft_.size() == 0)
                 {
                     std::memcpy(output, input, sizeof(float) * frames * channels_);
                     return;
                 }
-                // Advance the read position by `ratio_` (= 2^(semitones/12)) per
-                // output sample so a downward request lowers the pitch. (Previously
-                // 1/ratio_, which inverted the shift direction.)
-                const float step = ratio_;
-                const float smoothing = preserve_formants_ ? 0.35f : 0.2f;
                 for (uint32_t ch = 0; ch < channels_; ++ch)
                 {
-                    float accumulator = 0.0f;
-                    float previous = previous_[ch];
+                    ChannelState &state = states_[ch];
                     for (size_t frame = 0; frame < frames; ++frame)
                     {
-                        const float index = accumulator;
-                        const size_t i0 = static_cast<size_t>(index);
-                        const float frac = index - static_cast<float>(i0);
-                        const size_t i1 = std::min(i0 + 1, frames - 1);
-                        const float sample0 = input[i0 * channels_ + ch];
-                        const float sample1 = input[i1 * channels_ + ch];
-                        float value = sample0 + (sample1 - sample0) * frac;
-                        value = value * (1.0f - smoothing) + previous * smoothing;
-                        previous = value;
-                        output[frame * channels_ + ch] = value;
-                        accumulator += step;
-                        if (accumulator >= static_cast<float>(frames - 1))
+                        const size_t index = frame * channels_ + ch;
+                        const float sample = input[index];
+                        output[index] = state.output[state.fill - latency_];
+                        state.input[state.fill] = sample;
+                        if (++state.fill == fft_size_)
                         {
-                            accumulator -= static_cast<float>(frames - 1);
+                            process_frame(state);
+                            state.fill = latency_;
                         }
                     }
-                    previous_[ch] = previous;
                 }
             }
 
         private:
-            uint32_t sample_rate_{0};
-            uint32_t channels_{1};
-            float ratio_{1.0f};
-            bool preserve_formants_{false};
-            std::vector<float> previous_;
-        };
-
-#if defined(__ANDROID__) || defined(__linux__)
-        class SoundTouchBackend : public PitchBackend
-        {
-        public:
-            SoundTouchBackend()
+            struct ChannelState
+            {
+                /** Analysis FIFO; the first `fill` samples are valid. */
+                std::vector<float> input;
+                /** The hop of synthesized samples being played out. */
+                std::vector<float> output;
+                std::vector<float> accumulator;
+                std::vector<float> previous_re;
+                std::vector<float> previous_im;
+                /** Phase rotation applied to each input bin's region last frame. */
+                std::vector<float> rotation;
+                std::vector<float> next_rotation;
+                size_t fill{0};
+            };
+
+            /** Analyse one hop, shift peaks and overlap-add the result. */
+            void process_frame(ChannelState &state)
             {
-                handle_ = dlopen("libsoundtouch.so", RTLD_LAZY);
-                if (!handle_)
+                constexpr float kTwoPi = 6.28318530717958647692f;
+                for (size_t n = 0; n < fft_size_; ++n)
                 {
-                    handle_ = dlopen("libSoundTouch.so", RTLD_LAZY);
+                    frame_[n] = state.input[n] * window_[n];
                 }
-                if (!handle_)
+                fft_.forward(frame_.data(), spectrum_re_.data(), spectrum_im_.data());
+
+                float max_power = 0.0f;
+                for (size_t k = 0; k < bins_; ++k)
                 {
-                    return;
+                    power_[k] = spectrum_re_[k] * spectrum_re_[k] + spectrum_im_[k] * spectrum_im_[k];
+                    max_power = std::max(max_power, power_[k]);
                 }
-                create_ = reinterpret_cast<create_fn>(dlsym(handle_, "soundtouch_createInstance"));
-                destroy_ = reinterpret_cast<destroy_fn>(dlsym(handle_, "soundtouch_destroyInstance"));
-                set_rate_ = reinterpret_cast<set_rate_fn>(dlsym(handle_, "soundtouch_setSampleRate"));
-                set_channels_ = reinterpret_cast<set_channels_fn>(dlsym(handle_, "soundtouch_setChannels"));
-                set_pitch_semitones_ = reinterpret_cast<set_pitch_fn>(dlsym(handle_, "soundtouch_setPitchSemiTones"));
-                put_samples_ = reinterpret_cast<put_samples_fn>(dlsym(handle_, "soundtouch_putSamples"));
-                receive_samples_ =
-                    reinterpret_cast<receive_samples_fn>(dlsym(handle_, "soundtouch_receiveSamples"));
-                if (create_ && destroy_)
+                // Local maxima over +/-2 bins, at most 80 dB below the
+                // strongest bin.
+                const float floor = max_power * 1e-8f;
+                size_t peak_count = 0;
+                for (size_t k = 0; k < bins_; ++k)
                 {
-                    instance_ = create_();
+                    const float p = power_[k];
+                    if (p <= floor || (k >= 1 && p <= power_[k - 1]) ||
+                        (k >= 2 && p < power_[k - 2]) || (k + 1 < bins_ && p < power_[k + 1]) ||
+                        (k + 2 < bins_ && p < power_[k + 2]))
+                    {
+                        continue;
+                    }
+                    peaks_[peak_count++] = k;
                 }
-            }
 
-            ~SoundTouchBackend() override
-            {
-                if (instance_ && destroy_)
-                {
-                    destroy_(instance_);
-                }
-                if (handle_)
+                std::fill(shifted_re_.begin(), shifted_re_.end(), 0.0f);
+                std::fill(shifted_im_.begin(), shifted_im_.end(), 0.0f);
+                std::fill(state.next_rotation.begin(), state.next_rotation.end(), 0.0f);
+                const float hop = static_cast<float>(hop_);
+                const float bin_to_omega = kTwoPi / static_cast<float>(fft_size_);
+                for (size_t i = 0; i < peak_count; ++i)
                 {
-                    dlclose(handle_);
+                    const size_t peak = peaks_[i];
+                    // Instantaneous frequency from the phase advance since the
+                    // previous frame.
+                    const float re = spectrum_re_[peak];
+                    const float im = spectrum_im_[peak];
+                    const float prev_re = state.previous_re[peak];
+                    const float prev_im = state.previous_im[peak];
+                    const float advance = std::atan2(im * prev_re - re * prev_im,
+                                                     re * prev_re + im * prev_im);
+                    const float expected = bin_to_omega * static_cast<float>(peak) * hop;
+                    const float deviation = std::remainder(advance - expected, kTwoPi);
+                    const float omega = (expected + deviation) / hop;
+
+                    float theta = state.rotation[peak] + (ratio_ - 1.0f) * omega * hop;
+                    theta = std::remainder(theta, kTwoPi);
+                    const float rot_re = std::cos(theta);
+                    const float rot_im = std::sin(theta);
+                    const long target = std::lround(omega * ratio_ / bin_to_omega);
+                    const long shift = target - static_cast<long>(peak);
+
+                    const size_t begin = i == 0 ? 0 : (peaks_[i - 1] + peak) / 2 + 1;
+                    const size_t end = i + 1 == peak_count ? bins_ : (peak + peaks_[i + 1]) / 2 + 1;
+                    for (size_t k = begin; k < end; ++k)
+                    {
+                        state.next_rotation[k] = theta;
+                        const long destination = static_cast<long>(k) + shift;
+                        if (destination < 0 || destination >= static_cast<long>(bins_))
+                        {
+                            continue;
+                        }
+                        const float x_re = spectrum_re_[k];
+                        const float x_im = spectrum_im_[k];
+                        shifted_re_[destination] += x_re * rot_re - x_im * rot_im;
+                        shifted_im_[destination] += x_re * rot_im + x_im * rot_re;
+                    }
                 }
-            }
+                state.previous_re.swap(spectrum_re_);
+                state.previous_im.swap(spectrum_im_);
+                state.rotation.swap(state.next_rotation);
 
-            bool available() const { return instance_ && set_rate_ && set_channels_ && set_pitch_semitones_ &&
-                                            put_samples_ && receive_samples_; }
-
-            void set_realtime_ratio(float ratio) override
-            {
-                ratio_ = std::isfinite(ratio) ? std::clamp(ratio, 0.5f, 2.0f) : 1.0f;
-                if (available())
+                fft_.inverse(shifted_re_.data(), shifted_im_.data(), frame_.data());
+                for (size_t n = 0; n < fft_size_; ++n)
                 {
-                    set_pitch_semitones_(instance_, std::log2(ratio_) * 12.0f);
+                    state.accumulator[n] += frame_[n] * window_[n] * synthesis_gain_;
                 }
+                std::copy_n(state.accumulator.begin(), hop_, state.output.begin());
+                std::copy(state.accumulator.begin() + hop_, state.accumulator.end(), state.accumulator.begin());
+                std::fill(state.accumulator.end() - hop_, state.accumulator.end(), 0.0f);
+                std::copy(state.input.begin() + hop_, state.input.end(), state.input.begin());
             }
 
+            uint32_t channels_{1};
+            float ratio_{1.0f};
+            size_t fft_size_{0};
+            size_t hop_{0};
+            size_t latency_{0};
+            size_t bins_{0};
+            float synthesis_gain_{1.0f};
+            runtime::RealFft fft_;
+            std::vector<float> window_;
+            std::vector<ChannelState> states_;
+            std::vector<float> frame_;
+            std::vector<float> spectrum_re_;
+            std::vector<float> spectrum_im_;
+            std::vector<float> shifted_re_;
+            std::vector<float> shifted_im_;
+            std::vector<float> power_;
+            std::vector<size_t> peaks_;
+        };
+
+        /**
+         * @brief Time-domain WSOLA (waveform-similarity overlap-add) shifter.
+         *
+         * Every hop_ input frames a Hann grain of 2 * hop_ output frames is
+         * read from the input history at `ratio` input frames per output
+         * frame and overlap-added. The grain start is searched within
+         * +/- search_ frames of its nominal position for the splice that
+         * best continues the previous grain, using a normalized
+         * cross-correlation of a mono mixdown, so all channels splice at the
+         * same point. The search cost is fixed per hop, so the cost of a
+         * block is bounded by its length. All buffers are sized in
+         * configure().
+         */
+        class WsolaBackend : public PitchBackend
+        {
+        public:
             void configure(uint32_t sample_rate,
                            uint32_t channels,
                            float ratio,
                            bool preserve_formants) override
             {
                 (void)preserve_formants;
-                if (!available())
-                {
-                    channels_ = channels;
-                    ratio_ = ratio;
-                    return;
-                }
                 channels_ = channels;
-                ratio_ = ratio;
-                if (set_rate_)
-                {
-                    set_rate_(instance_, sample_rate);
-                }
-                if (set_channels_)
-                {
-                    set_channels_(instance_, channels);
-                }
-                if (set_pitch_semitones_)
+                // About 5 ms hops and 10 ms grains; the +/- hop search covers
+                // a full period of voices down to about 95 Hz.
+                hop_ = std::clamp<size_t>(std::bit_ceil(static_cast<size_t>(sample_rate) / 200), 64, 1024);
+                grain_ = 2 * hop_;
+                search_ = hop_;
+                // Room for the search span, a grain read at the maximum ratio
+                // of 2 and the incoming hop.
+                history_ = std::bit_ceil(2 * search_ + 2 * grain_ + 2 + hop_);
+                set_realtime_ratio(ratio);
+
+                constexpr double kPi = 3.14159265358979323846;
+                window_.resize(grain_);
+                for (size_t n = 0; n < grain_; ++n)
                 {
-                    const float semitones = std::log2(ratio) * 12.0f;
-                    set_pitch_semitones_(instance_, semitones);
+                    // Periodic Hann grains at 50 % overlap sum to one.
+                    window_[n] = static_cast<float>(
+                        0.5 - 0.5 * std::cos(2.0 * kPi * static_cast<double>(n) / static_cast<double>(grain_)));
                 }
+                input_.resize(static_cast<size_t>(channels_) * history_);
+                accumulator_.resize(static_cast<size_t>(channels_) * grain_);
+                output_.resize(static_cast<size_t>(channels_) * hop_);
+                mono_.resize(history_);
+                scores_.resize(2 * search_ + 1);
+                reset();
             }
 
             void reset() override
             {
-                // The SoundTouch API clears its state when rate/tempo is set; nothing to do.
+                std::fill(input_.begin(), input_.end(), 0.0f);
+                std::fill(accumulator_.begin(), accumulator_.end(), 0.0f);
+                std::fill(output_.begin(), output_.end(), 0.0f);
+                std::fill(mono_.begin(), mono_.end(), 0.0f);
+                fill_ = 0;
+                have_previous_ = false;
+                previous_position_ = 0.0;
+            }
+
+            void set_realtime_ratio(float ratio) override
+            {
+                ratio_ = std::isfinite(ratio) ? std::clamp(ratio, 0.5f, 2.0f) : 1.0f;
+                // The nominal grain start trails the newest input by the
+                // search span plus one grain read at the current ratio.
+                const size_t read_span = static_cast<size_t>(std::ceil(ratio_ * static_cast<float>(grain_))) + 2;
+                nominal_ = history_ - search_ - read_span;
             }
 
             void process(const float *input,
                          float *output,
                          size_t frames) override
             {
-                if (!available())
+                if (hop_ == 0)
                 {
                     std::memcpy(output, input, sizeof(float) * frames * channels_);
                     return;
                 }
-                put_samples_(instance_, input, frames);
-                size_t produced = receive_samples_(instance_, output, frames);
-                if (produced < frames)
+                size_t frame = 0;
+                while (frame < frames)
                 {
-                    const size_t remaining = (frames - produced) * channels_;
-                    std::fill(output + produced * channels_, output + produced * channels_ + remaining, 0.0f);
+                    const size_t run = std::min(frames - frame, hop_ - fill_);
+                    const size_t write = history_ - hop_ + fill_;
+                    for (size_t i = 0; i < run; ++i)
+                    {
+                        const size_t index = (frame + i) * channels_;
+                        float mix = 0.0f;
+                        for (uint32_t ch = 0; ch < channels_; ++ch)
+                        {
+                            input_[ch * history_ + write + i] = input[index + ch];
+                            output[index + ch] = output_[ch * hop_ + fill_ + i];
+                            mix += input[index + ch];
+                        }
+                        mono_[write + i] = mix;
+                    }
+                    frame += run;
+                    fill_ += run;
+                    if (fill_ == hop_)
+                    {
+                        process_hop();
+                        fill_ = 0;
+                    }
                 }
             }
 
         private:
-            using create_fn = void *(*)();
-            using destroy_fn = void (*)(void *);
-            using set_rate_fn = void (*)(void *, unsigned int);
-            using set_channels_fn = void (*)(void *, unsigned int);
-            using set_pitch_fn = void (*)(void *, float);
-            using put_samples_fn = void (*)(void *, const float *, unsigned long);
-            using receive_samples_fn = unsigned long (*)(void *, float *, unsigned long);
-
-            void *handle_{nullptr};
-            void *instance_{nullptr};
-            create_fn create_{nullptr};
-            destroy_fn destroy_{nullptr};
-            set_rate_fn set_rate_{nullptr};
-            set_channels_fn set_channels_{nullptr};
-            set_pitch_fn set_pitch_semitones_{nullptr};
-            put_samples_fn put_samples_{nullptr};
-            receive_samples_fn receive_samples_{nullptr};
+            /** Choose the next grain start; returns a position in history_. */
+            double find_grain_start()
+            {
+                const size_t first = nominal_ - search_;
+                if (!have_previous_)
+                {
+                    return static_cast<double>(nominal_);
+                }
+                // Template: the stretch of input the previous grain would
+                // have read next, had it kept going.
+                const double natural = previous_position_ + static_cast<double>(ratio_) * static_cast<double>(hop_);
+                const double clamped = std::clamp(natural, 0.0, static_cast<double>(history_ - hop_ - 1));
+                const size_t base = static_cast<size_t>(clamped);
+                const double fraction = clamped - static_cast<double>(base);
+
+                runtime::cross_correlation(&mono_[base], &mono_[first], hop_, scores_.size(), scores_.data());
+
+                // Normalize by the candidate energy, kept as a sliding sum.
+                double energy = 0.0;
+                for (size_t i = 0; i < hop_; ++i)
+                {
+                    energy += static_cast<double>(mono_[first + i]) * mono_[first + i];
+                }
+                size_t best = scores_.size() / 2;
+                double best_score = -std::numeric_limits<double>::infinity();
+                for (size_t lag = 0; lag < scores_.size(); ++lag)
+                {
+                    if (lag > 0)
+                    {
+                        const double leaving = mono_[first + lag - 1];
+                        const double entering = mono_[first + lag + hop_ - 1];
+                        energy = std::max(0.0, energy + entering * entering - leaving * leaving);
+                    }
+                    const double score = static_cast<double>(scores_[lag]) / std::sqrt(energy + 1e-9);
+                    if (score > best_score)
+                    {
+                        best_score = score;
+                        best = lag;
+                    }
+                }
+                return static_cast<double>(first + best) + fraction;
+            }
+
+            /** Add one grain, emit a hop and slide the buffers. */
+            void process_hop()
+            {
+                const double start = find_grain_start();
+                const double step = ratio_;
+                for (uint32_t ch = 0; ch < channels_; ++ch)
+                {
+                    const float *history = &input_[ch * history_];
+                    float *accumulator = &accumulator_[ch * grain_];
+                    for (size_t n = 0; n < grain_; ++n)
+                    {
+                        const double position = start + step * static_cast<double>(n);
+                        const size_t index = static_cast<size_t>(position);
+                        const float fraction = static_cast<float>(position - static_cast<double>(index));
+                        const float sample = history[index] + (history[index + 1] - history[index]) * fraction;
+                        accumulator[n] += window_[n] * sample;
+                    }
+                    float *out = &output_[ch * hop_];
+                    std::copy_n(accumulator, hop_, out);
+                    std::copy(accumulator + hop_, accumulator + grain_, accumulator);
+                    std::fill(accumulator + grain_ - hop_, accumulator + grain_, 0.0f);
+                    float *samples = &input_[ch * history_];
+                    std::copy(samples + hop_, samples + history_, samples);
+                }
+                std::copy(mono_.begin() + static_cast<std::ptrdiff_t>(hop_), mono_.end(), mono_.begin());
+                previous_position_ = start - static_cast<double>(hop_);
+                have_previous_ = true;
+            }
+
             uint32_t channels_{1};
             float ratio_{1.0f};
+            size_t hop_{0};
+            size_t grain_{0};
+            size_t search_{0};
+            size_t history_{0};
+            size_t nominal_{0};
+            size_t fill_{0};
+            bool have_previous_{false};
+            double previous_position_{0.0};
+            std::vector<float> window_;
+            /** Per channel: history_ input frames, newest hop last. */
+            std::vector<float> input_;
+            /** Per channel: the grain_ frames still being overlap-added. */
+            std::vector<float> accumulator_;
+            /** Per channel: the finished hop being played out. */
+            std::vector<float> output_;
+            std::vector<float> mono_;
+            std::vector<float> scores_;
         };
-#endif
 
     } // namespace
 
@@ -414,6 +852,7 @@ namespace echidna::dsp::effects
     {
         EffectProcessor::prepare(sample_rate, channels);
         scratch_.reserve(kDefaultRealtimeFrames * static_cast<size_t>(channels));
+        interleaved_output_.reserve(kDefaultRealtimeFrames * static_cast<size_t>(channels));
         rebuild_backend();
     }
 
@@ -429,6 +868,7 @@ namespace echidna::dsp::effects
     void PitchShifter::prepare_realtime(size_t max_frames)
     {
         scratch_.reserve(max_frames * static_cast<size_t>(channels_));
+        interleaved_output_.reserve(max_frames * static_cast<size_t>(channels_));
     }
 
     void PitchShifter::set_realtime_ratio(float ratio)
@@ -449,19 +889,27 @@ namespace echidna::dsp::effects
     /** Run processing using the configured backend. */
     void PitchShifter::process(ProcessContext &ctx)
     {
-        if (!enabled_ || !backend_ || ctx.buffer == nullptr || ctx.frames == 0 ||
+        if (!enabled_ || !backend_ || !ctx.has_audio() || ctx.frames == 0 ||
             ctx.channels != channels_)
         {
             return;
         }
         const size_t samples = ctx.frames * ctx.channels;
-        if (samples > scratch_.capacity())
+        if (samples > scratch_.capacity() ||
+            (ctx.planar != nullptr && samples > interleaved_output_.capacity()))
         {
             return;
         }
         scratch_.resize(samples);
-        std::copy_n(ctx.buffer, samples, scratch_.data());
-        backend_->process(scratch_.data(), ctx.buffer, ctx.frames);
+        copy_to_interleaved(ctx, scratch_.data());
+        if (ctx.planar == nullptr)
+        {
+            backend_->process(scratch_.data(), ctx.buffer, ctx.frames);
+            return;
+        }
+        interleaved_output_.resize(samples);
+        backend_->process(scratch_.data(), interleaved_output_.data(), ctx.frames);
+        copy_from_interleaved(interleaved_output_.data(), ctx);
     }
 
     /** Select and reconfigure an appropriate backend implementation based on
@@ -481,19 +929,11 @@ namespace echidna::dsp::effects
         }
         if (params_.quality == PitchQuality::kHighQuality)
         {
-#if defined(__ANDROID__) || defined(__linux__)
-            auto soundtouch = std::make_unique<SoundTouchBackend>();
-            if (soundtouch->available())
-            {
-                backend_ = std::move(soundtouch);
-            }
-            else
-            {
-                backend_ = std::make_unique<PhaseVocoderBackend>();
-            }
-#else
             backend_ = std::make_unique<PhaseVocoderBackend>();
-#endif
+        }
+        else if (params_.quality == PitchQuality::kBalanced)
+        {
+            backend_ = std::make_unique<WsolaBackend>();
         }
         else
         {
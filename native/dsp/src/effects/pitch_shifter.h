@@ -2,8 +2,9 @@
 
 /**
  * @file pitch_shifter.h
- * @brief Pitch shifting support including different backends (granular,
- * phase vocoder, optional SoundTouch) and parameter structures.
+ * @brief Pitch shifting support including different backends (granular for
+ * low latency, WSOLA for balanced, an STFT phase vocoder for high quality)
+ * and parameter structures.
  */
 
 #include <cstdint>
@@ -18,7 +19,11 @@ namespace echidna::dsp::effects
     /** Quality / algorithm selection for pitch shifting. */
     enum class PitchQuality
     {
+        /** Granular resampling; no added latency. */
         kLowLatency,
+        /** WSOLA time-domain splicing; about one grain of latency. */
+        kBalanced,
+        /** Phase vocoder; adds three quarters of an FFT frame of latency. */
         kHighQuality
     };
 
@@ -29,6 +34,8 @@ namespace echidna::dsp::effects
         float cents{0.0f};
         PitchQuality quality{PitchQuality::kLowLatency};
         bool preserve_formants{false};
+
+        bool operator==(const PitchParameters &) const = default;
     };
 
     /**
@@ -83,6 +90,10 @@ namespace echidna::dsp::effects
         PitchParameters params_{};
         std::unique_ptr<PitchBackend> backend_;
         std::vector<float> scratch_;
+        // Backends work on interleaved audio, so a planar context costs two
+        // full-block copies: interleave into scratch_, then deinterleave from
+        // this buffer. Only planar backends would remove them.
+        std::vector<float> interleaved_output_;
     };
 
 } // namespace echidna::dsp::effects
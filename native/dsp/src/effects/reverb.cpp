@@ -6,138 +6,247 @@
  */
 
 #include <algorithm>
+#include <bit>
 #include <cmath>
 
+#include "../runtime/simd_lanes.h"
+
 namespace echidna::dsp::effects
 {
     namespace
     {
-        constexpr std::array<float, 4> kCombTimes{0.0297f, 0.0371f, 0.0411f, 0.0437f};
-        constexpr std::array<float, 3> kAllPassTimes{0.005f, 0.0017f, 0.0006f};
+        namespace lanes = runtime::lanes;
+
+        /** Line lengths at room size 50; room size scales them by 0.5 to 1.5. */
+        constexpr std::array<float, Reverb::kLines> kLineTimes{
+            0.0297f, 0.0371f, 0.0411f, 0.0437f, 0.0253f, 0.0313f, 0.0467f, 0.0509f};
+        /** Signs the input is injected with and the line outputs are summed with. */
+        constexpr std::array<float, Reverb::kLines> kInputSigns{1, -1, 1, -1, 1, -1, 1, -1};
+        constexpr std::array<float, Reverb::kLines> kOutputSigns{1, 1, -1, -1, 1, 1, -1, -1};
+        /** 1 / sqrt(kLines): keeps the Hadamard mix, injection and tap sum unitary. */
+        constexpr float kNormalise = 0.35355339f;
+        /** Region offsets are rounded to this many floats (one cache line). */
+        constexpr size_t kRegionAlign = runtime::kPlanarAlignment / sizeof(float);
+
+        constexpr size_t round_up(size_t value)
+        {
+            return (value + kRegionAlign - 1) / kRegionAlign * kRegionAlign;
+        }
+
+        /** Room size and damping mapped to 0..1; non-finite values read as 0. */
+        float unit(float percent)
+        {
+            return std::isfinite(percent) ? std::clamp(percent, 0.0f, 100.0f) / 100.0f : 0.0f;
+        }
     } // namespace
 
     /**
      * @brief Update Reverb parameters.
      */
-    void Reverb::set_parameters(const ReverbParameters &params) { params_ = params; }
+    void Reverb::set_parameters(const ReverbParameters &params)
+    {
+        params_ = params;
+        update_layout();
+        update_gains();
+    }
 
     /**
-     * @brief Prepare internal delay and filter buffers based on sample rate
-     * and channel count.
+     * @brief Lay out the delay arena for the sample rate and channel count.
      */
     void Reverb::prepare(uint32_t sample_rate, uint32_t channels)
     {
         EffectProcessor::prepare(sample_rate, channels);
-        ensure_buffers();
+        arena_.clear();
+        update_layout();
+        update_gains();
     }
 
     /**
-     * @brief Reset all internal buffers to silence and zero indices.
+     * @brief Reset all delay lines to silence.
      */
     void Reverb::reset()
     {
-        for (auto &comb : combs_)
+        std::fill(arena_.begin(), arena_.end(), 0.0f);
+        write_ = 0;
+    }
+
+    void Reverb::update_layout()
+    {
+        if (sample_rate_ == 0 || channels_ == 0)
+        {
+            return;
+        }
+        const float scale = 0.5f + unit(params_.room_size);
+        std::array<size_t, kLines> lengths{};
+        for (size_t i = 0; i < kLines; ++i)
+        {
+            // Odd lengths keep the lines from sharing short common periods;
+            // the floor keeps every read at least one lane group behind the write.
+            const auto length = static_cast<size_t>(kLineTimes[i] * scale * static_cast<float>(sample_rate_));
+            lengths[i] = std::max<size_t>(2 * lanes::kWidth, length) | 1;
+        }
+        const float pre_delay_ms = std::isfinite(params_.pre_delay_ms) ? std::max(0.0f, params_.pre_delay_ms) : 0.0f;
+        const auto predelay = static_cast<size_t>(pre_delay_ms * static_cast<float>(sample_rate_) / 1000.0f);
+        if (!arena_.empty() && lengths == line_length_ && predelay == predelay_frames_)
+        {
+            return;
+        }
+
+        line_length_ = lengths;
+        size_t offset = 0;
+        for (size_t i = 0; i < kLines; ++i)
+        {
+            // Room for a lane group of writes beyond the oldest tap (and the
+            // sample before it), plus kWidth mirrored samples after the end.
+            const size_t capacity = std::bit_ceil(lengths[i] + lanes::kWidth + 1);
+            line_mask_[i] = capacity - 1;
+            line_offset_[i] = offset;
+            offset += round_up(capacity + lanes::kWidth);
+        }
+        predelay_frames_ = predelay;
+        predelay_offset_ = offset;
+        predelay_mask_ = 0;
+        if (predelay != 0)
+        {
+            const size_t capacity = std::bit_ceil(predelay + 1);
+            predelay_mask_ = capacity - 1;
+            offset += round_up(capacity);
+        }
+        channel_stride_ = offset;
+        // assign() keeps the existing allocation whenever it is large enough.
+        arena_.assign(channel_stride_ * channels_, 0.0f);
+        write_ = 0;
+    }
+
+    void Reverb::update_gains()
+    {
+        if (sample_rate_ == 0)
         {
-            std::fill(comb.buffer.begin(), comb.buffer.end(), 0.0f);
-            comb.index = 0;
+            return;
         }
-        for (auto &ap : allpasses_)
+        // RT60 from about 0.3 s (room 0) to 4.5 s (room 100).
+        const float rt60 = 0.3f * std::pow(15.0f, unit(params_.room_size));
+        for (size_t i = 0; i < kLines; ++i)
         {
-            std::fill(ap.buffer.begin(), ap.buffer.end(), 0.0f);
-            ap.index = 0;
+            const float seconds = static_cast<float>(line_length_[i]) / static_cast<float>(sample_rate_);
+            line_gain_[i] = std::pow(10.0f, -3.0f * seconds / rt60) * kNormalise;
         }
-        std::fill(predelay_buffer_.begin(), predelay_buffer_.end(), 0.0f);
-        predelay_index_ = 0;
+        damping_ = 0.45f * unit(params_.damping);
     }
 
     /**
-     * @brief Allocate and size all internal comb/allpass/predelay buffers using
-     * current parameters, sample_rate_ and channels_.
+     * @brief One lane per frame: the taps of all four frames were written at
+     * least a lane group earlier, so the frames do not depend on each other.
      */
-    void Reverb::ensure_buffers()
+    void Reverb::process_group(uint32_t ch, size_t frame, const float *input, float *output, size_t count)
     {
-        const float room = std::clamp(params_.room_size, 0.0f, 100.0f) / 100.0f;
-        const float damp = std::clamp(params_.damping, 0.0f, 100.0f) / 100.0f;
-        const float base_feedback = 0.6f + room * 0.35f;
-        const float damping = 0.2f + damp * 0.6f;
+        float *region = arena_.data() + ch * channel_stride_;
+        const size_t write = write_ + frame;
 
-        combs_.resize(channels_ * kCombTimes.size());
-        allpasses_.resize(channels_ * kAllPassTimes.size());
+        alignas(16) float delayed[lanes::kWidth]{};
+        if (predelay_frames_ == 0)
+        {
+            std::copy_n(input, count, delayed);
+        }
+        else
+        {
+            float *ring = region + predelay_offset_;
+            for (size_t k = 0; k < count; ++k)
+            {
+                delayed[k] = ring[(write + k - predelay_frames_) & predelay_mask_];
+                ring[(write + k) & predelay_mask_] = input[k];
+            }
+        }
+        const lanes::Lanes in = lanes::load(delayed);
+        const lanes::Lanes damping = lanes::splat(damping_);
+
+        lanes::Lanes mixed[kLines];
+        lanes::Lanes sum = lanes::splat(0.0f);
+        for (size_t i = 0; i < kLines; ++i)
+        {
+            const float *line = region + line_offset_[i];
+            const size_t tap = (write - line_length_[i]) & line_mask_[i];
+            const size_t previous = (write - line_length_[i] - 1) & line_mask_[i];
+            const lanes::Lanes current = lanes::load(line + tap);
+            const lanes::Lanes before = lanes::load(line + previous);
+            sum = lanes::add(sum, lanes::mul(current, lanes::splat(kOutputSigns[i])));
+            mixed[i] = lanes::add(current, lanes::mul(lanes::sub(before, current), damping));
+        }
 
-        for (uint32_t ch = 0; ch < channels_; ++ch)
+        // Fast Walsh-Hadamard transform across the lines.
+        for (size_t half = 1; half < kLines; half *= 2)
         {
-            for (size_t i = 0; i < kCombTimes.size(); ++i)
+            for (size_t block = 0; block < kLines; block += 2 * half)
             {
-                Comb &comb = combs_[ch * kCombTimes.size() + i];
-                const size_t length =
-                    std::max<size_t>(1, static_cast<size_t>(kCombTimes[i] * sample_rate_));
-                comb.buffer.assign(length, 0.0f);
-                comb.index = 0;
-                comb.feedback = base_feedback - damping * 0.1f * static_cast<float>(i);
+                for (size_t i = block; i < block + half; ++i)
+                {
+                    const lanes::Lanes a = mixed[i];
+                    const lanes::Lanes b = mixed[i + half];
+                    mixed[i] = lanes::add(a, b);
+                    mixed[i + half] = lanes::sub(a, b);
+                }
             }
-            for (size_t i = 0; i < kAllPassTimes.size(); ++i)
+        }
+
+        alignas(16) float values[lanes::kWidth];
+        for (size_t i = 0; i < kLines; ++i)
+        {
+            const lanes::Lanes fed = lanes::add(lanes::mul(mixed[i], lanes::splat(line_gain_[i])),
+                                                lanes::mul(in, lanes::splat(kInputSigns[i] * kNormalise)));
+            lanes::store(values, fed);
+            float *line = region + line_offset_[i];
+            const size_t capacity = line_mask_[i] + 1;
+            for (size_t k = 0; k < count; ++k)
             {
-                AllPass &ap = allpasses_[ch * kAllPassTimes.size() + i];
-                const size_t length =
-                    std::max<size_t>(1, static_cast<size_t>(kAllPassTimes[i] * sample_rate_));
-                ap.buffer.assign(length, 0.0f);
-                ap.index = 0;
-                ap.feedback = 0.5f - 0.1f * static_cast<float>(i);
+                const size_t index = (write + k) & line_mask_[i];
+                line[index] = values[k];
+                if (index < lanes::kWidth)
+                {
+                    line[capacity + index] = values[k];
+                }
             }
         }
 
-        const size_t predelay_samples =
-            std::max<size_t>(1, static_cast<size_t>(params_.pre_delay_ms * sample_rate_ / 1000.0f));
-        predelay_buffer_.assign(predelay_samples * channels_, 0.0f);
-        predelay_index_ = 0;
+        lanes::store(values, lanes::mul(sum, lanes::splat(kNormalise)));
+        std::copy_n(values, count, output);
     }
 
     /**
-     * @brief Per-frame processing implementation for the reverb engine.
+     * @brief Run every channel through its network in groups of four frames.
      */
     void Reverb::process(ProcessContext &ctx)
     {
-        if (!enabled_)
+        if (!enabled_ || arena_.empty())
+        {
+            return;
+        }
+        if (!ctx.has_audio() || ctx.channels != channels_)
         {
             return;
         }
         const float wet = std::clamp(params_.mix, 0.0f, 50.0f) / 100.0f;
-        const size_t comb_per_channel = kCombTimes.size();
-        const size_t ap_per_channel = kAllPassTimes.size();
-
-        for (size_t frame = 0; frame < ctx.frames; ++frame)
+        const size_t frames = ctx.frames;
+        // Channels are independent, so each one runs over the whole block.
+        auto process_channel = [&](uint32_t ch, auto span)
         {
-            const size_t predelay_base = predelay_index_ * channels_;
-            for (uint32_t ch = 0; ch < channels_; ++ch)
+            float input[lanes::kWidth];
+            float output[lanes::kWidth];
+            for (size_t frame = 0; frame < frames; frame += lanes::kWidth)
             {
-                const size_t idx = frame * channels_ + ch;
-                const float input = ctx.buffer[idx];
-                float delayed = predelay_buffer_[predelay_base + ch];
-                predelay_buffer_[predelay_base + ch] = input;
-
-                float acc = 0.0f;
-                for (size_t i = 0; i < comb_per_channel; ++i)
+                const size_t count = std::min<size_t>(lanes::kWidth, frames - frame);
+                for (size_t k = 0; k < count; ++k)
                 {
-                    Comb &comb = combs_[ch * comb_per_channel + i];
-                    float y = comb.buffer[comb.index];
-                    comb.buffer[comb.index] = delayed + y * comb.feedback;
-                    comb.index = (comb.index + 1) % comb.buffer.size();
-                    acc += y;
+                    input[k] = span[frame + k];
                 }
-                float out = acc / static_cast<float>(comb_per_channel);
-                for (size_t i = 0; i < ap_per_channel; ++i)
+                process_group(ch, frame, input, output, count);
+                for (size_t k = 0; k < count; ++k)
                 {
-                    AllPass &ap = allpasses_[ch * ap_per_channel + i];
-                    float buf = ap.buffer[ap.index];
-                    float y = -out + buf;
-                    ap.buffer[ap.index] = out + buf * ap.feedback;
-                    ap.index = (ap.index + 1) % ap.buffer.size();
-                    out = y;
+                    span[frame + k] = input[k] * (1.0f - wet) + output[k] * wet;
                 }
-                ctx.buffer[idx] = input * (1.0f - wet) + out * wet;
             }
-            predelay_index_ = (predelay_index_ + 1) % (predelay_buffer_.size() / channels_);
-        }
+        };
+        for_each_channel(ctx, process_channel);
+        write_ += frames;
     }
 
 } // namespace echidna::dsp::effects
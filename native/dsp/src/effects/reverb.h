@@ -6,9 +6,11 @@
  */
 
 #include <array>
+#include <cstddef>
 #include <vector>
 
 #include "effect_base.h"
+#include "../runtime/planar_buffer.h"
 
 namespace echidna::dsp::effects
 {
@@ -22,15 +24,38 @@ namespace echidna::dsp::effects
         float damping{30.0f};
         float pre_delay_ms{0.0f};
         float mix{10.0f};
+
+        bool operator==(const ReverbParameters &) const = default;
     };
 
     /**
-     * @brief Simple multi-comb/all-pass reverb processor.
+     * @brief Eight-line feedback delay network reverb.
+     *
+     * Every channel runs its own network: after the pre-delay, the input is
+     * fed into eight delay lines whose outputs are damped by a two-tap
+     * low-pass, mixed by an orthonormal Hadamard matrix and fed back with
+     * per-line gains that give a room-size dependent RT60. Room size also
+     * scales the line lengths.
+     *
+     * All delay lines and pre-delays live in one aligned arena. Each line is
+     * a power-of-two ring read with a mask, and its first few samples are
+     * mirrored past the end so four consecutive samples load contiguously.
+     * Every line is far longer than four frames, so four frames are computed
+     * at once, one per SIMD lane.
      */
     class Reverb : public EffectProcessor
     {
     public:
-        /** Set new reverb parameters (copied). */
+        /** Delay lines per channel. */
+        static constexpr size_t kLines = 8;
+
+        /**
+         * @brief Set new reverb parameters (copied).
+         *
+         * Once prepared, damping and room size update the gains in place.
+         * A new room size or pre-delay also changes the line lengths; only
+         * then is the arena rebuilt (growing it may allocate) and cleared.
+         */
         void set_parameters(const ReverbParameters &params);
 
         /** Prepare internal buffers for the configured sample rate and channels. */
@@ -40,28 +65,34 @@ namespace echidna::dsp::effects
         /** Process `ctx.frames` frames in-place stored at ctx.buffer. */
         void process(ProcessContext &ctx) override;
 
-    private:
-        struct Comb
-        {
-            std::vector<float> buffer;
-            size_t index{0};
-            float feedback{0.7f};
-        };
+        /** Floats in the delay arena, every channel's lines and pre-delay. */
+        size_t arena_size() const { return arena_.size(); }
+        /** Length in frames of delay line `line`. */
+        size_t line_length(size_t line) const { return line_length_[line]; }
 
-        struct AllPass
-        {
-            std::vector<float> buffer;
-            size_t index{0};
-            float feedback{0.5f};
-        };
-
-        void ensure_buffers();
+    private:
+        /** Recompute line lengths and rebuild the arena if they changed. */
+        void update_layout();
+        /** Derive feedback gains and the damping coefficient. */
+        void update_gains();
+        /** Run up to four frames of channel `ch` starting at write_ + `frame`. */
+        void process_group(uint32_t ch, size_t frame, const float *input, float *output, size_t count);
 
         ReverbParameters params_{};
-        std::vector<Comb> combs_;
-        std::vector<AllPass> allpasses_;
-        std::vector<float> predelay_buffer_;
-        size_t predelay_index_{0};
+        std::array<size_t, kLines> line_length_{};
+        std::array<size_t, kLines> line_mask_{};
+        std::array<size_t, kLines> line_offset_{};
+        /** Feedback gain of each line, with the Hadamard normalisation folded in. */
+        std::array<float, kLines> line_gain_{};
+        float damping_{0.0f};
+        size_t predelay_frames_{0};
+        size_t predelay_mask_{0};
+        size_t predelay_offset_{0};
+        /** Floats between the regions of consecutive channels. */
+        size_t channel_stride_{0};
+        /** Frames written since reset(); ring indices are masked from it. */
+        size_t write_{0};
+        std::vector<float, runtime::AlignedAllocator<float>> arena_{};
     };
 
 } // namespace echidna::dsp::effects
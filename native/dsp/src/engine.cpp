@@ -9,6 +9,7 @@
 #include <algorithm>
 #include <atomic>
 #include <chrono>
+#include <cstdint>
 #include <cstdlib>
 #include <cstring>
 #include <limits>
@@ -33,6 +34,59 @@ namespace echidna::dsp
             *out = frames * static_cast<size_t>(channels);
             return true;
         }
+
+        /** True when the two `samples`-long blocks share any sample. */
+        bool BlocksOverlap(const float *a, const float *b, size_t samples)
+        {
+            const auto first = reinterpret_cast<uintptr_t>(a);
+            const auto second = reinterpret_cast<uintptr_t>(b);
+            const size_t bytes = samples * sizeof(float);
+            return first < second + bytes && second < first + bytes;
+        }
+
+        /**
+         * Linear per-frame crossfade: `from` becomes `to` over `frames`, ending
+         * exactly on `to` so the next block continues without a step.
+         */
+        void CrossfadeInto(float *from, const float *to, size_t frames, uint32_t channels)
+        {
+            const float step = 1.0f / static_cast<float>(frames);
+            for (size_t frame = 0; frame < frames; ++frame)
+            {
+                const float t = static_cast<float>(frame + 1) * step;
+                for (uint32_t ch = 0; ch < channels; ++ch)
+                {
+                    const size_t i = frame * channels + ch;
+                    from[i] += (to[i] - from[i]) * t;
+                }
+            }
+        }
+
+        /** Planar counterpart of CrossfadeInto for the per-channel wet spans. */
+        void CrossfadePlanarInto(float *const *from,
+                                 const float *const *to,
+                                 size_t frames,
+                                 uint32_t channels)
+        {
+            const float step = 1.0f / static_cast<float>(frames);
+            for (uint32_t ch = 0; ch < channels; ++ch)
+            {
+                float *dst = from[ch];
+                const float *src = to[ch];
+                for (size_t frame = 0; frame < frames; ++frame)
+                {
+                    const float t = static_cast<float>(frame + 1) * step;
+                    dst[frame] += (src[frame] - dst[frame]) * t;
+                }
+            }
+        }
+
+        /** Plan entry point: a non-virtual call into the concrete effect. */
+        template <typename Effect>
+        void RunStage(effects::EffectProcessor &effect, effects::ProcessContext &ctx)
+        {
+            static_cast<Effect &>(effect).Effect::process(ctx);
+        }
     } // namespace
 
     /**
@@ -57,9 +111,10 @@ namespace echidna::dsp
           channels_(channels),
           quality_mode_(quality),
           options_(options),
-          input_queue_(8),
-          output_queue_(8)
+          input_queue_(kHybridPoolBlocks + 1),
+          output_queue_(kHybridPoolBlocks + 1)
     {
+        hybrid_pending_.fill(runtime::AudioBlockPool::kInvalidIndex);
         if (options_.load_plugins)
         {
             const char *plugin_dir = std::getenv("ECHIDNA_PLUGIN_DIR");
@@ -68,7 +123,15 @@ namespace echidna::dsp
                 plugin_dir = "/data/local/tmp/echidna/plugins";
             }
             plugin_loader_.LoadFromDirectory(plugin_dir);
+            // Plugins do not depend on the preset, so they are prepared once
+            // instead of on every (lock-free) preset swap.
+            plugin_loader_.PrepareAll(sample_rate_, channels_);
+            plugin_loader_.ResetAll();
         }
+        // Nothing is configured yet, so every module lands in bank 1; bank 0
+        // instances are only prepared once a preset first changes them.
+        ApplyPresetLocked(plans_[0], preset_, plans_[1]);
+        plan_state_.store(1U, std::memory_order_relaxed);
     }
 
     /**
@@ -79,69 +142,102 @@ namespace echidna::dsp
     /**
      * @brief Apply a new preset definition and configure internal effects.
      *
-     * This method updates internal effect parameters, stops/restarts the
-     * hybrid worker if required and returns a status code.
+     * The preset is applied to the standby chain while the audio thread keeps
+     * running the active one, then published; callbacks never fail a try_lock
+     * because of a preset update unless the processing mode changes.
      */
     ech_dsp_status_t DspEngine::UpdatePreset(const config::PresetDefinition &preset)
     {
-        std::scoped_lock lock(preset_mutex_, process_mutex_);
-        preset_ = preset;
+        std::lock_guard preset_lock(preset_mutex_);
 
+        config::ProcessingMode mode = config::ProcessingMode::kSynchronous;
         if (!options_.lock_free_realtime_process &&
             preset.processing_mode == config::ProcessingMode::kHybrid &&
             quality_mode_ != ECH_DSP_QUALITY_LOW_LATENCY)
         {
-            processing_mode_ = config::ProcessingMode::kHybrid;
+            mode = config::ProcessingMode::kHybrid;
         }
-        else
+
+        const uint32_t active = AcquireStandbyPlanLocked();
+        bool changed = false;
+        try
         {
-            processing_mode_ = config::ProcessingMode::kSynchronous;
+            changed = ApplyPresetLocked(plans_[active], preset, plans_[active ^ 1U]);
+            preset_ = preset;
         }
-
-        StopWorker();
-
-        gate_.set_enabled(preset_.gate.enabled);
-        gate_.set_parameters(preset_.gate.params);
-
-        eq_.set_enabled(preset_.eq.enabled);
-        eq_.set_bands(preset_.eq.bands);
-
-        compressor_.set_enabled(preset_.compressor.enabled);
-        compressor_.set_parameters(preset_.compressor.params);
-
-        pitch_.set_enabled(preset_.pitch.enabled);
-        auto pitch_params = preset_.pitch.params;
-        bool allow_high_quality =
-            quality_mode_ == ECH_DSP_QUALITY_HIGH ||
-            (quality_mode_ == ECH_DSP_QUALITY_BALANCED &&
-             preset_.quality != config::QualityPreference::kLowLatency);
-        if (!allow_high_quality)
+        catch (...)
         {
-            pitch_params.quality = effects::PitchQuality::kLowLatency;
+            return ECH_DSP_STATUS_ERROR;
         }
-        pitch_.set_parameters(pitch_params);
 
-        formant_.set_enabled(preset_.formant.enabled);
-        formant_.set_parameters(preset_.formant.params);
-
-        autotune_.set_enabled(preset_.autotune.enabled);
-        autotune_.set_parameters(preset_.autotune.params);
-
-        reverb_.set_enabled(preset_.reverb.enabled);
-        reverb_.set_parameters(preset_.reverb.params);
-
-        mix_.set_parameters(preset_.mix.params);
-
-        ApplyPresetLocked();
+        if (mode == processing_mode_.load(std::memory_order_relaxed))
+        {
+            if (changed)
+            {
+                PublishStandbyPlan();
+            }
+            return ECH_DSP_STATUS_OK;
+        }
 
-        if (processing_mode_ == config::ProcessingMode::kHybrid)
+        std::scoped_lock lock(process_mutex_, hybrid_mutex_);
+        StopWorker();
+        ResetHybridPipelineLocked();
+        processing_mode_.store(mode, std::memory_order_relaxed);
+        if (changed)
+        {
+            PublishStandbyPlan();
+        }
+        if (mode == config::ProcessingMode::kHybrid)
         {
             StartWorker();
         }
-
         return ECH_DSP_STATUS_OK;
     }
 
+    uint32_t DspEngine::AcquireStandbyPlanLocked()
+    {
+        uint32_t state = plan_state_.load(std::memory_order_acquire);
+        while ((state & kPlanSwapPending) != 0)
+        {
+            if ((state & kPlanReaderBusy) == 0)
+            {
+                // No audio is flowing, so there is nothing to crossfade.
+                const uint32_t swapped = (state ^ kPlanActiveMask) & kPlanActiveMask;
+                if (plan_state_.compare_exchange_weak(state,
+                                                      swapped,
+                                                      std::memory_order_acq_rel,
+                                                      std::memory_order_acquire))
+                {
+                    state = swapped;
+                }
+                continue;
+            }
+            // The reader is fading into the standby plan; that takes one block.
+            std::this_thread::yield();
+            state = plan_state_.load(std::memory_order_acquire);
+        }
+        return state & kPlanActiveMask;
+    }
+
+    void DspEngine::PublishStandbyPlan()
+    {
+        uint32_t state = plan_state_.load(std::memory_order_acquire);
+        while (true)
+        {
+            // Only the writer sets PENDING, so it is clear here.
+            const bool idle_plan = (state & (kPlanActiveUsed | kPlanReaderBusy)) == 0;
+            const uint32_t next = idle_plan ? (state ^ kPlanActiveMask) & kPlanActiveMask
+                                            : state | kPlanSwapPending;
+            if (plan_state_.compare_exchange_weak(state,
+                                                  next,
+                                                  std::memory_order_acq_rel,
+                                                  std::memory_order_acquire))
+            {
+                return;
+            }
+        }
+    }
+
     ech_dsp_status_t DspEngine::PrepareRealtime(size_t max_frames)
     {
         size_t samples = 0;
@@ -149,21 +245,41 @@ namespace echidna::dsp
         {
             return ECH_DSP_STATUS_INVALID_ARGUMENT;
         }
+        std::scoped_lock lock(preset_mutex_, process_mutex_, hybrid_mutex_);
+        // The pool may only be resized while no block is in flight.
+        StopWorker();
+        ResetHybridPipelineLocked();
+        ech_dsp_status_t status = ECH_DSP_STATUS_OK;
         try
         {
-            std::scoped_lock lock(preset_mutex_, process_mutex_);
-            dry_buffer_.resize(samples);
-            wet_buffer_.resize(samples);
-            pitch_.prepare_realtime(max_frames);
-            autotune_.prepare_realtime(max_frames);
+            EnsureBuffers(max_frames);
+            // No reader runs while process_mutex_ is held, so both chains,
+            // including a pending standby, can be touched.
+            for (auto &bank : banks_)
+            {
+                bank.pitch.prepare_realtime(max_frames);
+                bank.autotune.prepare_realtime(max_frames);
+            }
+            block_pool_.prepare(sample_rate_, channels_, max_frames);
+            for (auto &slot : hybrid_dry_)
+            {
+                slot.reserve(samples);
+            }
+            // Leftover output of a larger block plus the next due block.
+            hybrid_fifo_.reserve(samples * kHybridSlots);
             realtime_max_frames_ = max_frames;
-            return ECH_DSP_STATUS_OK;
         }
         catch (...)
         {
             realtime_max_frames_ = 0;
-            return ECH_DSP_STATUS_ERROR;
+            status = ECH_DSP_STATUS_ERROR;
+        }
+        if (processing_mode_.load(std::memory_order_relaxed) ==
+            config::ProcessingMode::kHybrid)
+        {
+            StartWorker();
         }
+        return status;
     }
 
     /**
@@ -171,9 +287,9 @@ namespace echidna::dsp
      *
      * This method is the main entry point for block processing. Behavior differs
      * based on the configured processing mode. In synchronous mode this will call
-     * ProcessInternal directly. In hybrid mode the call will attempt to schedule
-     * work for the background worker and return a previously processed block if
-     * available. On invalid parameters an error status is returned.
+     * ProcessInternal directly. In hybrid mode the block is queued for the
+     * background worker and the output of an earlier block is returned (see
+     * ProcessHybrid). On invalid parameters an error status is returned.
      */
     ech_dsp_status_t DspEngine::ProcessBlock(const float *input,
                                              float *output,
@@ -187,72 +303,260 @@ namespace echidna::dsp
 
         if (options_.lock_free_realtime_process)
         {
-            if (realtime_max_frames_ == 0 || frames > realtime_max_frames_)
+            const size_t max_frames = realtime_max_frames_.load(std::memory_order_relaxed);
+            if (max_frames == 0 || frames > max_frames)
             {
                 return ECH_DSP_STATUS_INVALID_ARGUMENT;
             }
             return ProcessInternalUnlocked(input, output, frames);
         }
 
-        config::ProcessingMode mode;
-        uint32_t block_timeout_ms;
+        const size_t max_frames = realtime_max_frames_.load(std::memory_order_relaxed);
+        if (max_frames != 0 && frames > max_frames)
+        {
+            return ECH_DSP_STATUS_INVALID_ARGUMENT;
+        }
+
+        if (processing_mode_.load(std::memory_order_relaxed) ==
+            config::ProcessingMode::kSynchronous)
         {
-            std::unique_lock lock(preset_mutex_, std::try_to_lock);
-            if (!lock.owns_lock())
+            return ProcessInternal(input, output, frames);
+        }
+
+        return ProcessHybrid(input, output, frames);
+    }
+
+    /**
+     * @brief Submit block N to the worker and emit block N - k.
+     *
+     * The first k callbacks after the pipeline is (re-)armed emit silence, the
+     * prefix of a k-block delay line. Afterwards the caller never waits: a
+     * block the worker has not handed back by the time it is due is emitted
+     * as its delayed dry input and counted as an underrun, so the reported
+     * latency holds even while the worker overruns. Due blocks pass through a
+     * small output FIFO, so a change of block size keeps the stream continuous;
+     * only a larger block has to pad its head with silence, which grows the
+     * delay to the new size. Blocks come from the preallocated pool, so after
+     * PrepareRealtime() this path does not touch the heap; a block that cannot
+     * be claimed is emitted dry as well.
+     */
+    ech_dsp_status_t DspEngine::ProcessHybrid(const float *input,
+                                              float *output,
+                                              size_t frames)
+    {
+        const size_t samples = frames * channels_;
+        std::unique_lock lock(hybrid_mutex_, std::try_to_lock);
+        if (!lock.owns_lock())
+        {
+            return ECH_DSP_STATUS_ERROR;
+        }
+        if (reset_pipeline_.exchange(false, std::memory_order_acq_rel))
+        {
+            ResetHybridPipelineLocked();
+        }
+
+        const uint64_t sequence = hybrid_next_input_;
+        const size_t input_slot = static_cast<size_t>(sequence % kHybridSlots);
+        try
+        {
+            // Within the capacity PrepareRealtime() reserved neither call
+            // allocates.
+            size_t due_samples = 0;
+            for (uint64_t wanted = hybrid_next_output_;
+                 wanted + kHybridPipelineDepth <= sequence;
+                 ++wanted)
             {
-                return ECH_DSP_STATUS_ERROR;
+                due_samples += hybrid_dry_[wanted % kHybridSlots].size();
             }
-            mode = processing_mode_;
-            block_timeout_ms = preset_.block_ms;
-            if (realtime_max_frames_ != 0)
+            hybrid_fifo_.reserve(hybrid_fifo_.size() + due_samples);
+            hybrid_dry_[input_slot].assign(input, input + samples);
+        }
+        catch (...)
+        {
+            return ECH_DSP_STATUS_ERROR;
+        }
+        ++hybrid_next_input_;
+
+        // Reclaim outputs of blocks that were already emitted dry so a stalled
+        // worker cannot strand the pool once it recovers.
+        uint32_t stale = runtime::AudioBlockPool::kInvalidIndex;
+        while (output_queue_.peek(stale) &&
+               block_pool_.at(stale).sequence < hybrid_next_output_)
+        {
+            output_queue_.pop(stale);
+            block_pool_.release(stale);
+        }
+
+        // A block that cannot be queued keeps its slot; it is emitted dry.
+        uint32_t index = block_pool_.acquire();
+        if (index != runtime::AudioBlockPool::kInvalidIndex)
+        {
+            runtime::AudioBlock &block = block_pool_.at(index);
+            try
             {
-                if (frames > realtime_max_frames_)
+                block.resize(sample_rate_, channels_, frames);
+                block.sequence = sequence;
+                std::memcpy(block.data.data(), input, sizeof(float) * samples);
+                if (!input_queue_.push(index))
                 {
-                    return ECH_DSP_STATUS_INVALID_ARGUMENT;
+                    block_pool_.release(index);
+                    index = runtime::AudioBlockPool::kInvalidIndex;
                 }
-                mode = config::ProcessingMode::kSynchronous;
+            }
+            catch (...)
+            {
+                block_pool_.release(index);
+                index = runtime::AudioBlockPool::kInvalidIndex;
             }
         }
+        hybrid_pending_[input_slot] = index;
 
-        if (mode == config::ProcessingMode::kSynchronous)
+        while (hybrid_next_output_ + kHybridPipelineDepth <= sequence)
         {
-            return ProcessInternal(input, output, frames);
+            EmitHybridBlockLocked(hybrid_next_output_++);
         }
 
-        std::shared_ptr<runtime::AudioBlock> block;
-        try
+        // The FIFO runs short while the pipeline primes and when the block
+        // size grows; the gap is silence and the delay grows by its length.
+        const size_t ready = std::min(hybrid_fifo_.size(), samples);
+        std::memcpy(output, hybrid_fifo_.data(), sizeof(float) * ready);
+        std::fill(output + ready, output + samples, 0.0f);
+        hybrid_fifo_.erase(hybrid_fifo_.begin(),
+                           hybrid_fifo_.begin() + static_cast<std::ptrdiff_t>(ready));
+
+        size_t in_flight = hybrid_fifo_.size();
+        for (uint64_t pending = hybrid_next_output_; pending < hybrid_next_input_; ++pending)
         {
-            block = std::make_shared<runtime::AudioBlock>(sample_rate_, channels_, frames);
+            in_flight += hybrid_dry_[pending % kHybridSlots].size();
         }
-        catch (...)
+        hybrid_latency_frames_.store(in_flight / channels_, std::memory_order_relaxed);
+        return ECH_DSP_STATUS_OK;
+    }
+
+    void DspEngine::EmitHybridBlockLocked(uint64_t wanted)
+    {
+        const size_t slot = static_cast<size_t>(wanted % kHybridSlots);
+        const std::vector<float> &dry = hybrid_dry_[slot];
+        const size_t offset = hybrid_fifo_.size();
+        hybrid_fifo_.resize(offset + dry.size());
+        float *destination = hybrid_fifo_.data() + offset;
+
+        const uint32_t pending = hybrid_pending_[slot];
+        hybrid_pending_[slot] = runtime::AudioBlockPool::kInvalidIndex;
+        if (pending != runtime::AudioBlockPool::kInvalidIndex)
         {
-            return ProcessInternal(input, output, frames);
+            bool in_flight = true;
+            uint32_t processed = runtime::AudioBlockPool::kInvalidIndex;
+            while (in_flight && output_queue_.pop(processed))
+            {
+                // Older sequences are outputs of blocks already emitted dry or
+                // cancelled by a reset; the wanted block may come back unprocessed.
+                in_flight = block_pool_.at(processed).sequence < wanted;
+                if (ConsumeHybridBlock(processed, wanted, destination, dry.size()))
+                {
+                    return;
+                }
+            }
+            if (in_flight)
+            {
+                // The worker skips it, and it is released when it surfaces with
+                // an older sequence on a later call.
+                block_pool_.at(pending).cancelled.store(true, std::memory_order_release);
+            }
         }
-        block->cancelled.store(false, std::memory_order_relaxed);
-        std::memcpy(block->data.data(), input, sizeof(float) * samples);
-        if (!input_queue_.push(block))
+        hybrid_underruns_.fetch_add(1, std::memory_order_relaxed);
+        std::memcpy(destination, dry.data(), sizeof(float) * dry.size());
+    }
+
+    bool DspEngine::ConsumeHybridBlock(uint32_t index,
+                                       uint64_t wanted,
+                                       float *output,
+                                       size_t samples)
+    {
+        runtime::AudioBlock &block = block_pool_.at(index);
+        const bool usable = block.sequence == wanted && block.processed &&
+                            !block.cancelled.load(std::memory_order_acquire) &&
+                            block.data.size() >= samples;
+        if (usable)
         {
-            return ProcessInternal(input, output, frames);
+            std::memcpy(output, block.data.data(), sizeof(float) * samples);
         }
-        auto processed =
-            output_queue_.pop_wait(std::chrono::milliseconds(block_timeout_ms));
-        if (!processed)
+        block_pool_.release(index);
+        return usable;
+    }
+
+    /**
+     * @brief Cancel in-flight hybrid blocks and drop the queued output.
+     *
+     * Cancelled blocks stay owned by the queues until the caller pops them
+     * (they carry older sequence numbers and are released unused) or
+     * StopWorker() drains them. The dry slots and the FIFO keep their
+     * capacity.
+     */
+    void DspEngine::ResetHybridPipelineLocked()
+    {
+        for (auto &pending : hybrid_pending_)
         {
-            block->cancelled.store(true, std::memory_order_release);
-            // Ensure no stale hybrid output is returned on the next call.
-            while (output_queue_.pop())
+            if (pending != runtime::AudioBlockPool::kInvalidIndex)
             {
+                block_pool_.at(pending).cancelled.store(true, std::memory_order_release);
+                pending = runtime::AudioBlockPool::kInvalidIndex;
             }
-            return ProcessInternal(input, output, frames);
         }
-        if (processed->data.size() < samples)
+        hybrid_next_output_ = hybrid_next_input_;
+        hybrid_fifo_.clear();
+        hybrid_latency_frames_.store(0, std::memory_order_relaxed);
+    }
+
+    ech_dsp_status_t DspEngine::GetLatency(uint32_t *latency_blocks,
+                                           size_t *latency_frames)
+    {
+        if (!latency_blocks && !latency_frames)
+        {
+            return ECH_DSP_STATUS_INVALID_ARGUMENT;
+        }
+        const bool hybrid = processing_mode_.load(std::memory_order_relaxed) ==
+                            config::ProcessingMode::kHybrid;
+        if (latency_blocks)
         {
-            return ECH_DSP_STATUS_ERROR;
+            *latency_blocks = hybrid ? kHybridPipelineDepth : 0;
+        }
+        if (latency_frames)
+        {
+            *latency_frames =
+                hybrid ? hybrid_latency_frames_.load(std::memory_order_relaxed) : 0;
         }
-        std::memcpy(output, processed->data.data(), sizeof(float) * samples);
         return ECH_DSP_STATUS_OK;
     }
 
+    void DspEngine::Reset()
+    {
+        reset_effects_.store(true, std::memory_order_release);
+        reset_pipeline_.store(true, std::memory_order_release);
+    }
+
+    void DspEngine::ResetPlanEffects(const ExecutionPlan &plan)
+    {
+        for (uint32_t index = 0; index < plan.stage_count; ++index)
+        {
+            plan.stages[index].effect->reset();
+        }
+        if (plan.mix != nullptr)
+        {
+            plan.mix->reset();
+        }
+    }
+
+    uint64_t DspEngine::hybrid_underruns() const
+    {
+        return hybrid_underruns_.load(std::memory_order_relaxed);
+    }
+
+    uint64_t DspEngine::worker_wakeups() const
+    {
+        return worker_wakeups_.load(std::memory_order_relaxed);
+    }
+
     /**
      * @brief The synchronous processing implementation used internally.
      *
@@ -273,7 +577,8 @@ namespace echidna::dsp
         {
             return ECH_DSP_STATUS_ERROR;
         }
-        if (realtime_max_frames_ != 0 && frames > realtime_max_frames_)
+        const size_t max_frames = realtime_max_frames_.load(std::memory_order_relaxed);
+        if (max_frames != 0 && frames > max_frames)
         {
             return ECH_DSP_STATUS_INVALID_ARGUMENT;
         }
@@ -289,7 +594,8 @@ namespace echidna::dsp
         {
             return ECH_DSP_STATUS_INVALID_ARGUMENT;
         }
-        if (realtime_max_frames_ != 0 && frames > realtime_max_frames_)
+        const size_t max_frames = realtime_max_frames_.load(std::memory_order_relaxed);
+        if (max_frames != 0 && frames > max_frames)
         {
             return ECH_DSP_STATUS_INVALID_ARGUMENT;
         }
@@ -301,32 +607,180 @@ namespace echidna::dsp
         {
             return ECH_DSP_STATUS_ERROR;
         }
-        std::memcpy(dry_buffer_.data(), input, sizeof(float) * samples);
-        std::memcpy(wet_buffer_.data(), input, sizeof(float) * samples);
+        // BUSY keeps the writer from reconfiguring any instance this block
+        // touches.
+        const uint32_t state =
+            plan_state_.fetch_or(kPlanReaderBusy | kPlanActiveUsed, std::memory_order_acq_rel);
+        const uint32_t active = state & kPlanActiveMask;
+        const ExecutionPlan &plan = plans_[active];
+        analysis_fed_ = false;
+        if (reset_effects_.exchange(false, std::memory_order_acq_rel))
+        {
+            // While a swap is pending the reader owns both plans.
+            ResetPlanEffects(plan);
+            if ((state & kPlanSwapPending) != 0)
+            {
+                ResetPlanEffects(plans_[active ^ 1U]);
+            }
+            analysis_.reset();
+        }
+
+        if ((state & kPlanSwapPending) == 0)
+        {
+            // Steady state: the wet path runs in `output` itself. A disjoint
+            // input is still intact when the bus mixes, so it is read as the
+            // dry signal directly; only an in-place call needs the copy.
+            const float *dry = input;
+            if (plan.needs_dry && BlocksOverlap(input, output, samples))
+            {
+                std::memcpy(dry_buffer_.data(), input, sizeof(float) * samples);
+                dry = dry_buffer_.data();
+            }
+            if (plan.stage_count == 0)
+            {
+                if (output != input)
+                {
+                    std::memmove(output, input, sizeof(float) * samples);
+                }
+            }
+            else
+            {
+                // Effects run on aligned per-channel spans: deinterleave once
+                // on entry and interleave once on exit.
+                runtime::deinterleave(input, planar_.channels(), frames, channels_);
+                RunStages(plan, 0, plan.stage_count, planar_.channels(), frames);
+                runtime::interleave(planar_.channels(), output, frames, channels_);
+            }
+            effects::ProcessContext ctx{output, frames, channels_, sample_rate_};
+            if (options_.load_plugins)
+            {
+                plugin_loader_.ProcessAll(ctx);
+            }
+            if (plan.needs_dry)
+            {
+                plan.mix->process_buffers(dry, output, output, frames);
+            }
+            else if (!plan.mix_is_identity)
+            {
+                plan.mix->process(ctx);
+            }
+            plan_state_.fetch_and(~kPlanReaderBusy, std::memory_order_release);
+            return ECH_DSP_STATUS_OK;
+        }
+
+        const ExecutionPlan &next = plans_[active ^ 1U];
+        // Output is only written by the final mix, so a disjoint input serves
+        // as the dry signal; an aliased one is copied first.
+        const float *dry = input;
+        if (BlocksOverlap(input, output, samples))
+        {
+            std::memcpy(dry_buffer_.data(), input, sizeof(float) * samples);
+            dry = dry_buffer_.data();
+        }
+        runtime::deinterleave(input, planar_.channels(), frames, channels_);
 
-        effects::ProcessContext ctx{wet_buffer_.data(), frames, channels_, sample_rate_};
-        gate_.process(ctx);
-        eq_.process(ctx);
-        compressor_.process(ctx);
-        pitch_.process(ctx);
-        formant_.process(ctx);
-        autotune_.process(ctx);
-        reverb_.process(ctx);
+        // Instances both plans run keep their relative order (see
+        // ApplyPresetLocked). Each runs once, on the faded signal; the stages
+        // between two of them run per plan and are faded before the next.
+        const auto find_stage = [&plan](uint32_t first, const effects::EffectProcessor *effect)
+        {
+            while (first < plan.stage_count && plan.stages[first].effect != effect)
+            {
+                ++first;
+            }
+            return first;
+        };
+        uint32_t from = 0;
+        uint32_t to = 0;
+        while (from < plan.stage_count || to < next.stage_count)
+        {
+            if (from < plan.stage_count && to < next.stage_count &&
+                plan.stages[from].effect == next.stages[to].effect)
+            {
+                RunStages(next, to, to + 1, planar_.channels(), frames);
+                ++from;
+                ++to;
+                continue;
+            }
+            uint32_t from_end = plan.stage_count;
+            uint32_t to_end = to;
+            while (to_end < next.stage_count &&
+                   (from_end = find_stage(from, next.stages[to_end].effect)) == plan.stage_count)
+            {
+                ++to_end;
+            }
+            for (uint32_t ch = 0; ch < channels_; ++ch)
+            {
+                std::memcpy(fade_planar_.channel(ch), planar_.channel(ch), sizeof(float) * frames);
+            }
+            RunStages(plan, from, from_end, planar_.channels(), frames);
+            RunStages(next, to, to_end, fade_planar_.channels(), frames);
+            CrossfadePlanarInto(planar_.channels(), fade_planar_.channels(), frames, channels_);
+            from = from_end;
+            to = to_end;
+        }
+        runtime::interleave(planar_.channels(), wet_buffer_.data(), frames, channels_);
 
         if (options_.load_plugins)
         {
+            effects::ProcessContext ctx{wet_buffer_.data(), frames, channels_, sample_rate_};
             plugin_loader_.ProcessAll(ctx);
         }
 
-        mix_.process_buffers(dry_buffer_.data(), wet_buffer_.data(), output, frames);
+        plan.mix->process_buffers(dry, wet_buffer_.data(), output, frames);
+        if (next.mix != plan.mix)
+        {
+            next.mix->process_buffers(dry,
+                                      wet_buffer_.data(),
+                                      fade_output_buffer_.data(),
+                                      frames);
+            CrossfadeInto(output, fade_output_buffer_.data(), frames, channels_);
+        }
+
+        // The writer waits while PENDING and BUSY are both set, so nothing else
+        // can have changed the state during this block.
+        plan_state_.store((active ^ 1U) | kPlanActiveUsed, std::memory_order_release);
         return ECH_DSP_STATUS_OK;
     }
 
+    void DspEngine::RunStages(const ExecutionPlan &plan,
+                              uint32_t first,
+                              uint32_t last,
+                              float *const *channels,
+                              size_t frames)
+    {
+        effects::ProcessContext ctx{nullptr, frames, channels_, sample_rate_, channels};
+        if (first > plan.analysis_at)
+        {
+            ctx.analysis = &analysis_;
+        }
+        for (uint32_t index = first; index < last; ++index)
+        {
+            if (index == plan.analysis_at)
+            {
+                // While plans crossfade the bus only takes the first feed.
+                if (!analysis_fed_)
+                {
+                    analysis_.analyze(channels, channels_, frames, plan.analysis_features);
+                    analysis_fed_ = true;
+                }
+                ctx.analysis = &analysis_;
+            }
+            const PlanStage &stage = plan.stages[index];
+            stage.run(*stage.effect, ctx);
+        }
+    }
+
     bool DspEngine::plugin_directory_scanned() const
     {
         return plugin_loader_.directory_scanned();
     }
 
+    bool DspEngine::analysis_bus_allocated() const
+    {
+        return analysis_.prepared();
+    }
+
     /**
      * @brief Ensure internal buffers have capacity for 'frames' frames.
      */
@@ -341,41 +795,404 @@ namespace echidna::dsp
         {
             wet_buffer_.resize(samples);
         }
+        planar_.ensure(channels_, frames);
+        fade_planar_.ensure(channels_, frames);
+        if (fade_output_buffer_.size() < samples)
+        {
+            fade_output_buffer_.resize(samples);
+        }
     }
 
     /**
-     * @brief Apply preset configuration to all owned effects and plugins.
+     * @brief Diff a preset against the live plan, configure the standby
+     * instances of the modules it changes and compile the standby plan.
      */
-    void DspEngine::ApplyPresetLocked()
+    bool DspEngine::ApplyPresetLocked(const ExecutionPlan &live,
+                                      const config::PresetDefinition &preset,
+                                      ExecutionPlan &standby)
     {
-        gate_.prepare(sample_rate_, channels_);
-        gate_.reset();
+        config::PresetDefinition effective = preset;
+        bool allow_high_quality =
+            quality_mode_ == ECH_DSP_QUALITY_HIGH ||
+            (quality_mode_ == ECH_DSP_QUALITY_BALANCED &&
+             preset.quality != config::QualityPreference::kLowLatency);
+        if (!allow_high_quality)
+        {
+            effective.pitch.params.quality = effects::PitchQuality::kLowLatency;
+        }
 
-        eq_.prepare(sample_rate_, channels_);
-        eq_.reset();
+        std::array<Module, kMix> order{};
+        uint32_t count = 0;
+        for (config::EffectStage stage : effective.stage_order)
+        {
+            const auto module = static_cast<Module>(stage);
+            if (ModuleEnabled(effective, module))
+            {
+                order[count++] = module;
+            }
+        }
 
-        compressor_.prepare(sample_rate_, channels_);
-        compressor_.reset();
+        // A live stage whose configuration is unchanged keeps its instance,
+        // and its state, wherever it moves in the chain, as long as the kept
+        // stages stay in their relative order: the reader runs each of them
+        // once, between the segments it crossfades. Keep the longest such run.
+        const auto bank_of = [](uint32_t selection, Module module)
+        { return (selection >> module) & 1U; };
+        const auto reusable = [&](uint32_t live_index, uint32_t index)
+        {
+            const Module module = live.stages[live_index].module;
+            return module == order[index] &&
+                   ModuleMatches(banks_[bank_of(live.selection, module)], module, effective);
+        };
+        std::array<std::array<uint8_t, kMix + 1>, kMix + 1> common{};
+        for (uint32_t live_index = live.stage_count; live_index-- > 0;)
+        {
+            for (uint32_t index = count; index-- > 0;)
+            {
+                common[live_index][index] =
+                    reusable(live_index, index)
+                        ? static_cast<uint8_t>(common[live_index + 1][index + 1] + 1)
+                        : std::max(common[live_index + 1][index], common[live_index][index + 1]);
+            }
+        }
+        uint32_t kept = 0;
+        for (uint32_t live_index = 0, index = 0; live_index < live.stage_count && index < count;)
+        {
+            if (reusable(live_index, index))
+            {
+                kept |= 1U << order[index];
+                ++live_index;
+                ++index;
+            }
+            else if (common[live_index + 1][index] >= common[live_index][index + 1])
+            {
+                ++live_index;
+            }
+            else
+            {
+                ++index;
+            }
+        }
 
-        pitch_.prepare(sample_rate_, channels_);
-        pitch_.reset();
+        uint32_t selection = live.selection;
+        for (uint32_t index = 0; index < kModuleCount; ++index)
+        {
+            const auto module = static_cast<Module>(index);
+            bool keep = ModuleMatches(banks_[bank_of(live.selection, module)], module, effective);
+            if (module != kMix && ModuleEnabled(effective, module))
+            {
+                keep = (kept & (1U << module)) != 0;
+            }
+            if (!keep)
+            {
+                selection ^= 1U << module;
+                ConfigureModuleLocked(banks_[bank_of(selection, module)], module, effective);
+            }
+        }
 
-        formant_.prepare(sample_rate_, channels_);
-        formant_.reset();
+        CompilePlanLocked(selection, order, count, standby);
+        if (standby.stage_count != live.stage_count || standby.mix != live.mix)
+        {
+            return true;
+        }
+        for (uint32_t index = 0; index < standby.stage_count; ++index)
+        {
+            if (standby.stages[index].effect != live.stages[index].effect)
+            {
+                return true;
+            }
+        }
+        return false;
+    }
 
-        autotune_.prepare(sample_rate_, channels_);
-        autotune_.reset();
+    bool DspEngine::ModuleEnabled(const config::PresetDefinition &preset, Module module)
+    {
+        switch (module)
+        {
+        case kGate:
+            return preset.gate.enabled;
+        case kEq:
+            return preset.eq.enabled;
+        case kCompressor:
+            return preset.compressor.enabled;
+        case kPitch:
+            return preset.pitch.enabled;
+        case kFormant:
+            return preset.formant.enabled;
+        case kAutoTune:
+            return preset.autotune.enabled;
+        case kReverb:
+            return preset.reverb.enabled;
+        default:
+            return false;
+        }
+    }
 
-        reverb_.prepare(sample_rate_, channels_);
-        reverb_.reset();
+    bool DspEngine::ModuleMatches(const EffectChain &chain,
+                                  Module module,
+                                  const config::PresetDefinition &preset)
+    {
+        if ((chain.configured & (1U << module)) == 0)
+        {
+            return false;
+        }
+        switch (module)
+        {
+        case kGate:
+            return chain.applied.gate == preset.gate;
+        case kEq:
+            return chain.applied.eq == preset.eq;
+        case kCompressor:
+            return chain.applied.compressor == preset.compressor;
+        case kPitch:
+            return chain.applied.pitch == preset.pitch;
+        case kFormant:
+            return chain.applied.formant == preset.formant;
+        case kAutoTune:
+            return chain.applied.autotune == preset.autotune;
+        case kReverb:
+            return chain.applied.reverb == preset.reverb;
+        case kMix:
+            return chain.applied.mix == preset.mix;
+        default:
+            return false;
+        }
+    }
 
-        mix_.prepare(sample_rate_, channels_);
+    void DspEngine::CompilePlanLocked(uint32_t selection,
+                                      const std::array<Module, kMix> &order,
+                                      uint32_t count,
+                                      ExecutionPlan &plan)
+    {
+        for (uint32_t index = 0; index < count; ++index)
+        {
+            const Module module = order[index];
+            EffectChain &bank = banks_[(selection >> module) & 1U];
+            PlanStage &stage = plan.stages[index];
+            stage.module = module;
+            switch (module)
+            {
+            case kGate:
+                stage.run = &RunStage<effects::GateProcessor>;
+                stage.effect = &bank.gate;
+                break;
+            case kEq:
+                stage.run = &RunStage<effects::ParametricEQ>;
+                stage.effect = &bank.eq;
+                break;
+            case kCompressor:
+                stage.run = &RunStage<effects::Compressor>;
+                stage.effect = &bank.compressor;
+                break;
+            case kPitch:
+                stage.run = &RunStage<effects::PitchShifter>;
+                stage.effect = &bank.pitch;
+                break;
+            case kFormant:
+                stage.run = &RunStage<effects::FormantShifter>;
+                stage.effect = &bank.formant;
+                break;
+            case kAutoTune:
+                stage.run = &RunStage<effects::AutoTune>;
+                stage.effect = &bank.autotune;
+                break;
+            case kReverb:
+                if (bank.applied.reverb.mode == config::ReverbMode::kConvolution)
+                {
+                    stage.run = &RunStage<effects::ConvolutionReverb>;
+                    stage.effect = &bank.convolution;
+                }
+                else
+                {
+                    stage.run = &RunStage<effects::Reverb>;
+                    stage.effect = &bank.reverb;
+                }
+                break;
+            default:
+                break;
+            }
+        }
+        plan.stage_count = count;
 
-        if (options_.load_plugins)
+        // The tap sits before the first subscriber that no pitch shifter
+        // separates from the last one, so the pitch it measures is the pitch
+        // every later subscriber receives. Subscribers ahead of the tap run
+        // their own analysis.
+        uint32_t last_subscriber = count;
+        for (uint32_t index = 0; index < count; ++index)
         {
-            plugin_loader_.PrepareAll(sample_rate_, channels_);
-            plugin_loader_.ResetAll();
+            if (plan.stages[index].effect->analysis_features() != 0)
+            {
+                last_subscriber = index;
+            }
+        }
+        plan.analysis_at = count;
+        plan.analysis_features = 0;
+        if (last_subscriber != count)
+        {
+            uint32_t barrier = 0;
+            for (uint32_t index = 0; index < last_subscriber; ++index)
+            {
+                if (plan.stages[index].module == kPitch)
+                {
+                    barrier = index + 1;
+                }
+            }
+            for (uint32_t index = barrier; index <= last_subscriber; ++index)
+            {
+                const uint32_t features = plan.stages[index].effect->analysis_features();
+                if (features != 0 && plan.analysis_at == count)
+                {
+                    plan.analysis_at = index;
+                }
+                plan.analysis_features |= features;
+            }
+            if (!analysis_.prepared() && !analysis_.prepare(sample_rate_))
+            {
+                plan.analysis_at = count;
+                plan.analysis_features = 0;
+            }
+        }
+
+        plan.mix = &banks_[(selection >> kMix) & 1U].mix;
+        plan.needs_dry = !plan.mix->wet_only();
+        plan.mix_is_identity = plan.mix->is_identity();
+        plan.selection = selection;
+    }
+
+    /**
+     * @brief Apply one module's configuration to a standby instance.
+     *
+     * An instance that was never prepared, or whose new configuration changes
+     * its buffer layout, is prepared; otherwise only its parameters change.
+     * The instance is always reset because its state, if any, is stale.
+     */
+    void DspEngine::ConfigureModuleLocked(EffectChain &chain,
+                                          Module module,
+                                          const config::PresetDefinition &preset)
+    {
+        const uint32_t bit = 1U << module;
+        const bool first_use = (chain.configured & bit) == 0;
+        const size_t max_frames = realtime_max_frames_.load(std::memory_order_relaxed);
+        switch (module)
+        {
+        case kGate:
+            chain.gate.set_enabled(preset.gate.enabled);
+            chain.gate.set_parameters(preset.gate.params);
+            if (first_use)
+            {
+                chain.gate.prepare(sample_rate_, channels_);
+            }
+            chain.gate.reset();
+            chain.applied.gate = preset.gate;
+            break;
+        case kEq:
+        {
+            const bool structural =
+                first_use || chain.applied.eq.bands.size() != preset.eq.bands.size();
+            chain.eq.set_enabled(preset.eq.enabled);
+            chain.eq.set_bands(preset.eq.bands);
+            if (structural)
+            {
+                chain.eq.prepare(sample_rate_, channels_);
+            }
+            chain.eq.reset();
+            chain.applied.eq = preset.eq;
+            break;
+        }
+        case kCompressor:
+            chain.compressor.set_enabled(preset.compressor.enabled);
+            chain.compressor.set_parameters(preset.compressor.params);
+            if (first_use)
+            {
+                chain.compressor.prepare(sample_rate_, channels_);
+            }
+            chain.compressor.reset();
+            chain.applied.compressor = preset.compressor;
+            break;
+        case kPitch:
+            chain.pitch.set_enabled(preset.pitch.enabled);
+            if (first_use || !(chain.applied.pitch.params == preset.pitch.params))
+            {
+                chain.pitch.set_parameters(preset.pitch.params);
+            }
+            if (first_use)
+            {
+                chain.pitch.prepare(sample_rate_, channels_);
+                if (max_frames != 0)
+                {
+                    chain.pitch.prepare_realtime(max_frames);
+                }
+            }
+            chain.pitch.reset();
+            chain.applied.pitch = preset.pitch;
+            break;
+        case kFormant:
+            chain.formant.set_enabled(preset.formant.enabled);
+            chain.formant.set_parameters(preset.formant.params);
+            if (first_use)
+            {
+                chain.formant.prepare(sample_rate_, channels_);
+            }
+            chain.formant.reset();
+            chain.applied.formant = preset.formant;
+            break;
+        case kAutoTune:
+            chain.autotune.set_enabled(preset.autotune.enabled);
+            if (first_use || !(chain.applied.autotune.params == preset.autotune.params))
+            {
+                chain.autotune.set_parameters(preset.autotune.params);
+            }
+            if (first_use)
+            {
+                chain.autotune.prepare(sample_rate_, channels_);
+                if (max_frames != 0)
+                {
+                    chain.autotune.prepare_realtime(max_frames);
+                }
+            }
+            chain.autotune.reset();
+            chain.applied.autotune = preset.autotune;
+            break;
+        case kReverb:
+            if (first_use)
+            {
+                chain.reverb.prepare(sample_rate_, channels_);
+                chain.convolution.prepare(sample_rate_, channels_);
+            }
+            if (preset.reverb.mode == config::ReverbMode::kConvolution)
+            {
+                // The spectra are computed once per process and rate, then
+                // shared; an unknown id leaves the stage passing audio through.
+                chain.convolution.set_enabled(preset.reverb.enabled);
+                chain.convolution.set_parameters(preset.reverb.params);
+                chain.convolution.set_impulse_response(runtime::ImpulseResponseLibrary::instance().partitioned(
+                    preset.reverb.impulse_response,
+                    sample_rate_,
+                    effects::ConvolutionReverb::partition_frames(sample_rate_)));
+                chain.convolution.reset();
+            }
+            else
+            {
+                chain.reverb.set_enabled(preset.reverb.enabled);
+                // Resizes the delay arena itself when room size or pre-delay change.
+                chain.reverb.set_parameters(preset.reverb.params);
+                chain.reverb.reset();
+            }
+            chain.applied.reverb = preset.reverb;
+            break;
+        case kMix:
+            chain.mix.set_parameters(preset.mix.params);
+            if (first_use)
+            {
+                chain.mix.prepare(sample_rate_, channels_);
+            }
+            chain.applied.mix = preset.mix;
+            break;
+        default:
+            break;
         }
+        chain.configured |= bit;
     }
 
     /**
@@ -402,15 +1219,19 @@ namespace echidna::dsp
             return;
         }
         worker_running_ = false;
+        input_queue_.notify();
         if (worker_thread_.joinable())
         {
             worker_thread_.join();
         }
-        while (output_queue_.pop())
+        uint32_t index = runtime::AudioBlockPool::kInvalidIndex;
+        while (output_queue_.pop(index))
         {
+            block_pool_.release(index);
         }
-        while (input_queue_.pop())
+        while (input_queue_.pop(index))
         {
+            block_pool_.release(index);
         }
     }
 
@@ -430,82 +1251,61 @@ namespace echidna::dsp
         // before dropping blocks to let the system recover.
         constexpr uint32_t kOverrunThresholdUs = 30000;
         constexpr uint32_t kConsecutiveOverrunLimit = 6;
+        constexpr auto kIdleWait = std::chrono::milliseconds(50);
         uint32_t consecutive_overruns = 0;
         uint32_t total_xruns = 0;
 
         while (worker_running_)
         {
-            auto block = input_queue_.pop_wait(std::chrono::milliseconds(5));
-            if (!block)
-            {
-                continue;
-            }
-            if (block->cancelled.load(std::memory_order_acquire))
+            uint32_t index = runtime::AudioBlockPool::kInvalidIndex;
+            // An idle worker sleeps on the queue's futex; StopWorker() wakes it.
+            const bool popped = input_queue_.pop_wait(index, kIdleWait);
+            worker_wakeups_.fetch_add(1, std::memory_order_relaxed);
+            if (!popped)
             {
                 continue;
             }
-
-            auto wall_start = std::chrono::steady_clock::now();
-
+            runtime::AudioBlock &block = block_pool_.at(index);
+            block.processed = false;
             size_t samples = 0;
-            if (!ComputeSampleCount(block->frames, block->channels, &samples))
-            {
-                continue;
-            }
-            std::vector<float> output;
-            ech_dsp_status_t status = ECH_DSP_STATUS_ERROR;
-            try
+            if (!block.cancelled.load(std::memory_order_acquire) &&
+                ComputeSampleCount(block.frames, block.channels, &samples))
             {
-                output.resize(samples);
-                status = ProcessInternal(block->data.data(), output.data(), block->frames);
-            }
-            catch (...)
-            {
-                status = ECH_DSP_STATUS_ERROR;
-            }
+                auto wall_start = std::chrono::steady_clock::now();
 
-            auto wall_end = std::chrono::steady_clock::now();
-            const auto wall_us = std::chrono::duration_cast<std::chrono::microseconds>(
-                                     wall_end - wall_start)
-                                     .count();
+                // Processed in place: the chain copies its input into the dry and
+                // wet scratch before it writes the output.
+                const ech_dsp_status_t status =
+                    ProcessInternal(block.data.data(), block.data.data(), block.frames);
 
-            if (wall_us > kOverrunThresholdUs)
-            {
-                ++consecutive_overruns;
-                ++total_xruns;
-            }
-            else
-            {
-                consecutive_overruns = 0;
-            }
+                auto wall_end = std::chrono::steady_clock::now();
+                const auto wall_us = std::chrono::duration_cast<std::chrono::microseconds>(
+                                         wall_end - wall_start)
+                                         .count();
 
-            if (consecutive_overruns >= kConsecutiveOverrunLimit)
-            {
-                consecutive_overruns = 0;
-                continue;
-            }
+                if (wall_us > kOverrunThresholdUs)
+                {
+                    ++consecutive_overruns;
+                    ++total_xruns;
+                }
+                else
+                {
+                    consecutive_overruns = 0;
+                }
 
-            if (status != ECH_DSP_STATUS_OK)
-            {
-                continue;
-            }
-            if (block->cancelled.load(std::memory_order_acquire))
-            {
-                continue;
-            }
-            block->data = std::move(output);
-            while (worker_running_)
-            {
-                if (block->cancelled.load(std::memory_order_acquire))
+                if (consecutive_overruns >= kConsecutiveOverrunLimit)
                 {
-                    break;
+                    consecutive_overruns = 0;
                 }
-                if (output_queue_.push(block))
+                else
                 {
-                    break;
+                    block.processed = status == ECH_DSP_STATUS_OK;
                 }
-                std::this_thread::yield();
             }
+            // Every popped block goes back to the caller, which owns its release;
+            // an unprocessed one is emitted dry. The queue holds the whole pool,
+            // so this push cannot fail.
+            output_queue_.push(index);
         }
     }
 
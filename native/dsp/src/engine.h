@@ -10,6 +10,7 @@
  * ech_dsp_status_t values for success/failure.
  */
 
+#include <array>
 #include <atomic>
 #include <cstddef>
 #include <cstdint>
@@ -23,6 +24,7 @@
 #include "config/preset_loader.h"
 #include "effects/auto_tune.h"
 #include "effects/compressor.h"
+#include "effects/convolution_reverb.h"
 #include "effects/formant_shifter.h"
 #include "effects/gate_processor.h"
 #include "effects/mix_bus.h"
@@ -31,6 +33,8 @@
 #include "effects/reverb.h"
 #include "plugins/plugin_loader.h"
 #include "runtime/block_queue.h"
+#include "runtime/planar_buffer.h"
+#include "runtime/spectral_analysis.h"
 
 namespace echidna::dsp
 {
@@ -77,27 +81,37 @@ namespace echidna::dsp
         /**
          * @brief Apply or update the currently active preset.
          *
-         * This takes ownership (copies) of the provided preset definition and
-         * updates internal effect parameters. This call will stop any running
-         * hybrid worker before applying preset changes and restart it if
-         * appropriate for the preset's processing mode.
+         * This takes ownership (copies) of the provided preset definition,
+         * configures the effect instances it changes off the audio thread and
+         * compiles them into a standby execution plan. The plan is then
+         * published with a single atomic state update and the next processed
+         * block crossfades from the old plan to the new one, so audio
+         * callbacks keep running throughout. The hybrid worker is only stopped
+         * or started when the processing mode itself changes.
          *
          * @param preset Preset definition to apply.
          * @return ECH_DSP_STATUS_OK on success, error code on failure.
          */
         ech_dsp_status_t UpdatePreset(const config::PresetDefinition &preset);
-        /** Preallocate all core callback-path scratch for max_frames. */
+        /**
+         * Preallocate all core callback-path scratch for max_frames, including
+         * the hybrid block pool, so neither processing mode allocates.
+         */
         ech_dsp_status_t PrepareRealtime(size_t max_frames);
         /**
          * @brief Process a single audio block.
          *
          * If the engine is configured for synchronous processing the block
          * will be processed immediately and the output buffer will be populated.
-         * For hybrid mode the block may be scheduled to an internal worker and
-         * the function will attempt to return latest available hybrid output.
+         * In hybrid mode the block is handed to the worker thread and the output
+         * buffer receives the audio submitted kHybridPipelineDepth calls earlier
+         * (see GetLatency()), so the worker runs alongside the caller. The
+         * caller never waits for the worker; a late block is emitted dry.
          *
          * @param input Pointer to input samples (frames * channels floats).
-         * @param output Pointer where processed samples will be written.
+         * @param output Pointer where processed samples will be written; it
+         *        may alias `input`. A disjoint input is never written and
+         *        is mixed as the dry signal in place of an internal copy.
          * @param frames Number of frames in this block.
          * @return ECH_DSP_STATUS_OK on success or an appropriate error.
          */
@@ -105,10 +119,132 @@ namespace echidna::dsp
                                       float *output,
                                       size_t frames);
 
+        /**
+         * @brief Report the fixed delay the active processing mode adds.
+         *
+         * Synchronous processing adds no delay. Hybrid processing returns block
+         * N - kHybridPipelineDepth from the call that submits block N, so the
+         * delay is that many callbacks of the hybrid block size (zero frames
+         * until the first hybrid block establishes the size). A block size
+         * change keeps the stream continuous, so the frame delay follows the
+         * largest block seen since the pipeline was last armed.
+         *
+         * @param latency_blocks Optional output for the delay in callbacks.
+         * @param latency_frames Optional output for the delay in frames.
+         * @return ECH_DSP_STATUS_OK, or an error if both outputs are null.
+         */
+        ech_dsp_status_t GetLatency(uint32_t *latency_blocks,
+                                    size_t *latency_frames);
+
+        /**
+         * @brief Forget the audio history of every running effect.
+         *
+         * Callback-safe: it only raises a request. The next processed block
+         * starts from cleared effect state, and in hybrid mode the next call
+         * also drops the output still queued from earlier blocks, so none of
+         * the audio that came before is emitted. The preset is kept.
+         */
+        void Reset();
+
         /** Internal diagnostic used to prove HAL contexts never scan plugins. */
         bool plugin_directory_scanned() const;
+        /** Internal diagnostic: whether a preset has allocated the analysis bus. */
+        bool analysis_bus_allocated() const;
+        /** Internal diagnostic: hybrid blocks emitted dry because the worker was late. */
+        uint64_t hybrid_underruns() const;
+        /** Internal diagnostic: times the hybrid worker returned from its queue wait. */
+        uint64_t worker_wakeups() const;
+
+        /** Number of callbacks a hybrid block spends in the worker pipeline. */
+        static constexpr uint32_t kHybridPipelineDepth = 1;
 
     private:
+        /** Built-in modules; the effect stages mirror config::EffectStage. */
+        enum Module : uint32_t
+        {
+            kGate,
+            kEq,
+            kCompressor,
+            kPitch,
+            kFormant,
+            kAutoTune,
+            kReverb,
+            kMix,
+            kModuleCount
+        };
+        static_assert(config::kEffectStageCount == kMix);
+        static_assert(static_cast<uint32_t>(config::EffectStage::kReverb) == kReverb);
+
+        /**
+         * @brief One instance of every built-in effect plus the per-module
+         * configuration it was last given.
+         *
+         * The engine keeps two banks. The live chain picks one bank per module;
+         * UpdatePreset() only ever configures the other instance of a module.
+         */
+        struct EffectChain
+        {
+            effects::GateProcessor gate;
+            effects::ParametricEQ eq;
+            effects::Compressor compressor;
+            effects::PitchShifter pitch;
+            effects::FormantShifter formant;
+            effects::AutoTune autotune;
+            effects::Reverb reverb;
+            /** Runs the reverb stage instead of `reverb` in convolution mode. */
+            effects::ConvolutionReverb convolution;
+            effects::MixBus mix;
+            /** Configuration applied to each module (pitch after quality clamping). */
+            config::PresetDefinition applied;
+            /** Bit per Module set once that instance has been prepared. */
+            uint32_t configured{0};
+        };
+
+        using StageFn = void (*)(effects::EffectProcessor &, effects::ProcessContext &);
+
+        /** One enabled effect stage bound to the instance that runs it. */
+        struct PlanStage
+        {
+            StageFn run{nullptr};
+            effects::EffectProcessor *effect{nullptr};
+            Module module{kGate};
+        };
+
+        /**
+         * @brief Flat, preset-compiled description of one block's work.
+         *
+         * Only enabled stages are listed, in the preset's stage order, and the
+         * flags let the reader skip the dry copy and the mix pass when the mix
+         * bus would not change the wet signal.
+         */
+        struct ExecutionPlan
+        {
+            std::array<PlanStage, kMix> stages{};
+            uint32_t stage_count{0};
+            effects::MixBus *mix{nullptr};
+            /** The mix bus reads the dry signal. */
+            bool needs_dry{true};
+            /** The mix bus output equals its wet input. */
+            bool mix_is_identity{false};
+            /** Bank of every module (bit per Module); only read by the writer. */
+            uint32_t selection{0};
+            /**
+             * Stage the analysis bus is fed before; stage_count when no stage
+             * subscribes. Stages from here on receive it in their context.
+             */
+            uint32_t analysis_at{0};
+            /** SpectralAnalysis features read by the stages from analysis_at. */
+            uint32_t analysis_features{0};
+        };
+
+        // plan_state_ bits. The active plan index lives in bit 0; the reader
+        // (whoever runs ProcessInternalUnlocked) owns BUSY while it runs a plan
+        // and clears PENDING once it has faded into the standby plan.
+        static constexpr uint32_t kPlanActiveMask = 1U;
+        static constexpr uint32_t kPlanSwapPending = 2U;
+        static constexpr uint32_t kPlanReaderBusy = 4U;
+        static constexpr uint32_t kPlanActiveUsed = 8U;
+
         /**
          * @brief Internal synchronous processing implementation used by both
          * synchronous and hybrid codepaths.
@@ -123,24 +259,116 @@ namespace echidna::dsp
         ech_dsp_status_t ProcessInternalUnlocked(const float *input,
                                                  float *output,
                                                  size_t frames);
+        /**
+         * @brief Pipelined hybrid path: submit block N to the worker and emit
+         * block N - kHybridPipelineDepth.
+         *
+         * A block the worker has not handed back when it is due is replaced
+         * by its delayed dry input, so the caller never waits on the worker.
+         */
+        ech_dsp_status_t ProcessHybrid(const float *input,
+                                       float *output,
+                                       size_t frames);
+        /**
+         * @brief Append due block `wanted` to the output FIFO: the worker's
+         * result if it is already back, otherwise its dry input. Caller must
+         * hold `hybrid_mutex_` and have reserved the FIFO.
+         */
+        void EmitHybridBlockLocked(uint64_t wanted);
+        /**
+         * @brief Cancel in-flight hybrid blocks and re-arm the pipeline.
+         * Caller must hold `hybrid_mutex_`.
+         */
+        void ResetHybridPipelineLocked();
+        /**
+         * @brief Return a processed block to the pool, copying it to `output`
+         * if it is the processed result for sequence `wanted`.
+         * @return true if `output` was written.
+         */
+        bool ConsumeHybridBlock(uint32_t index,
+                                uint64_t wanted,
+                                float *output,
+                                size_t samples);
         /**
          * @brief Ensure the internal dry/wet buffers are sized for the provided
          * number of frames.
          */
         void EnsureBuffers(size_t frames);
         /**
-         * @brief Apply the current preset configuration to all owned effects.
+         * @brief Diff `preset` against the live plan, configure the other
+         * instance of every module that changed and compile `standby`.
          *
-         * This method expects the caller to hold the `preset_mutex_` so updates
-         * are atomic relative to other callers.
+         * Live stages with an unchanged configuration keep their instance,
+         * and its state, and are not touched at all, wherever they sit in the
+         * chain; only stages that change their order relative to other kept
+         * stages give that up. Every other changed or newly enabled module
+         * moves to its standby instance: parameters are updated in place,
+         * prepare() only runs for structural changes (first use, EQ band
+         * count; the reverb resizes its own arena for a new room size or
+         * pre-delay), then reset(). This method expects the caller to hold
+         * the `preset_mutex_`.
+         *
+         * @return true if `standby` differs from `live`.
+         */
+        bool ApplyPresetLocked(const ExecutionPlan &live,
+                               const config::PresetDefinition &preset,
+                               ExecutionPlan &standby);
+        /**
+         * @brief Bring one module of `chain` to `preset`'s configuration.
          */
-        void ApplyPresetLocked();
+        void ConfigureModuleLocked(EffectChain &chain,
+                                   Module module,
+                                   const config::PresetDefinition &preset);
+        /** Whether `chain`'s instance of `module` already matches `preset`. */
+        static bool ModuleMatches(const EffectChain &chain,
+                                  Module module,
+                                  const config::PresetDefinition &preset);
+        /** Whether `preset` enables effect stage `module`. */
+        static bool ModuleEnabled(const config::PresetDefinition &preset, Module module);
+        /**
+         * @brief Compile the plan running `order[0, count)` and the mix bus on
+         * the instances chosen by `selection`.
+         *
+         * Allocates the analysis bus the first time a plan has a subscriber;
+         * no plan read the bus before, so the reader never sees it change.
+         */
+        void CompilePlanLocked(uint32_t selection,
+                               const std::array<Module, kMix> &order,
+                               uint32_t count,
+                               ExecutionPlan &plan);
+        /**
+         * @brief Wait out the grace period of the previous swap and return the
+         * active plan index; the other plan is no longer read.
+         *
+         * A swap the reader has not picked up yet is completed here, without a
+         * crossfade, if no block is in progress. Caller must hold
+         * `preset_mutex_`.
+         */
+        uint32_t AcquireStandbyPlanLocked();
+        /**
+         * @brief Publish the standby plan. A plan that has not processed any
+         * audio yet is replaced outright; otherwise the next block fades.
+         */
+        void PublishStandbyPlan();
+        /**
+         * @brief Run stages [first, last) of `plan` in place on the planar
+         * channel spans `channels`, feeding the analysis bus at the plan's
+         * tap unless it was already fed this block.
+         */
+        void RunStages(const ExecutionPlan &plan,
+                       uint32_t first,
+                       uint32_t last,
+                       float *const *channels,
+                       size_t frames);
+        /** Reset every effect `plan` runs, including its mix bus. */
+        static void ResetPlanEffects(const ExecutionPlan &plan);
         /**
          * @brief Start the hybrid worker thread (if not already running).
          */
         void StartWorker();
         /**
-         * @brief Stop the hybrid worker thread and drain internal queues.
+         * @brief Stop the hybrid worker thread, drain internal queues and
+         * return every drained block to the pool.
          */
         void StopWorker();
         /**
@@ -156,28 +384,56 @@ namespace echidna::dsp
 
         config::PresetDefinition preset_;
 
-        effects::GateProcessor gate_;
-        effects::ParametricEQ eq_;
-        effects::Compressor compressor_;
-        effects::PitchShifter pitch_;
-        effects::FormantShifter formant_;
-        effects::AutoTune autotune_;
-        effects::Reverb reverb_;
-        effects::MixBus mix_;
+        std::array<EffectChain, 2> banks_;
+        std::array<ExecutionPlan, 2> plans_;
+        std::atomic<uint32_t> plan_state_{0};
+        // Reset() requests, taken by the reader and by the hybrid caller.
+        std::atomic<bool> reset_effects_{false};
+        std::atomic<bool> reset_pipeline_{false};
+        // Shared by both plans so its history survives preset swaps. Only
+        // the reader touches it once allocated.
+        runtime::SpectralAnalysis analysis_;
+        bool analysis_fed_{false};
         plugins::PluginLoader plugin_loader_;
 
         std::vector<float> dry_buffer_;
         std::vector<float> wet_buffer_;
-        size_t realtime_max_frames_{0};
+        // Effect stages run on these per-channel spans.
+        runtime::PlanarBuffer planar_;
+        // Second wet path and output used while crossfading between plans.
+        runtime::PlanarBuffer fade_planar_;
+        std::vector<float> fade_output_buffer_;
+        std::atomic<size_t> realtime_max_frames_{0};
 
-        config::ProcessingMode processing_mode_{config::ProcessingMode::kSynchronous};
+        // Read by the audio thread without preset_mutex_.
+        std::atomic<config::ProcessingMode> processing_mode_{
+            config::ProcessingMode::kSynchronous};
         std::mutex preset_mutex_;
         std::mutex process_mutex_;
 
-        runtime::BlockQueue input_queue_{8};
-        runtime::BlockQueue output_queue_{8};
+        // The caller is the only thread that acquires or releases pool blocks;
+        // the worker hands every block it pops back through output_queue_.
+        // Both queues can hold the whole pool, so neither push can fail.
+        static constexpr size_t kHybridPoolBlocks = 8;
+        runtime::AudioBlockPool block_pool_{kHybridPoolBlocks};
+        runtime::BlockQueue input_queue_{kHybridPoolBlocks + 1};
+        runtime::BlockQueue output_queue_{kHybridPoolBlocks + 1};
         std::atomic<bool> worker_running_{false};
         std::thread worker_thread_;
+        std::atomic<uint64_t> worker_wakeups_{0};
+
+        // Caller-side pipeline state, only touched with hybrid_mutex_ held.
+        static constexpr size_t kHybridSlots = kHybridPipelineDepth + 1;
+        std::mutex hybrid_mutex_;
+        std::array<uint32_t, kHybridSlots> hybrid_pending_{};
+        // Dry input of every block still in the pipeline, one slot each.
+        std::array<std::vector<float>, kHybridSlots> hybrid_dry_;
+        // Output of due blocks not yet handed to a callback.
+        std::vector<float> hybrid_fifo_;
+        uint64_t hybrid_next_input_{0};
+        uint64_t hybrid_next_output_{0};
+        std::atomic<size_t> hybrid_latency_frames_{0};
+        std::atomic<uint64_t> hybrid_underruns_{0};
     };
 
 } // namespace echidna::dsp
@@ -0,0 +1,224 @@
+#include "biquad_cascade.h"
+
+/**
+ * @file biquad_cascade.cpp
+ * @brief BiquadCascade kernel on the four-lane SIMD wrapper.
+ */
+
+#include <algorithm>
+
+#include "simd_lanes.h"
+
+namespace echidna::dsp::runtime
+{
+
+    namespace
+    {
+
+        constexpr size_t kCoefficientsPerStage = 5;
+        constexpr size_t kStateLanesPerStage = 2 * BiquadCascade::kLanes;
+        constexpr size_t kCoefficientLanesPerStage =
+            kCoefficientsPerStage * BiquadCascade::kLanes;
+
+        using lanes::add;
+        using lanes::Lanes;
+        using lanes::load;
+        using lanes::mul;
+        using lanes::store;
+        using lanes::sub;
+
+        static_assert(BiquadCascade::kLanes == lanes::kWidth);
+
+        /** Run one frame of one lane group through every stage. */
+        inline Lanes cascade_frame(Lanes x,
+                                   const float *coefficients,
+                                   float *state,
+                                   size_t stages)
+        {
+            for (size_t stage = 0; stage < stages; ++stage)
+            {
+                const float *c = coefficients + stage * kCoefficientLanesPerStage;
+                float *z = state + stage * kStateLanesPerStage;
+                const Lanes b0 = load(c);
+                const Lanes b1 = load(c + BiquadCascade::kLanes);
+                const Lanes b2 = load(c + 2 * BiquadCascade::kLanes);
+                const Lanes a1 = load(c + 3 * BiquadCascade::kLanes);
+                const Lanes a2 = load(c + 4 * BiquadCascade::kLanes);
+                const Lanes z1 = load(z);
+                const Lanes z2 = load(z + BiquadCascade::kLanes);
+                const Lanes y = add(mul(b0, x), z1);
+                store(z, add(sub(mul(b1, x), mul(a1, y)), z2));
+                store(z + BiquadCascade::kLanes, sub(mul(b2, x), mul(a2, y)));
+                x = y;
+            }
+            return x;
+        }
+
+    } // namespace
+
+    /** Allocate lane storage and start from identity stages. */
+    void BiquadCascade::configure(uint32_t channels, size_t stages)
+    {
+        channels_ = channels;
+        groups_ = (channels + kLanes - 1) / kLanes;
+        stages_ = stages;
+        ramp_remaining_ = 0;
+        current_.assign(stages, {});
+        target_.assign(stages, {});
+        step_.assign(stages, {});
+        lane_coefficients_.assign(stages * kCoefficientLanesPerStage, 0.0f);
+        state_.assign(static_cast<size_t>(groups_) * stages * kStateLanesPerStage, 0.0f);
+        broadcast_coefficients();
+    }
+
+    /** Snap to or start ramping towards new coefficients. */
+    void BiquadCascade::set_coefficients(const BiquadCoefficients *coefficients,
+                                         size_t ramp_frames)
+    {
+        std::copy_n(coefficients, stages_, target_.begin());
+        if (ramp_frames == 0)
+        {
+            current_ = target_;
+            ramp_remaining_ = 0;
+            broadcast_coefficients();
+            return;
+        }
+        const float inv = 1.0f / static_cast<float>(ramp_frames);
+        for (size_t stage = 0; stage < stages_; ++stage)
+        {
+            const BiquadCoefficients &from = current_[stage];
+            const BiquadCoefficients &to = target_[stage];
+            step_[stage] = {(to.b0 - from.b0) * inv,
+                            (to.b1 - from.b1) * inv,
+                            (to.b2 - from.b2) * inv,
+                            (to.a1 - from.a1) * inv,
+                            (to.a2 - from.a2) * inv};
+        }
+        ramp_remaining_ = ramp_frames;
+    }
+
+    /** Zero the delay lines and land any ramp on its target. */
+    void BiquadCascade::reset()
+    {
+        std::fill(state_.begin(), state_.end(), 0.0f);
+        if (ramp_remaining_ > 0)
+        {
+            current_ = target_;
+            ramp_remaining_ = 0;
+            broadcast_coefficients();
+        }
+    }
+
+    /**
+     * @brief Shared kernel: gather a frame of up to kLanes channels, run it
+     * through every stage, scatter it back.
+     *
+     * Frames inside a coefficient ramp go frame by frame across all lane
+     * groups so each group sees the same coefficients; the rest of the block
+     * runs group by group.
+     */
+    template <typename Sample>
+    void BiquadCascade::run(Sample &&sample, size_t frames)
+    {
+        if (stages_ == 0 || channels_ == 0)
+        {
+            return;
+        }
+        alignas(kPlanarAlignment) float gathered[kLanes];
+        auto process_frame = [&](uint32_t group, size_t frame)
+        {
+            const uint32_t base = group * kLanes;
+            const uint32_t active = std::min(kLanes, channels_ - base);
+            for (uint32_t lane = 0; lane < kLanes; ++lane)
+            {
+                gathered[lane] = lane < active ? sample(frame, base + lane) : 0.0f;
+            }
+            const Lanes y = cascade_frame(load(gathered),
+                                          lane_coefficients_.data(),
+                                          state_.data() + group * stages_ * kStateLanesPerStage,
+                                          stages_);
+            store(gathered, y);
+            for (uint32_t lane = 0; lane < active; ++lane)
+            {
+                sample(frame, base + lane) = gathered[lane];
+            }
+        };
+
+        size_t frame = 0;
+        for (; frame < frames && ramp_remaining_ > 0; ++frame)
+        {
+            advance_ramp();
+            for (uint32_t group = 0; group < groups_; ++group)
+            {
+                process_frame(group, frame);
+            }
+        }
+        for (uint32_t group = 0; group < groups_; ++group)
+        {
+            for (size_t f = frame; f < frames; ++f)
+            {
+                process_frame(group, f);
+            }
+        }
+    }
+
+    /** Filter planar channel spans. */
+    void BiquadCascade::process(float *const *channels, size_t frames)
+    {
+        auto sample = [channels](size_t frame, uint32_t channel) -> float &
+        {
+            return channels[channel][frame];
+        };
+        run(sample, frames);
+    }
+
+    /** Filter an interleaved buffer. */
+    void BiquadCascade::process_interleaved(float *interleaved, size_t frames)
+    {
+        const uint32_t stride = channels_;
+        auto sample = [interleaved, stride](size_t frame, uint32_t channel) -> float &
+        {
+            return interleaved[frame * stride + channel];
+        };
+        run(sample, frames);
+    }
+
+    /** Step the coefficients one frame along the ramp. */
+    void BiquadCascade::advance_ramp()
+    {
+        if (--ramp_remaining_ == 0)
+        {
+            current_ = target_;
+        }
+        else
+        {
+            for (size_t stage = 0; stage < stages_; ++stage)
+            {
+                BiquadCoefficients &c = current_[stage];
+                const BiquadCoefficients &d = step_[stage];
+                c.b0 += d.b0;
+                c.b1 += d.b1;
+                c.b2 += d.b2;
+                c.a1 += d.a1;
+                c.a2 += d.a2;
+            }
+        }
+        broadcast_coefficients();
+    }
+
+    /** Splat the current coefficients across the lanes of each stage. */
+    void BiquadCascade::broadcast_coefficients()
+    {
+        for (size_t stage = 0; stage < stages_; ++stage)
+        {
+            const BiquadCoefficients &c = current_[stage];
+            const float values[kCoefficientsPerStage] = {c.b0, c.b1, c.b2, c.a1, c.a2};
+            float *dst = lane_coefficients_.data() + stage * kCoefficientLanesPerStage;
+            for (size_t k = 0; k < kCoefficientsPerStage; ++k)
+            {
+                std::fill_n(dst + k * kLanes, kLanes, values[k]);
+            }
+        }
+    }
+
+} // namespace echidna::dsp::runtime
@@ -0,0 +1,97 @@
+#pragma once
+
+/**
+ * @file biquad_cascade.h
+ * @brief Vectorized cascade of direct-form-II-transposed biquads that runs
+ * every stage for a frame before moving to the next, with channels mapped
+ * to SIMD lanes.
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "planar_buffer.h"
+
+namespace echidna::dsp::runtime
+{
+
+    /**
+     * @brief Normalized biquad coefficients (a0 == 1).
+     *
+     * y = b0 * x + z1; z1' = b1 * x - a1 * y + z2; z2' = b2 * x - a2 * y
+     */
+    struct BiquadCoefficients
+    {
+        float b0{1.0f};
+        float b1{0.0f};
+        float b2{0.0f};
+        float a1{0.0f};
+        float a2{0.0f};
+    };
+
+    /**
+     * @brief Serial chain of biquads applied to any number of channels.
+     *
+     * Channels are processed kLanes at a time, one channel per SIMD lane, and
+     * all stages run back to back on each frame so the block is read and
+     * written once regardless of the stage count. Coefficient changes on a
+     * configured cascade ramp linearly per sample instead of stepping; the
+     * stability region of (a1, a2) is convex, so every intermediate filter
+     * of a ramp between two stable filters is stable too.
+     */
+    class BiquadCascade
+    {
+    public:
+        /** Channels processed per SIMD pass. */
+        static constexpr uint32_t kLanes = 4;
+
+        /**
+         * Size the cascade for `channels` channels and `stages` biquads. All
+         * stages start as identity filters with cleared state.
+         */
+        void configure(uint32_t channels, size_t stages);
+
+        /**
+         * Set the target coefficients of every stage (`coefficients` holds
+         * stages() entries). With `ramp_frames` == 0 they apply immediately,
+         * otherwise the current coefficients glide to them over that many
+         * frames while the filter state is kept.
+         */
+        void set_coefficients(const BiquadCoefficients *coefficients, size_t ramp_frames);
+
+        /** Clear the filter state and finish any pending coefficient ramp. */
+        void reset();
+
+        /** Filter `frames` samples of each channel span in place. */
+        void process(float *const *channels, size_t frames);
+        /** Filter `frames` interleaved frames in place. */
+        void process_interleaved(float *interleaved, size_t frames);
+
+        uint32_t channels() const { return channels_; }
+        size_t stages() const { return stages_; }
+        /** True while a coefficient ramp is still in progress. */
+        bool ramping() const { return ramp_remaining_ > 0; }
+
+    private:
+        template <typename Sample>
+        void run(Sample &&sample, size_t frames);
+        void advance_ramp();
+        void broadcast_coefficients();
+
+        using LaneVector = std::vector<float, AlignedAllocator<float>>;
+
+        uint32_t channels_{0};
+        uint32_t groups_{0};
+        size_t stages_{0};
+        size_t ramp_remaining_{0};
+        std::vector<BiquadCoefficients> current_{};
+        std::vector<BiquadCoefficients> target_{};
+        std::vector<BiquadCoefficients> step_{};
+        /** Per stage: b0, b1, b2, a1, a2, each splatted over kLanes floats. */
+        LaneVector lane_coefficients_{};
+        /** Per lane group and stage: z1 and z2, kLanes floats each. */
+        LaneVector state_{};
+    };
+
+} // namespace echidna::dsp::runtime
@@ -2,59 +2,220 @@
 
 /**
  * @file block_queue.cpp
- * @brief BlockQueue implementation used by hybrid DSP worker threads.
+ * @brief AudioBlockPool and BlockQueue implementations used by hybrid DSP
+ * worker threads.
  */
 
+#include <algorithm>
 #include <chrono>
-#include <thread>
+
+#if defined(_M_X64) || defined(_M_IX86)
+#include <immintrin.h>
+#endif
+
+#include "futex.h"
 
 namespace echidna::dsp::runtime
 {
+    namespace
+    {
+        /** Hint to the core that this is a spin-wait loop. */
+        inline void cpu_relax()
+        {
+#if defined(__x86_64__) || defined(__i386__)
+            __builtin_ia32_pause();
+#elif defined(_M_X64) || defined(_M_IX86)
+            _mm_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+            asm volatile("yield");
+#endif
+        }
+    } // namespace
 
     /**
-     * @brief Construct a BlockQueue with specified capacity.
+     * @brief Construct a pool of `capacity` default (empty) blocks.
      */
-    BlockQueue::BlockQueue(size_t capacity) : ring_(capacity) {}
+    AudioBlockPool::AudioBlockPool(size_t capacity)
+        : blocks_(capacity),
+          in_use_(std::make_unique<std::atomic<bool>[]>(capacity))
+    {
+        for (size_t i = 0; i < capacity; ++i)
+        {
+            in_use_[i].store(false, std::memory_order_relaxed);
+        }
+    }
+
+    /**
+     * @brief Grow every block's storage to hold `max_frames` frames.
+     */
+    void AudioBlockPool::prepare(uint32_t sample_rate, uint32_t channels, size_t max_frames)
+    {
+        for (auto &block : blocks_)
+        {
+            block.resize(sample_rate, channels, max_frames);
+        }
+    }
+
+    /**
+     * @brief Claim the first free block at or after a rotating hint.
+     *
+     * The pool is small, so a linear compare-exchange scan is cheaper than a
+     * tagged free list and has no ABA hazard.
+     */
+    uint32_t AudioBlockPool::acquire()
+    {
+        const size_t count = blocks_.size();
+        const size_t start = next_hint_.load(std::memory_order_relaxed);
+        for (size_t offset = 0; offset < count; ++offset)
+        {
+            const size_t index = (start + offset) % count;
+            bool expected = false;
+            if (in_use_[index].compare_exchange_strong(expected,
+                                                       true,
+                                                       std::memory_order_acquire,
+                                                       std::memory_order_relaxed))
+            {
+                next_hint_.store((index + 1) % count, std::memory_order_relaxed);
+                return static_cast<uint32_t>(index);
+            }
+        }
+        return kInvalidIndex;
+    }
 
     /**
-     * @brief Try to push a block. Returns false if the underlying ring buffer
-     * is full.
+     * @brief Mark a block free so acquire() can hand it out again.
      */
-    bool BlockQueue::push(const std::shared_ptr<AudioBlock> &block)
+    void AudioBlockPool::release(uint32_t index)
     {
-        return ring_.push(block);
+        if (index < blocks_.size())
+        {
+            in_use_[index].store(false, std::memory_order_release);
+        }
     }
 
     /**
-     * @brief Pop a block if one is available, otherwise return nullptr.
+     * @brief Count blocks not currently claimed.
      */
-    std::shared_ptr<AudioBlock> BlockQueue::pop()
+    size_t AudioBlockPool::available() const
     {
-        std::shared_ptr<AudioBlock> block;
-        if (!ring_.pop(block))
+        size_t free_blocks = 0;
+        for (size_t i = 0; i < blocks_.size(); ++i)
         {
-            return nullptr;
+            if (!in_use_[i].load(std::memory_order_acquire))
+            {
+                ++free_blocks;
+            }
         }
-        return block;
+        return free_blocks;
     }
 
     /**
-     * @brief Repeatedly attempt to pop from the ring buffer until timeout.
+     * @brief Construct a BlockQueue with specified capacity.
      */
-    std::shared_ptr<AudioBlock> BlockQueue::pop_wait(
-        std::chrono::microseconds timeout)
+    BlockQueue::BlockQueue(size_t capacity) : ring_(capacity) {}
+
+    /**
+     * @brief Try to push a block index. Returns false if the underlying ring
+     * buffer is full.
+     */
+    bool BlockQueue::push(uint32_t index)
     {
+        if (!ring_.push(index))
+        {
+            return false;
+        }
+        // Pairs with the fence in pop_wait(): either the consumer sees the new
+        // element before parking or this thread sees it parked.
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (parked_.load(std::memory_order_relaxed))
+        {
+            wake_parked();
+        }
+        return true;
+    }
+
+    /**
+     * @brief Pop a block index if one is available.
+     */
+    bool BlockQueue::pop(uint32_t &index)
+    {
+        return ring_.pop(index);
+    }
+
+    /**
+     * @brief Peek at the next block index without advancing the queue.
+     */
+    bool BlockQueue::peek(uint32_t &index) const
+    {
+        return ring_.peek(index);
+    }
+
+    /**
+     * @brief Pop, spinning briefly and then parking until a push or timeout.
+     *
+     * The ring is always polled at least once, so a zero timeout behaves like
+     * pop(). The spin budget adapts to whether spinning has recently paid off,
+     * so a tightly coupled producer is caught without a syscall while an idle
+     * one costs only a futex sleep.
+     */
+    bool BlockQueue::pop_wait(uint32_t &index, std::chrono::microseconds timeout)
+    {
+        if (ring_.pop(index))
+        {
+            return true;
+        }
         const auto deadline = std::chrono::steady_clock::now() + timeout;
-        std::shared_ptr<AudioBlock> block;
-        while (std::chrono::steady_clock::now() < deadline)
+        if (timeout.count() <= 0)
         {
-            if (ring_.pop(block))
+            return false;
+        }
+
+        for (uint32_t spin = 0; spin < spin_limit_; ++spin)
+        {
+            cpu_relax();
+            if (ring_.pop(index))
+            {
+                spin_limit_ = std::min(spin_limit_ * 2U, kMaxSpins);
+                return true;
+            }
+        }
+        spin_limit_ = std::max(spin_limit_ / 2U, kMinSpins);
+
+        while (true)
+        {
+            const uint32_t epoch = wake_epoch_.load(std::memory_order_acquire);
+            parked_.store(true, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            const bool popped = ring_.pop(index);
+            const auto now = std::chrono::steady_clock::now();
+            if (!popped && now < deadline)
+            {
+                futex_wait(wake_epoch_,
+                           epoch,
+                           std::chrono::duration_cast<std::chrono::microseconds>(deadline - now));
+            }
+            parked_.store(false, std::memory_order_relaxed);
+            if (popped || ring_.pop(index))
+            {
+                return true;
+            }
+            if (std::chrono::steady_clock::now() >= deadline)
             {
-                return block;
+                return false;
             }
-            std::this_thread::yield();
         }
-        return nullptr;
+    }
+
+    /**
+     * @brief Unconditionally bump the futex word and wake the consumer, so a
+     * consumer that is about to park returns straight away as well.
+     */
+    void BlockQueue::notify() { wake_parked(); }
+
+    void BlockQueue::wake_parked()
+    {
+        wake_epoch_.fetch_add(1, std::memory_order_release);
+        futex_wake(wake_epoch_, 1);
     }
 
     /**
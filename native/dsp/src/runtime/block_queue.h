@@ -2,14 +2,15 @@
 
 /**
  * @file block_queue.h
- * @brief Thread-safe ring-buffer backed queue for passing AudioBlock objects
- * between producer and consumer (worker) threads.
+ * @brief Preallocated AudioBlock pool and the ring-buffer backed queue that
+ * passes pool indices between producer and consumer (worker) threads.
  */
 
 #include <atomic>
 #include <chrono>
 #include <cstddef>
 #include <cstdint>
+#include <limits>
 #include <memory>
 #include <vector>
 
@@ -24,15 +25,20 @@ namespace echidna::dsp::runtime
      *
      * This struct holds the sample rate, channel count, frame count and sample
      * data for a block. The `cancelled` flag is used by the hybrid processing
-     * system to indicate the block should be dropped.
+     * system to indicate the block should be dropped, `sequence` lets the
+     * pipelined caller match a returned block to the slot it is waiting for,
+     * and `processed` records whether the worker replaced `data` with wet
+     * output.
      */
     struct AudioBlock
     {
         uint32_t sample_rate{0};
         uint32_t channels{0};
         size_t frames{0};
+        uint64_t sequence{0};
         std::vector<float> data;
         std::atomic<bool> cancelled{false};
+        bool processed{false};
 
         /** Default constructor creates an empty block. */
         AudioBlock() = default;
@@ -48,19 +54,83 @@ namespace echidna::dsp::runtime
 
         /**
          * @brief Resize the block and pre-allocate sample storage.
+         *
+         * Storage only grows, so resizing to a size the block has already held
+         * never allocates.
          */
         void resize(uint32_t sr, uint32_t ch, size_t fr)
         {
             sample_rate = sr;
             channels = ch;
             frames = fr;
-            data.resize(fr * ch);
+            if (data.size() < fr * ch)
+            {
+                data.resize(fr * ch);
+            }
+            processed = false;
             cancelled.store(false, std::memory_order_relaxed);
         }
     };
 
     /**
-     * @brief Simple blocking/non-blocking queue for AudioBlock shared pointers.
+     * @brief Fixed-capacity, lock-free pool of AudioBlocks addressed by index.
+     *
+     * The set of blocks never changes after construction, so an index stays
+     * valid for the pool's lifetime and can be handed across threads through a
+     * BlockQueue. acquire() and release() are lock-free and may be called from
+     * any thread; the holder of an index has exclusive access to its block.
+     */
+    class AudioBlockPool
+    {
+    public:
+        /** Index value returned by acquire() when every block is in use. */
+        static constexpr uint32_t kInvalidIndex = std::numeric_limits<uint32_t>::max();
+
+        /**
+         * @brief Create a pool of `capacity` empty blocks.
+         */
+        explicit AudioBlockPool(size_t capacity);
+
+        /**
+         * @brief Preallocate sample storage for blocks of up to `max_frames`.
+         *
+         * Not thread-safe: every block must be free (no index outstanding).
+         */
+        void prepare(uint32_t sample_rate, uint32_t channels, size_t max_frames);
+
+        /**
+         * @brief Claim a free block.
+         * @return Its index, or kInvalidIndex if the pool is exhausted.
+         */
+        uint32_t acquire();
+
+        /**
+         * @brief Return a block claimed with acquire() to the pool.
+         */
+        void release(uint32_t index);
+
+        /** Access the block at `index`; the caller must hold that index. */
+        AudioBlock &at(uint32_t index) { return blocks_[index]; }
+
+        /** Total number of blocks. */
+        size_t capacity() const { return blocks_.size(); }
+
+        /** Number of blocks not currently claimed. */
+        size_t available() const;
+
+    private:
+        std::vector<AudioBlock> blocks_;
+        std::unique_ptr<std::atomic<bool>[]> in_use_;
+        std::atomic<size_t> next_hint_{0};
+    };
+
+    /**
+     * @brief Single-producer single-consumer queue for AudioBlockPool indices.
+     *
+     * push() never blocks. pop_wait() polls with an adaptive short spin and
+     * then parks the consumer on a futex; push() only issues a wake-up when
+     * the consumer is actually parked, so a busy pipeline makes no syscalls
+     * and an idle one burns no CPU.
      */
     class BlockQueue
     {
@@ -72,23 +142,37 @@ namespace echidna::dsp::runtime
         explicit BlockQueue(size_t capacity);
 
         /**
-         * @brief Attempt to push a block onto the queue.
-         * @param block Shared pointer to the AudioBlock to push.
+         * @brief Attempt to push a block index onto the queue.
+         * @param index Pool index of the AudioBlock to push.
          * @return true if pushed, false if the queue is full.
          */
-        bool push(const std::shared_ptr<AudioBlock> &block);
+        bool push(uint32_t index);
         /**
-         * @brief Pop an available block or return nullptr if empty.
+         * @brief Pop an available block index.
+         * @return false if the queue is empty.
          */
-        std::shared_ptr<AudioBlock> pop();
+        bool pop(uint32_t &index);
 
         /**
-         * @brief Pop an available block waiting up to the specified timeout.
+         * @brief Read the next block index without removing it (consumer side).
+         * @return false if the queue is empty.
+         */
+        bool peek(uint32_t &index) const;
+
+        /**
+         * @brief Pop an available block index waiting up to the specified
+         * timeout.
+         * @param index Receives the popped index.
          * @param timeout Maximum time to wait for a block to become available.
-         * @return Shared pointer to the block or nullptr if timeout expired.
+         * @return false if the timeout expired with the queue still empty.
+         */
+        bool pop_wait(uint32_t &index, std::chrono::microseconds timeout);
+
+        /**
+         * @brief Wake a consumer parked in pop_wait() without pushing, e.g. so
+         * it can observe a shutdown flag.
          */
-        std::shared_ptr<AudioBlock> pop_wait(
-            std::chrono::microseconds timeout);
+        void notify();
 
         /**
          * @brief Return current number of elements in the queue.
@@ -96,7 +180,18 @@ namespace echidna::dsp::runtime
         size_t size() const;
 
     private:
-        RingBuffer<std::shared_ptr<AudioBlock>> ring_;
+        /** Bounds for the consumer's adaptive spin before it parks. */
+        static constexpr uint32_t kMinSpins = 16;
+        static constexpr uint32_t kMaxSpins = 1024;
+
+        void wake_parked();
+
+        RingBuffer<uint32_t> ring_;
+        // Futex word bumped on every wake-up and the consumer's parked flag.
+        std::atomic<uint32_t> wake_epoch_{0};
+        std::atomic<bool> parked_{false};
+        // Consumer-only: doubled when spinning finds a block, halved when not.
+        uint32_t spin_limit_{kMinSpins};
     };
 
 } // namespace echidna::dsp::runtime
@@ -0,0 +1,58 @@
+#include "correlation.h"
+
+/**
+ * @file correlation.cpp
+ * @brief Cross-correlation kernel with a four-lag vector body.
+ */
+
+#include "simd_lanes.h"
+
+namespace echidna::dsp::runtime
+{
+
+    void cross_correlation(const float *reference,
+                           const float *signal,
+                           size_t length,
+                           size_t lags,
+                           float *out)
+    {
+        size_t lag = 0;
+        // Each vector holds four adjacent lags, so one unaligned load of
+        // the signal serves all four against a broadcast reference sample.
+        // Two vectors per pass keep two independent accumulation chains.
+        for (; lag + 2 * lanes::kWidth <= lags; lag += 2 * lanes::kWidth)
+        {
+            lanes::Lanes low = lanes::splat(0.0f);
+            lanes::Lanes high = lanes::splat(0.0f);
+            const float *window = signal + lag;
+            for (size_t i = 0; i < length; ++i)
+            {
+                const lanes::Lanes r = lanes::splat(reference[i]);
+                low = lanes::add(low, lanes::mul(r, lanes::load(window + i)));
+                high = lanes::add(high, lanes::mul(r, lanes::load(window + i + lanes::kWidth)));
+            }
+            lanes::store(out + lag, low);
+            lanes::store(out + lag + lanes::kWidth, high);
+        }
+        for (; lag + lanes::kWidth <= lags; lag += lanes::kWidth)
+        {
+            lanes::Lanes acc = lanes::splat(0.0f);
+            const float *window = signal + lag;
+            for (size_t i = 0; i < length; ++i)
+            {
+                acc = lanes::add(acc, lanes::mul(lanes::splat(reference[i]), lanes::load(window + i)));
+            }
+            lanes::store(out + lag, acc);
+        }
+        for (; lag < lags; ++lag)
+        {
+            float acc = 0.0f;
+            for (size_t i = 0; i < length; ++i)
+            {
+                acc += reference[i] * signal[lag + i];
+            }
+            out[lag] = acc;
+        }
+    }
+
+} // namespace echidna::dsp::runtime
@@ -0,0 +1,28 @@
+#pragma once
+
+/**
+ * @file correlation.h
+ * @brief Vectorized cross-correlation over a range of lags, used by the
+ * time-domain pitch backend to find the best splice point.
+ */
+
+#include <cstddef>
+
+namespace echidna::dsp::runtime
+{
+
+    /**
+     * @brief out[lag] = sum over i < length of reference[i] * signal[lag + i],
+     * for every lag in [0, lags).
+     *
+     * `signal` must hold lags + length - 1 samples. Four lags are
+     * accumulated per vector on NEON and SSE, so the cost is
+     * lags * length / 4 multiply-adds plus a scalar tail.
+     */
+    void cross_correlation(const float *reference,
+                           const float *signal,
+                           size_t length,
+                           size_t lags,
+                           float *out);
+
+} // namespace echidna::dsp::runtime
@@ -0,0 +1,65 @@
+#include "dynamics.h"
+
+/**
+ * @file dynamics.cpp
+ * @brief Peak detector kernels and coefficient helpers for the dynamics
+ * effects.
+ */
+
+#if defined(ECHIDNA_DSP_HAS_NEON)
+#include <arm_neon.h>
+#elif defined(ECHIDNA_DSP_HAS_AVX) && defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+namespace echidna::dsp::runtime
+{
+
+    /** exp(-1 / samples-per-time-constant), measured in updates. */
+    float smoothing_coefficient(float ms, float updates_per_second)
+    {
+        const float updates = (ms / 1000.0f) * updates_per_second;
+        if (updates <= 1.0f)
+        {
+            return 0.0f;
+        }
+        return std::exp(-1.0f / updates);
+    }
+
+    /** Vectorized max(|x|); four lanes on NEON and SSE. */
+    float peak_abs(const float *samples, size_t count)
+    {
+        float peak = 0.0f;
+        size_t i = 0;
+#if defined(ECHIDNA_DSP_HAS_NEON)
+        if (count >= 4)
+        {
+            float32x4_t acc = vdupq_n_f32(0.0f);
+            for (; i + 4 <= count; i += 4)
+            {
+                acc = vmaxq_f32(acc, vabsq_f32(vld1q_f32(&samples[i])));
+            }
+            peak = vmaxvq_f32(acc);
+        }
+#elif defined(ECHIDNA_DSP_HAS_AVX) && defined(__SSE2__)
+        if (count >= 4)
+        {
+            const __m128 sign = _mm_set1_ps(-0.0f);
+            __m128 acc = _mm_setzero_ps();
+            for (; i + 4 <= count; i += 4)
+            {
+                acc = _mm_max_ps(acc, _mm_andnot_ps(sign, _mm_loadu_ps(&samples[i])));
+            }
+            acc = _mm_max_ps(acc, _mm_movehl_ps(acc, acc));
+            acc = _mm_max_ss(acc, _mm_shuffle_ps(acc, acc, 0x55));
+            peak = _mm_cvtss_f32(acc);
+        }
+#endif
+        for (; i < count; ++i)
+        {
+            peak = std::max(peak, std::abs(samples[i]));
+        }
+        return peak;
+    }
+
+} // namespace echidna::dsp::runtime
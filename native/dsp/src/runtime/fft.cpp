@@ -0,0 +1,372 @@
+#include "fft.h"
+
+/**
+ * @file fft.cpp
+ * @brief RealFft passes, real/complex split and the shared twiddle tables.
+ */
+
+#include <array>
+#include <bit>
+#include <cmath>
+#include <memory>
+#include <mutex>
+#include <numbers>
+
+#include "simd.h"
+#include "simd_lanes.h"
+
+namespace echidna::dsp::runtime
+{
+
+    /**
+     * @brief Twiddles for one real FFT size N (complex size M = N / 2).
+     *
+     * `stage` holds, for each radix-4 pass of length n, the factors
+     * W_n^p, W_n^2p, W_n^3p for p < n / 4 as six planar arrays (re, im per
+     * factor). `split_re` / `split_im` hold W_N^k for k <= M.
+     */
+    struct FftTables
+    {
+        size_t size{0};
+        size_t half{0};
+        std::vector<size_t> stage_offsets{};
+        std::vector<float, AlignedAllocator<float>> stage{};
+        std::vector<float, AlignedAllocator<float>> split_re{};
+        std::vector<float, AlignedAllocator<float>> split_im{};
+    };
+
+    namespace
+    {
+
+        using lanes::add;
+        using lanes::Lanes;
+        using lanes::load;
+        using lanes::mul;
+        using lanes::splat;
+        using lanes::store;
+        using lanes::sub;
+
+        constexpr size_t kTableCount =
+            std::countr_zero(RealFft::kMaxSize) - std::countr_zero(RealFft::kMinSize) + 1;
+
+        std::unique_ptr<FftTables> build_tables(size_t size)
+        {
+            auto tables = std::make_unique<FftTables>();
+            tables->size = size;
+            tables->half = size / 2;
+            const double tau = 2.0 * std::numbers::pi;
+            for (size_t n = tables->half; n >= 4; n /= 4)
+            {
+                const size_t m = n / 4;
+                const size_t offset = tables->stage.size();
+                tables->stage_offsets.push_back(offset);
+                tables->stage.resize(offset + 6 * m);
+                float *w = tables->stage.data() + offset;
+                for (size_t p = 0; p < m; ++p)
+                {
+                    for (size_t j = 1; j <= 3; ++j)
+                    {
+                        const double angle = -tau * static_cast<double>(j * p) / static_cast<double>(n);
+                        w[(2 * j - 2) * m + p] = static_cast<float>(std::cos(angle));
+                        w[(2 * j - 1) * m + p] = static_cast<float>(std::sin(angle));
+                    }
+                }
+            }
+            tables->split_re.resize(tables->half + 1);
+            tables->split_im.resize(tables->half + 1);
+            for (size_t k = 0; k <= tables->half; ++k)
+            {
+                const double angle = -tau * static_cast<double>(k) / static_cast<double>(size);
+                tables->split_re[k] = static_cast<float>(std::cos(angle));
+                tables->split_im[k] = static_cast<float>(std::sin(angle));
+            }
+            return tables;
+        }
+
+        /** Tables for `size`, built on first use and kept for the process. */
+        const FftTables *acquire_tables(size_t size)
+        {
+            static std::mutex mutex;
+            static std::array<std::unique_ptr<FftTables>, kTableCount> cache;
+            const size_t index = std::countr_zero(size) - std::countr_zero(RealFft::kMinSize);
+            std::lock_guard<std::mutex> lock(mutex);
+            if (!cache[index])
+            {
+                cache[index] = build_tables(size);
+            }
+            return cache[index].get();
+        }
+
+        /** Four complex values in planar lanes. */
+        struct Complex4
+        {
+            Lanes re;
+            Lanes im;
+        };
+
+        inline Complex4 load_complex(const float *re, const float *im, size_t index)
+        {
+            return {load(re + index), load(im + index)};
+        }
+
+        inline void store_complex(float *re, float *im, size_t index, Complex4 v)
+        {
+            store(re + index, v.re);
+            store(im + index, v.im);
+        }
+
+        inline Complex4 cmul(Complex4 a, Lanes wr, Lanes wi)
+        {
+            return {sub(mul(a.re, wr), mul(a.im, wi)), add(mul(a.re, wi), mul(a.im, wr))};
+        }
+
+        /**
+         * Forward radix-4 butterfly; outputs y1..y3 still need their
+         * twiddles.
+         */
+        inline void butterfly4(Complex4 a, Complex4 b, Complex4 c, Complex4 d, Complex4 y[4])
+        {
+            const Complex4 apc{add(a.re, c.re), add(a.im, c.im)};
+            const Complex4 amc{sub(a.re, c.re), sub(a.im, c.im)};
+            const Complex4 bpd{add(b.re, d.re), add(b.im, d.im)};
+            const Complex4 bmd{sub(b.re, d.re), sub(b.im, d.im)};
+            y[0] = {add(apc.re, bpd.re), add(apc.im, bpd.im)};
+            // amc -/+ i * bmd
+            y[1] = {add(amc.re, bmd.im), sub(amc.im, bmd.re)};
+            y[2] = {sub(apc.re, bpd.re), sub(apc.im, bpd.im)};
+            y[3] = {sub(amc.re, bmd.im), add(amc.im, bmd.re)};
+        }
+
+        /**
+         * First radix-4 pass (stride 1): vectorized over p, with the four
+         * outputs of each butterfly stored interleaved.
+         */
+        void radix4_first(const float *xr, const float *xi, float *yr, float *yi, size_t m, const float *w)
+        {
+            for (size_t p = 0; p < m; p += lanes::kWidth)
+            {
+                Complex4 y[4];
+                butterfly4(load_complex(xr, xi, p),
+                           load_complex(xr, xi, p + m),
+                           load_complex(xr, xi, p + 2 * m),
+                           load_complex(xr, xi, p + 3 * m),
+                           y);
+                y[1] = cmul(y[1], load(w + p), load(w + m + p));
+                y[2] = cmul(y[2], load(w + 2 * m + p), load(w + 3 * m + p));
+                y[3] = cmul(y[3], load(w + 4 * m + p), load(w + 5 * m + p));
+                lanes::store_interleaved(yr + 4 * p, y[0].re, y[1].re, y[2].re, y[3].re);
+                lanes::store_interleaved(yi + 4 * p, y[0].im, y[1].im, y[2].im, y[3].im);
+            }
+        }
+
+        /** Radix-4 pass with stride `s` >= 4: vectorized over q. */
+        void radix4_pass(const float *xr, const float *xi, float *yr, float *yi, size_t m, size_t s, const float *w)
+        {
+            for (size_t p = 0; p < m; ++p)
+            {
+                const Lanes w1r = splat(w[p]);
+                const Lanes w1i = splat(w[m + p]);
+                const Lanes w2r = splat(w[2 * m + p]);
+                const Lanes w2i = splat(w[3 * m + p]);
+                const Lanes w3r = splat(w[4 * m + p]);
+                const Lanes w3i = splat(w[5 * m + p]);
+                for (size_t q = 0; q < s; q += lanes::kWidth)
+                {
+                    Complex4 y[4];
+                    butterfly4(load_complex(xr, xi, q + s * p),
+                               load_complex(xr, xi, q + s * (p + m)),
+                               load_complex(xr, xi, q + s * (p + 2 * m)),
+                               load_complex(xr, xi, q + s * (p + 3 * m)),
+                               y);
+                    store_complex(yr, yi, q + s * (4 * p), y[0]);
+                    store_complex(yr, yi, q + s * (4 * p + 1), cmul(y[1], w1r, w1i));
+                    store_complex(yr, yi, q + s * (4 * p + 2), cmul(y[2], w2r, w2i));
+                    store_complex(yr, yi, q + s * (4 * p + 3), cmul(y[3], w3r, w3i));
+                }
+            }
+        }
+
+        /** Closing radix-2 pass (length 2, stride `s`), no twiddles. */
+        void radix2_last(const float *xr, const float *xi, float *yr, float *yi, size_t s)
+        {
+            for (size_t q = 0; q < s; q += lanes::kWidth)
+            {
+                const Complex4 a = load_complex(xr, xi, q);
+                const Complex4 b = load_complex(xr, xi, q + s);
+                store_complex(yr, yi, q, {add(a.re, b.re), add(a.im, b.im)});
+                store_complex(yr, yi, q + s, {sub(a.re, b.re), sub(a.im, b.im)});
+            }
+        }
+
+    } // namespace
+
+    /** Bind the shared tables and size the scratch buffers. */
+    bool RealFft::prepare(size_t size)
+    {
+        if (size < kMinSize || size > kMaxSize || !std::has_single_bit(size))
+        {
+            tables_ = nullptr;
+            size_ = 0;
+            return false;
+        }
+        tables_ = acquire_tables(size);
+        size_ = size;
+        work_.assign(2 * size, 0.0f);
+        return true;
+    }
+
+    /** Stockham passes over work buffer 0, ping-ponging with buffer 1. */
+    size_t RealFft::run_passes()
+    {
+        const size_t half = tables_->half;
+        size_t source = 0;
+        auto re = [&](size_t buffer) { return work_.data() + buffer * 2 * half; };
+        auto im = [&](size_t buffer) { return work_.data() + buffer * 2 * half + half; };
+
+        size_t stride = 1;
+        size_t stage = 0;
+        for (size_t n = half; n >= 4; n /= 4, ++stage)
+        {
+            const size_t m = n / 4;
+            const float *w = tables_->stage.data() + tables_->stage_offsets[stage];
+            if (stride == 1)
+            {
+                radix4_first(re(source), im(source), re(source ^ 1), im(source ^ 1), m, w);
+            }
+            else
+            {
+                radix4_pass(re(source), im(source), re(source ^ 1), im(source ^ 1), m, stride, w);
+            }
+            source ^= 1;
+            stride *= 4;
+        }
+        if (stride < half)
+        {
+            radix2_last(re(source), im(source), re(source ^ 1), im(source ^ 1), stride);
+            source ^= 1;
+        }
+        return source;
+    }
+
+    /**
+     * @brief Pack even/odd samples as one complex sequence, transform it and
+     * split the result into the spectrum of the real input.
+     *
+     * With Z = FFT(x[2n] + i x[2n+1]) and Z[M] = Z[0]:
+     * X[k] = (Z[k] + conj Z[M-k]) / 2 - i W^k (Z[k] - conj Z[M-k]) / 2.
+     */
+    void RealFft::forward(const float *input, float *re, float *im)
+    {
+        const size_t half = tables_->half;
+        float *const packed[2] = {work_.data(), work_.data() + half};
+        deinterleave(input, packed, half, 2);
+        const size_t result = run_passes();
+        const float *zr = work_.data() + result * 2 * half;
+        const float *zi = zr + half;
+        const float *wr = tables_->split_re.data();
+        const float *wi = tables_->split_im.data();
+
+        auto split_bin = [&](size_t k)
+        {
+            const size_t kk = k % half;
+            const size_t kc = (half - k) % half;
+            const float fe_r = 0.5f * (zr[kk] + zr[kc]);
+            const float fe_i = 0.5f * (zi[kk] - zi[kc]);
+            const float fo_r = 0.5f * (zi[kk] + zi[kc]);
+            const float fo_i = -0.5f * (zr[kk] - zr[kc]);
+            re[k] = fe_r + (wr[k] * fo_r - wi[k] * fo_i);
+            im[k] = fe_i + (wr[k] * fo_i + wi[k] * fo_r);
+        };
+
+        const Lanes one_half = splat(0.5f);
+        const Lanes minus_half = splat(-0.5f);
+        size_t k = 1;
+        for (; k + lanes::kWidth <= half - 3; k += lanes::kWidth)
+        {
+            const Lanes zkr = load(zr + k);
+            const Lanes zki = load(zi + k);
+            const Lanes zcr = lanes::reverse(load(zr + half - k - 3));
+            const Lanes zci = lanes::reverse(load(zi + half - k - 3));
+            const Lanes fe_r = mul(one_half, add(zkr, zcr));
+            const Lanes fe_i = mul(one_half, sub(zki, zci));
+            const Lanes fo_r = mul(one_half, add(zki, zci));
+            const Lanes fo_i = mul(minus_half, sub(zkr, zcr));
+            const Lanes w_r = load(wr + k);
+            const Lanes w_i = load(wi + k);
+            store(re + k, add(fe_r, sub(mul(w_r, fo_r), mul(w_i, fo_i))));
+            store(im + k, add(fe_i, add(mul(w_r, fo_i), mul(w_i, fo_r))));
+        }
+        split_bin(0);
+        for (; k <= half; ++k)
+        {
+            split_bin(k);
+        }
+    }
+
+    /**
+     * @brief Rebuild the packed complex spectrum, run the passes on its
+     * conjugate and unpack the even/odd samples.
+     *
+     * Z[k] = (X[k] + conj X[M-k]) / 2 + i conj(W^k) (X[k] - conj X[M-k]) / 2,
+     * and IFFT(Z) = conj(FFT(conj Z)) / M.
+     */
+    void RealFft::inverse(const float *re, const float *im, float *output)
+    {
+        const size_t half = tables_->half;
+        float *zr = work_.data();
+        float *zi = work_.data() + half;
+        const float *wr = tables_->split_re.data();
+        const float *wi = tables_->split_im.data();
+
+        // Writes conj(Z[k]); the DC and Nyquist imaginary parts are dropped.
+        auto pack_bin = [&](size_t k)
+        {
+            const size_t kc = half - k;
+            const float xk_i = (k == 0) ? 0.0f : im[k];
+            const float xc_i = (kc == half) ? 0.0f : im[kc];
+            const float fe_r = 0.5f * (re[k] + re[kc]);
+            const float fe_i = 0.5f * (xk_i - xc_i);
+            const float d_r = re[k] - re[kc];
+            const float d_i = xk_i + xc_i;
+            const float fo_r = 0.5f * (d_r * wr[k] + d_i * wi[k]);
+            const float fo_i = 0.5f * (d_i * wr[k] - d_r * wi[k]);
+            zr[k] = fe_r - fo_i;
+            zi[k] = -(fe_i + fo_r);
+        };
+
+        const Lanes one_half = splat(0.5f);
+        size_t k = 1;
+        for (; k + lanes::kWidth <= half - 3; k += lanes::kWidth)
+        {
+            const Lanes xkr = load(re + k);
+            const Lanes xki = load(im + k);
+            const Lanes xcr = lanes::reverse(load(re + half - k - 3));
+            const Lanes xci = lanes::reverse(load(im + half - k - 3));
+            const Lanes fe_r = mul(one_half, add(xkr, xcr));
+            const Lanes fe_i = mul(one_half, sub(xki, xci));
+            const Lanes d_r = sub(xkr, xcr);
+            const Lanes d_i = add(xki, xci);
+            const Lanes w_r = load(wr + k);
+            const Lanes w_i = load(wi + k);
+            const Lanes fo_r = mul(one_half, add(mul(d_r, w_r), mul(d_i, w_i)));
+            const Lanes fo_i = mul(one_half, sub(mul(d_i, w_r), mul(d_r, w_i)));
+            store(zr + k, sub(fe_r, fo_i));
+            store(zi + k, lanes::neg(add(fe_i, fo_r)));
+        }
+        pack_bin(0);
+        for (; k < half; ++k)
+        {
+            pack_bin(k);
+        }
+
+        const size_t result = run_passes();
+        float *out_r = work_.data() + result * 2 * half;
+        float *out_i = out_r + half;
+        const float scale = 1.0f / static_cast<float>(half);
+        apply_gain(out_r, half, scale);
+        apply_gain(out_i, half, -scale);
+        const float *const packed[2] = {out_r, out_i};
+        interleave(packed, output, half, 2);
+    }
+
+} // namespace echidna::dsp::runtime
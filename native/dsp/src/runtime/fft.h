@@ -0,0 +1,74 @@
+#pragma once
+
+/**
+ * @file fft.h
+ * @brief Real-input FFT / IFFT for power-of-two sizes with planar complex
+ * spectra.
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "planar_buffer.h"
+
+namespace echidna::dsp::runtime
+{
+
+    struct FftTables;
+
+    /**
+     * @brief Real FFT of one power-of-two size between kMinSize and kMaxSize.
+     *
+     * A size-N transform runs as a size-N/2 complex FFT (radix-4 Stockham
+     * passes, plus one radix-2 pass when needed) followed by a split into
+     * N/2 + 1 bins. The twiddle tables for each size are built once per
+     * process and shared by every RealFft of that size. Each instance owns
+     * only its scratch buffers, so forward() and inverse() never allocate
+     * and separate instances can run on separate threads.
+     */
+    class RealFft
+    {
+    public:
+        static constexpr size_t kMinSize = 64;
+        static constexpr size_t kMaxSize = 8192;
+
+        /**
+         * Prepare for transforms of `size` real samples. Returns false (and
+         * leaves the instance unprepared) when `size` is not a power of two
+         * within [kMinSize, kMaxSize].
+         */
+        bool prepare(size_t size);
+
+        /** Transform size, or 0 when unprepared. */
+        size_t size() const { return size_; }
+        /** Bins per spectrum: size() / 2 + 1. */
+        size_t bins() const { return size_ / 2 + 1; }
+
+        /**
+         * @brief Spectrum of `input` (size() samples).
+         *
+         * `re` and `im` receive bins() values; bin 0 is DC and the last bin
+         * is Nyquist. The transform is unscaled.
+         */
+        void forward(const float *input, float *re, float *im);
+
+        /**
+         * @brief Samples from a spectrum of bins() values, scaled by
+         * 1 / size() so inverse(forward(x)) reproduces x.
+         *
+         * The imaginary parts of the DC and Nyquist bins are ignored.
+         */
+        void inverse(const float *re, const float *im, float *output);
+
+    private:
+        /** Run the complex passes; returns the buffer index holding the result. */
+        size_t run_passes();
+
+        const FftTables *tables_{nullptr};
+        size_t size_{0};
+        /** Two ping-pong complex buffers of size() / 2 points (re, im). */
+        std::vector<float, AlignedAllocator<float>> work_{};
+    };
+
+} // namespace echidna::dsp::runtime
@@ -0,0 +1,72 @@
+#include "futex.h"
+
+/**
+ * @file futex.cpp
+ * @brief futex_wait/futex_wake implementation.
+ */
+
+#include <algorithm>
+#include <thread>
+
+#if defined(__ANDROID__) || defined(__linux__)
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+#endif
+
+namespace echidna::dsp::runtime
+{
+
+    static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t),
+                  "futex words must be plain 32-bit integers");
+
+    void futex_wait(std::atomic<uint32_t> &word,
+                    uint32_t expected,
+                    std::chrono::microseconds timeout)
+    {
+        if (timeout.count() <= 0)
+        {
+            return;
+        }
+#if defined(__ANDROID__) || defined(__linux__)
+        const auto seconds = std::chrono::duration_cast<std::chrono::seconds>(timeout);
+        struct timespec relative{};
+        relative.tv_sec = static_cast<time_t>(seconds.count());
+        relative.tv_nsec = static_cast<long>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(timeout - seconds).count());
+        // Private: the word never crosses a process boundary.
+        syscall(SYS_futex,
+                reinterpret_cast<uint32_t *>(&word),
+                FUTEX_WAIT_PRIVATE,
+                expected,
+                &relative,
+                nullptr,
+                0);
+#else
+        // No portable timed address wait; poll at a coarse interval instead.
+        constexpr auto kPollInterval = std::chrono::microseconds(500);
+        if (word.load(std::memory_order_acquire) == expected)
+        {
+            std::this_thread::sleep_for(std::min(timeout, kPollInterval));
+        }
+#endif
+    }
+
+    void futex_wake(std::atomic<uint32_t> &word, int count)
+    {
+#if defined(__ANDROID__) || defined(__linux__)
+        syscall(SYS_futex,
+                reinterpret_cast<uint32_t *>(&word),
+                FUTEX_WAKE_PRIVATE,
+                count,
+                nullptr,
+                nullptr,
+                0);
+#else
+        (void)word;
+        (void)count;
+#endif
+    }
+
+} // namespace echidna::dsp::runtime
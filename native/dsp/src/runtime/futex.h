@@ -0,0 +1,34 @@
+#pragma once
+
+/**
+ * @file futex.h
+ * @brief Minimal address-based wait/wake primitives used to park idle DSP
+ * threads. Linux and Android use the futex syscall; other hosts fall back to
+ * a short sleep.
+ */
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+namespace echidna::dsp::runtime
+{
+
+    /**
+     * @brief Sleep while `*word == expected`, for at most `timeout`.
+     *
+     * Returns early on a futex_wake() for the same word, on a value mismatch
+     * or spuriously; callers must re-check their condition.
+     */
+    void futex_wait(std::atomic<uint32_t> &word,
+                    uint32_t expected,
+                    std::chrono::microseconds timeout);
+
+    /**
+     * @brief Wake up to `count` threads parked in futex_wait() on `word`.
+     *
+     * Never blocks, so it is safe to call from an audio callback.
+     */
+    void futex_wake(std::atomic<uint32_t> &word, int count);
+
+} // namespace echidna::dsp::runtime
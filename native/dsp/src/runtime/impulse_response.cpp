@@ -0,0 +1,194 @@
+#include "impulse_response.h"
+
+/**
+ * @file impulse_response.cpp
+ * @brief Built-in responses, resampling and partitioning of the impulse
+ * response library.
+ */
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+
+#include "fft.h"
+
+namespace echidna::dsp::runtime
+{
+    namespace
+    {
+        /** Rate the built-in responses are synthesised at. */
+        constexpr uint32_t kBuiltInRate = 48000;
+
+        struct BuiltIn
+        {
+            const char *id;
+            float rt60_seconds;
+            /** One-pole low-pass coefficient at the start and end of the tail. */
+            float damping_start;
+            float damping_end;
+            /** Early reflections (ms) ahead of the diffuse tail; 0 ends the list. */
+            float reflections_ms[6];
+        };
+
+        constexpr BuiltIn kBuiltIns[] = {
+            {"room", 0.5f, 0.2f, 0.7f, {4.3f, 7.9f, 11.3f, 16.1f, 21.7f, 0.0f}},
+            {"plate", 1.2f, 0.05f, 0.4f, {0.0f}},
+            {"hall", 1.8f, 0.3f, 0.85f, {11.0f, 19.3f, 27.1f, 37.9f, 0.0f}},
+        };
+
+        /**
+         * Exponentially decaying noise, darkening over the tail, after a few
+         * early reflections; long enough to decay by 60 dB.
+         */
+        std::vector<float> Synthesise(const BuiltIn &spec)
+        {
+            const auto frames = static_cast<size_t>(spec.rt60_seconds * kBuiltInRate);
+            std::vector<float> samples(frames, 0.0f);
+            const auto onset = static_cast<size_t>(0.002f * kBuiltInRate);
+            uint32_t seed = 0x52455642u;
+            float lowpass = 0.0f;
+            for (size_t n = onset; n < frames; ++n)
+            {
+                const float t = static_cast<float>(n) / static_cast<float>(frames);
+                seed = seed * 1664525u + 1013904223u;
+                const float noise = static_cast<float>(seed >> 8) / 8388608.0f - 1.0f;
+                const float damping = spec.damping_start + (spec.damping_end - spec.damping_start) * t;
+                lowpass = noise * (1.0f - damping) + lowpass * damping;
+                const float seconds = static_cast<float>(n) / static_cast<float>(kBuiltInRate);
+                samples[n] = lowpass * std::pow(10.0f, -3.0f * seconds / spec.rt60_seconds);
+            }
+            float gain = 1.0f;
+            for (float ms : spec.reflections_ms)
+            {
+                if (ms == 0.0f)
+                {
+                    break;
+                }
+                const auto at = static_cast<size_t>(ms * 0.001f * kBuiltInRate);
+                samples[at] += gain;
+                gain *= -0.7f;
+            }
+            return samples;
+        }
+    } // namespace
+
+    ImpulseResponseLibrary &ImpulseResponseLibrary::instance()
+    {
+        static ImpulseResponseLibrary library;
+        return library;
+    }
+
+    ImpulseResponseLibrary::ImpulseResponseLibrary()
+    {
+        for (const BuiltIn &spec : kBuiltIns)
+        {
+            sources_[spec.id] = Source{Synthesise(spec), kBuiltInRate};
+        }
+    }
+
+    bool ImpulseResponseLibrary::add(std::string_view id,
+                                     const float *samples,
+                                     size_t frames,
+                                     uint32_t sample_rate)
+    {
+        if (id.empty() || id.size() > kMaxIdLength || samples == nullptr || frames == 0 ||
+            sample_rate == 0 || static_cast<double>(frames) > kMaxSeconds * sample_rate)
+        {
+            return false;
+        }
+        bool audible = false;
+        for (size_t n = 0; n < frames; ++n)
+        {
+            if (!std::isfinite(samples[n]))
+            {
+                return false;
+            }
+            audible = audible || samples[n] != 0.0f;
+        }
+        if (!audible)
+        {
+            return false;
+        }
+
+        Source source{std::vector<float>(samples, samples + frames), sample_rate};
+        std::lock_guard lock(mutex_);
+        for (auto it = cache_.begin(); it != cache_.end();)
+        {
+            it = std::get<0>(it->first) == id ? cache_.erase(it) : std::next(it);
+        }
+        sources_.insert_or_assign(std::string(id), std::move(source));
+        return true;
+    }
+
+    bool ImpulseResponseLibrary::contains(std::string_view id) const
+    {
+        std::lock_guard lock(mutex_);
+        return sources_.find(id) != sources_.end();
+    }
+
+    std::shared_ptr<const PartitionedImpulseResponse> ImpulseResponseLibrary::partitioned(
+        std::string_view id,
+        uint32_t sample_rate,
+        size_t partition_frames)
+    {
+        RealFft fft;
+        if (sample_rate == 0 || !std::has_single_bit(partition_frames) || !fft.prepare(2 * partition_frames))
+        {
+            return nullptr;
+        }
+        std::lock_guard lock(mutex_);
+        const auto source = sources_.find(id);
+        if (source == sources_.end())
+        {
+            return nullptr;
+        }
+        CacheKey key{std::string(id), sample_rate, partition_frames};
+        if (const auto cached = cache_.find(key); cached != cache_.end())
+        {
+            return cached->second;
+        }
+
+        // Resample to the engine rate and normalise to unit energy, so the
+        // wet signal of white noise is as loud as the input.
+        const std::vector<float> &input = source->second.samples;
+        const double step = static_cast<double>(source->second.sample_rate) / sample_rate;
+        const auto frames = std::max<size_t>(1, static_cast<size_t>(std::ceil(input.size() / step)));
+        std::vector<float> samples(frames);
+        double energy = 0.0;
+        for (size_t n = 0; n < frames; ++n)
+        {
+            const double position = static_cast<double>(n) * step;
+            const auto index = static_cast<size_t>(position);
+            const float a = index < input.size() ? input[index] : 0.0f;
+            const float b = index + 1 < input.size() ? input[index + 1] : 0.0f;
+            samples[n] = a + (b - a) * static_cast<float>(position - static_cast<double>(index));
+            energy += static_cast<double>(samples[n]) * samples[n];
+        }
+        const float scale = energy > 0.0 ? static_cast<float>(1.0 / std::sqrt(energy)) : 0.0f;
+
+        auto result = std::make_shared<PartitionedImpulseResponse>();
+        constexpr size_t kStrideAlign = kPlanarAlignment / sizeof(float);
+        result->partition_frames = partition_frames;
+        result->partitions = (frames + partition_frames - 1) / partition_frames;
+        result->bins = fft.bins();
+        result->stride = (result->bins + kStrideAlign - 1) / kStrideAlign * kStrideAlign;
+        result->frames = frames;
+        result->re.assign(result->partitions * result->stride, 0.0f);
+        result->im.assign(result->partitions * result->stride, 0.0f);
+        std::vector<float> block(2 * partition_frames, 0.0f);
+        for (size_t p = 0; p < result->partitions; ++p)
+        {
+            const size_t begin = p * partition_frames;
+            const size_t count = std::min(partition_frames, frames - begin);
+            std::fill(block.begin(), block.end(), 0.0f);
+            for (size_t n = 0; n < count; ++n)
+            {
+                block[n] = samples[begin + n] * scale;
+            }
+            fft.forward(block.data(), result->re.data() + p * result->stride, result->im.data() + p * result->stride);
+        }
+        cache_.emplace(std::move(key), result);
+        return result;
+    }
+
+} // namespace echidna::dsp::runtime
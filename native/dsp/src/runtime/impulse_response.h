@@ -0,0 +1,105 @@
+#pragma once
+
+/**
+ * @file impulse_response.h
+ * @brief Process-wide library of named impulse responses and the
+ * partitioned spectra the convolution reverb multiplies with.
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <vector>
+
+#include "planar_buffer.h"
+
+namespace echidna::dsp::runtime
+{
+
+    /**
+     * @brief An impulse response cut into equal partitions, each zero-padded
+     * to twice its length and transformed, for one sample rate.
+     *
+     * Immutable once built; engines share it read-only.
+     */
+    struct PartitionedImpulseResponse
+    {
+        /** Frames per partition; the transform size is twice this. */
+        size_t partition_frames{0};
+        size_t partitions{0};
+        /** Complex bins per partition: partition_frames + 1. */
+        size_t bins{0};
+        /** Floats between partitions in re and im (bins rounded up to the SIMD width). */
+        size_t stride{0};
+        /** Impulse response length in frames at this sample rate. */
+        size_t frames{0};
+        std::vector<float, AlignedAllocator<float>> re{};
+        std::vector<float, AlignedAllocator<float>> im{};
+    };
+
+    /**
+     * @brief Named mono impulse responses, shared by every engine in the
+     * process.
+     *
+     * The library starts with the synthetic "room", "plate" and "hall"
+     * responses; add() registers more or replaces one. partitioned() resamples
+     * a response to the engine rate (linear interpolation), normalises it to
+     * unit energy and transforms it once per (id, sample rate, partition
+     * size); later calls return the same spectra. Replacing a response drops
+     * its cached spectra, while engines that already hold them keep using
+     * them until their next preset update.
+     *
+     * Every method may allocate and locks a mutex: call them only from
+     * control threads.
+     */
+    class ImpulseResponseLibrary
+    {
+    public:
+        static constexpr size_t kMaxIdLength = 64;
+        /** Longest accepted response, in seconds at its own rate. */
+        static constexpr double kMaxSeconds = 8.0;
+
+        /** The process-wide library. */
+        static ImpulseResponseLibrary &instance();
+
+        /**
+         * @brief Register `frames` samples at `sample_rate` as `id`.
+         *
+         * Returns false, leaving the library unchanged, for an empty or
+         * overlong id, no samples, a non-finite sample, a silent response or
+         * one longer than kMaxSeconds.
+         */
+        bool add(std::string_view id, const float *samples, size_t frames, uint32_t sample_rate);
+        /** True if `id` names a registered response. */
+        bool contains(std::string_view id) const;
+
+        /**
+         * @brief Spectra of `id` at `sample_rate` in partitions of
+         * `partition_frames` (a power of two the FFT supports at twice the
+         * size), or nullptr for an unknown id or unsupported size.
+         */
+        std::shared_ptr<const PartitionedImpulseResponse> partitioned(std::string_view id,
+                                                                      uint32_t sample_rate,
+                                                                      size_t partition_frames);
+
+    private:
+        struct Source
+        {
+            std::vector<float> samples;
+            uint32_t sample_rate{0};
+        };
+        using CacheKey = std::tuple<std::string, uint32_t, size_t>;
+
+        ImpulseResponseLibrary();
+
+        mutable std::mutex mutex_;
+        std::map<std::string, Source, std::less<>> sources_;
+        std::map<CacheKey, std::shared_ptr<const PartitionedImpulseResponse>> cache_;
+    };
+
+} // namespace echidna::dsp::runtime
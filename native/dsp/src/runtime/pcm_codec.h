@@ -0,0 +1,187 @@
+#pragma once
+
+/**
+ * @file pcm_codec.h
+ * @brief Conversion between interleaved PCM and normalised float samples,
+ * shared by the DSP bridge, the legacy effect and every capture route.
+ *
+ * PcmTraits<> is the per-sample definition of each encoding; decode_pcm()
+ * and encode_pcm() run a whole block through the variant simd.h selected,
+ * which matches the traits exactly. Buffers are native-endian and need no
+ * alignment.
+ *
+ * Signed encodings decode as code / 2^(bits-1). Encoding clamps to [-1, 1],
+ * scales by 2^(bits-1) - 1 and rounds half away from zero, and -1 maps to
+ * the most negative code. Unsigned 8-bit is offset by 128 on decode and
+ * spans 0 … 255 on encode.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+
+namespace echidna::dsp::runtime
+{
+
+    /** Interleaved PCM sample encodings, in the order of the codec tables. */
+    enum class PcmEncoding : uint8_t
+    {
+        kUnsigned8,
+        kSigned16,
+        kSigned24Packed,
+        kSigned32,
+        kFloat32,
+    };
+
+    inline constexpr size_t kPcmEncodingCount = 5;
+
+    /**
+     * Per-encoding storage and quantisation. `Code` is the integer (or float)
+     * value stored in `kBytes` bytes.
+     */
+    template <PcmEncoding Encoding>
+    struct PcmTraits;
+
+    template <>
+    struct PcmTraits<PcmEncoding::kUnsigned8>
+    {
+        using Code = uint8_t;
+        static constexpr size_t kBytes = 1;
+
+        static Code load(const uint8_t *bytes) { return bytes[0]; }
+        static void store(Code code, uint8_t *bytes) { bytes[0] = code; }
+        static float dequantize(Code code) { return (static_cast<float>(code) - 128.0f) * (1.0f / 128.0f); }
+        static Code quantize(float sample)
+        {
+            const float clamped = std::clamp(sample, -1.0f, 1.0f);
+            return static_cast<Code>(std::clamp(std::lround((clamped * 127.5f) + 127.5f), 0l, 255l));
+        }
+    };
+
+    template <>
+    struct PcmTraits<PcmEncoding::kSigned16>
+    {
+        using Code = int16_t;
+        static constexpr size_t kBytes = 2;
+
+        static Code load(const uint8_t *bytes)
+        {
+            Code code;
+            std::memcpy(&code, bytes, sizeof(code));
+            return code;
+        }
+        static void store(Code code, uint8_t *bytes) { std::memcpy(bytes, &code, sizeof(code)); }
+        static float dequantize(Code code) { return static_cast<float>(code) * (1.0f / 32768.0f); }
+        static Code quantize(float sample)
+        {
+            const float clamped = std::clamp(sample, -1.0f, 1.0f);
+            if (clamped <= -1.0f)
+            {
+                return std::numeric_limits<Code>::min();
+            }
+            return static_cast<Code>(std::lround(clamped * 32767.0f));
+        }
+    };
+
+    template <>
+    struct PcmTraits<PcmEncoding::kSigned24Packed>
+    {
+        using Code = int32_t;
+        static constexpr size_t kBytes = 3;
+
+        static Code load(const uint8_t *bytes)
+        {
+            uint32_t value = static_cast<uint32_t>(bytes[0]) | (static_cast<uint32_t>(bytes[1]) << 8) |
+                             (static_cast<uint32_t>(bytes[2]) << 16);
+            if ((value & 0x00800000u) != 0)
+            {
+                value |= 0xff000000u;
+            }
+            return static_cast<Code>(value);
+        }
+        static void store(Code code, uint8_t *bytes)
+        {
+            const uint32_t value = static_cast<uint32_t>(code);
+            bytes[0] = static_cast<uint8_t>(value & 0xffu);
+            bytes[1] = static_cast<uint8_t>((value >> 8) & 0xffu);
+            bytes[2] = static_cast<uint8_t>((value >> 16) & 0xffu);
+        }
+        static float dequantize(Code code) { return static_cast<float>(code) * (1.0f / 8388608.0f); }
+        static Code quantize(float sample)
+        {
+            const float clamped = std::clamp(sample, -1.0f, 1.0f);
+            if (clamped <= -1.0f)
+            {
+                return -8388608;
+            }
+            return static_cast<Code>(std::lround(clamped * 8388607.0f));
+        }
+    };
+
+    template <>
+    struct PcmTraits<PcmEncoding::kSigned32>
+    {
+        using Code = int32_t;
+        static constexpr size_t kBytes = 4;
+
+        static Code load(const uint8_t *bytes)
+        {
+            Code code;
+            std::memcpy(&code, bytes, sizeof(code));
+            return code;
+        }
+        static void store(Code code, uint8_t *bytes) { std::memcpy(bytes, &code, sizeof(code)); }
+        static float dequantize(Code code) { return static_cast<float>(code) * (1.0f / 2147483648.0f); }
+        /** Scaled in double: float cannot hold 2^31 - 1. */
+        static Code quantize(float sample)
+        {
+            const double clamped = std::clamp(static_cast<double>(sample), -1.0, 1.0);
+            if (clamped <= -1.0)
+            {
+                return std::numeric_limits<Code>::min();
+            }
+            return static_cast<Code>(std::llround(clamped * 2147483647.0));
+        }
+    };
+
+    template <>
+    struct PcmTraits<PcmEncoding::kFloat32>
+    {
+        using Code = float;
+        static constexpr size_t kBytes = 4;
+
+        static Code load(const uint8_t *bytes)
+        {
+            Code code;
+            std::memcpy(&code, bytes, sizeof(code));
+            return code;
+        }
+        static void store(Code code, uint8_t *bytes) { std::memcpy(bytes, &code, sizeof(code)); }
+        static float dequantize(Code code) { return code; }
+        /** Float output is passed through unclamped. */
+        static Code quantize(float sample) { return sample; }
+    };
+
+    /** Bytes per sample, or 0 for an unknown encoding. */
+    size_t pcm_bytes_per_sample(PcmEncoding encoding);
+
+    /**
+     * @brief Decode `samples` PCM values from `src` into `dst`.
+     *
+     * Returns false when a float32 sample is NaN or infinite (integer codes
+     * always decode to finite values) or the encoding is unknown; `dst` is
+     * then unspecified.
+     */
+    bool decode_pcm(PcmEncoding encoding, const void *src, float *dst, size_t samples);
+
+    /**
+     * @brief Encode `samples` floats from `src` into `dst`, saturating at full
+     * scale. Inputs must be finite: the capture routes check before they
+     * write, so a rejected block never reaches the caller's buffer.
+     */
+    void encode_pcm(PcmEncoding encoding, const float *src, void *dst, size_t samples);
+
+} // namespace echidna::dsp::runtime
@@ -0,0 +1,233 @@
+#include "pitch_detector.h"
+
+/**
+ * @file pitch_detector.cpp
+ * @brief YIN pitch detection with FFT-based correlation and optional
+ * decimation.
+ */
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+
+namespace echidna::dsp::runtime
+{
+    namespace
+    {
+        /** RBJ low-pass section at `cutoff_hz` with quality factor `q`. */
+        BiquadCoefficients low_pass(float sample_rate, float cutoff_hz, float q)
+        {
+            constexpr double kPi = 3.14159265358979323846;
+            const double w0 = 2.0 * kPi * static_cast<double>(cutoff_hz) / static_cast<double>(sample_rate);
+            const double alpha = std::sin(w0) / (2.0 * static_cast<double>(q));
+            const double cos_w0 = std::cos(w0);
+            const double a0 = 1.0 + alpha;
+            BiquadCoefficients c;
+            c.b0 = static_cast<float>((1.0 - cos_w0) / 2.0 / a0);
+            c.b1 = static_cast<float>((1.0 - cos_w0) / a0);
+            c.b2 = c.b0;
+            c.a1 = static_cast<float>(-2.0 * cos_w0 / a0);
+            c.a2 = static_cast<float>((1.0 - alpha) / a0);
+            return c;
+        }
+    } // namespace
+
+    bool YinPitchDetector::prepare(uint32_t sample_rate, const PitchDetectorSettings &settings)
+    {
+        if (sample_rate == 0 || !(settings.min_hz > 0.0f) || !(settings.max_hz > settings.min_hz))
+        {
+            return false;
+        }
+        decimation_ = settings.analysis_rate_hz == 0
+                          ? 1
+                          : std::max<uint32_t>(1, sample_rate / settings.analysis_rate_hz);
+        analysis_rate_ = static_cast<float>(sample_rate) / static_cast<float>(decimation_);
+        min_lag_ = std::max<size_t>(2, static_cast<size_t>(analysis_rate_ / settings.max_hz));
+        max_lag_ = static_cast<size_t>(std::ceil(analysis_rate_ / settings.min_hz));
+        window_ = 2 * max_lag_;
+        const size_t fft_size = std::max(RealFft::kMinSize, std::bit_ceil(window_));
+        if (min_lag_ >= max_lag_ || !fft_.prepare(fft_size))
+        {
+            window_ = 0;
+            return false;
+        }
+
+        // Fourth-order Butterworth at 40 % of the decimated rate keeps the
+        // voice band and stops aliases folding onto the fundamental.
+        anti_alias_.configure(1, 2);
+        if (decimation_ > 1)
+        {
+            const float cutoff = 0.4f * analysis_rate_;
+            const BiquadCoefficients sections[2] = {
+                low_pass(static_cast<float>(sample_rate), cutoff, 0.54119610f),
+                low_pass(static_cast<float>(sample_rate), cutoff, 1.30656296f),
+            };
+            anti_alias_.set_coefficients(sections, 0);
+        }
+
+        ring_.assign(window_, 0.0f);
+        frame_.assign(fft_size, 0.0f);
+        head_.assign(fft_size, 0.0f);
+        frame_re_.assign(fft_.bins(), 0.0f);
+        frame_im_.assign(fft_.bins(), 0.0f);
+        head_re_.assign(fft_.bins(), 0.0f);
+        head_im_.assign(fft_.bins(), 0.0f);
+        correlation_.assign(fft_size, 0.0f);
+        difference_.assign(max_lag_ + 2, 0.0f);
+        prefix_energy_.assign(window_ + 1, 0.0);
+        reset();
+        return true;
+    }
+
+    void YinPitchDetector::reset()
+    {
+        anti_alias_.reset();
+        std::fill(ring_.begin(), ring_.end(), 0.0f);
+        decimation_phase_ = 0;
+        write_ = 0;
+        filled_ = 0;
+    }
+
+    void YinPitchDetector::push(const float *samples, size_t frames)
+    {
+        if (window_ == 0)
+        {
+            return;
+        }
+        auto store = [&](float sample)
+        {
+            ring_[write_] = sample;
+            write_ = write_ + 1 == window_ ? 0 : write_ + 1;
+            filled_ = std::min(filled_ + 1, window_);
+        };
+        if (decimation_ == 1)
+        {
+            for (size_t i = 0; i < frames; ++i)
+            {
+                store(samples[i]);
+            }
+            return;
+        }
+        for (size_t offset = 0; offset < frames; offset += kChunk)
+        {
+            const size_t count = std::min(kChunk, frames - offset);
+            std::copy_n(samples + offset, count, chunk_.data());
+            float *channel = chunk_.data();
+            anti_alias_.process(&channel, count);
+            for (size_t i = 0; i < count; ++i)
+            {
+                if (decimation_phase_ == 0)
+                {
+                    store(chunk_[i]);
+                }
+                decimation_phase_ = decimation_phase_ + 1 == decimation_ ? 0 : decimation_phase_ + 1;
+            }
+        }
+    }
+
+    float YinPitchDetector::estimate()
+    {
+        if (window_ == 0 || filled_ < window_)
+        {
+            return 0.0f;
+        }
+
+        // Unroll the ring, oldest first, without its mean.
+        const size_t newest_run = window_ - write_;
+        std::copy_n(ring_.begin() + static_cast<std::ptrdiff_t>(write_), newest_run, frame_.begin());
+        std::copy_n(ring_.begin(), write_, frame_.begin() + static_cast<std::ptrdiff_t>(newest_run));
+        double mean = 0.0;
+        for (size_t i = 0; i < window_; ++i)
+        {
+            mean += frame_[i];
+        }
+        mean /= static_cast<double>(window_);
+        prefix_energy_[0] = 0.0;
+        for (size_t i = 0; i < window_; ++i)
+        {
+            frame_[i] -= static_cast<float>(mean);
+            prefix_energy_[i + 1] = prefix_energy_[i] + static_cast<double>(frame_[i]) * frame_[i];
+        }
+        if (prefix_energy_[window_] / static_cast<double>(window_) < 1.0e-8)
+        {
+            return 0.0f;
+        }
+
+        // r(tau) = sum_{j < W} x[j] x[j + tau] for tau <= max_lag_, with
+        // W = max_lag_: the transform size holds W + max_lag_ samples, so
+        // the circular correlation does not wrap into those lags.
+        const size_t integration = max_lag_;
+        std::fill(frame_.begin() + static_cast<std::ptrdiff_t>(window_), frame_.end(), 0.0f);
+        std::copy_n(frame_.begin(), integration, head_.begin());
+        std::fill(head_.begin() + static_cast<std::ptrdiff_t>(integration), head_.end(), 0.0f);
+        fft_.forward(frame_.data(), frame_re_.data(), frame_im_.data());
+        fft_.forward(head_.data(), head_re_.data(), head_im_.data());
+        for (size_t k = 0; k < fft_.bins(); ++k)
+        {
+            // conj(head) * frame
+            const float re = head_re_[k] * frame_re_[k] + head_im_[k] * frame_im_[k];
+            const float im = head_re_[k] * frame_im_[k] - head_im_[k] * frame_re_[k];
+            frame_re_[k] = re;
+            frame_im_[k] = im;
+        }
+        fft_.inverse(frame_re_.data(), frame_im_.data(), correlation_.data());
+
+        // Cumulative-mean-normalized difference d'(tau).
+        const double head_energy = prefix_energy_[integration];
+        double running = 0.0;
+        difference_[0] = 1.0f;
+        for (size_t lag = 1; lag <= max_lag_; ++lag)
+        {
+            const double lagged_energy = prefix_energy_[lag + integration] - prefix_energy_[lag];
+            const double d = std::max(0.0, head_energy + lagged_energy - 2.0 * correlation_[lag]);
+            running += d;
+            difference_[lag] = running > 0.0 ? static_cast<float>(d * static_cast<double>(lag) / running) : 1.0f;
+        }
+
+        // First dip under the threshold, followed to its minimum; otherwise
+        // the global minimum if it is periodic enough.
+        size_t best = 0;
+        for (size_t lag = min_lag_; lag <= max_lag_; ++lag)
+        {
+            if (difference_[lag] < kThreshold)
+            {
+                while (lag + 1 <= max_lag_ && difference_[lag + 1] < difference_[lag])
+                {
+                    ++lag;
+                }
+                best = lag;
+                break;
+            }
+        }
+        if (best == 0)
+        {
+            best = min_lag_;
+            for (size_t lag = min_lag_ + 1; lag <= max_lag_; ++lag)
+            {
+                if (difference_[lag] < difference_[best])
+                {
+                    best = lag;
+                }
+            }
+            if (difference_[best] > kVoicingLimit)
+            {
+                return 0.0f;
+            }
+        }
+
+        float period = static_cast<float>(best);
+        if (best > min_lag_ && best < max_lag_)
+        {
+            const float previous = difference_[best - 1];
+            const float current = difference_[best];
+            const float next = difference_[best + 1];
+            const float denominator = previous - 2.0f * current + next;
+            if (std::abs(denominator) > 1.0e-12f)
+            {
+                period += std::clamp(0.5f * (previous - next) / denominator, -0.5f, 0.5f);
+            }
+        }
+        return analysis_rate_ / period;
+    }
+
+} // namespace echidna::dsp::runtime
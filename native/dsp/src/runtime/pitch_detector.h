@@ -0,0 +1,108 @@
+#pragma once
+
+/**
+ * @file pitch_detector.h
+ * @brief Streaming monophonic pitch detectors: a common interface and a YIN
+ * implementation built on the real FFT.
+ */
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "biquad_cascade.h"
+#include "fft.h"
+
+namespace echidna::dsp::runtime
+{
+
+    /** Search range and analysis rate shared by the pitch detectors. */
+    struct PitchDetectorSettings
+    {
+        float min_hz{60.0f};
+        float max_hz{1000.0f};
+        /**
+         * Rate the detector analyses at. The input is low-passed and
+         * decimated by the largest integer factor that stays at or above
+         * this rate; 0 analyses at the input rate.
+         */
+        uint32_t analysis_rate_hz{12000};
+    };
+
+    /**
+     * @brief A pitch detector fed one mono stream.
+     *
+     * push() is called with every block and keeps whatever history the
+     * detector needs; estimate() analyses the most recent window. Both run
+     * on the audio thread and must not allocate once prepare() succeeded.
+     */
+    class PitchDetector
+    {
+    public:
+        virtual ~PitchDetector() = default;
+        /** Size all state; returns false for an unusable configuration. */
+        virtual bool prepare(uint32_t sample_rate, const PitchDetectorSettings &settings) = 0;
+        /** Forget all history. */
+        virtual void reset() = 0;
+        /** Append `frames` mono samples. */
+        virtual void push(const float *samples, size_t frames) = 0;
+        /** Fundamental (Hz) of the latest window, or 0 when unvoiced. */
+        virtual float estimate() = 0;
+    };
+
+    /**
+     * @brief YIN detector (de Cheveigné & Kawahara) with the difference
+     * function evaluated through FFT cross-correlation.
+     *
+     * The window spans two periods of min_hz. Its squared-difference
+     * function d(tau) = e(0) + e(tau) - 2 r(tau) takes the energies from
+     * prefix sums and the correlation r from one forward transform of the
+     * window, one of its first half and one inverse, O(N log N) instead of
+     * O(N * lags). Input is decimated as it arrives, so each sample is
+     * filtered once however often estimate() runs.
+     */
+    class YinPitchDetector final : public PitchDetector
+    {
+    public:
+        /** Cumulative-mean-normalized difference that accepts a dip. */
+        static constexpr float kThreshold = 0.15f;
+        /** Above this normalized difference the window is unvoiced. */
+        static constexpr float kVoicingLimit = 0.35f;
+
+        bool prepare(uint32_t sample_rate, const PitchDetectorSettings &settings) override;
+        void reset() override;
+        void push(const float *samples, size_t frames) override;
+        float estimate() override;
+
+        /** Rate of the analysed signal after decimation. */
+        float analysis_rate() const { return analysis_rate_; }
+
+    private:
+        static constexpr size_t kChunk = 256;
+
+        uint32_t decimation_{1};
+        uint32_t decimation_phase_{0};
+        float analysis_rate_{0.0f};
+        size_t min_lag_{0};
+        size_t max_lag_{0};
+        size_t window_{0};
+        size_t write_{0};
+        size_t filled_{0};
+        BiquadCascade anti_alias_{};
+        RealFft fft_{};
+        std::array<float, kChunk> chunk_{};
+        /** Ring of the last window_ decimated samples. */
+        std::vector<float> ring_{};
+        std::vector<float> frame_{};
+        std::vector<float> head_{};
+        std::vector<float> frame_re_{};
+        std::vector<float> frame_im_{};
+        std::vector<float> head_re_{};
+        std::vector<float> head_im_{};
+        std::vector<float> correlation_{};
+        std::vector<float> difference_{};
+        std::vector<double> prefix_energy_{};
+    };
+
+} // namespace echidna::dsp::runtime
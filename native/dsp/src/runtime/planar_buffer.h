@@ -0,0 +1,99 @@
+#pragma once
+
+/**
+ * @file planar_buffer.h
+ * @brief Cache-line aligned storage for deinterleaved (planar) audio, plus
+ * the aligned allocator it is built on.
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <vector>
+
+namespace echidna::dsp::runtime
+{
+
+    /** Bytes every channel span of a PlanarBuffer is aligned to. */
+    inline constexpr size_t kPlanarAlignment = 64;
+
+    /**
+     * @brief Minimal std::allocator replacement returning `Alignment`-aligned
+     * storage, for buffers SIMD kernels load with aligned instructions.
+     */
+    template <typename T, size_t Alignment = kPlanarAlignment>
+    struct AlignedAllocator
+    {
+        using value_type = T;
+
+        template <typename U>
+        struct rebind
+        {
+            using other = AlignedAllocator<U, Alignment>;
+        };
+
+        AlignedAllocator() = default;
+        template <typename U>
+        AlignedAllocator(const AlignedAllocator<U, Alignment> &) noexcept
+        {
+        }
+
+        T *allocate(size_t count)
+        {
+            return static_cast<T *>(
+                ::operator new(count * sizeof(T), std::align_val_t{Alignment}));
+        }
+
+        void deallocate(T *pointer, size_t) noexcept
+        {
+            ::operator delete(pointer, std::align_val_t{Alignment});
+        }
+
+        template <typename U>
+        bool operator==(const AlignedAllocator<U, Alignment> &) const noexcept
+        {
+            return true;
+        }
+    };
+
+    /**
+     * @brief Per-channel contiguous sample spans in one aligned allocation.
+     *
+     * Every channel starts on a kPlanarAlignment boundary. Storage only
+     * grows, so a buffer sized before the audio thread starts never
+     * allocates on it.
+     */
+    class PlanarBuffer
+    {
+    public:
+        /** Grow to hold `frames` samples for each of `channels` channels. */
+        void ensure(uint32_t channels, size_t frames)
+        {
+            constexpr size_t kFloatsPerLine = kPlanarAlignment / sizeof(float);
+            const size_t stride = (frames + kFloatsPerLine - 1) / kFloatsPerLine * kFloatsPerLine;
+            if (channels == channels_.size() && stride <= stride_)
+            {
+                return;
+            }
+            storage_.assign(stride * channels, 0.0f);
+            channels_.resize(channels);
+            for (uint32_t ch = 0; ch < channels; ++ch)
+            {
+                channels_[ch] = storage_.data() + ch * stride;
+            }
+            stride_ = stride;
+        }
+
+        /** Channel span pointers, suitable for ProcessContext::planar. */
+        float *const *channels() const { return channels_.data(); }
+        float *channel(uint32_t ch) const { return channels_[ch]; }
+        /** Frames each channel span can hold. */
+        size_t capacity_frames() const { return stride_; }
+
+    private:
+        std::vector<float, AlignedAllocator<float>> storage_;
+        std::vector<float *> channels_;
+        size_t stride_{0};
+    };
+
+} // namespace echidna::dsp::runtime
@@ -3,7 +3,8 @@
 /**
  * @file ring_buffer.h
  * @brief Lock-free single-producer single-consumer ring buffer template used by
- * the BlockQueue implementation for passing shared_ptr blocks between threads.
+ * the BlockQueue implementation for passing AudioBlockPool indices between
+ * threads.
  */
 
 #include <atomic>
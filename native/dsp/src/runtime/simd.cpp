@@ -2,100 +2,472 @@
 
 /**
  * @file simd.cpp
- * @brief Platform-optimized implementations for SIMD helper functions.
+ * @brief CPU feature probe, kernel dispatch and the scalar kernel variants.
  */
 
 #include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cmath>
 
-#if defined(ECHIDNA_DSP_HAS_NEON)
-#include <arm_neon.h>
-#elif defined(ECHIDNA_DSP_HAS_AVX) && defined(__AVX__)
+#include "pcm_codec.h"
+#include "simd_dispatch.h"
+
+#if defined(ECHIDNA_DSP_HAS_AVX)
+#if defined(_MSC_VER)
 #include <immintrin.h>
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
 #endif
 
 namespace echidna::dsp::runtime
 {
-
-    /**
-     * @brief Apply gain to the provided buffer.
-     */
-    void apply_gain(float *data, size_t samples, float gain)
+    namespace
     {
-#if defined(ECHIDNA_DSP_HAS_NEON)
-        const float32x4_t gain_vec = vdupq_n_f32(gain);
-        size_t i = 0;
-        for (; i + 4 <= samples; i += 4)
+        void apply_gain_scalar(float *data, size_t samples, float gain)
+        {
+            for (size_t i = 0; i < samples; ++i)
+            {
+                data[i] *= gain;
+            }
+        }
+
+        void mix_in_scalar(float *dst, const float *src, size_t samples, float gain)
         {
-            float32x4_t x = vld1q_f32(&data[i]);
-            x = vmulq_f32(x, gain_vec);
-            vst1q_f32(&data[i], x);
+            for (size_t i = 0; i < samples; ++i)
+            {
+                dst[i] += src[i] * gain;
+            }
         }
-        for (; i < samples; ++i)
+
+        void crossfade_scalar(const float *dry,
+                              const float *wet,
+                              float *output,
+                              size_t samples,
+                              float dry_gain,
+                              float wet_gain,
+                              float output_gain)
         {
-            data[i] *= gain;
+            for (size_t i = 0; i < samples; ++i)
+            {
+                output[i] = (dry[i] * dry_gain + wet[i] * wet_gain) * output_gain;
+            }
         }
-#elif defined(ECHIDNA_DSP_HAS_AVX) && defined(__AVX__)
-        const __m256 gain_vec = _mm256_set1_ps(gain);
-        size_t i = 0;
-        for (; i + 8 <= samples; i += 8)
+
+        BlockScan scan_block_scalar(const float *data, size_t samples, const float *reference)
         {
-            __m256 x = _mm256_loadu_ps(&data[i]);
-            x = _mm256_mul_ps(x, gain_vec);
-            _mm256_storeu_ps(&data[i], x);
+            BlockScan scan;
+            scan_tail(data, samples, reference, scan);
+            return scan;
         }
-        for (; i < samples; ++i)
+
+        bool all_finite_scalar(const float *data, size_t samples)
         {
-            data[i] *= gain;
+            for (size_t i = 0; i < samples; ++i)
+            {
+                if (!std::isfinite(data[i]))
+                {
+                    return false;
+                }
+            }
+            return true;
         }
+
+        bool reencode_s16_scalar(const float *processed,
+                                 const float *decoded,
+                                 const int16_t *original,
+                                 int16_t *dst,
+                                 size_t samples)
+        {
+            bool changed = false;
+            for (size_t i = 0; i < samples; ++i)
+            {
+                const int16_t before = original[i];
+                const bool touched =
+                    std::bit_cast<uint32_t>(processed[i]) != std::bit_cast<uint32_t>(decoded[i]);
+                const int16_t after = touched ? encode_s16(processed[i]) : before;
+                changed = changed || after != before;
+                dst[i] = after;
+            }
+            return changed;
+        }
+
+        void deinterleave_stereo_scalar(const float *interleaved, float *left, float *right, size_t frames)
+        {
+            for (size_t frame = 0; frame < frames; ++frame)
+            {
+                left[frame] = interleaved[frame * 2];
+                right[frame] = interleaved[frame * 2 + 1];
+            }
+        }
+
+        void interleave_stereo_scalar(const float *left, const float *right, float *interleaved, size_t frames)
+        {
+            for (size_t frame = 0; frame < frames; ++frame)
+            {
+                interleaved[frame * 2] = left[frame];
+                interleaved[frame * 2 + 1] = right[frame];
+            }
+        }
+
+        constexpr uint32_t level_bit(SimdLevel level)
+        {
+            return 1u << static_cast<uint32_t>(level);
+        }
+
+#if defined(ECHIDNA_DSP_HAS_AVX)
+        struct CpuidRegisters
+        {
+            uint32_t eax{0};
+            uint32_t ebx{0};
+            uint32_t ecx{0};
+            uint32_t edx{0};
+        };
+
+        CpuidRegisters cpuid(uint32_t leaf, uint32_t subleaf)
+        {
+            CpuidRegisters regs;
+#if defined(_MSC_VER)
+            int values[4] = {};
+            __cpuidex(values, static_cast<int>(leaf), static_cast<int>(subleaf));
+            regs.eax = static_cast<uint32_t>(values[0]);
+            regs.ebx = static_cast<uint32_t>(values[1]);
+            regs.ecx = static_cast<uint32_t>(values[2]);
+            regs.edx = static_cast<uint32_t>(values[3]);
 #else
-        for (size_t i = 0; i < samples; ++i)
+            unsigned int a = 0;
+            unsigned int b = 0;
+            unsigned int c = 0;
+            unsigned int d = 0;
+            if (__get_cpuid_count(leaf, subleaf, &a, &b, &c, &d) != 0)
+            {
+                regs = CpuidRegisters{a, b, c, d};
+            }
+#endif
+            return regs;
+        }
+
+        /** XCR0: which register files the OS saves on a context switch. */
+        uint64_t enabled_xstate()
+        {
+#if defined(_MSC_VER)
+            return _xgetbv(0);
+#else
+            uint32_t low = 0;
+            uint32_t high = 0;
+            __asm__ volatile("xgetbv" : "=a"(low), "=d"(high) : "c"(0));
+            return (static_cast<uint64_t>(high) << 32) | low;
+#endif
+        }
+
+        uint32_t probe_features()
         {
-            data[i] *= gain;
+            uint32_t features = 0;
+            const CpuidRegisters basic = cpuid(0, 0);
+            if (basic.eax < 1)
+            {
+                return features;
+            }
+            const CpuidRegisters leaf1 = cpuid(1, 0);
+            if ((leaf1.ecx & (1u << 19)) != 0)
+            {
+                features |= level_bit(SimdLevel::kSse41);
+            }
+            // AVX state must be enabled by the OS (OSXSAVE + XCR0), not just
+            // present in the CPU.
+            const bool osxsave = (leaf1.ecx & (1u << 27)) != 0;
+            const bool avx = (leaf1.ecx & (1u << 28)) != 0;
+            if (!osxsave || !avx || basic.eax < 7)
+            {
+                return features;
+            }
+            const uint64_t xstate = enabled_xstate();
+            const CpuidRegisters leaf7 = cpuid(7, 0);
+            constexpr uint64_t kYmmState = 0x6;
+            constexpr uint64_t kZmmState = 0xe6;
+            if ((xstate & kYmmState) == kYmmState && (leaf7.ebx & (1u << 5)) != 0)
+            {
+                features |= level_bit(SimdLevel::kAvx2);
+            }
+            if ((xstate & kZmmState) == kZmmState && (leaf7.ebx & (1u << 16)) != 0)
+            {
+                features |= level_bit(SimdLevel::kAvx512);
+            }
+            return features;
         }
+#elif defined(ECHIDNA_DSP_HAS_NEON)
+        uint32_t probe_features()
+        {
+            // Advanced SIMD is mandatory on AArch64.
+            return level_bit(SimdLevel::kNeon);
+        }
+#else
+        uint32_t probe_features()
+        {
+            return 0;
+        }
+#endif
+
+        /** Table for `level`, or nullptr when this build does not carry it. */
+        const SimdKernels *kernels_for(SimdLevel level)
+        {
+            switch (level)
+            {
+            case SimdLevel::kScalar:
+                return &kScalarKernels;
+#if defined(ECHIDNA_DSP_HAS_AVX)
+            case SimdLevel::kSse41:
+                return &kSse41Kernels;
+            case SimdLevel::kAvx2:
+                return &kAvx2Kernels;
+            case SimdLevel::kAvx512:
+                return &kAvx512Kernels;
+#endif
+#if defined(ECHIDNA_DSP_HAS_NEON)
+            case SimdLevel::kNeon:
+                return &kNeonKernels;
 #endif
+            default:
+                return nullptr;
+            }
+        }
+
+        uint32_t cpu_features()
+        {
+            static const uint32_t features = level_bit(SimdLevel::kScalar) | probe_features();
+            return features;
+        }
+
+        std::atomic<const SimdKernels *> g_kernels{nullptr};
+        std::atomic<SimdLevel> g_level{SimdLevel::kScalar};
+
+        const SimdKernels &kernels()
+        {
+            const SimdKernels *table = g_kernels.load(std::memory_order_acquire);
+            if (table == nullptr)
+            {
+                // Only reachable from another static initializer that runs
+                // before the one below.
+                force_simd_level(detected_simd_level());
+                table = g_kernels.load(std::memory_order_acquire);
+            }
+            return *table;
+        }
+
+        /** Probe and fill the table at load so no audio callback pays for it. */
+        [[maybe_unused]] const bool g_dispatch_ready = (kernels(), true);
+    } // namespace
+
+    const SimdKernels kScalarKernels{
+        apply_gain_scalar,
+        mix_in_scalar,
+        crossfade_scalar,
+        scan_block_scalar,
+        all_finite_scalar,
+        {decode_pcm_scalar<PcmEncoding::kUnsigned8>,
+         decode_pcm_scalar<PcmEncoding::kSigned16>,
+         decode_pcm_scalar<PcmEncoding::kSigned24Packed>,
+         decode_pcm_scalar<PcmEncoding::kSigned32>,
+         decode_pcm_scalar<PcmEncoding::kFloat32>},
+        {encode_pcm_scalar<PcmEncoding::kUnsigned8>,
+         encode_pcm_scalar<PcmEncoding::kSigned16>,
+         encode_pcm_scalar<PcmEncoding::kSigned24Packed>,
+         encode_pcm_scalar<PcmEncoding::kSigned32>,
+         encode_pcm_scalar<PcmEncoding::kFloat32>},
+        reencode_s16_scalar,
+        deinterleave_stereo_scalar,
+        interleave_stereo_scalar,
+    };
+
+    const char *simd_level_name(SimdLevel level)
+    {
+        switch (level)
+        {
+        case SimdLevel::kScalar:
+            return "scalar";
+        case SimdLevel::kSse41:
+            return "sse4.1";
+        case SimdLevel::kAvx2:
+            return "avx2";
+        case SimdLevel::kAvx512:
+            return "avx512";
+        case SimdLevel::kNeon:
+            return "neon";
+        }
+        return "unknown";
+    }
+
+    bool simd_level_supported(SimdLevel level)
+    {
+        return (cpu_features() & level_bit(level)) != 0 && kernels_for(level) != nullptr;
+    }
+
+    SimdLevel detected_simd_level()
+    {
+        static const SimdLevel detected = []()
+        {
+            SimdLevel best = SimdLevel::kScalar;
+            for (SimdLevel level : {SimdLevel::kSse41,
+                                    SimdLevel::kAvx2,
+                                    SimdLevel::kAvx512,
+                                    SimdLevel::kNeon})
+            {
+                if (simd_level_supported(level))
+                {
+                    best = level;
+                }
+            }
+            return best;
+        }();
+        return detected;
+    }
+
+    SimdLevel active_simd_level()
+    {
+        kernels();
+        return g_level.load(std::memory_order_relaxed);
+    }
+
+    bool force_simd_level(SimdLevel level)
+    {
+        if (!simd_level_supported(level))
+        {
+            return false;
+        }
+        g_level.store(level, std::memory_order_relaxed);
+        g_kernels.store(kernels_for(level), std::memory_order_release);
+        return true;
+    }
+
+    void apply_gain(float *data, size_t samples, float gain)
+    {
+        kernels().apply_gain(data, samples, gain);
+    }
+
+    void mix_in(float *dst, const float *src, size_t samples, float gain)
+    {
+        kernels().mix_in(dst, src, samples, gain);
+    }
+
+    void crossfade(const float *dry,
+                   const float *wet,
+                   float *output,
+                   size_t samples,
+                   float dry_gain,
+                   float wet_gain,
+                   float output_gain)
+    {
+        kernels().crossfade(dry, wet, output, samples, dry_gain, wet_gain, output_gain);
+    }
+
+    BlockScan scan_block(const float *data, size_t samples, const float *reference)
+    {
+        return kernels().scan_block(data, samples, reference);
+    }
+
+    bool all_finite(const float *data, size_t samples)
+    {
+        return kernels().all_finite(data, samples);
+    }
+
+    size_t pcm_bytes_per_sample(PcmEncoding encoding)
+    {
+        switch (encoding)
+        {
+        case PcmEncoding::kUnsigned8:
+            return PcmTraits<PcmEncoding::kUnsigned8>::kBytes;
+        case PcmEncoding::kSigned16:
+            return PcmTraits<PcmEncoding::kSigned16>::kBytes;
+        case PcmEncoding::kSigned24Packed:
+            return PcmTraits<PcmEncoding::kSigned24Packed>::kBytes;
+        case PcmEncoding::kSigned32:
+            return PcmTraits<PcmEncoding::kSigned32>::kBytes;
+        case PcmEncoding::kFloat32:
+            return PcmTraits<PcmEncoding::kFloat32>::kBytes;
+        }
+        return 0;
+    }
+
+    bool decode_pcm(PcmEncoding encoding, const void *src, float *dst, size_t samples)
+    {
+        const auto index = static_cast<size_t>(encoding);
+        return index < kPcmEncodingCount && kernels().decode_pcm[index](src, dst, samples);
+    }
+
+    void encode_pcm(PcmEncoding encoding, const float *src, void *dst, size_t samples)
+    {
+        const auto index = static_cast<size_t>(encoding);
+        if (index < kPcmEncodingCount)
+        {
+            kernels().encode_pcm[index](src, dst, samples);
+        }
+    }
+
+    bool reencode_s16(const float *processed,
+                      const float *decoded,
+                      const int16_t *original,
+                      int16_t *dst,
+                      size_t samples)
+    {
+        return kernels().reencode_s16(processed, decoded, original, dst, samples);
     }
 
     /**
-     * @brief Mix src into dst with the specified gain (dst += src * gain).
+     * @brief Deinterleave into per-channel spans; stereo has a dedicated kernel.
      */
-    void mix_in(float *dst, const float *src, size_t samples, float gain)
+    void deinterleave(const float *interleaved,
+                      float *const *channels,
+                      size_t frames,
+                      uint32_t channel_count)
     {
-#if defined(ECHIDNA_DSP_HAS_NEON)
-        const float32x4_t gain_vec = vdupq_n_f32(gain);
-        size_t i = 0;
-        for (; i + 4 <= samples; i += 4)
+        if (channel_count == 1)
         {
-            float32x4_t d = vld1q_f32(&dst[i]);
-            float32x4_t s = vld1q_f32(&src[i]);
-            s = vmulq_f32(s, gain_vec);
-            d = vaddq_f32(d, s);
-            vst1q_f32(&dst[i], d);
+            std::copy_n(interleaved, frames, channels[0]);
+            return;
         }
-        for (; i < samples; ++i)
+        if (channel_count == 2)
         {
-            dst[i] += src[i] * gain;
+            kernels().deinterleave_stereo(interleaved, channels[0], channels[1], frames);
+            return;
         }
-#elif defined(ECHIDNA_DSP_HAS_AVX) && defined(__AVX__)
-        const __m256 gain_vec = _mm256_set1_ps(gain);
-        size_t i = 0;
-        for (; i + 8 <= samples; i += 8)
+        for (uint32_t ch = 0; ch < channel_count; ++ch)
         {
-            __m256 d = _mm256_loadu_ps(&dst[i]);
-            __m256 s = _mm256_loadu_ps(&src[i]);
-            s = _mm256_mul_ps(s, gain_vec);
-            d = _mm256_add_ps(d, s);
-            _mm256_storeu_ps(&dst[i], d);
+            float *dst = channels[ch];
+            for (size_t frame = 0; frame < frames; ++frame)
+            {
+                dst[frame] = interleaved[frame * channel_count + ch];
+            }
         }
-        for (; i < samples; ++i)
+    }
+
+    /**
+     * @brief Interleave per-channel spans; stereo has a dedicated kernel.
+     */
+    void interleave(const float *const *channels,
+                    float *interleaved,
+                    size_t frames,
+                    uint32_t channel_count)
+    {
+        if (channel_count == 1)
         {
-            dst[i] += src[i] * gain;
+            std::copy_n(channels[0], frames, interleaved);
+            return;
         }
-#else
-        for (size_t i = 0; i < samples; ++i)
+        if (channel_count == 2)
         {
-            dst[i] += src[i] * gain;
+            kernels().interleave_stereo(channels[0], channels[1], interleaved, frames);
+            return;
+        }
+        for (uint32_t ch = 0; ch < channel_count; ++ch)
+        {
+            const float *src = channels[ch];
+            for (size_t frame = 0; frame < frames; ++frame)
+            {
+                interleaved[frame * channel_count + ch] = src[frame];
+            }
         }
-#endif
     }
 
 } // namespace echidna::dsp::runtime
@@ -2,15 +2,50 @@
 
 /**
  * @file simd.h
- * @brief Small SIMD utility helpers used across the DSP pipeline. Implementations
- * will use platform optimized intrinsics when available.
+ * @brief SIMD kernel library shared by the DSP pipeline and the capture
+ * bridge: gain and mixing, block metering, PCM16 re-encoding and
+ * (de)interleaving. The PCM codec in pcm_codec.h dispatches through the same
+ * tables.
+ *
+ * Each helper dispatches through a kernel table chosen once at load from the
+ * CPU features the build can use (cpuid on x86-64, AT_HWCAP on AArch64), so a
+ * generic x86-64 build still runs the AVX2 or AVX-512 loops on hosts that
+ * have them.
  */
 
 #include <cstddef>
+#include <cstdint>
 
 namespace echidna::dsp::runtime
 {
 
+    /** Instruction-set variants of the kernels below. */
+    enum class SimdLevel : uint8_t
+    {
+        kScalar,
+        kSse41,
+        kAvx2,
+        kAvx512,
+        kNeon,
+    };
+
+    /** Short lowercase name for reports ("scalar", "avx2", ...). */
+    const char *simd_level_name(SimdLevel level);
+    /** True when this build carries `level` and the CPU can execute it. */
+    bool simd_level_supported(SimdLevel level);
+    /** Best supported level, probed once at load. */
+    SimdLevel detected_simd_level();
+    /** Level the kernels currently dispatch to. */
+    SimdLevel active_simd_level();
+    /**
+     * @brief Route every kernel to `level`, e.g. to test or benchmark one
+     * variant. Safe while other threads are inside a kernel: each call reads
+     * the table once.
+     * @return false, leaving the selection unchanged, when `level` is not
+     * supported.
+     */
+    bool force_simd_level(SimdLevel level);
+
     /**
      * @brief Multiply each sample by a scalar gain in-place.
      * @param data Pointer to sample buffer with at least `samples` elements.
@@ -24,5 +59,70 @@ namespace echidna::dsp::runtime
      * dst[i] += src[i] * gain for i in [0, samples)
      */
     void mix_in(float *dst, const float *src, size_t samples, float gain);
+    /**
+     * @brief Dry/wet crossfade followed by an output gain, in one pass.
+     *
+     * output[i] = (dry[i] * dry_gain + wet[i] * wet_gain) * output_gain.
+     * `output` may alias `dry` or `wet`.
+     */
+    void crossfade(const float *dry,
+                   const float *wet,
+                   float *output,
+                   size_t samples,
+                   float dry_gain,
+                   float wet_gain,
+                   float output_gain);
+
+    /** Result of scan_block(). */
+    struct BlockScan
+    {
+        /** max |x|; meaningless when `finite` is false. */
+        float peak{0.0f};
+        /** Sum of x² accumulated in double; meaningless when `finite` is false. */
+        double sum_squares{0.0};
+        /** No sample is NaN or infinite. */
+        bool finite{true};
+        /** Some sample's bit pattern differs from the reference. */
+        bool changed{false};
+    };
+    /**
+     * @brief Peak, energy, finiteness and bitwise change against `reference`
+     * (when non-null) in a single read of the block.
+     */
+    BlockScan scan_block(const float *data, size_t samples, const float *reference = nullptr);
+    /** True when no sample is NaN or infinite. */
+    bool all_finite(const float *data, size_t samples);
+
+    /**
+     * @brief int16 encode_pcm() (see pcm_codec.h) that keeps `original[i]`
+     * wherever `processed[i]` is bit-identical to `decoded[i]`, so untouched
+     * samples survive the lossy round trip. Inputs must be finite; `dst` may
+     * alias `original`.
+     * @return true when any written sample differs from `original`.
+     */
+    bool reencode_s16(const float *processed,
+                      const float *decoded,
+                      const int16_t *original,
+                      int16_t *dst,
+                      size_t samples);
+
+    /**
+     * @brief Split interleaved samples into per-channel spans.
+     *
+     * channels[ch][frame] = interleaved[frame * channel_count + ch]
+     */
+    void deinterleave(const float *interleaved,
+                      float *const *channels,
+                      size_t frames,
+                      uint32_t channel_count);
+    /**
+     * @brief Merge per-channel spans into interleaved samples.
+     *
+     * interleaved[frame * channel_count + ch] = channels[ch][frame]
+     */
+    void interleave(const float *const *channels,
+                    float *interleaved,
+                    size_t frames,
+                    uint32_t channel_count);
 
 } // namespace echidna::dsp::runtime
@@ -0,0 +1,144 @@
+#pragma once
+
+/**
+ * @file simd_dispatch.h
+ * @brief Per-instruction-set kernel tables behind the functions in simd.h.
+ *
+ * Only include this from ech_dsp_simd translation units: which tables exist
+ * depends on the ECHIDNA_DSP_HAS_* definitions that are private to that
+ * target. Each table is constant-initialized, so it can be selected before
+ * any dynamic initializer has run.
+ */
+
+#include <bit>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+
+#include "pcm_codec.h"
+#include "simd.h"
+
+namespace echidna::dsp::runtime
+{
+
+    /** One variant of every dispatched kernel. */
+    struct SimdKernels
+    {
+        void (*apply_gain)(float *data, size_t samples, float gain);
+        void (*mix_in)(float *dst, const float *src, size_t samples, float gain);
+        void (*crossfade)(const float *dry,
+                          const float *wet,
+                          float *output,
+                          size_t samples,
+                          float dry_gain,
+                          float wet_gain,
+                          float output_gain);
+        BlockScan (*scan_block)(const float *data, size_t samples, const float *reference);
+        bool (*all_finite)(const float *data, size_t samples);
+        /** Indexed by PcmEncoding; decode reports whether every sample was finite. */
+        bool (*decode_pcm[kPcmEncodingCount])(const void *src, float *dst, size_t samples);
+        void (*encode_pcm[kPcmEncodingCount])(const float *src, void *dst, size_t samples);
+        bool (*reencode_s16)(const float *processed,
+                             const float *decoded,
+                             const int16_t *original,
+                             int16_t *dst,
+                             size_t samples);
+        void (*deinterleave_stereo)(const float *interleaved, float *left, float *right, size_t frames);
+        void (*interleave_stereo)(const float *left, const float *right, float *interleaved, size_t frames);
+    };
+
+    /** The int16 quantiser shared by every variant's tail loop. */
+    inline int16_t encode_s16(float sample)
+    {
+        return PcmTraits<PcmEncoding::kSigned16>::quantize(sample);
+    }
+
+    /**
+     * Scalar codec loops: the scalar table's entries, the tails of the vector
+     * variants, and the variant for encodings an instruction set leaves alone.
+     */
+    template <PcmEncoding Encoding>
+    bool decode_pcm_scalar(const void *src, float *dst, size_t samples)
+    {
+        using Traits = PcmTraits<Encoding>;
+        const auto *bytes = static_cast<const uint8_t *>(src);
+        if constexpr (Encoding == PcmEncoding::kFloat32)
+        {
+            std::memcpy(dst, bytes, samples * sizeof(float));
+            bool finite = true;
+            for (size_t i = 0; i < samples; ++i)
+            {
+                finite = finite && std::isfinite(dst[i]);
+            }
+            return finite;
+        }
+        else
+        {
+            for (size_t i = 0; i < samples; ++i)
+            {
+                dst[i] = Traits::dequantize(Traits::load(bytes + i * Traits::kBytes));
+            }
+            return true;
+        }
+    }
+
+    template <PcmEncoding Encoding>
+    void encode_pcm_scalar(const float *src, void *dst, size_t samples)
+    {
+        using Traits = PcmTraits<Encoding>;
+        auto *bytes = static_cast<uint8_t *>(dst);
+        if constexpr (Encoding == PcmEncoding::kFloat32)
+        {
+            std::memmove(bytes, src, samples * sizeof(float));
+        }
+        else
+        {
+            for (size_t i = 0; i < samples; ++i)
+            {
+                Traits::store(Traits::quantize(src[i]), bytes + i * Traits::kBytes);
+            }
+        }
+    }
+
+    /** Byte offset of sample `index`, for handing a tail to the scalar loops. */
+    template <PcmEncoding Encoding>
+    constexpr size_t pcm_offset(size_t index)
+    {
+        return index * PcmTraits<Encoding>::kBytes;
+    }
+
+    /** Scalar tail of scan_block(), folded into `scan`. */
+    inline void scan_tail(const float *data, size_t samples, const float *reference, BlockScan &scan)
+    {
+        for (size_t i = 0; i < samples; ++i)
+        {
+            const float sample = data[i];
+            scan.finite = scan.finite && std::isfinite(sample);
+            const float magnitude = std::fabs(sample);
+            scan.peak = magnitude > scan.peak ? magnitude : scan.peak;
+            scan.sum_squares += static_cast<double>(sample) * static_cast<double>(sample);
+            if (reference != nullptr && !scan.changed)
+            {
+                scan.changed = std::bit_cast<uint32_t>(sample) != std::bit_cast<uint32_t>(reference[i]);
+            }
+        }
+    }
+
+    /** Portable loops; the compiler may still auto-vectorize them for the baseline ISA. */
+    extern const SimdKernels kScalarKernels;
+
+#if defined(ECHIDNA_DSP_HAS_AVX)
+    // Built with per-function target attributes so the baseline build flags
+    // stay at SSE2; only call these after the CPU probe has cleared them.
+    extern const SimdKernels kSse41Kernels;
+    extern const SimdKernels kAvx2Kernels;
+    extern const SimdKernels kAvx512Kernels;
+#endif
+
+#if defined(ECHIDNA_DSP_HAS_NEON)
+    extern const SimdKernels kNeonKernels;
+#endif
+
+} // namespace echidna::dsp::runtime
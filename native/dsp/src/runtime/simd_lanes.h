@@ -0,0 +1,118 @@
+#pragma once
+
+/**
+ * @file simd_lanes.h
+ * @brief Four-lane float vector wrapper over NEON / SSE with a scalar
+ * fallback, for the runtime kernels.
+ *
+ * Only include this from ech_dsp_core translation units: the lane type
+ * depends on the ECHIDNA_DSP_HAS_* definitions that are private to that
+ * target.
+ */
+
+#include <cstddef>
+#include <cstdint>
+
+#if defined(ECHIDNA_DSP_HAS_NEON)
+#include <arm_neon.h>
+#elif defined(ECHIDNA_DSP_HAS_AVX) && defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+namespace echidna::dsp::runtime::lanes
+{
+
+    /** Floats per Lanes value. */
+    inline constexpr uint32_t kWidth = 4;
+
+    // Multiplies and adds stay separate (no fused multiply-add) so every
+    // lane rounds exactly like the equivalent scalar expression.
+#if defined(ECHIDNA_DSP_HAS_NEON)
+    using Lanes = float32x4_t;
+    inline Lanes load(const float *p) { return vld1q_f32(p); }
+    inline void store(float *p, Lanes v) { vst1q_f32(p, v); }
+    inline Lanes splat(float value) { return vdupq_n_f32(value); }
+    /** {a, b, c, d} built in registers, without a store and reload. */
+    inline Lanes set(float a, float b, float c, float d)
+    {
+        return vsetq_lane_f32(d, vsetq_lane_f32(c, vsetq_lane_f32(b, vdupq_n_f32(a), 1), 2), 3);
+    }
+    inline Lanes add(Lanes a, Lanes b) { return vaddq_f32(a, b); }
+    inline Lanes sub(Lanes a, Lanes b) { return vsubq_f32(a, b); }
+    inline Lanes mul(Lanes a, Lanes b) { return vmulq_f32(a, b); }
+    inline Lanes neg(Lanes a) { return vnegq_f32(a); }
+    /** Lane order reversed: {v3, v2, v1, v0}. */
+    inline Lanes reverse(Lanes v)
+    {
+        const float32x4_t swapped = vrev64q_f32(v);
+        return vextq_f32(swapped, swapped, 2);
+    }
+    /** dst[4 * i + j] = v_j[i]: four vectors stored interleaved. */
+    inline void store_interleaved(float *dst, Lanes v0, Lanes v1, Lanes v2, Lanes v3)
+    {
+        vst4q_f32(dst, (float32x4x4_t{{v0, v1, v2, v3}}));
+    }
+#elif defined(ECHIDNA_DSP_HAS_AVX) && defined(__SSE2__)
+    using Lanes = __m128;
+    inline Lanes load(const float *p) { return _mm_loadu_ps(p); }
+    inline void store(float *p, Lanes v) { _mm_storeu_ps(p, v); }
+    inline Lanes splat(float value) { return _mm_set1_ps(value); }
+    inline Lanes set(float a, float b, float c, float d) { return _mm_setr_ps(a, b, c, d); }
+    inline Lanes add(Lanes a, Lanes b) { return _mm_add_ps(a, b); }
+    inline Lanes sub(Lanes a, Lanes b) { return _mm_sub_ps(a, b); }
+    inline Lanes mul(Lanes a, Lanes b) { return _mm_mul_ps(a, b); }
+    inline Lanes neg(Lanes a) { return _mm_xor_ps(a, _mm_set1_ps(-0.0f)); }
+    inline Lanes reverse(Lanes v) { return _mm_shuffle_ps(v, v, _MM_SHUFFLE(0, 1, 2, 3)); }
+    inline void store_interleaved(float *dst, Lanes v0, Lanes v1, Lanes v2, Lanes v3)
+    {
+        _MM_TRANSPOSE4_PS(v0, v1, v2, v3);
+        _mm_storeu_ps(dst, v0);
+        _mm_storeu_ps(dst + 4, v1);
+        _mm_storeu_ps(dst + 8, v2);
+        _mm_storeu_ps(dst + 12, v3);
+    }
+#else
+    struct Lanes
+    {
+        float v[kWidth];
+    };
+    inline Lanes load(const float *p)
+    {
+        return Lanes{{p[0], p[1], p[2], p[3]}};
+    }
+    inline void store(float *p, Lanes v)
+    {
+        for (uint32_t i = 0; i < kWidth; ++i)
+        {
+            p[i] = v.v[i];
+        }
+    }
+    inline Lanes splat(float value) { return Lanes{{value, value, value, value}}; }
+    inline Lanes set(float a, float b, float c, float d) { return Lanes{{a, b, c, d}}; }
+    template <typename Op>
+    inline Lanes lanewise(Lanes a, Lanes b, Op op)
+    {
+        for (uint32_t i = 0; i < kWidth; ++i)
+        {
+            a.v[i] = op(a.v[i], b.v[i]);
+        }
+        return a;
+    }
+    inline Lanes add(Lanes a, Lanes b) { return lanewise(a, b, [](float x, float y) { return x + y; }); }
+    inline Lanes sub(Lanes a, Lanes b) { return lanewise(a, b, [](float x, float y) { return x - y; }); }
+    inline Lanes mul(Lanes a, Lanes b) { return lanewise(a, b, [](float x, float y) { return x * y; }); }
+    inline Lanes neg(Lanes a) { return lanewise(a, a, [](float x, float) { return -x; }); }
+    inline Lanes reverse(Lanes v) { return Lanes{{v.v[3], v.v[2], v.v[1], v.v[0]}}; }
+    inline void store_interleaved(float *dst, Lanes v0, Lanes v1, Lanes v2, Lanes v3)
+    {
+        for (uint32_t i = 0; i < kWidth; ++i)
+        {
+            dst[4 * i] = v0.v[i];
+            dst[4 * i + 1] = v1.v[i];
+            dst[4 * i + 2] = v2.v[i];
+            dst[4 * i + 3] = v3.v[i];
+        }
+    }
+#endif
+
+} // namespace echidna::dsp::runtime::lanes
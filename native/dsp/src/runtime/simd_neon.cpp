@@ -0,0 +1,425 @@
+#include "simd_dispatch.h"
+
+/**
+ * @file simd_neon.cpp
+ * @brief NEON kernel variants. Advanced SIMD is part of the AArch64
+ * baseline, so no target attributes are needed.
+ */
+
+#if defined(ECHIDNA_DSP_HAS_NEON)
+
+#include <arm_neon.h>
+
+#include <bit>
+#include <cmath>
+#include <limits>
+
+namespace echidna::dsp::runtime
+{
+    namespace
+    {
+        void apply_gain_neon(float *data, size_t samples, float gain)
+        {
+            const float32x4_t gain_vec = vdupq_n_f32(gain);
+            size_t i = 0;
+            for (; i + 4 <= samples; i += 4)
+            {
+                vst1q_f32(&data[i], vmulq_f32(vld1q_f32(&data[i]), gain_vec));
+            }
+            for (; i < samples; ++i)
+            {
+                data[i] *= gain;
+            }
+        }
+
+        void mix_in_neon(float *dst, const float *src, size_t samples, float gain)
+        {
+            const float32x4_t gain_vec = vdupq_n_f32(gain);
+            size_t i = 0;
+            for (; i + 4 <= samples; i += 4)
+            {
+                const float32x4_t s = vmulq_f32(vld1q_f32(&src[i]), gain_vec);
+                vst1q_f32(&dst[i], vaddq_f32(vld1q_f32(&dst[i]), s));
+            }
+            for (; i < samples; ++i)
+            {
+                dst[i] += src[i] * gain;
+            }
+        }
+
+        void crossfade_neon(const float *dry,
+                            const float *wet,
+                            float *output,
+                            size_t samples,
+                            float dry_gain,
+                            float wet_gain,
+                            float output_gain)
+        {
+            const float32x4_t dg = vdupq_n_f32(dry_gain);
+            const float32x4_t wg = vdupq_n_f32(wet_gain);
+            const float32x4_t og = vdupq_n_f32(output_gain);
+            size_t i = 0;
+            for (; i + 4 <= samples; i += 4)
+            {
+                const float32x4_t mixed =
+                    vaddq_f32(vmulq_f32(vld1q_f32(&dry[i]), dg), vmulq_f32(vld1q_f32(&wet[i]), wg));
+                vst1q_f32(&output[i], vmulq_f32(mixed, og));
+            }
+            for (; i < samples; ++i)
+            {
+                output[i] = (dry[i] * dry_gain + wet[i] * wet_gain) * output_gain;
+            }
+        }
+
+        BlockScan scan_block_neon(const float *data, size_t samples, const float *reference)
+        {
+            const float32x4_t largest = vdupq_n_f32(std::numeric_limits<float>::max());
+            float32x4_t peak = vdupq_n_f32(0.0f);
+            uint32x4_t finite = vdupq_n_u32(~0u);
+            float64x2_t sum_low = vdupq_n_f64(0.0);
+            float64x2_t sum_high = vdupq_n_f64(0.0);
+            uint32x4_t diff = vdupq_n_u32(0);
+            size_t i = 0;
+            for (; i + 4 <= samples; i += 4)
+            {
+                const float32x4_t x = vld1q_f32(&data[i]);
+                const float32x4_t magnitude = vabsq_f32(x);
+                // Ordered compare: NaN fails it as well as infinity.
+                finite = vandq_u32(finite, vcleq_f32(magnitude, largest));
+                peak = vmaxq_f32(peak, magnitude);
+                const float64x2_t low = vcvt_f64_f32(vget_low_f32(x));
+                const float64x2_t high = vcvt_high_f64_f32(x);
+                sum_low = vaddq_f64(sum_low, vmulq_f64(low, low));
+                sum_high = vaddq_f64(sum_high, vmulq_f64(high, high));
+                if (reference != nullptr)
+                {
+                    diff = vorrq_u32(diff, veorq_u32(vreinterpretq_u32_f32(x),
+                                                     vreinterpretq_u32_f32(vld1q_f32(&reference[i]))));
+                }
+            }
+            BlockScan scan;
+            scan.peak = vmaxvq_f32(peak);
+            scan.sum_squares = vaddvq_f64(vaddq_f64(sum_low, sum_high));
+            scan.finite = vminvq_u32(finite) != 0;
+            scan.changed = vmaxvq_u32(diff) != 0;
+            scan_tail(data + i, samples - i, reference != nullptr ? reference + i : nullptr, scan);
+            return scan;
+        }
+
+        bool all_finite_neon(const float *data, size_t samples)
+        {
+            const float32x4_t largest = vdupq_n_f32(std::numeric_limits<float>::max());
+            uint32x4_t finite = vdupq_n_u32(~0u);
+            size_t i = 0;
+            for (; i + 4 <= samples; i += 4)
+            {
+                finite = vandq_u32(finite, vcleq_f32(vabsq_f32(vld1q_f32(&data[i])), largest));
+            }
+            bool result = vminvq_u32(finite) != 0;
+            for (; i < samples; ++i)
+            {
+                result = result && std::isfinite(data[i]);
+            }
+            return result;
+        }
+
+        bool decode_u8_neon(const void *src, float *dst, size_t samples)
+        {
+            const auto *bytes = static_cast<const uint8_t *>(src);
+            const float32x4_t offset = vdupq_n_f32(128.0f);
+            const float scale = 1.0f / 128.0f;
+            size_t i = 0;
+            for (; i + 16 <= samples; i += 16)
+            {
+                const uint8x16_t codes = vld1q_u8(bytes + i);
+                const uint16x8_t low = vmovl_u8(vget_low_u8(codes));
+                const uint16x8_t high = vmovl_high_u8(codes);
+                const uint32x4_t quads[4] = {vmovl_u16(vget_low_u16(low)),
+                                             vmovl_high_u16(low),
+                                             vmovl_u16(vget_low_u16(high)),
+                                             vmovl_high_u16(high)};
+                for (size_t quad = 0; quad < 4; ++quad)
+                {
+                    vst1q_f32(&dst[i + 4 * quad], vmulq_n_f32(vsubq_f32(vcvtq_f32_u32(quads[quad]), offset), scale));
+                }
+            }
+            return decode_pcm_scalar<PcmEncoding::kUnsigned8>(bytes + i, dst + i, samples - i);
+        }
+
+        /** PcmTraits<kUnsigned8>::quantize() on four lanes, as uint32. */
+        inline uint32x4_t quantize_u8_neon(float32x4_t x)
+        {
+            const float32x4_t clamped = vminq_f32(vmaxq_f32(x, vdupq_n_f32(-1.0f)), vdupq_n_f32(1.0f));
+            return vcvtaq_u32_f32(vaddq_f32(vmulq_n_f32(clamped, 127.5f), vdupq_n_f32(127.5f)));
+        }
+
+        void encode_u8_neon(const float *src, void *dst, size_t samples)
+        {
+            auto *bytes = static_cast<uint8_t *>(dst);
+            size_t i = 0;
+            for (; i + 8 <= samples; i += 8)
+            {
+                const uint16x8_t words = vcombine_u16(vmovn_u32(quantize_u8_neon(vld1q_f32(&src[i]))),
+                                                      vmovn_u32(quantize_u8_neon(vld1q_f32(&src[i + 4]))));
+                vst1_u8(bytes + i, vmovn_u16(words));
+            }
+            encode_pcm_scalar<PcmEncoding::kUnsigned8>(src + i, bytes + i, samples - i);
+        }
+
+        bool decode_s16_neon(const void *src, float *dst, size_t samples)
+        {
+            const auto *bytes = static_cast<const uint8_t *>(src);
+            const float scale = 1.0f / 32768.0f;
+            size_t i = 0;
+            for (; i + 8 <= samples; i += 8)
+            {
+                const int16x8_t packed = vreinterpretq_s16_u8(vld1q_u8(bytes + 2 * i));
+                vst1q_f32(&dst[i], vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_low_s16(packed))), scale));
+                vst1q_f32(&dst[i + 4], vmulq_n_f32(vcvtq_f32_s32(vmovl_high_s16(packed)), scale));
+            }
+            return decode_pcm_scalar<PcmEncoding::kSigned16>(
+                bytes + pcm_offset<PcmEncoding::kSigned16>(i), dst + i, samples - i);
+        }
+
+        /**
+         * Clamp, scale by `full_scale` and round half away from zero, pinning
+         * -1 to `minimum`: the int16 and packed 24-bit quantisers.
+         */
+        inline int32x4_t quantize_neon(float32x4_t x, float full_scale, int32_t minimum)
+        {
+            const float32x4_t floor = vdupq_n_f32(-1.0f);
+            const float32x4_t clamped = vminq_f32(vmaxq_f32(x, floor), vdupq_n_f32(1.0f));
+            // FCVTAS rounds half away from zero, exactly like lround().
+            const int32x4_t rounded = vcvtaq_s32_f32(vmulq_n_f32(clamped, full_scale));
+            return vbslq_s32(vcleq_f32(clamped, floor), vdupq_n_s32(minimum), rounded);
+        }
+
+        /** encode_s16() on four lanes, widened to int32. */
+        inline int32x4_t quantize_s16_neon(float32x4_t x)
+        {
+            return quantize_neon(x, 32767.0f, std::numeric_limits<int16_t>::min());
+        }
+
+        void encode_s16_neon(const float *src, void *dst, size_t samples)
+        {
+            auto *bytes = static_cast<uint8_t *>(dst);
+            size_t i = 0;
+            for (; i + 8 <= samples; i += 8)
+            {
+                const int32x4_t low = quantize_s16_neon(vld1q_f32(&src[i]));
+                const int32x4_t high = quantize_s16_neon(vld1q_f32(&src[i + 4]));
+                vst1q_u8(bytes + 2 * i, vreinterpretq_u8_s16(vcombine_s16(vqmovn_s32(low), vqmovn_s32(high))));
+            }
+            encode_pcm_scalar<PcmEncoding::kSigned16>(
+                src + i, bytes + pcm_offset<PcmEncoding::kSigned16>(i), samples - i);
+        }
+
+        bool decode_s24_neon(const void *src, float *dst, size_t samples)
+        {
+            const auto *bytes = static_cast<const uint8_t *>(src);
+            const float scale = 1.0f / 8388608.0f;
+            size_t i = 0;
+            for (; i + 16 <= samples; i += 16)
+            {
+                // val[0..2] hold the low, middle and high byte of each sample.
+                const uint8x16x3_t planes = vld3q_u8(bytes + 3 * i);
+                const int16x8_t upper_low = vreinterpretq_s16_u8(vzip1q_u8(planes.val[1], planes.val[2]));
+                const int16x8_t upper_high = vreinterpretq_s16_u8(vzip2q_u8(planes.val[1], planes.val[2]));
+                const uint16x8_t lower_low = vmovl_u8(vget_low_u8(planes.val[0]));
+                const uint16x8_t lower_high = vmovl_high_u8(planes.val[0]);
+                const int32x4_t codes[4] = {
+                    vorrq_s32(vshll_n_s16(vget_low_s16(upper_low), 8),
+                              vreinterpretq_s32_u32(vmovl_u16(vget_low_u16(lower_low)))),
+                    vorrq_s32(vshll_high_n_s16(upper_low, 8), vreinterpretq_s32_u32(vmovl_high_u16(lower_low))),
+                    vorrq_s32(vshll_n_s16(vget_low_s16(upper_high), 8),
+                              vreinterpretq_s32_u32(vmovl_u16(vget_low_u16(lower_high)))),
+                    vorrq_s32(vshll_high_n_s16(upper_high, 8), vreinterpretq_s32_u32(vmovl_high_u16(lower_high))),
+                };
+                for (size_t quad = 0; quad < 4; ++quad)
+                {
+                    vst1q_f32(&dst[i + 4 * quad], vmulq_n_f32(vcvtq_f32_s32(codes[quad]), scale));
+                }
+            }
+            return decode_pcm_scalar<PcmEncoding::kSigned24Packed>(
+                bytes + pcm_offset<PcmEncoding::kSigned24Packed>(i), dst + i, samples - i);
+        }
+
+        void encode_s24_neon(const float *src, void *dst, size_t samples)
+        {
+            auto *bytes = static_cast<uint8_t *>(dst);
+            size_t i = 0;
+            for (; i + 16 <= samples; i += 16)
+            {
+                uint32x4_t codes[4];
+                for (size_t quad = 0; quad < 4; ++quad)
+                {
+                    const float32x4_t x = vld1q_f32(&src[i + 4 * quad]);
+                    codes[quad] = vreinterpretq_u32_s32(quantize_neon(x, 8388607.0f, -8388608));
+                }
+                const uint16x8_t words_low = vcombine_u16(vmovn_u32(codes[0]), vmovn_u32(codes[1]));
+                const uint16x8_t words_high = vcombine_u16(vmovn_u32(codes[2]), vmovn_u32(codes[3]));
+                const uint16x8_t tops_low = vcombine_u16(vshrn_n_u32(codes[0], 16), vshrn_n_u32(codes[1], 16));
+                const uint16x8_t tops_high = vcombine_u16(vshrn_n_u32(codes[2], 16), vshrn_n_u32(codes[3], 16));
+                uint8x16x3_t planes;
+                planes.val[0] = vcombine_u8(vmovn_u16(words_low), vmovn_u16(words_high));
+                planes.val[1] = vcombine_u8(vshrn_n_u16(words_low, 8), vshrn_n_u16(words_high, 8));
+                planes.val[2] = vcombine_u8(vmovn_u16(tops_low), vmovn_u16(tops_high));
+                vst3q_u8(bytes + 3 * i, planes);
+            }
+            encode_pcm_scalar<PcmEncoding::kSigned24Packed>(
+                src + i, bytes + pcm_offset<PcmEncoding::kSigned24Packed>(i), samples - i);
+        }
+
+        bool decode_s32_neon(const void *src, float *dst, size_t samples)
+        {
+            const auto *bytes = static_cast<const uint8_t *>(src);
+            const float scale = 1.0f / 2147483648.0f;
+            size_t i = 0;
+            for (; i + 4 <= samples; i += 4)
+            {
+                const int32x4_t codes = vreinterpretq_s32_u8(vld1q_u8(bytes + 4 * i));
+                vst1q_f32(&dst[i], vmulq_n_f32(vcvtq_f32_s32(codes), scale));
+            }
+            return decode_pcm_scalar<PcmEncoding::kSigned32>(
+                bytes + pcm_offset<PcmEncoding::kSigned32>(i), dst + i, samples - i);
+        }
+
+        /** PcmTraits<kSigned32>::quantize() on two double lanes. */
+        inline int32x2_t quantize_s32_neon(float64x2_t x)
+        {
+            const float64x2_t floor = vdupq_n_f64(-1.0);
+            const float64x2_t clamped = vminq_f64(vmaxq_f64(x, floor), vdupq_n_f64(1.0));
+            const int64x2_t rounded = vcvtaq_s64_f64(vmulq_n_f64(clamped, 2147483647.0));
+            return vmovn_s64(vbslq_s64(vcleq_f64(clamped, floor),
+                                       vdupq_n_s64(std::numeric_limits<int32_t>::min()),
+                                       rounded));
+        }
+
+        void encode_s32_neon(const float *src, void *dst, size_t samples)
+        {
+            auto *bytes = static_cast<uint8_t *>(dst);
+            size_t i = 0;
+            for (; i + 4 <= samples; i += 4)
+            {
+                const float32x4_t x = vld1q_f32(&src[i]);
+                const int32x4_t codes = vcombine_s32(quantize_s32_neon(vcvt_f64_f32(vget_low_f32(x))),
+                                                     quantize_s32_neon(vcvt_high_f64_f32(x)));
+                vst1q_u8(bytes + 4 * i, vreinterpretq_u8_s32(codes));
+            }
+            encode_pcm_scalar<PcmEncoding::kSigned32>(
+                src + i, bytes + pcm_offset<PcmEncoding::kSigned32>(i), samples - i);
+        }
+
+        bool decode_f32_neon(const void *src, float *dst, size_t samples)
+        {
+            const auto *bytes = static_cast<const uint8_t *>(src);
+            const float32x4_t largest = vdupq_n_f32(std::numeric_limits<float>::max());
+            uint32x4_t finite = vdupq_n_u32(~0u);
+            size_t i = 0;
+            for (; i + 4 <= samples; i += 4)
+            {
+                const float32x4_t x = vreinterpretq_f32_u8(vld1q_u8(bytes + 4 * i));
+                finite = vandq_u32(finite, vcleq_f32(vabsq_f32(x), largest));
+                vst1q_f32(&dst[i], x);
+            }
+            const bool tail = decode_pcm_scalar<PcmEncoding::kFloat32>(
+                bytes + pcm_offset<PcmEncoding::kFloat32>(i), dst + i, samples - i);
+            return tail && vminvq_u32(finite) != 0;
+        }
+
+        bool reencode_s16_neon(const float *processed,
+                               const float *decoded,
+                               const int16_t *original,
+                               int16_t *dst,
+                               size_t samples)
+        {
+            uint32x4_t diff = vdupq_n_u32(0);
+            size_t i = 0;
+            for (; i + 8 <= samples; i += 8)
+            {
+                const int16x8_t before = vld1q_s16(&original[i]);
+                const int32x4_t before_low = vmovl_s16(vget_low_s16(before));
+                const int32x4_t before_high = vmovl_high_s16(before);
+                const float32x4_t low = vld1q_f32(&processed[i]);
+                const float32x4_t high = vld1q_f32(&processed[i + 4]);
+                const uint32x4_t same_low =
+                    vceqq_u32(vreinterpretq_u32_f32(low), vreinterpretq_u32_f32(vld1q_f32(&decoded[i])));
+                const uint32x4_t same_high =
+                    vceqq_u32(vreinterpretq_u32_f32(high), vreinterpretq_u32_f32(vld1q_f32(&decoded[i + 4])));
+                const int32x4_t after_low = vbslq_s32(same_low, before_low, quantize_s16_neon(low));
+                const int32x4_t after_high = vbslq_s32(same_high, before_high, quantize_s16_neon(high));
+                diff = vorrq_u32(diff, vreinterpretq_u32_s32(veorq_s32(after_low, before_low)));
+                diff = vorrq_u32(diff, vreinterpretq_u32_s32(veorq_s32(after_high, before_high)));
+                vst1q_s16(&dst[i], vcombine_s16(vqmovn_s32(after_low), vqmovn_s32(after_high)));
+            }
+            bool changed = vmaxvq_u32(diff) != 0;
+            for (; i < samples; ++i)
+            {
+                const int16_t before = original[i];
+                const bool touched =
+                    std::bit_cast<uint32_t>(processed[i]) != std::bit_cast<uint32_t>(decoded[i]);
+                const int16_t after = touched ? encode_s16(processed[i]) : before;
+                changed = changed || after != before;
+                dst[i] = after;
+            }
+            return changed;
+        }
+
+        void deinterleave_stereo_neon(const float *interleaved, float *left, float *right, size_t frames)
+        {
+            size_t frame = 0;
+            for (; frame + 4 <= frames; frame += 4)
+            {
+                const float32x4x2_t pair = vld2q_f32(&interleaved[frame * 2]);
+                vst1q_f32(&left[frame], pair.val[0]);
+                vst1q_f32(&right[frame], pair.val[1]);
+            }
+            for (; frame < frames; ++frame)
+            {
+                left[frame] = interleaved[frame * 2];
+                right[frame] = interleaved[frame * 2 + 1];
+            }
+        }
+
+        void interleave_stereo_neon(const float *left, const float *right, float *interleaved, size_t frames)
+        {
+            size_t frame = 0;
+            for (; frame + 4 <= frames; frame += 4)
+            {
+                float32x4x2_t pair;
+                pair.val[0] = vld1q_f32(&left[frame]);
+                pair.val[1] = vld1q_f32(&right[frame]);
+                vst2q_f32(&interleaved[frame * 2], pair);
+            }
+            for (; frame < frames; ++frame)
+            {
+                interleaved[frame * 2] = left[frame];
+                interleaved[frame * 2 + 1] = right[frame];
+            }
+        }
+    } // namespace
+
+    const SimdKernels kNeonKernels{
+        apply_gain_neon,
+        mix_in_neon,
+        crossfade_neon,
+        scan_block_neon,
+        all_finite_neon,
+        {decode_u8_neon,
+         decode_s16_neon,
+         decode_s24_neon,
+         decode_s32_neon,
+         decode_f32_neon},
+        {encode_u8_neon,
+         encode_s16_neon,
+         encode_s24_neon,
+         encode_s32_neon,
+         encode_pcm_scalar<PcmEncoding::kFloat32>},
+        reencode_s16_neon,
+        deinterleave_stereo_neon,
+        interleave_stereo_neon,
+    };
+
+} // namespace echidna::dsp::runtime
+
+#endif // ECHIDNA_DSP_HAS_NEON
@@ -0,0 +1,1125 @@
+#include "simd_dispatch.h"
+
+/**
+ * @file simd_x86.cpp
+ * @brief SSE4.1, AVX2 and AVX-512 kernel variants.
+ *
+ * Every function carries its own target attribute, so the file builds with
+ * the baseline x86-64 flags and nothing here runs unless simd.cpp's cpuid
+ * probe selected it. Multiplies and adds stay separate, which keeps every
+ * variant bit-exact with the scalar loops; only scan_block's double-precision
+ * energy sum is reassociated across lanes.
+ */
+
+#if defined(ECHIDNA_DSP_HAS_AVX)
+
+#include <immintrin.h>
+
+#include <bit>
+#include <cmath>
+#include <limits>
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#define ECHIDNA_DSP_TARGET(isa)
+#else
+#define ECHIDNA_DSP_TARGET(isa) __attribute__((target(isa)))
+#endif
+
+namespace echidna::dsp::runtime
+{
+    namespace
+    {
+        // --- SSE4.1: four lanes ---
+
+        ECHIDNA_DSP_TARGET("sse4.1")
+        void apply_gain_sse41(float *data, size_t samples, float gain)
+        {
+            const __m128 g = _mm_set1_ps(gain);
+            size_t i = 0;
+            for (; i + 4 <= samples; i += 4)
+            {
+                _mm_storeu_ps(data + i, _mm_mul_ps(_mm_loadu_ps(data + i), g));
+            }
+            for (; i < samples; ++i)
+            {
+                data[i] *= gain;
+            }
+        }
+
+        ECHIDNA_DSP_TARGET("sse4.1")
+        void mix_in_sse41(float *dst, const float *src, size_t samples, float gain)
+        {
+            const __m128 g = _mm_set1_ps(gain);
+            size_t i = 0;
+            for (; i + 4 <= samples; i += 4)
+            {
+                const __m128 s = _mm_mul_ps(_mm_loadu_ps(src + i), g);
+                _mm_storeu_ps(dst + i, _mm_add_ps(_mm_loadu_ps(dst + i), s));
+            }
+            for (; i < samples; ++i)
+            {
+                dst[i] += src[i] * gain;
+            }
+        }
+
+        ECHIDNA_DSP_TARGET("sse4.1")
+        void crossfade_sse41(const float *dry,
+                             const float *wet,
+                             float *output,
+                             size_t samples,
+                             float dry_gain,
+                             float wet_gain,
+                             float output_gain)
+        {
+            const __m128 dg = _mm_set1_ps(dry_gain);
+            const __m128 wg = _mm_set1_ps(wet_gain);
+            const __m128 og = _mm_set1_ps(output_gain);
+            size_t i = 0;
+            for (; i + 4 <= samples; i += 4)
+            {
+                const __m128 mixed = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(dry + i), dg),
+                                                _mm_mul_ps(_mm_loadu_ps(wet + i), wg));
+                _mm_storeu_ps(output + i, _mm_mul_ps(mixed, og));
+            }
+            for (; i < samples; ++i)
+            {
+                output[i] = (dry[i] * dry_gain + wet[i] * wet_gain) * output_gain;
+            }
+        }
+
+        ECHIDNA_DSP_TARGET("sse4.1")
+        BlockScan scan_block_sse41(const float *data, size_t samples, const float *reference)
+        {
+            const __m128 sign = _mm_set1_ps(-0.0f);
+            const __m128 largest = _mm_set1_ps(std::numeric_limits<float>::max());
+            __m128 peak = _mm_setzero_ps();
+            __m128 finite = _mm_castsi128_ps(_mm_set1_epi32(-1));
+            __m128d sum_low = _mm_setzero_pd();
+            __m128d sum_high = _mm_setzero_pd();
+            __m128i diff = _mm_setzero_si128();
+            size_t i = 0;
+            for (; i + 4 <= samples; i += 4)
+            {
+                const __m128 x = _mm_loadu_ps(data + i);
+                const __m128 magnitude = _mm_andnot_ps(sign, x);
+                // Ordered compare: NaN fails it as well as infinity.
+                finite = _mm_and_ps(finite, _mm_cmple_ps(magnitude, largest));
+                peak = _mm_max_ps(peak, magnitude);
+                const __m128d low = _mm_cvtps_pd(x);
+                const __m128d high = _mm_cvtps_pd(_mm_movehl_ps(x, x));
+                sum_low = _mm_add_pd(sum_low, _mm_mul_pd(low, low));
+                sum_high = _mm_add_pd(sum_high, _mm_mul_pd(high, high));
+                if (reference != nullptr)
+                {
+                    diff = _mm_or_si128(diff, _mm_xor_si128(_mm_castps_si128(x),
+                                                            _mm_castps_si128(_mm_loadu_ps(reference + i))));
+                }
+            }
+            peak = _mm_max_ps(peak, _mm_movehl_ps(peak, peak));
+            peak = _mm_max_ss(peak, _mm_shuffle_ps(peak, peak, 0x55));
+            const __m128d sum = _mm_add_pd(sum_low, sum_high);
+            BlockScan scan;
+            scan.peak = _mm_cvtss_f32(peak);
+            scan.sum_squares = _mm_cvtsd_f64(_mm_add_sd(sum, _mm_unpackhi_pd(sum, sum)));
+            scan.finite = _mm_movemask_ps(finite) == 0xf;
+            scan.changed = _mm_testz_si128(diff, diff) == 0;
+            scan_tail(data + i, samples - i, reference != nullptr ? reference + i : nullptr, scan);
+            return scan;
+        }
+
+        ECHIDNA_DSP_TARGET("sse4.1")
+        bool all_finite_sse41(const float *data, size_t samples)
+        {
+            const __m128 sign = _mm_set1_ps(-0.0f);
+            const __m128 largest = _mm_set1_ps(std::numeric_limits<float>::max());
+            __m128 finite = _mm_castsi128_ps(_mm_set1_epi32(-1));
+            size_t i = 0;
+            for (; i + 4 <= samples; i += 4)
+            {
+                finite = _mm_and_ps(finite, _mm_cmple_ps(_mm_andnot_ps(sign, _mm_loadu_ps(data + i)), largest));
+            }
+            bool result = _mm_movemask_ps(finite) == 0xf;
+            for (; i < samples; ++i)
+            {
+                result = result && std::isfinite(data[i]);
+            }
+            return result;
+        }
+
+        ECHIDNA_DSP_TARGET("sse4.1")
+        inline __m128 dequantize_u8_sse41(__m128i codes)
+        {
+            const __m128 values = _mm_cvtepi32_ps(_mm_cvtepu8_epi32(codes));
+            return _mm_mul_ps(_mm_sub_ps(values, _mm_set1_ps(128.0f)), _mm_set1_ps(1.0f / 128.0f));
+        }
+
+        ECHIDNA_DSP_TARGET("sse4.1")
+        bool decode_u8_sse41(const void *src, float *dst, size_t samples)
+        {
+            const auto *bytes = static_cast<const uint8_t *>(src);
+            size_t i = 0;
+            for (; i + 16 <= samples; i += 16)
+            {
+                const __m128i packed = _mm_loadu_si128(reinterpret_cast<const __m128i *>(bytes + i));
+                _mm_storeu_ps(dst + i, dequantize_u8_sse41(packed));
+                _mm_storeu_ps(dst + i + 4, dequantize_u8_sse41(_mm_srli_si128(packed, 4)));
+                _mm_storeu_ps(dst + i + 8, dequantize_u8_sse41(_mm_srli_si128(packed, 8)));
+                _mm_storeu_ps(dst + i + 12, dequantize_u8_sse41(_mm_srli_si128(packed, 12)));
+            }
+            return decode_pcm_scalar<PcmEncoding::kUnsigned8>(bytes + i, dst + i, samples - i);
+        }
+
+        /** PcmTraits<kUnsigned8>::quantize() on four lanes, as int32. */
+        ECHIDNA_DSP_TARGET("sse4.1")
+        inline __m128i quantize_u8_sse41(__m128 x)
+        {
+            const __m128 clamped = _mm_min_ps(_mm_max_ps(x, _mm_set1_ps(-1.0f)), _mm_set1_ps(1.0f));
+            const __m128 scaled = _mm_add_ps(_mm_mul_ps(clamped, _mm_set1_ps(127.5f)), _mm_set1_ps(127.5f));
+            // Never negative, so lround() is truncation plus one from a half up.
+            const __m128 whole = _mm_round_ps(scaled, _MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC);
+            const __m128 away =
+                _mm_and_ps(_mm_cmpge_ps(_mm_sub_ps(scaled, whole), _mm_set1_ps(0.5f)), _mm_set1_ps(1.0f));
+            return _mm_cvttps_epi32(_mm_add_ps(whole, away));
+        }
+
+        ECHIDNA_DSP_TARGET("sse4.1")
+        void encode_u8_sse41(const float *src, void *dst, size_t samples)
+        {
+            auto *bytes = static_cast<uint8_t *>(dst);
+            size_t i = 0;
+            for (; i + 16 <= samples; i += 16)
+            {
+                const __m128i low = _mm_packs_epi32(quantize_u8_sse41(_mm_loadu_ps(src + i)),
+                                                    quantize_u8_sse41(_mm_loadu_ps(src + i + 4)));
+                const __m128i high = _mm_packs_epi32(quantize_u8_sse41(_mm_loadu_ps(src + i + 8)),
+                                                     quantize_u8_sse41(_mm_loadu_ps(src + i + 12)));
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(bytes + i), _mm_packus_epi16(low, high));
+            }
+            encode_pcm_scalar<PcmEncoding::kUnsigned8>(src + i, bytes + i, samples - i);
+        }
+
+        ECHIDNA_DSP_TARGET("sse4.1")
+        bool decode_s16_sse41(const void *src, float *dst, size_t samples)
+        {
+            const auto *bytes = static_cast<const uint8_t *>(src);
+            const __m128 scale = _mm_set1_ps(1.0f / 32768.0f);
+            size_t i = 0;
+            for (; i + 8 <= samples; i += 8)
+            {
+                const __m128i packed = _mm_loadu_si128(reinterpret_cast<const __m128i *>(bytes + 2 * i));
+                const __m128i low = _mm_cvtepi16_epi32(packed);
+                const __m128i high = _mm_cvtepi16_epi32(_mm_srli_si128(packed, 8));
+                _mm_storeu_ps(dst + i, _mm_mul_ps(_mm_cvtepi32_ps(low), scale));
+                _mm_storeu_ps(dst + i + 4, _mm_mul_ps(_mm_cvtepi32_ps(high), scale));
+            }
+            return decode_pcm_scalar<PcmEncoding::kSigned16>(
+                bytes + pcm_offset<PcmEncoding::kSigned16>(i), dst + i, samples - i);
+        }
+
+        /**
+         * PcmTraits<>::quantize() for 16 and 24 bits on four lanes, as int32:
+         * clamp, scale by `full_scale`, round half away from zero and map -1
+         * to `minimum`.
+         */
+        ECHIDNA_DSP_TARGET("sse4.1")
+        inline __m128i quantize_sse41(__m128 x, float full_scale, int32_t minimum)
+        {
+            const __m128 floor = _mm_set1_ps(-1.0f);
+            const __m128 clamped = _mm_min_ps(_mm_max_ps(x, floor), _mm_set1_ps(1.0f));
+            const __m128 scaled = _mm_mul_ps(clamped, _mm_set1_ps(full_scale));
+            // lround(): truncate, then step away from zero when the dropped
+            // fraction is at least one half. Both steps are exact below 2^23.
+            const __m128 sign = _mm_set1_ps(-0.0f);
+            const __m128 whole = _mm_round_ps(scaled, _MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC);
+            const __m128 fraction = _mm_andnot_ps(sign, _mm_sub_ps(scaled, whole));
+            const __m128 unit = _mm_or_ps(_mm_and_ps(scaled, sign), _mm_set1_ps(1.0f));
+            const __m128 away = _mm_and_ps(_mm_cmpge_ps(fraction, _mm_set1_ps(0.5f)), unit);
+            const __m128i rounded = _mm_cvttps_epi32(_mm_add_ps(whole, away));
+            return _mm_blendv_epi8(rounded, _mm_set1_epi32(minimum), _mm_castps_si128(_mm_cmple_ps(clamped, floor)));
+        }
+
+        ECHIDNA_DSP_TARGET("sse4.1")
+        inline __m128i quantize_s16_sse41(__m128 x)
+        {
+            return quantize_sse41(x, 32767.0f, std::numeric_limits<int16_t>::min());
+        }
+
+        ECHIDNA_DSP_TARGET("sse4.1")
+        void encode_s16_sse41(const float *src, void *dst, size_t samples)
+        {
+            auto *bytes = static_cast<uint8_t *>(dst);
+            size_t i = 0;
+            for (; i + 8 <= samples; i += 8)
+            {
+                const __m128i low = quantize_s16_sse41(_mm_loadu_ps(src + i));
+                const __m128i high = quantize_s16_sse41(_mm_loadu_ps(src + i + 4));
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(bytes + 2 * i), _mm_packs_epi32(low, high));
+            }
+            encode_pcm_scalar<PcmEncoding::kSigned16>(
+                src + i, bytes + pcm_offset<PcmEncoding::kSigned16>(i), samples - i);
+        }
+
+        ECHIDNA_DSP_TARGET("sse4.1")
+        bool decode_s24_sse41(const void *src, float *dst, size_t samples)
+        {
+            const auto *bytes = static_cast<const uint8_t *>(src);
+            // Each sample's three bytes go to the top of a lane; the
+            // arithmetic shift then sign-extends them.
+            const __m128i spread = _mm_setr_epi8(-1, 0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11);
+            const __m128 scale = _mm_set1_ps(1.0f / 8388608.0f);
+            size_t i = 0;
+            // The 16-byte load covers five and a third samples, so stop two
+            // short of the end rather than read past the buffer.
+            for (; i + 6 <= samples; i += 4)
+            {
+                const __m128i packed = _mm_loadu_si128(reinterpret_cast<const __m128i *>(bytes + 3 * i));
+                const __m128i codes = _mm_srai_epi32(_mm_shuffle_epi8(packed, spread), 8);
+                _mm_storeu_ps(dst + i, _mm_mul_ps(_mm_cvtepi32_ps(codes), scale));
+            }
+            return decode_pcm_scalar<PcmEncoding::kSigned24Packed>(
+                bytes + pcm_offset<PcmEncoding::kSigned24Packed>(i), dst + i, samples - i);
+        }
+
+        ECHIDNA_DSP_TARGET("sse4.1")
+        void encode_s24_sse41(const float *src, void *dst, size_t samples)
+        {
+            auto *bytes = static_cast<uint8_t *>(dst);
+            const __m128i gather = _mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1);
+            size_t i = 0;
+            for (; i + 4 <= samples; i += 4)
+            {
+                const __m128i codes = quantize_sse41(_mm_loadu_ps(src + i), 8388607.0f, -8388608);
+                const __m128i packed = _mm_shuffle_epi8(codes, gather);
+                uint8_t *out = bytes + 3 * i;
+                _mm_storel_epi64(reinterpret_cast<__m128i *>(out), packed);
+                const auto last = static_cast<uint32_t>(_mm_extract_epi32(packed, 2));
+                std::memcpy(out + 8, &last, sizeof(last));
+            }
+            encode_pcm_scalar<PcmEncoding::kSigned24Packed>(
+                src + i, bytes + pcm_offset<PcmEncoding::kSigned24Packed>(i), samples - i);
+        }
+
+        ECHIDNA_DSP_TARGET("sse4.1")
+        bool decode_s32_sse41(const void *src, float *dst, size_t samples)
+        {
+            const auto *bytes = static_cast<const uint8_t *>(src);
+            const __m128 scale = _mm_set1_ps(1.0f / 2147483648.0f);
+            size_t i = 0;
+            for (; i + 4 <= samples; i += 4)
+            {
+                const __m128i codes = _mm_loadu_si128(reinterpret_cast<const __m128i *>(bytes + 4 * i));
+                _mm_storeu_ps(dst + i, _mm_mul_ps(_mm_cvtepi32_ps(codes), scale));
+            }
+            return decode_pcm_scalar<PcmEncoding::kSigned32>(
+                bytes + pcm_offset<PcmEncoding::kSigned32>(i), dst + i, samples - i);
+        }
+
+        /** PcmTraits<kSigned32>::quantize() on two double lanes; int32 results in the low half. */
+        ECHIDNA_DSP_TARGET("sse4.1")
+        inline __m128i quantize_s32_sse41(__m128d x)
+        {
+            const __m128d floor = _mm_set1_pd(-1.0);
+            const __m128d clamped = _mm_min_pd(_mm_max_pd(x, floor), _mm_set1_pd(1.0));
+            const __m128d scaled = _mm_mul_pd(clamped, _mm_set1_pd(2147483647.0));
+            const __m128d sign = _mm_set1_pd(-0.0);
+            const __m128d whole = _mm_round_pd(scaled, _MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC);
+            const __m128d fraction = _mm_andnot_pd(sign, _mm_sub_pd(scaled, whole));
+            const __m128d unit = _mm_or_pd(_mm_and_pd(scaled, sign), _mm_set1_pd(1.0));
+            const __m128d away = _mm_and_pd(_mm_cmpge_pd(fraction, _mm_set1_pd(0.5)), unit);
+            // -2^31 is exact in double and converts to INT32_MIN.
+            const __m128d rounded = _mm_blendv_pd(
+                _mm_add_pd(whole, away), _mm_set1_pd(-2147483648.0), _mm_cmple_pd(clamped, floor));
+            return _mm_cvttpd_epi32(rounded);
+        }
+
+        ECHIDNA_DSP_TARGET("sse4.1")
+        void encode_s32_sse41(const float *src, void *dst, size_t samples)
+        {
+            auto *bytes = static_cast<uint8_t *>(dst);
+            size_t i = 0;
+            for (; i + 4 <= samples; i += 4)
+            {
+                const __m128 x = _mm_loadu_ps(src + i);
+                const __m128i low = quantize_s32_sse41(_mm_cvtps_pd(x));
+                const __m128i high = quantize_s32_sse41(_mm_cvtps_pd(_mm_movehl_ps(x, x)));
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(bytes + 4 * i), _mm_unpacklo_epi64(low, high));
+            }
+            encode_pcm_scalar<PcmEncoding::kSigned32>(
+                src + i, bytes + pcm_offset<PcmEncoding::kSigned32>(i), samples - i);
+        }
+
+        /** Copy float32 PCM out while checking it, in one pass. */
+        ECHIDNA_DSP_TARGET("sse4.1")
+        bool decode_f32_sse41(const void *src, float *dst, size_t samples)
+        {
+            const auto *bytes = static_cast<const uint8_t *>(src);
+            const __m128 sign = _mm_set1_ps(-0.0f);
+            const __m128 largest = _mm_set1_ps(std::numeric_limits<float>::max());
+            __m128 finite = _mm_castsi128_ps(_mm_set1_epi32(-1));
+            size_t i = 0;
+            for (; i + 4 <= samples; i += 4)
+            {
+                const __m128 x = _mm_loadu_ps(reinterpret_cast<const float *>(bytes + 4 * i));
+                finite = _mm_and_ps(finite, _mm_cmple_ps(_mm_andnot_ps(sign, x), largest));
+                _mm_storeu_ps(dst + i, x);
+            }
+            const bool tail = decode_pcm_scalar<PcmEncoding::kFloat32>(
+                bytes + pcm_offset<PcmEncoding::kFloat32>(i), dst + i, samples - i);
+            return tail && _mm_movemask_ps(finite) == 0xf;
+        }
+
+        ECHIDNA_DSP_TARGET("sse4.1")
+        bool reencode_s16_sse41(const float *processed,
+                                const float *decoded,
+                                const int16_t *original,
+                                int16_t *dst,
+                                size_t samples)
+        {
+            __m128i diff = _mm_setzero_si128();
+            size_t i = 0;
+            for (; i + 8 <= samples; i += 8)
+            {
+                const __m128i before = _mm_loadu_si128(reinterpret_cast<const __m128i *>(original + i));
+                const __m128i before_low = _mm_cvtepi16_epi32(before);
+                const __m128i before_high = _mm_cvtepi16_epi32(_mm_srli_si128(before, 8));
+                const __m128 low = _mm_loadu_ps(processed + i);
+                const __m128 high = _mm_loadu_ps(processed + i + 4);
+                const __m128i same_low = _mm_cmpeq_epi32(_mm_castps_si128(low),
+                                                         _mm_castps_si128(_mm_loadu_ps(decoded + i)));
+                const __m128i same_high = _mm_cmpeq_epi32(_mm_castps_si128(high),
+                                                          _mm_castps_si128(_mm_loadu_ps(decoded + i + 4)));
+                const __m128i after_low = _mm_blendv_epi8(quantize_s16_sse41(low), before_low, same_low);
+                const __m128i after_high = _mm_blendv_epi8(quantize_s16_sse41(high), before_high, same_high);
+                diff = _mm_or_si128(diff, _mm_xor_si128(after_low, before_low));
+                diff = _mm_or_si128(diff, _mm_xor_si128(after_high, before_high));
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i), _mm_packs_epi32(after_low, after_high));
+            }
+            bool changed = _mm_testz_si128(diff, diff) == 0;
+            for (; i < samples; ++i)
+            {
+                const int16_t before = original[i];
+                const bool touched =
+                    std::bit_cast<uint32_t>(processed[i]) != std::bit_cast<uint32_t>(decoded[i]);
+                const int16_t after = touched ? encode_s16(processed[i]) : before;
+                changed = changed || after != before;
+                dst[i] = after;
+            }
+            return changed;
+        }
+
+        ECHIDNA_DSP_TARGET("sse4.1")
+        void deinterleave_stereo_sse41(const float *interleaved, float *left, float *right, size_t frames)
+        {
+            size_t frame = 0;
+            for (; frame + 4 <= frames; frame += 4)
+            {
+                const __m128 a = _mm_loadu_ps(interleaved + frame * 2);
+                const __m128 b = _mm_loadu_ps(interleaved + frame * 2 + 4);
+                _mm_storeu_ps(left + frame, _mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0)));
+                _mm_storeu_ps(right + frame, _mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1)));
+            }
+            for (; frame < frames; ++frame)
+            {
+                left[frame] = interleaved[frame * 2];
+                right[frame] = interleaved[frame * 2 + 1];
+            }
+        }
+
+        ECHIDNA_DSP_TARGET("sse4.1")
+        void interleave_stereo_sse41(const float *left, const float *right, float *interleaved, size_t frames)
+        {
+            size_t frame = 0;
+            for (; frame + 4 <= frames; frame += 4)
+            {
+                const __m128 l = _mm_loadu_ps(left + frame);
+                const __m128 r = _mm_loadu_ps(right + frame);
+                _mm_storeu_ps(interleaved + frame * 2, _mm_unpacklo_ps(l, r));
+                _mm_storeu_ps(interleaved + frame * 2 + 4, _mm_unpackhi_ps(l, r));
+            }
+            for (; frame < frames; ++frame)
+            {
+                interleaved[frame * 2] = left[frame];
+                interleaved[frame * 2 + 1] = right[frame];
+            }
+        }
+
+        // --- AVX2: eight lanes ---
+
+        ECHIDNA_DSP_TARGET("avx2")
+        void apply_gain_avx2(float *data, size_t samples, float gain)
+        {
+            const __m256 g = _mm256_set1_ps(gain);
+            size_t i = 0;
+            for (; i + 8 <= samples; i += 8)
+            {
+                _mm256_storeu_ps(data + i, _mm256_mul_ps(_mm256_loadu_ps(data + i), g));
+            }
+            for (; i < samples; ++i)
+            {
+                data[i] *= gain;
+            }
+        }
+
+        ECHIDNA_DSP_TARGET("avx2")
+        void mix_in_avx2(float *dst, const float *src, size_t samples, float gain)
+        {
+            const __m256 g = _mm256_set1_ps(gain);
+            size_t i = 0;
+            for (; i + 8 <= samples; i += 8)
+            {
+                const __m256 s = _mm256_mul_ps(_mm256_loadu_ps(src + i), g);
+                _mm256_storeu_ps(dst + i, _mm256_add_ps(_mm256_loadu_ps(dst + i), s));
+            }
+            for (; i < samples; ++i)
+            {
+                dst[i] += src[i] * gain;
+            }
+        }
+
+        ECHIDNA_DSP_TARGET("avx2")
+        void crossfade_avx2(const float *dry,
+                            const float *wet,
+                            float *output,
+                            size_t samples,
+                            float dry_gain,
+                            float wet_gain,
+                            float output_gain)
+        {
+            const __m256 dg = _mm256_set1_ps(dry_gain);
+            const __m256 wg = _mm256_set1_ps(wet_gain);
+            const __m256 og = _mm256_set1_ps(output_gain);
+            size_t i = 0;
+            for (; i + 8 <= samples; i += 8)
+            {
+                const __m256 mixed = _mm256_add_ps(_mm256_mul_ps(_mm256_loadu_ps(dry + i), dg),
+                                                   _mm256_mul_ps(_mm256_loadu_ps(wet + i), wg));
+                _mm256_storeu_ps(output + i, _mm256_mul_ps(mixed, og));
+            }
+            for (; i < samples; ++i)
+            {
+                output[i] = (dry[i] * dry_gain + wet[i] * wet_gain) * output_gain;
+            }
+        }
+
+        ECHIDNA_DSP_TARGET("avx2")
+        BlockScan scan_block_avx2(const float *data, size_t samples, const float *reference)
+        {
+            const __m256 sign = _mm256_set1_ps(-0.0f);
+            const __m256 largest = _mm256_set1_ps(std::numeric_limits<float>::max());
+            __m256 peak = _mm256_setzero_ps();
+            __m256 finite = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+            __m256d sum_low = _mm256_setzero_pd();
+            __m256d sum_high = _mm256_setzero_pd();
+            __m256i diff = _mm256_setzero_si256();
+            size_t i = 0;
+            for (; i + 8 <= samples; i += 8)
+            {
+                const __m256 x = _mm256_loadu_ps(data + i);
+                const __m256 magnitude = _mm256_andnot_ps(sign, x);
+                finite = _mm256_and_ps(finite, _mm256_cmp_ps(magnitude, largest, _CMP_LE_OQ));
+                peak = _mm256_max_ps(peak, magnitude);
+                const __m256d low = _mm256_cvtps_pd(_mm256_castps256_ps128(x));
+                const __m256d high = _mm256_cvtps_pd(_mm256_extractf128_ps(x, 1));
+                sum_low = _mm256_add_pd(sum_low, _mm256_mul_pd(low, low));
+                sum_high = _mm256_add_pd(sum_high, _mm256_mul_pd(high, high));
+                if (reference != nullptr)
+                {
+                    diff = _mm256_or_si256(diff,
+                                           _mm256_xor_si256(_mm256_castps_si256(x),
+                                                            _mm256_castps_si256(_mm256_loadu_ps(reference + i))));
+                }
+            }
+            __m128 peak4 = _mm_max_ps(_mm256_castps256_ps128(peak), _mm256_extractf128_ps(peak, 1));
+            peak4 = _mm_max_ps(peak4, _mm_movehl_ps(peak4, peak4));
+            peak4 = _mm_max_ss(peak4, _mm_shuffle_ps(peak4, peak4, 0x55));
+            const __m256d sum4 = _mm256_add_pd(sum_low, sum_high);
+            const __m128d sum2 = _mm_add_pd(_mm256_castpd256_pd128(sum4), _mm256_extractf128_pd(sum4, 1));
+            BlockScan scan;
+            scan.peak = _mm_cvtss_f32(peak4);
+            scan.sum_squares = _mm_cvtsd_f64(_mm_add_sd(sum2, _mm_unpackhi_pd(sum2, sum2)));
+            scan.finite = _mm256_movemask_ps(finite) == 0xff;
+            scan.changed = _mm256_testz_si256(diff, diff) == 0;
+            scan_tail(data + i, samples - i, reference != nullptr ? reference + i : nullptr, scan);
+            return scan;
+        }
+
+        ECHIDNA_DSP_TARGET("avx2")
+        bool all_finite_avx2(const float *data, size_t samples)
+        {
+            const __m256 sign = _mm256_set1_ps(-0.0f);
+            const __m256 largest = _mm256_set1_ps(std::numeric_limits<float>::max());
+            __m256 finite = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+            size_t i = 0;
+            for (; i + 8 <= samples; i += 8)
+            {
+                const __m256 magnitude = _mm256_andnot_ps(sign, _mm256_loadu_ps(data + i));
+                finite = _mm256_and_ps(finite, _mm256_cmp_ps(magnitude, largest, _CMP_LE_OQ));
+            }
+            bool result = _mm256_movemask_ps(finite) == 0xff;
+            for (; i < samples; ++i)
+            {
+                result = result && std::isfinite(data[i]);
+            }
+            return result;
+        }
+
+        ECHIDNA_DSP_TARGET("avx2")
+        bool decode_u8_avx2(const void *src, float *dst, size_t samples)
+        {
+            const auto *bytes = static_cast<const uint8_t *>(src);
+            const __m256 offset = _mm256_set1_ps(128.0f);
+            const __m256 scale = _mm256_set1_ps(1.0f / 128.0f);
+            size_t i = 0;
+            for (; i + 8 <= samples; i += 8)
+            {
+                const __m256i codes =
+                    _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(bytes + i)));
+                _mm256_storeu_ps(dst + i, _mm256_mul_ps(_mm256_sub_ps(_mm256_cvtepi32_ps(codes), offset), scale));
+            }
+            return decode_pcm_scalar<PcmEncoding::kUnsigned8>(bytes + i, dst + i, samples - i);
+        }
+
+        /** quantize_u8_sse41() on eight lanes. */
+        ECHIDNA_DSP_TARGET("avx2")
+        inline __m256i quantize_u8_avx2(__m256 x)
+        {
+            const __m256 clamped = _mm256_min_ps(_mm256_max_ps(x, _mm256_set1_ps(-1.0f)), _mm256_set1_ps(1.0f));
+            const __m256 scaled =
+                _mm256_add_ps(_mm256_mul_ps(clamped, _mm256_set1_ps(127.5f)), _mm256_set1_ps(127.5f));
+            const __m256 whole = _mm256_round_ps(scaled, _MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC);
+            const __m256 away = _mm256_and_ps(
+                _mm256_cmp_ps(_mm256_sub_ps(scaled, whole), _mm256_set1_ps(0.5f), _CMP_GE_OQ), _mm256_set1_ps(1.0f));
+            return _mm256_cvttps_epi32(_mm256_add_ps(whole, away));
+        }
+
+        /** Narrow eight in-range int32 lanes to int16. */
+        ECHIDNA_DSP_TARGET("avx2")
+        inline __m128i narrow_s16_avx2(__m256i wide)
+        {
+            return _mm_packs_epi32(_mm256_castsi256_si128(wide), _mm256_extracti128_si256(wide, 1));
+        }
+
+        ECHIDNA_DSP_TARGET("avx2")
+        void encode_u8_avx2(const float *src, void *dst, size_t samples)
+        {
+            auto *bytes = static_cast<uint8_t *>(dst);
+            size_t i = 0;
+            for (; i + 8 <= samples; i += 8)
+            {
+                const __m128i words = narrow_s16_avx2(quantize_u8_avx2(_mm256_loadu_ps(src + i)));
+                _mm_storel_epi64(reinterpret_cast<__m128i *>(bytes + i), _mm_packus_epi16(words, words));
+            }
+            encode_pcm_scalar<PcmEncoding::kUnsigned8>(src + i, bytes + i, samples - i);
+        }
+
+        ECHIDNA_DSP_TARGET("avx2")
+        bool decode_s16_avx2(const void *src, float *dst, size_t samples)
+        {
+            const auto *bytes = static_cast<const uint8_t *>(src);
+            const __m256 scale = _mm256_set1_ps(1.0f / 32768.0f);
+            size_t i = 0;
+            for (; i + 8 <= samples; i += 8)
+            {
+                const __m256i wide =
+                    _mm256_cvtepi16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i *>(bytes + 2 * i)));
+                _mm256_storeu_ps(dst + i, _mm256_mul_ps(_mm256_cvtepi32_ps(wide), scale));
+            }
+            return decode_pcm_scalar<PcmEncoding::kSigned16>(
+                bytes + pcm_offset<PcmEncoding::kSigned16>(i), dst + i, samples - i);
+        }
+
+        /** encode_s16() on eight lanes, widened to int32. */
+        ECHIDNA_DSP_TARGET("avx2")
+        inline __m256i quantize_s16_avx2(__m256 x)
+        {
+            const __m256 floor = _mm256_set1_ps(-1.0f);
+            const __m256 clamped = _mm256_min_ps(_mm256_max_ps(x, floor), _mm256_set1_ps(1.0f));
+            const __m256 scaled = _mm256_mul_ps(clamped, _mm256_set1_ps(32767.0f));
+            const __m256 sign = _mm256_set1_ps(-0.0f);
+            const __m256 whole = _mm256_round_ps(scaled, _MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC);
+            const __m256 fraction = _mm256_andnot_ps(sign, _mm256_sub_ps(scaled, whole));
+            const __m256 unit = _mm256_or_ps(_mm256_and_ps(scaled, sign), _mm256_set1_ps(1.0f));
+            const __m256 away = _mm256_and_ps(_mm256_cmp_ps(fraction, _mm256_set1_ps(0.5f), _CMP_GE_OQ), unit);
+            const __m256i rounded = _mm256_cvttps_epi32(_mm256_add_ps(whole, away));
+            return _mm256_blendv_epi8(rounded,
+                                      _mm256_set1_epi32(std::numeric_limits<int16_t>::min()),
+                                      _mm256_castps_si256(_mm256_cmp_ps(clamped, floor, _CMP_LE_OQ)));
+        }
+
+        ECHIDNA_DSP_TARGET("avx2")
+        void encode_s16_avx2(const float *src, void *dst, size_t samples)
+        {
+            auto *bytes = static_cast<uint8_t *>(dst);
+            size_t i = 0;
+            for (; i + 8 <= samples; i += 8)
+            {
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(bytes + 2 * i),
+                                 narrow_s16_avx2(quantize_s16_avx2(_mm256_loadu_ps(src + i))));
+            }
+            encode_pcm_scalar<PcmEncoding::kSigned16>(
+                src + i, bytes + pcm_offset<PcmEncoding::kSigned16>(i), samples - i);
+        }
+
+        ECHIDNA_DSP_TARGET("avx2")
+        bool decode_s32_avx2(const void *src, float *dst, size_t samples)
+        {
+            const auto *bytes = static_cast<const uint8_t *>(src);
+            const __m256 scale = _mm256_set1_ps(1.0f / 2147483648.0f);
+            size_t i = 0;
+            for (; i + 8 <= samples; i += 8)
+            {
+                const __m256i codes = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(bytes + 4 * i));
+                _mm256_storeu_ps(dst + i, _mm256_mul_ps(_mm256_cvtepi32_ps(codes), scale));
+            }
+            return decode_pcm_scalar<PcmEncoding::kSigned32>(
+                bytes + pcm_offset<PcmEncoding::kSigned32>(i), dst + i, samples - i);
+        }
+
+        /** quantize_s32_sse41() on four double lanes. */
+        ECHIDNA_DSP_TARGET("avx2")
+        inline __m128i quantize_s32_avx2(__m128 x)
+        {
+            const __m256d floor = _mm256_set1_pd(-1.0);
+            const __m256d clamped = _mm256_min_pd(_mm256_max_pd(_mm256_cvtps_pd(x), floor), _mm256_set1_pd(1.0));
+            const __m256d scaled = _mm256_mul_pd(clamped, _mm256_set1_pd(2147483647.0));
+            const __m256d sign = _mm256_set1_pd(-0.0);
+            const __m256d whole = _mm256_round_pd(scaled, _MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC);
+            const __m256d fraction = _mm256_andnot_pd(sign, _mm256_sub_pd(scaled, whole));
+            const __m256d unit = _mm256_or_pd(_mm256_and_pd(scaled, sign), _mm256_set1_pd(1.0));
+            const __m256d away =
+                _mm256_and_pd(_mm256_cmp_pd(fraction, _mm256_set1_pd(0.5), _CMP_GE_OQ), unit);
+            const __m256d rounded = _mm256_blendv_pd(_mm256_add_pd(whole, away),
+                                                     _mm256_set1_pd(-2147483648.0),
+                                                     _mm256_cmp_pd(clamped, floor, _CMP_LE_OQ));
+            return _mm256_cvttpd_epi32(rounded);
+        }
+
+        ECHIDNA_DSP_TARGET("avx2")
+        void encode_s32_avx2(const float *src, void *dst, size_t samples)
+        {
+            auto *bytes = static_cast<uint8_t *>(dst);
+            size_t i = 0;
+            for (; i + 8 <= samples; i += 8)
+            {
+                const __m256 x = _mm256_loadu_ps(src + i);
+                const __m128i low = quantize_s32_avx2(_mm256_castps256_ps128(x));
+                const __m128i high = quantize_s32_avx2(_mm256_extractf128_ps(x, 1));
+                _mm256_storeu_si256(reinterpret_cast<__m256i *>(bytes + 4 * i),
+                                    _mm256_inserti128_si256(_mm256_castsi128_si256(low), high, 1));
+            }
+            encode_pcm_scalar<PcmEncoding::kSigned32>(
+                src + i, bytes + pcm_offset<PcmEncoding::kSigned32>(i), samples - i);
+        }
+
+        ECHIDNA_DSP_TARGET("avx2")
+        bool decode_f32_avx2(const void *src, float *dst, size_t samples)
+        {
+            const auto *bytes = static_cast<const uint8_t *>(src);
+            const __m256 sign = _mm256_set1_ps(-0.0f);
+            const __m256 largest = _mm256_set1_ps(std::numeric_limits<float>::max());
+            __m256 finite = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+            size_t i = 0;
+            for (; i + 8 <= samples; i += 8)
+            {
+                const __m256 x = _mm256_loadu_ps(reinterpret_cast<const float *>(bytes + 4 * i));
+                finite = _mm256_and_ps(finite, _mm256_cmp_ps(_mm256_andnot_ps(sign, x), largest, _CMP_LE_OQ));
+                _mm256_storeu_ps(dst + i, x);
+            }
+            const bool tail = decode_pcm_scalar<PcmEncoding::kFloat32>(
+                bytes + pcm_offset<PcmEncoding::kFloat32>(i), dst + i, samples - i);
+            return tail && _mm256_movemask_ps(finite) == 0xff;
+        }
+
+        ECHIDNA_DSP_TARGET("avx2")
+        bool reencode_s16_avx2(const float *processed,
+                               const float *decoded,
+                               const int16_t *original,
+                               int16_t *dst,
+                               size_t samples)
+        {
+            __m256i diff = _mm256_setzero_si256();
+            size_t i = 0;
+            for (; i + 8 <= samples; i += 8)
+            {
+                const __m256i before =
+                    _mm256_cvtepi16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i *>(original + i)));
+                const __m256 x = _mm256_loadu_ps(processed + i);
+                const __m256i same = _mm256_cmpeq_epi32(_mm256_castps_si256(x),
+                                                        _mm256_castps_si256(_mm256_loadu_ps(decoded + i)));
+                const __m256i after = _mm256_blendv_epi8(quantize_s16_avx2(x), before, same);
+                diff = _mm256_or_si256(diff, _mm256_xor_si256(after, before));
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i), narrow_s16_avx2(after));
+            }
+            bool changed = _mm256_testz_si256(diff, diff) == 0;
+            for (; i < samples; ++i)
+            {
+                const int16_t before = original[i];
+                const bool touched =
+                    std::bit_cast<uint32_t>(processed[i]) != std::bit_cast<uint32_t>(decoded[i]);
+                const int16_t after = touched ? encode_s16(processed[i]) : before;
+                changed = changed || after != before;
+                dst[i] = after;
+            }
+            return changed;
+        }
+
+        ECHIDNA_DSP_TARGET("avx2")
+        void deinterleave_stereo_avx2(const float *interleaved, float *left, float *right, size_t frames)
+        {
+            size_t frame = 0;
+            for (; frame + 8 <= frames; frame += 8)
+            {
+                const __m256 a = _mm256_loadu_ps(interleaved + frame * 2);
+                const __m256 b = _mm256_loadu_ps(interleaved + frame * 2 + 8);
+                // Shuffles stay within 128-bit halves: {0 1 4 5 | 2 3 6 7}.
+                const __m256 even = _mm256_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0));
+                const __m256 odd = _mm256_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1));
+                constexpr int kOrder = _MM_SHUFFLE(3, 1, 2, 0);
+                _mm256_storeu_ps(left + frame,
+                                 _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(even), kOrder)));
+                _mm256_storeu_ps(right + frame,
+                                 _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(odd), kOrder)));
+            }
+            for (; frame < frames; ++frame)
+            {
+                left[frame] = interleaved[frame * 2];
+                right[frame] = interleaved[frame * 2 + 1];
+            }
+        }
+
+        ECHIDNA_DSP_TARGET("avx2")
+        void interleave_stereo_avx2(const float *left, const float *right, float *interleaved, size_t frames)
+        {
+            size_t frame = 0;
+            for (; frame + 8 <= frames; frame += 8)
+            {
+                const __m256 l = _mm256_loadu_ps(left + frame);
+                const __m256 r = _mm256_loadu_ps(right + frame);
+                // Frames {0 1 | 4 5} and {2 3 | 6 7}; swap the middle halves.
+                const __m256 low = _mm256_unpacklo_ps(l, r);
+                const __m256 high = _mm256_unpackhi_ps(l, r);
+                _mm256_storeu_ps(interleaved + frame * 2, _mm256_permute2f128_ps(low, high, 0x20));
+                _mm256_storeu_ps(interleaved + frame * 2 + 8, _mm256_permute2f128_ps(low, high, 0x31));
+            }
+            for (; frame < frames; ++frame)
+            {
+                interleaved[frame * 2] = left[frame];
+                interleaved[frame * 2 + 1] = right[frame];
+            }
+        }
+
+        // --- AVX-512: sixteen lanes, masked tails where lanes are independent ---
+
+        // GCC 12's avx512fintrin.h passes _mm512_undefined_*() as the merge
+        // source of the unmasked intrinsics, which -Wall reports as an
+        // uninitialised read once they inline (GCC PR 105593).
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wuninitialized"
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+
+        ECHIDNA_DSP_TARGET("avx512f")
+        void apply_gain_avx512(float *data, size_t samples, float gain)
+        {
+            const __m512 g = _mm512_set1_ps(gain);
+            size_t i = 0;
+            for (; i + 16 <= samples; i += 16)
+            {
+                _mm512_storeu_ps(data + i, _mm512_mul_ps(_mm512_loadu_ps(data + i), g));
+            }
+            if (i < samples)
+            {
+                const auto mask = static_cast<__mmask16>((1u << (samples - i)) - 1u);
+                _mm512_mask_storeu_ps(data + i, mask, _mm512_mul_ps(_mm512_maskz_loadu_ps(mask, data + i), g));
+            }
+        }
+
+        ECHIDNA_DSP_TARGET("avx512f")
+        void mix_in_avx512(float *dst, const float *src, size_t samples, float gain)
+        {
+            const __m512 g = _mm512_set1_ps(gain);
+            size_t i = 0;
+            for (; i + 16 <= samples; i += 16)
+            {
+                const __m512 s = _mm512_mul_ps(_mm512_loadu_ps(src + i), g);
+                _mm512_storeu_ps(dst + i, _mm512_add_ps(_mm512_loadu_ps(dst + i), s));
+            }
+            if (i < samples)
+            {
+                const auto mask = static_cast<__mmask16>((1u << (samples - i)) - 1u);
+                const __m512 s = _mm512_mul_ps(_mm512_maskz_loadu_ps(mask, src + i), g);
+                _mm512_mask_storeu_ps(dst + i, mask, _mm512_add_ps(_mm512_maskz_loadu_ps(mask, dst + i), s));
+            }
+        }
+
+        /** Lanes [0, count) of a sixteen-lane step; all of them from 16 up. */
+        inline __mmask16 tail_mask(size_t count)
+        {
+            return count >= 16 ? static_cast<__mmask16>(0xffff) : static_cast<__mmask16>((1u << count) - 1u);
+        }
+
+        ECHIDNA_DSP_TARGET("avx512f")
+        void crossfade_avx512(const float *dry,
+                              const float *wet,
+                              float *output,
+                              size_t samples,
+                              float dry_gain,
+                              float wet_gain,
+                              float output_gain)
+        {
+            const __m512 dg = _mm512_set1_ps(dry_gain);
+            const __m512 wg = _mm512_set1_ps(wet_gain);
+            const __m512 og = _mm512_set1_ps(output_gain);
+            for (size_t i = 0; i < samples; i += 16)
+            {
+                const __mmask16 mask = tail_mask(samples - i);
+                const __m512 mixed = _mm512_add_ps(_mm512_mul_ps(_mm512_maskz_loadu_ps(mask, dry + i), dg),
+                                                   _mm512_mul_ps(_mm512_maskz_loadu_ps(mask, wet + i), wg));
+                _mm512_mask_storeu_ps(output + i, mask, _mm512_mul_ps(mixed, og));
+            }
+        }
+
+        ECHIDNA_DSP_TARGET("avx512f")
+        BlockScan scan_block_avx512(const float *data, size_t samples, const float *reference)
+        {
+            const __m512 largest = _mm512_set1_ps(std::numeric_limits<float>::max());
+            __m512 peak = _mm512_setzero_ps();
+            __m512d sum_low = _mm512_setzero_pd();
+            __m512d sum_high = _mm512_setzero_pd();
+            __mmask16 not_finite = 0;
+            __mmask16 changed = 0;
+            // Masked-off lanes load as zero in both blocks, so they count as
+            // finite, silent and unchanged.
+            for (size_t i = 0; i < samples; i += 16)
+            {
+                const __mmask16 mask = tail_mask(samples - i);
+                const __m512 x = _mm512_maskz_loadu_ps(mask, data + i);
+                const __m512 magnitude = _mm512_abs_ps(x);
+                not_finite |= _mm512_cmp_ps_mask(magnitude, largest, _CMP_NLE_UQ);
+                peak = _mm512_max_ps(peak, magnitude);
+                const __m512d low = _mm512_cvtps_pd(_mm512_castps512_ps256(x));
+                const __m512d high =
+                    _mm512_cvtps_pd(_mm256_castpd_ps(_mm512_extractf64x4_pd(_mm512_castps_pd(x), 1)));
+                sum_low = _mm512_add_pd(sum_low, _mm512_mul_pd(low, low));
+                sum_high = _mm512_add_pd(sum_high, _mm512_mul_pd(high, high));
+                if (reference != nullptr)
+                {
+                    changed |= _mm512_cmpneq_epi32_mask(_mm512_castps_si512(x),
+                                                        _mm512_castps_si512(_mm512_maskz_loadu_ps(mask, reference + i)));
+                }
+            }
+            BlockScan scan;
+            scan.peak = _mm512_reduce_max_ps(peak);
+            scan.sum_squares = _mm512_reduce_add_pd(_mm512_add_pd(sum_low, sum_high));
+            scan.finite = not_finite == 0;
+            scan.changed = changed != 0;
+            return scan;
+        }
+
+        ECHIDNA_DSP_TARGET("avx512f")
+        bool all_finite_avx512(const float *data, size_t samples)
+        {
+            const __m512 largest = _mm512_set1_ps(std::numeric_limits<float>::max());
+            __mmask16 not_finite = 0;
+            for (size_t i = 0; i < samples; i += 16)
+            {
+                const __m512 magnitude = _mm512_abs_ps(_mm512_maskz_loadu_ps(tail_mask(samples - i), data + i));
+                not_finite |= _mm512_cmp_ps_mask(magnitude, largest, _CMP_NLE_UQ);
+            }
+            return not_finite == 0;
+        }
+
+        ECHIDNA_DSP_TARGET("avx512f")
+        bool decode_s16_avx512(const void *src, float *dst, size_t samples)
+        {
+            const auto *bytes = static_cast<const uint8_t *>(src);
+            const __m512 scale = _mm512_set1_ps(1.0f / 32768.0f);
+            size_t i = 0;
+            for (; i + 16 <= samples; i += 16)
+            {
+                const __m512i wide =
+                    _mm512_cvtepi16_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(bytes + 2 * i)));
+                _mm512_storeu_ps(dst + i, _mm512_mul_ps(_mm512_cvtepi32_ps(wide), scale));
+            }
+            return decode_pcm_scalar<PcmEncoding::kSigned16>(
+                bytes + pcm_offset<PcmEncoding::kSigned16>(i), dst + i, samples - i);
+        }
+
+        /** encode_s16() on sixteen lanes, widened to int32. */
+        ECHIDNA_DSP_TARGET("avx512f")
+        inline __m512i quantize_s16_avx512(__m512 x)
+        {
+            const __m512 floor = _mm512_set1_ps(-1.0f);
+            const __m512 clamped = _mm512_min_ps(_mm512_max_ps(x, floor), _mm512_set1_ps(1.0f));
+            const __m512 scaled = _mm512_mul_ps(clamped, _mm512_set1_ps(32767.0f));
+            const __m512 whole = _mm512_roundscale_ps(scaled, _MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC);
+            const __mmask16 away =
+                _mm512_cmp_ps_mask(_mm512_abs_ps(_mm512_sub_ps(scaled, whole)), _mm512_set1_ps(0.5f), _CMP_GE_OQ);
+            const __m512i sign_bits =
+                _mm512_and_si512(_mm512_castps_si512(scaled), _mm512_set1_epi32(std::numeric_limits<int32_t>::min()));
+            const __m512 unit =
+                _mm512_castsi512_ps(_mm512_or_si512(sign_bits, _mm512_castps_si512(_mm512_set1_ps(1.0f))));
+            const __m512i rounded = _mm512_cvttps_epi32(_mm512_mask_add_ps(whole, away, whole, unit));
+            return _mm512_mask_blend_epi32(_mm512_cmp_ps_mask(clamped, floor, _CMP_LE_OQ),
+                                           rounded,
+                                           _mm512_set1_epi32(std::numeric_limits<int16_t>::min()));
+        }
+
+        ECHIDNA_DSP_TARGET("avx512f")
+        void encode_s16_avx512(const float *src, void *dst, size_t samples)
+        {
+            auto *bytes = static_cast<uint8_t *>(dst);
+            size_t i = 0;
+            for (; i + 16 <= samples; i += 16)
+            {
+                _mm256_storeu_si256(reinterpret_cast<__m256i *>(bytes + 2 * i),
+                                    _mm512_cvtsepi32_epi16(quantize_s16_avx512(_mm512_loadu_ps(src + i))));
+            }
+            encode_pcm_scalar<PcmEncoding::kSigned16>(
+                src + i, bytes + pcm_offset<PcmEncoding::kSigned16>(i), samples - i);
+        }
+
+        ECHIDNA_DSP_TARGET("avx512f")
+        bool reencode_s16_avx512(const float *processed,
+                                 const float *decoded,
+                                 const int16_t *original,
+                                 int16_t *dst,
+                                 size_t samples)
+        {
+            __mmask16 diff = 0;
+            size_t i = 0;
+            for (; i + 16 <= samples; i += 16)
+            {
+                const __m512i before =
+                    _mm512_cvtepi16_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(original + i)));
+                const __m512 x = _mm512_loadu_ps(processed + i);
+                const __mmask16 same = _mm512_cmpeq_epi32_mask(_mm512_castps_si512(x),
+                                                               _mm512_castps_si512(_mm512_loadu_ps(decoded + i)));
+                const __m512i after = _mm512_mask_blend_epi32(same, quantize_s16_avx512(x), before);
+                diff |= _mm512_cmpneq_epi32_mask(after, before);
+                _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + i), _mm512_cvtsepi32_epi16(after));
+            }
+            bool changed = diff != 0;
+            for (; i < samples; ++i)
+            {
+                const int16_t before = original[i];
+                const bool touched =
+                    std::bit_cast<uint32_t>(processed[i]) != std::bit_cast<uint32_t>(decoded[i]);
+                const int16_t after = touched ? encode_s16(processed[i]) : before;
+                changed = changed || after != before;
+                dst[i] = after;
+            }
+            return changed;
+        }
+
+        ECHIDNA_DSP_TARGET("avx512f")
+        void deinterleave_stereo_avx512(const float *interleaved, float *left, float *right, size_t frames)
+        {
+            const __m512i even = _mm512_setr_epi32(0, 2, 4, 6, 8, 10, 12, 14, 16, 18, 20, 22, 24, 26, 28, 30);
+            const __m512i odd = _mm512_setr_epi32(1, 3, 5, 7, 9, 11, 13, 15, 17, 19, 21, 23, 25, 27, 29, 31);
+            size_t frame = 0;
+            for (; frame + 16 <= frames; frame += 16)
+            {
+                const __m512 a = _mm512_loadu_ps(interleaved + frame * 2);
+                const __m512 b = _mm512_loadu_ps(interleaved + frame * 2 + 16);
+                _mm512_storeu_ps(left + frame, _mm512_permutex2var_ps(a, even, b));
+                _mm512_storeu_ps(right + frame, _mm512_permutex2var_ps(a, odd, b));
+            }
+            for (; frame < frames; ++frame)
+            {
+                left[frame] = interleaved[frame * 2];
+                right[frame] = interleaved[frame * 2 + 1];
+            }
+        }
+
+        ECHIDNA_DSP_TARGET("avx512f")
+        void interleave_stereo_avx512(const float *left, const float *right, float *interleaved, size_t frames)
+        {
+            const __m512i low = _mm512_setr_epi32(0, 16, 1, 17, 2, 18, 3, 19, 4, 20, 5, 21, 6, 22, 7, 23);
+            const __m512i high = _mm512_setr_epi32(8, 24, 9, 25, 10, 26, 11, 27, 12, 28, 13, 29, 14, 30, 15, 31);
+            size_t frame = 0;
+            for (; frame + 16 <= frames; frame += 16)
+            {
+                const __m512 l = _mm512_loadu_ps(left + frame);
+                const __m512 r = _mm512_loadu_ps(right + frame);
+                _mm512_storeu_ps(interleaved + frame * 2, _mm512_permutex2var_ps(l, low, r));
+                _mm512_storeu_ps(interleaved + frame * 2 + 16, _mm512_permutex2var_ps(l, high, r));
+            }
+            for (; frame < frames; ++frame)
+            {
+                interleaved[frame * 2] = left[frame];
+                interleaved[frame * 2 + 1] = right[frame];
+            }
+        }
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+    } // namespace
+
+    const SimdKernels kSse41Kernels{
+        apply_gain_sse41,
+        mix_in_sse41,
+        crossfade_sse41,
+        scan_block_sse41,
+        all_finite_sse41,
+        {decode_u8_sse41,
+         decode_s16_sse41,
+         decode_s24_sse41,
+         decode_s32_sse41,
+         decode_f32_sse41},
+        {encode_u8_sse41,
+         encode_s16_sse41,
+         encode_s24_sse41,
+         encode_s32_sse41,
+         encode_pcm_scalar<PcmEncoding::kFloat32>},
+        reencode_s16_sse41,
+        deinterleave_stereo_sse41,
+        interleave_stereo_sse41,
+    };
+
+    const SimdKernels kAvx2Kernels{
+        apply_gain_avx2,
+        mix_in_avx2,
+        crossfade_avx2,
+        scan_block_avx2,
+        all_finite_avx2,
+        {decode_u8_avx2,
+         decode_s16_avx2,
+         decode_s24_sse41,
+         decode_s32_avx2,
+         decode_f32_avx2},
+        {encode_u8_avx2,
+         encode_s16_avx2,
+         encode_s24_sse41,
+         encode_s32_avx2,
+         encode_pcm_scalar<PcmEncoding::kFloat32>},
+        reencode_s16_avx2,
+        deinterleave_stereo_avx2,
+        interleave_stereo_avx2,
+    };
+
+    const SimdKernels kAvx512Kernels{
+        apply_gain_avx512,
+        mix_in_avx512,
+        crossfade_avx512,
+        scan_block_avx512,
+        all_finite_avx512,
+        {decode_u8_avx2,
+         decode_s16_avx512,
+         decode_s24_sse41,
+         decode_s32_avx2,
+         decode_f32_avx2},
+        {encode_u8_avx2,
+         encode_s16_avx512,
+         encode_s24_sse41,
+         encode_s32_avx2,
+         encode_pcm_scalar<PcmEncoding::kFloat32>},
+        reencode_s16_avx512,
+        deinterleave_stereo_avx512,
+        interleave_stereo_avx512,
+    };
+
+} // namespace echidna::dsp::runtime
+
+#endif // ECHIDNA_DSP_HAS_AVX
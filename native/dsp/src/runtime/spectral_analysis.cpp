@@ -0,0 +1,198 @@
+#include "spectral_analysis.h"
+
+/**
+ * @file spectral_analysis.cpp
+ * @brief Mono mixdown, hop scheduling and the per-hop pitch, STFT and
+ * cepstral envelope computations of the analysis bus.
+ */
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+
+namespace echidna::dsp::runtime
+{
+
+    bool CepstralEnvelope::prepare(uint32_t sample_rate, size_t fft_size)
+    {
+        if (sample_rate == 0 || !fft_.prepare(fft_size))
+        {
+            return false;
+        }
+        lifter_ = std::clamp<size_t>(static_cast<size_t>(static_cast<float>(sample_rate) / kLifterHz),
+                                     1, fft_size / 2 - 1);
+        re_.assign(fft_.bins(), 0.0f);
+        im_.assign(fft_.bins(), 0.0f);
+        cepstrum_.assign(fft_size, 0.0f);
+        return true;
+    }
+
+    void CepstralEnvelope::compute(const float *magnitude, float *envelope)
+    {
+        constexpr float kFloor = 1.0e-9f;
+        const size_t bins = fft_.bins();
+        for (size_t k = 0; k < bins; ++k)
+        {
+            re_[k] = std::log(std::max(magnitude[k], kFloor));
+            im_[k] = 0.0f;
+        }
+        fft_.inverse(re_.data(), im_.data(), cepstrum_.data());
+        std::fill(cepstrum_.begin() + static_cast<std::ptrdiff_t>(lifter_ + 1),
+                  cepstrum_.end() - static_cast<std::ptrdiff_t>(lifter_), 0.0f);
+        fft_.forward(cepstrum_.data(), re_.data(), im_.data());
+        for (size_t k = 0; k < bins; ++k)
+        {
+            envelope[k] = std::exp(re_[k]);
+        }
+    }
+
+    bool SpectralAnalysis::prepare(uint32_t sample_rate)
+    {
+        hop_ = 0;
+        if (sample_rate == 0)
+        {
+            return false;
+        }
+        // About 20 ms frames every 10 ms.
+        const size_t fft_size =
+            std::clamp<size_t>(std::bit_ceil<size_t>(sample_rate / 50), 256, RealFft::kMaxSize);
+        if (!fft_.prepare(fft_size) || !cepstral_.prepare(sample_rate, fft_size) ||
+            !detector_.prepare(sample_rate, PitchDetectorSettings{}))
+        {
+            return false;
+        }
+        bin_hz_ = static_cast<float>(sample_rate) / static_cast<float>(fft_size);
+
+        constexpr double kPi = 3.14159265358979323846;
+        window_.resize(fft_size);
+        for (size_t n = 0; n < fft_size; ++n)
+        {
+            window_[n] = static_cast<float>(
+                0.5 - 0.5 * std::cos(2.0 * kPi * static_cast<double>(n) / static_cast<double>(fft_size)));
+        }
+        history_.assign(fft_size, 0.0f);
+        frame_.assign(fft_size, 0.0f);
+        re_.assign(fft_.bins(), 0.0f);
+        im_.assign(fft_.bins(), 0.0f);
+        magnitude_.assign(fft_.bins(), 0.0f);
+        envelope_.assign(fft_.bins(), 0.0f);
+        hop_ = std::max<size_t>(1, sample_rate / 100);
+        reset();
+        return true;
+    }
+
+    void SpectralAnalysis::reset()
+    {
+        detector_.reset();
+        std::fill(history_.begin(), history_.end(), 0.0f);
+        std::fill(magnitude_.begin(), magnitude_.end(), 0.0f);
+        std::fill(envelope_.begin(), envelope_.end(), 0.0f);
+        since_hop_ = 0;
+        write_ = 0;
+        features_ = 0;
+        hop_count_ = 0;
+        pitch_hz_ = 0.0f;
+    }
+
+    void SpectralAnalysis::analyze(const float *const *channels,
+                                   uint32_t channel_count,
+                                   size_t frames,
+                                   uint32_t features)
+    {
+        if (hop_ == 0 || channel_count == 0)
+        {
+            return;
+        }
+        const float channel_scale = 1.0f / static_cast<float>(channel_count);
+        const size_t size = history_.size();
+        for (size_t offset = 0; offset < frames; offset += kChunk)
+        {
+            const size_t count = std::min(kChunk, frames - offset);
+            std::copy_n(channels[0] + offset, count, chunk_.data());
+            for (uint32_t ch = 1; ch < channel_count; ++ch)
+            {
+                const float *source = channels[ch] + offset;
+                for (size_t i = 0; i < count; ++i)
+                {
+                    chunk_[i] += source[i];
+                }
+            }
+            if (channel_count > 1)
+            {
+                for (size_t i = 0; i < count; ++i)
+                {
+                    chunk_[i] *= channel_scale;
+                }
+            }
+
+            // Split at hop boundaries so each hop sees exactly its samples.
+            size_t done = 0;
+            while (done < count)
+            {
+                const size_t take = std::min(count - done, hop_ - since_hop_);
+                const float *samples = chunk_.data() + done;
+                if ((features & kPitch) != 0)
+                {
+                    detector_.push(samples, take);
+                }
+                if ((features & (kSpectrum | kEnvelope)) != 0)
+                {
+                    for (size_t i = 0; i < take; ++i)
+                    {
+                        history_[write_] = samples[i];
+                        write_ = write_ + 1 == size ? 0 : write_ + 1;
+                    }
+                }
+                done += take;
+                since_hop_ += take;
+                if (since_hop_ == hop_)
+                {
+                    since_hop_ = 0;
+                    analyze_hop(features);
+                }
+            }
+        }
+    }
+
+    void SpectralAnalysis::analyze_hop(uint32_t features)
+    {
+        if ((features & kEnvelope) != 0)
+        {
+            features |= kSpectrum;
+        }
+        features_ = features;
+        ++hop_count_;
+        if ((features & kPitch) != 0)
+        {
+            pitch_hz_ = detector_.estimate();
+        }
+        if ((features & kSpectrum) == 0)
+        {
+            return;
+        }
+
+        // Oldest sample first.
+        const size_t size = history_.size();
+        const size_t tail = size - write_;
+        for (size_t n = 0; n < tail; ++n)
+        {
+            frame_[n] = history_[write_ + n] * window_[n];
+        }
+        for (size_t n = tail; n < size; ++n)
+        {
+            frame_[n] = history_[n - tail] * window_[n];
+        }
+        fft_.forward(frame_.data(), re_.data(), im_.data());
+        const size_t bins = fft_.bins();
+        for (size_t k = 0; k < bins; ++k)
+        {
+            magnitude_[k] = std::sqrt(re_[k] * re_[k] + im_[k] * im_[k]);
+        }
+        if ((features & kEnvelope) == 0)
+        {
+            return;
+        }
+        cepstral_.compute(magnitude_.data(), envelope_.data());
+    }
+
+} // namespace echidna::dsp::runtime
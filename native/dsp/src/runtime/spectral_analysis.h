@@ -0,0 +1,145 @@
+#pragma once
+
+/**
+ * @file spectral_analysis.h
+ * @brief Shared per-hop analysis of a mono mixdown: pitch, STFT magnitude
+ * and cepstral spectral envelope.
+ */
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "fft.h"
+#include "pitch_detector.h"
+
+namespace echidna::dsp::runtime
+{
+
+    /**
+     * @brief Smooth spectral envelope of a magnitude spectrum from its real
+     * cepstrum.
+     *
+     * The log magnitude is transformed to the cepstrum, quefrencies of
+     * 1 / kLifterHz seconds and above are cleared and the rest is transformed
+     * back and exponentiated. That leaves out the harmonic ripple of voices
+     * pitched under kLifterHz.
+     */
+    class CepstralEnvelope
+    {
+    public:
+        /** Lifter cutoff as a frequency. */
+        static constexpr float kLifterHz = 600.0f;
+
+        /**
+         * Prepare for spectra of a `fft_size`-point transform at
+         * `sample_rate`; returns false for an unsupported size.
+         */
+        bool prepare(uint32_t sample_rate, size_t fft_size);
+        /** Values per spectrum: fft_size / 2 + 1. */
+        size_t bins() const { return fft_.bins(); }
+        /** Write the envelope of `magnitude` (bins() values each); never allocates. */
+        void compute(const float *magnitude, float *envelope);
+
+    private:
+        size_t lifter_{0};
+        RealFft fft_{};
+        std::vector<float> re_{};
+        std::vector<float> im_{};
+        std::vector<float> cepstrum_{};
+    };
+
+    /**
+     * @brief Analysis bus computed once per 10 ms hop for every effect that
+     * subscribes to it.
+     *
+     * The engine feeds the bus the signal at one point of the chain and hands
+     * it to the following stages through effects::ProcessContext::analysis.
+     * Each analyze() call names the features its subscribers read, and only
+     * those are computed. The frame always describes the most recent complete
+     * hop: pitch from a YIN detector at its default settings, then the
+     * magnitude of a Hann-windowed STFT frame and its CepstralEnvelope.
+     */
+    class SpectralAnalysis
+    {
+    public:
+        /** Features a subscriber reads (bit mask). */
+        enum Feature : uint32_t
+        {
+            kPitch = 1U << 0,
+            kSpectrum = 1U << 1,
+            /** Implies kSpectrum. */
+            kEnvelope = 1U << 2,
+        };
+
+        /**
+         * Allocate every buffer for `sample_rate`; returns false (and stays
+         * unprepared) for a rate the FFT cannot cover.
+         */
+        bool prepare(uint32_t sample_rate);
+        /** True once prepare() succeeded. */
+        bool prepared() const { return hop_ != 0; }
+        /** Forget all history and clear the current frame. */
+        void reset();
+
+        /**
+         * @brief Append `frames` frames of `channel_count` planar channels and
+         * analyse every hop they complete, computing `features`.
+         *
+         * Never allocates.
+         */
+        void analyze(const float *const *channels,
+                     uint32_t channel_count,
+                     size_t frames,
+                     uint32_t features);
+
+        /** Features computed for the current frame. */
+        uint32_t features() const { return features_; }
+        /** Hops analysed since reset(). */
+        uint64_t hop_count() const { return hop_count_; }
+        /** Frames between analyses. */
+        size_t hop_frames() const { return hop_; }
+
+        /** Fundamental (Hz) of the current frame, or 0 when unvoiced. */
+        float pitch_hz() const { return pitch_hz_; }
+
+        /** STFT frame length in samples. */
+        size_t fft_size() const { return fft_.size(); }
+        /** Values in magnitude() and envelope(). */
+        size_t bins() const { return fft_.bins(); }
+        /** Frequency spacing of the bins. */
+        float bin_hz() const { return bin_hz_; }
+        /** |X[k]| of the current frame, bins() values. */
+        const float *magnitude() const { return magnitude_.data(); }
+        /** Smoothed |X[k]| of the current frame, bins() values. */
+        const float *envelope() const { return envelope_.data(); }
+
+    private:
+        static constexpr size_t kChunk = 256;
+
+        /** Analyse the frame ending at the latest sample. */
+        void analyze_hop(uint32_t features);
+
+        size_t hop_{0};
+        size_t since_hop_{0};
+        size_t write_{0};
+        float bin_hz_{0.0f};
+        uint32_t features_{0};
+        uint64_t hop_count_{0};
+        float pitch_hz_{0.0f};
+        YinPitchDetector detector_{};
+        RealFft fft_{};
+        CepstralEnvelope cepstral_{};
+        std::array<float, kChunk> chunk_{};
+        /** Ring of the last fft_size() mixdown samples. */
+        std::vector<float> history_{};
+        std::vector<float> window_{};
+        std::vector<float> frame_{};
+        std::vector<float> re_{};
+        std::vector<float> im_{};
+        std::vector<float> magnitude_{};
+        std::vector<float> envelope_{};
+    };
+
+} // namespace echidna::dsp::runtime
@@ -44,6 +44,8 @@ static_assert(std::is_same_v<decltype(&ech_dsp_prepare_realtime),
                              ech_dsp_status_t (*)(size_t)>);
 static_assert(std::is_same_v<decltype(&ech_dsp_process_block),
                              ech_dsp_status_t (*)(const float *, float *, size_t)>);
+static_assert(std::is_same_v<decltype(&ech_dsp_get_latency),
+                             ech_dsp_status_t (*)(uint32_t *, size_t *)>);
 static_assert(std::is_same_v<decltype(&ech_dsp_engine_create),
                              ech_dsp_status_t (*)(uint32_t,
                                                   uint32_t,
@@ -57,6 +59,12 @@ static_assert(std::is_same_v<decltype(&ech_dsp_engine_process),
                                                   const float *,
                                                   float *,
                                                   size_t)>);
+static_assert(std::is_same_v<decltype(&ech_dsp_engine_get_latency),
+                             ech_dsp_status_t (*)(ech_dsp_engine_t *,
+                                                  uint32_t *,
+                                                  size_t *)>);
+static_assert(std::is_same_v<decltype(&ech_dsp_engine_reset),
+                             ech_dsp_status_t (*)(ech_dsp_engine_t *)>);
 static_assert(std::is_same_v<decltype(&ech_dsp_engine_destroy),
                              void (*)(ech_dsp_engine_t *)>);
 static_assert(std::is_same_v<decltype(&ech_dsp_shutdown), void (*)(void)>);
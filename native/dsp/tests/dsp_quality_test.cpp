@@ -20,12 +20,17 @@
  *     non-finite input (garbage-in/garbage-out by design). The sanitizing guard
  *     lives one layer up in stream_handle_registry (std::isfinite). This test
  *     documents that contract so a future accidental change is caught.
+ *   - Shared analysis bus: allocated only once a preset enables a subscriber,
+ *     and the formant and Auto-Tune stages it feeds stay finite and in tune.
+ *   - Low-latency pitch tolerance: the granular delay-line shifter stays within
+ *     1e-4 of its original cos / modulo formulation across a ratio sweep.
  *
  * Uses an explicit CHECK macro (not assert()) so the checks run under NDEBUG /
  * Release, where assert() is compiled out and would pass vacuously.
  */
 
 #include "echidna/dsp/api.h"
+#include "effects/pitch_shifter.h"
 #include "engine.h"
 
 #include <algorithm>
@@ -35,6 +40,7 @@
 #include <cstdio>
 #include <cstring>
 #include <limits>
+#include <string>
 #include <vector>
 
 namespace
@@ -86,6 +92,52 @@ namespace
         ]
     })";
 
+    // Auto-Tune alone: the only subscriber of the shared analysis bus.
+    const char *kAutoTunePreset = R"({
+        "name": "Tune",
+        "engine": {"latencyMode": "LL", "blockMs": 20},
+        "modules": [
+            {"id": "gate", "enabled": false},
+            {"id": "eq", "enabled": false, "bands": []},
+            {"id": "comp", "enabled": false},
+            {"id": "pitch", "enabled": false},
+            {"id": "formant", "enabled": false},
+            {"id": "autotune", "enabled": true, "key": "C", "scale": "Chromatic", "retuneMs": 1.0, "humanize": 0.0},
+            {"id": "reverb", "enabled": false},
+            {"id": "mix", "wet": 100.0, "outGain": 0.0}
+        ]
+    })";
+
+    // Darth Vader: pitch down, then the formant stage reads the bus envelope.
+    const char *kPitchFormantPreset = R"({
+        "name": "PitchFormant",
+        "engine": {"latencyMode": "LL", "blockMs": 20},
+        "modules": [
+            {"id": "gate", "enabled": false},
+            {"id": "eq", "enabled": true, "bands": [{"f": 3500.0, "g": -12.0, "q": 0.7}]},
+            {"id": "comp", "enabled": false},
+            {"id": "pitch", "enabled": true, "semitones": -7, "cents": 0, "quality": "LL"},
+            {"id": "formant", "enabled": true, "cents": -250, "intelligibility": true},
+            {"id": "autotune", "enabled": false},
+            {"id": "reverb", "enabled": false},
+            {"id": "mix", "wet": 100.0, "outGain": 0.0}
+        ]
+    })";
+
+    // Convolution reverb with the response named `ir`.
+    std::string convolution_preset(const char *ir)
+    {
+        return std::string(R"({
+        "name": "Convolution",
+        "engine": {"latencyMode": "LL", "blockMs": 20},
+        "modules": [
+            {"id": "reverb", "enabled": true, "mode": "convolution", "ir": ")") +
+               ir + R"(", "predelayMs": 0, "mix": 50},
+            {"id": "mix", "wet": 100.0, "outGain": 0.0}
+        ]
+    })";
+    }
+
     bool all_finite(const float *x, size_t n)
     {
         for (size_t i = 0; i < n; ++i)
@@ -293,14 +345,263 @@ namespace
         CHECK(!std::isfinite(out[1 + 10]),
               "engine does not sanitize NaN input (sanitization is the registry's job)");
     }
+
+    // The analysis bus costs nothing until a preset enables a subscriber; it
+    // then feeds the formant stage behind a pitch shift, and the Auto-Tune
+    // stage, which must still correct 450 Hz to A4.
+    void test_analysis_bus()
+    {
+        using echidna::dsp::DspEngine;
+        using echidna::dsp::DspEngineOptions;
+        DspEngineOptions options;
+        options.load_plugins = false;
+        options.lock_free_realtime_process = true;
+        DspEngine engine(48000, 1, ECH_DSP_QUALITY_LOW_LATENCY, options);
+        auto chain = echidna::dsp::config::LoadPresetFromJson(kRealChainPreset);
+        CHECK(chain.ok && engine.UpdatePreset(chain.preset) == ECH_DSP_STATUS_OK,
+              "analysis bus chain preset apply");
+        CHECK(!engine.analysis_bus_allocated(), "a chain without subscribers must not allocate the bus");
+
+        constexpr size_t kBlock = 256;
+        constexpr size_t kBlocks = 300;
+        CHECK(engine.PrepareRealtime(kBlock) == ECH_DSP_STATUS_OK, "analysis bus prepare");
+        std::vector<float> output(kBlock * kBlocks);
+        std::vector<float> block(kBlock);
+        auto run = [&]()
+        {
+            for (size_t b = 0; b < kBlocks; ++b)
+            {
+                for (size_t i = 0; i < kBlock; ++i)
+                {
+                    const double t = static_cast<double>(b * kBlock + i) / 48000.0;
+                    block[i] = static_cast<float>(0.35 * std::sin(2.0 * kPi * 450.0 * t));
+                }
+                CHECK(engine.ProcessBlock(block.data(), output.data() + b * kBlock, kBlock) ==
+                          ECH_DSP_STATUS_OK,
+                      "analysis bus process");
+            }
+        };
+
+        auto vader = echidna::dsp::config::LoadPresetFromJson(kPitchFormantPreset);
+        CHECK(vader.ok && engine.UpdatePreset(vader.preset) == ECH_DSP_STATUS_OK,
+              "pitch and formant preset apply");
+        CHECK(engine.analysis_bus_allocated(), "a formant shift must allocate the bus");
+        run();
+        CHECK(all_finite(output.data(), output.size()), "bus-fed formant output must be finite");
+
+        auto tune = echidna::dsp::config::LoadPresetFromJson(kAutoTunePreset);
+        CHECK(tune.ok && engine.UpdatePreset(tune.preset) == ECH_DSP_STATUS_OK,
+              "auto-tune preset apply");
+        run();
+        // Rising zero crossings over the last half second.
+        const size_t begin = output.size() - 24000;
+        size_t first = 0;
+        size_t last = 0;
+        size_t crossings = 0;
+        for (size_t i = begin + 1; i < output.size(); ++i)
+        {
+            if (output[i - 1] < 0.0f && output[i] >= 0.0f)
+            {
+                first = crossings == 0 ? i : first;
+                last = i;
+                ++crossings;
+            }
+        }
+        const double hz = crossings > 1 ? 48000.0 * static_cast<double>(crossings - 1) /
+                                              static_cast<double>(last - first)
+                                        : 0.0;
+        CHECK(hz > 432.5 && hz < 447.5, "the bus-fed auto-tune must correct 450 Hz towards 440 Hz");
+    }
+
+    /**
+     * Reference for the granular delay-line shifter as first written: a
+     * per-channel std::cos crossfade and floor/modulo ring reads in double
+     * precision. The shipped backend uses a crossfade table and masked ring
+     * indexing and must stay within tolerance of this.
+     */
+    class ReferenceGranular
+    {
+    public:
+        ReferenceGranular(uint32_t sample_rate, uint32_t channels)
+            : channels_(channels),
+              span_(std::max<size_t>(64, sample_rate / 100)),
+              capacity_(span_ + 4),
+              buffer_(capacity_ * channels, 0.0f),
+              phases_(channels, 0.0f),
+              wet_step_(1.0f / std::max(1.0f, static_cast<float>(sample_rate) * 0.005f))
+        {
+        }
+
+        void process(const float *input, float *output, size_t frames, float ratio)
+        {
+            const bool active = std::abs(ratio - 1.0f) >= 1.0e-4f;
+            const double phase_step = (1.0 - static_cast<double>(ratio)) / static_cast<double>(span_);
+            for (size_t frame = 0; frame < frames; ++frame)
+            {
+                const size_t write_index = static_cast<size_t>(write_ % capacity_);
+                for (uint32_t ch = 0; ch < channels_; ++ch)
+                {
+                    buffer_[write_index * channels_ + ch] = input[frame * channels_ + ch];
+                }
+                if (!active || write_ <= span_ + 2)
+                {
+                    for (uint32_t ch = 0; ch < channels_; ++ch)
+                    {
+                        output[frame * channels_ + ch] = input[frame * channels_ + ch];
+                    }
+                    wet_ = 0.0f;
+                }
+                else
+                {
+                    wet_ = std::min(1.0f, wet_ + wet_step_);
+                    for (uint32_t ch = 0; ch < channels_; ++ch)
+                    {
+                        double phase_a = phases_[ch];
+                        double phase_b = phase_a + 0.5;
+                        if (phase_b >= 1.0)
+                        {
+                            phase_b -= 1.0;
+                        }
+                        const float sample_a = read(2.0 + phase_a * static_cast<double>(span_), ch);
+                        const float sample_b = read(2.0 + phase_b * static_cast<double>(span_), ch);
+                        const float weight_a = static_cast<float>(0.5 - 0.5 * std::cos(2.0 * kPi * phase_a));
+                        const float shifted = sample_a * weight_a + sample_b * (1.0f - weight_a);
+                        const float dry = input[frame * channels_ + ch];
+                        output[frame * channels_ + ch] = dry + (shifted - dry) * wet_;
+                        phase_a += phase_step;
+                        phase_a -= std::floor(phase_a);
+                        phases_[ch] = static_cast<float>(phase_a);
+                    }
+                }
+                ++write_;
+            }
+        }
+
+    private:
+        float read(double delay, uint32_t ch) const
+        {
+            const double position = static_cast<double>(write_) - delay;
+            const auto frame0 = static_cast<uint64_t>(std::floor(position));
+            const float fraction = static_cast<float>(position - std::floor(position));
+            const float sample0 = buffer_[static_cast<size_t>(frame0 % capacity_) * channels_ + ch];
+            const float sample1 = buffer_[static_cast<size_t>((frame0 + 1) % capacity_) * channels_ + ch];
+            return sample0 + (sample1 - sample0) * fraction;
+        }
+
+        uint32_t channels_;
+        size_t span_;
+        size_t capacity_;
+        std::vector<float> buffer_;
+        std::vector<float> phases_;
+        float wet_step_;
+        float wet_{0.0f};
+        uint64_t write_{0};
+    };
+
+    // The low-latency pitch path driven by a streaming ratio (as Auto-Tune
+    // does) must track the reference algorithm to within 1e-4 over a long
+    // run, for layouts on and off the four-channel vector width.
+    void test_granular_matches_reference()
+    {
+        using echidna::dsp::effects::PitchParameters;
+        using echidna::dsp::effects::PitchShifter;
+        using echidna::dsp::effects::ProcessContext;
+        constexpr uint32_t kRate = 48000;
+        constexpr size_t kBlock = 240;
+        for (uint32_t channels : {uint32_t{1}, uint32_t{2}, uint32_t{5}})
+        {
+            PitchShifter shifter;
+            shifter.prepare(kRate, channels);
+            shifter.prepare_realtime(kBlock);
+            shifter.set_enabled(true);
+            shifter.set_parameters(PitchParameters{});
+            ReferenceGranular reference(kRate, channels);
+
+            double max_diff = 0.0;
+            std::vector<float> input(kBlock * channels);
+            std::vector<float> expected(input.size());
+            for (size_t block = 0; block < 400; ++block)
+            {
+                // Sweep through shifts up and down, including unity.
+                const float ratio = std::pow(2.0f, static_cast<float>(static_cast<int>(block / 40) - 5) / 12.0f);
+                for (size_t frame = 0; frame < kBlock; ++frame)
+                {
+                    const double t = static_cast<double>(block * kBlock + frame) / kRate;
+                    for (uint32_t ch = 0; ch < channels; ++ch)
+                    {
+                        input[frame * channels + ch] =
+                            static_cast<float>(0.6 * std::sin(2.0 * kPi * (180.0 + 40.0 * ch) * t));
+                    }
+                }
+                reference.process(input.data(), expected.data(), kBlock, ratio);
+                shifter.set_realtime_ratio(ratio);
+                ProcessContext ctx{input.data(), kBlock, channels, kRate};
+                shifter.process(ctx);
+                for (size_t i = 0; i < input.size(); ++i)
+                {
+                    max_diff = std::max(max_diff, static_cast<double>(std::fabs(input[i] - expected[i])));
+                }
+            }
+            CHECK(max_diff < 1e-4, "granular pitch must match the reference algorithm within 1e-4");
+        }
+    }
 } // namespace
 
+    // A convolution preset runs the shared spectra through the engine; an
+    // unknown response leaves the stage passing audio through.
+    void test_convolution_preset()
+    {
+        using echidna::dsp::DspEngine;
+        using echidna::dsp::DspEngineOptions;
+        DspEngineOptions options;
+        options.load_plugins = false;
+        options.lock_free_realtime_process = true;
+        DspEngine engine(48000, 2, ECH_DSP_QUALITY_LOW_LATENCY, options);
+        constexpr size_t kBlock = 192;
+        constexpr size_t kBlocks = 250;
+        CHECK(engine.PrepareRealtime(kBlock) == ECH_DSP_STATUS_OK, "convolution prepare");
+        std::vector<float> output(2 * kBlock * kBlocks);
+        std::vector<float> block(2 * kBlock);
+        auto impulse_tail = [&](const char *ir)
+        {
+            auto preset = echidna::dsp::config::LoadPresetFromJson(convolution_preset(ir));
+            CHECK(preset.ok && engine.UpdatePreset(preset.preset) == ECH_DSP_STATUS_OK,
+                  "convolution preset apply");
+            for (size_t b = 0; b < kBlocks; ++b)
+            {
+                std::fill(block.begin(), block.end(), 0.0f);
+                if (b == 0)
+                {
+                    block[0] = 1.0f;
+                    block[1] = 1.0f;
+                }
+                CHECK(engine.ProcessBlock(block.data(), output.data() + b * block.size(), kBlock) ==
+                          ECH_DSP_STATUS_OK,
+                      "convolution process");
+            }
+            double tail = 0.0;
+            for (size_t i = 2 * 4800; i < output.size(); ++i)
+            {
+                tail += static_cast<double>(output[i]) * output[i];
+            }
+            return tail;
+        };
+        const double room = impulse_tail("room");
+        CHECK(all_finite(output.data(), output.size()), "convolution output must be finite");
+        CHECK(room > 1e-6, "the room response must leave a tail");
+        CHECK(impulse_tail("hall") > room, "the hall must ring longer than the room");
+        CHECK(impulse_tail("not_registered") == 0.0, "an unknown response must bypass the stage");
+    }
+
 int main()
 {
     test_neutral_bit_exact();
     test_denormals();
     test_full_chain_finite_and_canaries();
     test_engine_does_not_reject_non_finite();
+    test_analysis_bus();
+    test_convolution_preset();
+    test_granular_matches_reference();
     ech_dsp_shutdown();
 
     if (g_failures != 0)
@@ -2,7 +2,7 @@
  * @file effects_test.cpp
  * @brief Per-effect DSP correctness tests driven by deterministic golden
  * signals (pure tones, impulses) with quantitative assertions on the processed
- * output: pitch-shift cents accuracy, formant tilt, auto-tune snap, and
+ * output: pitch-shift cents accuracy, formant envelope shift, auto-tune snap, and
  * gate / compressor / EQ sanity.
  *
  * These tests link the DSP effect classes directly (white-box) and drive each
@@ -21,15 +21,33 @@
 
 #include "effects/auto_tune.h"
 #include "effects/compressor.h"
+#include "effects/convolution_reverb.h"
 #include "effects/formant_shifter.h"
 #include "effects/gate_processor.h"
+#include "effects/mix_bus.h"
 #include "effects/parametric_eq.h"
 #include "effects/pitch_shifter.h"
+#include "effects/reverb.h"
+#include "runtime/biquad_cascade.h"
+#include "runtime/correlation.h"
+#include "runtime/dynamics.h"
+#include "runtime/fft.h"
+#include "runtime/impulse_response.h"
+#include "runtime/pcm_codec.h"
+#include "runtime/pitch_detector.h"
+#include "runtime/simd.h"
+#include "runtime/spectral_analysis.h"
 
+#include <algorithm>
 #include <cmath>
 #include <cstddef>
 #include <cstdint>
 #include <cstdio>
+#include <cstring>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <utility>
 #include <vector>
 
 using namespace echidna::dsp::effects;
@@ -273,6 +291,90 @@ namespace
             CHECK(requested > 0.0 ? f_out > 200.0 : f_out < 200.0,
                   "pitch shifter must move in the requested direction");
         }
+
+        // Balanced (WSOLA) and high quality (phase vocoder) carry state
+        // across blocks: stream 10 ms blocks and measure once their latency
+        // has been flushed.
+        const Case streamed_cases[] = {
+            {2.0, 0.0, 200.0},
+            {-3.0, 0.0, 300.0},
+            {0.0, 40.0, 40.0},
+        };
+        for (PitchQuality quality : {PitchQuality::kBalanced, PitchQuality::kHighQuality})
+        {
+            for (const Case &c : streamed_cases)
+            {
+                const size_t n = 24000;
+                const size_t block = 480;
+                auto buf = make_sine(200.0, n, 0.5);
+                PitchShifter p;
+                p.prepare(sr, 1);
+                p.prepare_realtime(block);
+                p.set_enabled(true);
+                PitchParameters pp;
+                pp.semitones = static_cast<float>(c.semitones);
+                pp.cents = static_cast<float>(c.cents);
+                pp.quality = quality;
+                p.set_parameters(pp);
+                for (size_t offset = 0; offset < n; offset += block)
+                {
+                    ProcessContext ctx{buf.data() + offset, block, 1, sr};
+                    p.process(ctx);
+                }
+                CHECK(all_finite(buf), "streamed pitch output must be finite");
+                const double f_out = estimate_crossing_frequency(buf, sr, 8000);
+                const double applied = std::fabs(cents(f_out, 200.0));
+                CHECK_BETWEEN(applied, c.expect_cents - 12.0, c.expect_cents + 12.0);
+                const double requested = c.semitones * 100.0 + c.cents;
+                CHECK(requested > 0.0 ? f_out > 200.0 : f_out < 200.0,
+                      "streamed pitch shifter must move in the requested direction");
+                CHECK(rms(buf, 8000, n) > 0.2, "streamed pitch shifter must preserve level");
+            }
+        }
+
+        // Real-time ratios (Auto-Tune) run the granular delay line, which keeps
+        // its taps across callbacks: mono and stereo output is the same for
+        // 10 ms blocks and for odd-sized ones that leave a scalar tail after
+        // each run of vectorised frames.
+        for (uint32_t channels : {1u, 2u, 3u})
+        {
+            const size_t n = 9600;
+            std::vector<float> source(n * channels);
+            for (size_t frame = 0; frame < n; ++frame)
+            {
+                for (uint32_t ch = 0; ch < channels; ++ch)
+                {
+                    source[frame * channels + ch] = static_cast<float>(
+                        0.5 * std::sin(2.0 * kPi * (200.0 + 50.0 * ch) * static_cast<double>(frame) / kSampleRate));
+                }
+            }
+            auto stream = [&](size_t block)
+            {
+                std::vector<float> buf = source;
+                PitchShifter p;
+                p.prepare(sr, channels);
+                p.prepare_realtime(block);
+                p.set_enabled(true);
+                p.set_parameters(PitchParameters{0.0f, 0.0f, PitchQuality::kLowLatency, false});
+                p.set_realtime_ratio(std::exp2(3.0f / 12.0f));
+                for (size_t offset = 0; offset < n; offset += block)
+                {
+                    const size_t frames = std::min(block, n - offset);
+                    ProcessContext ctx{buf.data() + offset * channels, frames, channels, sr};
+                    p.process(ctx);
+                }
+                return buf;
+            };
+            const auto even = stream(480);
+            const auto odd = stream(331);
+            double max_diff = 0.0;
+            for (size_t i = 0; i < even.size(); ++i)
+            {
+                max_diff = std::max(max_diff, static_cast<double>(std::fabs(even[i] - odd[i])));
+            }
+            CHECK(all_finite(even) && even != source, "real-time pitch must shift the signal");
+            CHECK(max_diff < 1e-6, "real-time pitch output must not depend on the block size");
+        }
     }
 
     // --- Formant shifter ---------------------------------------------------
@@ -299,8 +401,7 @@ namespace
             CHECK(max_diff < 1e-9, "disabled formant shifter must be identity");
         }
 
-        // Zero-cent tilt: the all-pass coefficient is 0, so the stage reduces to
-        // a single-sample delay (out[i] == in[i-1], out[0] == 0).
+        // Zero cents is an exact bypass, with no added latency.
         {
             const size_t n = 512;
             auto in = make_sine(500.0, n, 0.4);
@@ -309,45 +410,101 @@ namespace
             f.prepare(sr, 1);
             f.set_enabled(true);
             f.set_parameters(FormantParameters{});
+            CHECK(f.analysis_features() == 0, "a zero shift must not subscribe to the bus");
             ProcessContext ctx{buf.data(), n, 1, sr};
             f.process(ctx);
-            CHECK(std::fabs(buf[0]) < 1e-9, "formant zero-cent out[0] must be 0");
-            double max_diff = 0.0;
-            for (size_t i = 1; i < n; ++i)
-            {
-                max_diff = std::max(max_diff, static_cast<double>(std::fabs(buf[i] - in[i - 1])));
-            }
-            CHECK(max_diff < 1e-6, "formant zero-cent must be a one-sample delay");
+            CHECK(buf == in, "formant zero-cent must be an exact bypass");
         }
 
-        // Non-zero tilt: first-order all-pass -> energy (RMS) preserved for a
-        // steady tone, but the waveform is phase-shifted (differs from the plain
-        // one-sample delay), confirming the tilt coefficient took effect.
+        // A vowel-like tone: 150 Hz harmonics under one formant at 1 kHz. The
+        // shift must move the envelope peak by the ratio and leave the
+        // harmonics, and so the pitch, in place. Stereo input is streamed in
+        // odd-sized callbacks, with and without the analysis bus.
+        auto vowel = [&](size_t frames)
         {
-            const size_t n = 4096;
-            auto in = make_sine(500.0, n, 0.4);
-            auto buf = in;
-            FormantShifter f;
-            f.prepare(sr, 1);
-            f.set_enabled(true);
-            FormantParameters fp;
-            fp.cents = 600.0f; // maximum tilt -> largest departure from delay
-            f.set_parameters(fp);
-            ProcessContext ctx{buf.data(), n, 1, sr};
-            f.process(ctx);
-            CHECK(all_finite(buf), "formant output must be finite");
-            const double r_in = rms(in, 100, n);
-            const double r_out = rms(buf, 100, n);
-            CHECK_BETWEEN(r_out / r_in, 0.97, 1.03); // all-pass preserves energy
-            double max_phase_diff = 0.0;
-            for (size_t i = 1; i < n; ++i)
+            std::vector<float> out(frames);
+            for (size_t t = 0; t < frames; ++t)
+            {
+                double sample = 0.0;
+                for (int harmonic = 1; harmonic <= 30; ++harmonic)
+                {
+                    const double hz = 150.0 * harmonic;
+                    const double gain = std::exp(-std::pow((hz - 1000.0) / 300.0, 2.0)) + 0.02;
+                    sample += 0.05 * gain * std::sin(2.0 * kPi * hz * static_cast<double>(t) / kSampleRate);
+                }
+                out[t] = static_cast<float>(sample);
+            }
+            return out;
+        };
+        auto analyse = [&](const std::vector<float> &mono, size_t begin)
+        {
+            echidna::dsp::runtime::SpectralAnalysis analysis;
+            analysis.prepare(sr);
+            const float *channel = mono.data() + begin;
+            analysis.analyze(&channel, 1, mono.size() - begin,
+                             echidna::dsp::runtime::SpectralAnalysis::kPitch |
+                                 echidna::dsp::runtime::SpectralAnalysis::kEnvelope);
+            const float *envelope = analysis.envelope();
+            size_t peak = 1;
+            for (size_t k = 2; k + 1 < analysis.bins(); ++k)
+            {
+                peak = envelope[k] > envelope[peak] ? k : peak;
+            }
+            // A formant between two harmonics leaves neighbouring bins almost
+            // level, so place the peak on the parabola through them.
+            const double left = envelope[peak - 1];
+            const double centre = envelope[peak];
+            const double right = envelope[peak + 1];
+            const double curvature = left - 2.0 * centre + right;
+            const double offset = curvature < 0.0 ? 0.5 * (left - right) / curvature : 0.0;
+            return std::pair<double, double>{analysis.pitch_hz(),
+                                             (static_cast<double>(peak) + offset) * analysis.bin_hz()};
+        };
+        {
+            const size_t n = sr / 2;
+            const auto source = vowel(n);
+            const auto reference = analyse(source, n / 2);
+            CHECK_BETWEEN(cents(reference.first, 150.0), -5.0, 5.0);
+            CHECK_BETWEEN(reference.second, 900.0, 1100.0);
+            for (float shift : {-300.0f, 300.0f})
             {
-                max_phase_diff =
-                    std::max(max_phase_diff, static_cast<double>(std::fabs(buf[i] - in[i - 1])));
+                for (bool use_bus : {false, true})
+                {
+                    FormantShifter f;
+                    f.prepare(sr, 2);
+                    f.set_enabled(true);
+                    f.set_parameters(FormantParameters{shift, false});
+                    CHECK(f.analysis_features() == echidna::dsp::runtime::SpectralAnalysis::kEnvelope,
+                          "a formant shift must subscribe to the bus envelope");
+                    echidna::dsp::runtime::SpectralAnalysis bus;
+                    bus.prepare(sr);
+                    std::vector<float> left = source;
+                    std::vector<float> right = source;
+                    constexpr size_t block = 333;
+                    for (size_t offset = 0; offset < n; offset += block)
+                    {
+                        const size_t frames = std::min(block, n - offset);
+                        float *planar[2] = {left.data() + offset, right.data() + offset};
+                        ProcessContext ctx{nullptr, frames, 2, sr, planar};
+                        if (use_bus)
+                        {
+                            bus.analyze(planar, 2, frames, f.analysis_features());
+                            ctx.analysis = &bus;
+                        }
+                        f.process(ctx);
+                    }
+                    CHECK(all_finite(left) && left == right, "stereo formant output must match per channel");
+                    CHECK(f.latency_frames() == f.fft_size() * 3 / 4,
+                          "the STFT adds three quarters of a frame of latency");
+                    const auto shifted = analyse(left, n / 2);
+                    const double expected = 1000.0 * std::exp2(static_cast<double>(shift) / 1200.0);
+                    CHECK_BETWEEN(cents(shifted.first, 150.0), -5.0, 5.0);
+                    CHECK_BETWEEN(shifted.second, expected - 100.0, expected + 100.0);
+                    const double r_in = rms(source, n / 2, n);
+                    const double r_out = rms(left, n / 2, n);
+                    CHECK_BETWEEN(r_out / r_in, 0.8, 1.25);
+                }
             }
-            // The all-pass phase term departs from a plain one-sample delay by a
-            // small but deterministic amount (~0.011 peak here); confirm it fired.
-            CHECK(max_phase_diff > 0.004, "non-zero tilt must alter the waveform");
         }
     }
 
@@ -493,6 +650,87 @@ namespace
             }
         }
 
+        // Stereo: one detection on the mixdown drives both channels, so a
+        // centred voice is corrected identically on the left and the right.
+        {
+            constexpr size_t block_frames = 480;
+            const size_t frames = block_frames * 200;
+            const auto mono = make_sine(450.0, frames, 0.35);
+            std::vector<float> stereo(frames * 2);
+            for (size_t i = 0; i < frames; ++i)
+            {
+                stereo[2 * i] = mono[i];
+                stereo[2 * i + 1] = mono[i];
+            }
+            AutoTune tuner;
+            tuner.prepare(sr, 2);
+            tuner.prepare_realtime(block_frames);
+            tuner.set_enabled(true);
+            AutoTuneParameters parameters;
+            parameters.retune_speed_ms = 1.0f;
+            parameters.humanize = 0.0f;
+            tuner.set_parameters(parameters);
+            for (size_t offset = 0; offset < frames; offset += block_frames)
+            {
+                ProcessContext ctx{stereo.data() + offset * 2, block_frames, 2, sr};
+                tuner.process(ctx);
+            }
+            std::vector<float> left(frames);
+            bool identical = true;
+            for (size_t i = 0; i < frames; ++i)
+            {
+                left[i] = stereo[2 * i];
+                identical = identical && stereo[2 * i] == stereo[2 * i + 1];
+            }
+            CHECK(identical, "a centred stereo voice must be corrected identically per channel");
+            CHECK_BETWEEN(estimate_crossing_frequency(left, sr, frames - block_frames * 16), 432.5, 447.5);
+        }
+
+        // With the shared analysis bus in the context the bus pitch drives the
+        // correction and the internal detector is never fed.
+        {
+            struct CountingDetector final : echidna::dsp::runtime::PitchDetector
+            {
+                size_t *pushes;
+                explicit CountingDetector(size_t *counter) : pushes(counter) {}
+                bool prepare(uint32_t, const echidna::dsp::runtime::PitchDetectorSettings &) override
+                {
+                    return true;
+                }
+                void reset() override {}
+                void push(const float *, size_t) override { ++*pushes; }
+                float estimate() override { return 0.0f; }
+            };
+            using echidna::dsp::runtime::SpectralAnalysis;
+            constexpr size_t block_frames = 256;
+            const size_t frames = block_frames * 300;
+            auto mono = make_sine(450.0, frames, 0.35);
+            size_t pushes = 0;
+            AutoTune tuner;
+            tuner.set_pitch_detector(std::make_unique<CountingDetector>(&pushes),
+                                     echidna::dsp::runtime::PitchDetectorSettings{});
+            tuner.prepare(sr, 1);
+            tuner.prepare_realtime(block_frames);
+            tuner.set_enabled(true);
+            AutoTuneParameters parameters;
+            parameters.retune_speed_ms = 1.0f;
+            parameters.humanize = 0.0f;
+            tuner.set_parameters(parameters);
+            CHECK(tuner.analysis_features() == SpectralAnalysis::kPitch,
+                  "auto-tune must subscribe to the bus pitch");
+            SpectralAnalysis bus;
+            CHECK(bus.prepare(sr), "analysis bus must prepare at 48 kHz");
+            for (size_t offset = 0; offset < frames; offset += block_frames)
+            {
+                float *channel = mono.data() + offset;
+                bus.analyze(&channel, 1, block_frames, tuner.analysis_features());
+                ProcessContext ctx{nullptr, block_frames, 1, sr, &channel, &bus};
+                tuner.process(ctx);
+            }
+            CHECK(pushes == 0, "a bus-fed auto-tune must not run its own detector");
+            CHECK_BETWEEN(estimate_crossing_frequency(mono, sr, frames - block_frames * 32), 432.5, 447.5);
+        }
+
         // Silence and deterministic aperiodic input are unvoiced and must be
         // exact bypasses. Reset must also restore history, smoothing and phase.
         {
@@ -733,6 +971,93 @@ namespace
         CHECK(r_mid < r_quiet, "compression must increase with level");
     }
 
+    // --- Shared dynamics core ----------------------------------------------
+    void test_dynamics_core()
+    {
+        using namespace echidna::dsp::runtime;
+        const uint32_t sr = static_cast<uint32_t>(kSampleRate);
+
+        // Approximation error bounds documented in dynamics.h.
+        double log2_error = 0.0;
+        for (double x = 1e-6; x < 64.0; x *= 1.0007)
+        {
+            const float xf = static_cast<float>(x);
+            log2_error = std::max(log2_error, std::fabs(static_cast<double>(fast_log2(xf)) - std::log2(static_cast<double>(xf))));
+        }
+        double exp2_error = 0.0;
+        for (double x = -40.0; x < 20.0; x += 0.00073)
+        {
+            const float xf = static_cast<float>(x);
+            exp2_error = std::max(exp2_error, std::fabs(static_cast<double>(fast_exp2(xf)) / std::exp2(static_cast<double>(xf)) - 1.0));
+        }
+        CHECK(log2_error < 2e-5, "fast_log2 must stay within its documented bound");
+        CHECK(exp2_error < 3e-7, "fast_exp2 must stay within its documented bound");
+
+        std::vector<float> ramp(37);
+        for (size_t i = 0; i < ramp.size(); ++i)
+        {
+            ramp[i] = (i % 2 ? -1.0f : 1.0f) * static_cast<float>(i) * 0.01f;
+        }
+        CHECK(peak_abs(ramp.data(), ramp.size()) == std::fabs(ramp[36]), "peak_abs must find the largest magnitude");
+        CHECK(peak_abs(ramp.data(), 3) == ramp[2], "peak_abs must handle spans shorter than a vector");
+
+        // Stereo link: a loud left channel pulls the quiet right channel down
+        // only when linked.
+        auto right_gain = [&](bool linked)
+        {
+            const size_t n = 4096;
+            Compressor c;
+            CompressorParameters cp;
+            cp.threshold_db = -24.0f;
+            cp.ratio = 4.0f;
+            cp.stereo_link = linked;
+            c.set_parameters(cp);
+            c.prepare(sr, 2);
+            c.set_enabled(true);
+            auto left = make_sine(300.0, n, 0.5);
+            auto right = make_sine(450.0, n, 0.02);
+            std::vector<float> buf(n * 2);
+            for (size_t i = 0; i < n; ++i)
+            {
+                buf[i * 2] = left[i];
+                buf[i * 2 + 1] = right[i];
+            }
+            ProcessContext ctx{buf.data(), n, 2, sr};
+            c.process(ctx);
+            double out_peak = 0.0;
+            for (size_t i = 3072; i < n; ++i)
+            {
+                out_peak = std::max(out_peak, static_cast<double>(std::fabs(buf[i * 2 + 1])));
+            }
+            return out_peak / peak(right, 3072, n);
+        };
+        CHECK(right_gain(true) < 0.5, "linked compressor must duck the quiet channel with the loud one");
+        CHECK_BETWEEN(right_gain(false), 0.95, 1.05);
+
+        // Sub-block boundaries carry across calls: output is independent of
+        // the callback size, including sizes that split sub-blocks.
+        auto compress_in_blocks = [&](size_t block_frames)
+        {
+            const size_t n = 4800;
+            Compressor c;
+            c.prepare(sr, 1);
+            c.set_enabled(true);
+            auto buf = make_sine(300.0, n, 0.4);
+            for (size_t offset = 0; offset < n; offset += block_frames)
+            {
+                ProcessContext ctx{buf.data() + offset, std::min(block_frames, n - offset), 1, sr};
+                c.process(ctx);
+            }
+            return buf;
+        };
+        const auto reference = compress_in_blocks(4800);
+        for (size_t block_frames : {size_t{7}, size_t{64}, size_t{250}})
+        {
+            CHECK(compress_in_blocks(block_frames) == reference,
+                  "compressor output must be callback-size invariant");
+        }
+    }
+
     // --- Parametric EQ -----------------------------------------------------
     void test_parametric_eq()
     {
@@ -790,6 +1115,1314 @@ namespace
         }
     }
 
+    // --- Biquad cascade kernel ----------------------------------------------
+    void test_biquad_cascade()
+    {
+        using echidna::dsp::runtime::BiquadCascade;
+        using echidna::dsp::runtime::BiquadCoefficients;
+
+        // Six channels span two lane groups, the second half full.
+        const uint32_t channels = 6;
+        const size_t frames = 1000;
+        const std::vector<BiquadCoefficients> stages = {
+            {1.02f, -1.85f, 0.84f, -1.85f, 0.86f},
+            {0.97f, -1.60f, 0.70f, -1.60f, 0.67f},
+            {1.10f, -0.90f, 0.30f, -0.90f, 0.40f},
+            {0.50f, 1.00f, 0.50f, -0.20f, 0.10f},
+            {1.00f, -1.94f, 0.95f, -1.93f, 0.94f},
+            {0.80f, 0.10f, -0.10f, 0.05f, -0.30f},
+            {1.00f, 0.00f, 0.00f, 0.00f, 0.00f}};
+
+        std::vector<std::vector<float>> input(channels);
+        for (uint32_t ch = 0; ch < channels; ++ch)
+        {
+            input[ch] = make_sine(150.0 + 400.0 * ch, frames, 0.1 + 0.05 * ch);
+        }
+
+        // Scalar band-by-band reference.
+        auto reference = input;
+        for (auto &channel : reference)
+        {
+            for (const BiquadCoefficients &c : stages)
+            {
+                float z1 = 0.0f;
+                float z2 = 0.0f;
+                for (float &sample : channel)
+                {
+                    const float x = sample;
+                    const float y = c.b0 * x + z1;
+                    z1 = c.b1 * x - c.a1 * y + z2;
+                    z2 = c.b2 * x - c.a2 * y;
+                    sample = y;
+                }
+            }
+        }
+
+        BiquadCascade planar;
+        planar.configure(channels, stages.size());
+        planar.set_coefficients(stages.data(), 0);
+        auto planar_io = input;
+        std::vector<float *> spans(channels);
+        for (uint32_t ch = 0; ch < channels; ++ch)
+        {
+            spans[ch] = planar_io[ch].data();
+        }
+        // Uneven block sizes exercise state carry-over between calls.
+        planar.process(spans.data(), 333);
+        for (uint32_t ch = 0; ch < channels; ++ch)
+        {
+            spans[ch] += 333;
+        }
+        planar.process(spans.data(), frames - 333);
+
+        BiquadCascade interleaved;
+        interleaved.configure(channels, stages.size());
+        interleaved.set_coefficients(stages.data(), 0);
+        std::vector<float> interleaved_io(frames * channels);
+        for (size_t i = 0; i < frames; ++i)
+        {
+            for (uint32_t ch = 0; ch < channels; ++ch)
+            {
+                interleaved_io[i * channels + ch] = input[ch][i];
+            }
+        }
+        interleaved.process_interleaved(interleaved_io.data(), frames);
+
+        double ref_diff = 0.0;
+        double layout_diff = 0.0;
+        for (size_t i = 0; i < frames; ++i)
+        {
+            for (uint32_t ch = 0; ch < channels; ++ch)
+            {
+                ref_diff = std::max(ref_diff, static_cast<double>(std::fabs(planar_io[ch][i] - reference[ch][i])));
+                layout_diff = std::max(layout_diff, static_cast<double>(std::fabs(planar_io[ch][i] - interleaved_io[i * channels + ch])));
+            }
+        }
+        CHECK(ref_diff < 1e-4, "fused cascade must match the scalar band-by-band reference");
+        CHECK(layout_diff == 0.0, "cascade planar and interleaved output must be identical");
+    }
+
+    // --- Real FFT ------------------------------------------------------------
+    // --- SIMD kernel dispatch -----------------------------------------------
+    void test_simd_dispatch()
+    {
+        using echidna::dsp::runtime::SimdLevel;
+        namespace runtime = echidna::dsp::runtime;
+
+        const SimdLevel detected = runtime::detected_simd_level();
+        CHECK(runtime::active_simd_level() == detected, "the probed level must be active at load");
+        CHECK(runtime::simd_level_supported(SimdLevel::kScalar), "the scalar kernels are always available");
+        CHECK(runtime::simd_level_supported(detected), "the probed level must be supported");
+
+        uint32_t seed = 0x51d0u;
+        auto noise = [&]()
+        {
+            seed = seed * 1664525u + 1013904223u;
+            return static_cast<float>(seed >> 8) / 8388608.0f - 1.0f;
+        };
+        // Frame counts around every vector width so each tail path runs.
+        constexpr size_t kMaxFrames = 67;
+        std::vector<float> source(2 * kMaxFrames);
+        std::vector<float> other(2 * kMaxFrames);
+        std::vector<int16_t> pcm(2 * kMaxFrames);
+        for (size_t i = 0; i < source.size(); ++i)
+        {
+            source[i] = noise();
+            other[i] = noise();
+            pcm[i] = static_cast<int16_t>(noise() * 32768.0f);
+        }
+        pcm[0] = std::numeric_limits<int16_t>::min();
+        pcm[1] = std::numeric_limits<int16_t>::max();
+        // Half the samples leave [-1, 1] so the clamp is exercised.
+        std::vector<float> loud(source.size());
+        for (size_t i = 0; i < loud.size(); ++i)
+        {
+            loud[i] = 2.0f * source[i];
+        }
+
+        struct Outputs
+        {
+            std::vector<float> gained;
+            std::vector<float> mixed;
+            std::vector<float> left;
+            std::vector<float> right;
+            std::vector<float> interleaved;
+            std::vector<float> crossfaded;
+            bool crossfade_aliased{false};
+            runtime::BlockScan scan;
+            runtime::BlockScan scan_against;
+            std::vector<bool> finite;
+            std::vector<float> decoded;
+            std::vector<int16_t> encoded;
+            std::vector<int16_t> reencoded;
+            bool reencode_changed{false};
+        };
+        auto same_scan = [](const runtime::BlockScan &a, const runtime::BlockScan &b)
+        {
+            // Only the double energy sum may be reassociated across lanes.
+            return a.peak == b.peak && a.finite == b.finite && a.changed == b.changed &&
+                   std::fabs(a.sum_squares - b.sum_squares) <= 1e-9 * (1.0 + std::fabs(b.sum_squares));
+        };
+        auto run_kernels = [&](size_t frames)
+        {
+            Outputs out;
+            out.gained.assign(source.begin(), source.begin() + static_cast<std::ptrdiff_t>(2 * frames));
+            runtime::apply_gain(out.gained.data(), out.gained.size(), 0.7f);
+            out.mixed.assign(other.begin(), other.begin() + static_cast<std::ptrdiff_t>(2 * frames));
+            runtime::mix_in(out.mixed.data(), source.data(), out.mixed.size(), -1.3f);
+            out.left.assign(frames, 0.0f);
+            out.right.assign(frames, 0.0f);
+            float *planar[2] = {out.left.data(), out.right.data()};
+            runtime::deinterleave(source.data(), planar, frames, 2);
+            out.interleaved.assign(2 * frames, 0.0f);
+            const float *const sources[2] = {source.data(), other.data()};
+            runtime::interleave(sources, out.interleaved.data(), frames, 2);
+
+            const size_t samples = 2 * frames;
+            out.crossfaded.assign(samples, 0.0f);
+            runtime::crossfade(source.data(), other.data(), out.crossfaded.data(), samples, 0.6f, -0.45f, 1.25f);
+            std::vector<float> wet(other.begin(), other.begin() + static_cast<std::ptrdiff_t>(samples));
+            runtime::crossfade(source.data(), wet.data(), wet.data(), samples, 0.6f, -0.45f, 1.25f);
+            out.crossfade_aliased = wet == out.crossfaded;
+            out.scan = runtime::scan_block(source.data(), samples);
+            std::vector<float> touched(source.begin(), source.begin() + static_cast<std::ptrdiff_t>(samples));
+            if (samples > 0)
+            {
+                touched[samples - 1] = -touched[samples - 1];
+            }
+            out.scan_against = runtime::scan_block(source.data(), samples, touched.data());
+            // One poisoned sample at every position, alternating NaN and infinity.
+            for (size_t poison = 0; poison < samples; ++poison)
+            {
+                touched.assign(source.begin(), source.begin() + static_cast<std::ptrdiff_t>(samples));
+                touched[poison] = (poison % 2) == 0 ? std::numeric_limits<float>::quiet_NaN()
+                                                    : -std::numeric_limits<float>::infinity();
+                out.finite.push_back(runtime::all_finite(touched.data(), samples));
+                out.finite.push_back(runtime::scan_block(touched.data(), samples).finite);
+            }
+            out.finite.push_back(runtime::all_finite(source.data(), samples));
+
+            out.decoded.assign(samples, 0.0f);
+            runtime::decode_pcm(runtime::PcmEncoding::kSigned16, pcm.data(), out.decoded.data(), samples);
+            out.encoded.assign(samples, 0);
+            runtime::encode_pcm(runtime::PcmEncoding::kSigned16, loud.data(), out.encoded.data(), samples);
+            // Every third sample is left untouched by the "engine".
+            std::vector<float> processed(loud.begin(), loud.begin() + static_cast<std::ptrdiff_t>(samples));
+            for (size_t i = 0; i < samples; i += 3)
+            {
+                processed[i] = out.decoded[i];
+            }
+            out.reencoded.assign(pcm.begin(), pcm.begin() + static_cast<std::ptrdiff_t>(samples));
+            out.reencode_changed = runtime::reencode_s16(
+                processed.data(), out.decoded.data(), out.reencoded.data(), out.reencoded.data(), samples);
+            return out;
+        };
+
+        std::vector<Outputs> reference;
+        CHECK(runtime::force_simd_level(SimdLevel::kScalar), "forcing the scalar kernels must succeed");
+        CHECK(runtime::active_simd_level() == SimdLevel::kScalar, "a forced level must become active");
+        for (size_t frames = 0; frames <= kMaxFrames; ++frames)
+        {
+            reference.push_back(run_kernels(frames));
+        }
+        for (size_t frame = 0; frame < kMaxFrames; ++frame)
+        {
+            CHECK(reference.back().left[frame] == source[2 * frame] &&
+                      reference.back().right[frame] == source[2 * frame + 1] &&
+                      reference.back().interleaved[2 * frame] == source[frame] &&
+                      reference.back().interleaved[2 * frame + 1] == other[frame],
+                  "scalar stereo (de)interleave must move samples to the documented slots");
+        }
+
+        // The scalar variants against the formulas documented in simd.h.
+        for (size_t frames = 0; frames <= kMaxFrames; ++frames)
+        {
+            const Outputs &out = reference[frames];
+            const size_t samples = 2 * frames;
+            bool crossfade_ok = true;
+            bool codec_ok = true;
+            bool reencode_ok = true;
+            bool any_reencoded = false;
+            float peak = 0.0f;
+            double energy = 0.0;
+            for (size_t i = 0; i < samples; ++i)
+            {
+                const float expected = (source[i] * 0.6f + other[i] * -0.45f) * 1.25f;
+                crossfade_ok = crossfade_ok && std::fabs(out.crossfaded[i] - expected) < 1e-6f;
+                peak = std::max(peak, std::fabs(source[i]));
+                energy += static_cast<double>(source[i]) * source[i];
+
+                codec_ok = codec_ok && out.decoded[i] == static_cast<float>(pcm[i]) / 32768.0f;
+                const float clamped = std::clamp(loud[i], -1.0f, 1.0f);
+                const long expected_pcm = clamped == -1.0f ? -32768 : std::lround(clamped * 32767.0f);
+                codec_ok = codec_ok && out.encoded[i] == expected_pcm;
+
+                const int16_t kept = (i % 3) == 0 ? pcm[i] : out.encoded[i];
+                reencode_ok = reencode_ok && out.reencoded[i] == kept;
+                any_reencoded = any_reencoded || kept != pcm[i];
+            }
+            CHECK(crossfade_ok, "crossfade must mix, then apply the output gain");
+            CHECK(out.crossfade_aliased, "crossfade must allow the output to alias the wet input");
+            CHECK(out.scan.peak == peak && std::fabs(out.scan.sum_squares - energy) <= 1e-9 * (1.0 + energy) &&
+                      out.scan.finite && !out.scan.changed,
+                  "scan_block must report peak and energy and no change without a reference");
+            CHECK(out.scan_against.changed == (samples > 0), "scan_block must detect a single flipped sample");
+            CHECK(codec_ok, "int16 conversion must scale by 32768 in and clamp, round and scale by 32767 out");
+            CHECK(reencode_ok && out.reencode_changed == any_reencoded,
+                  "reencode_s16 must keep untouched samples and report whether any value changed");
+            bool poison_found = true;
+            for (size_t i = 0; i + 1 < out.finite.size(); ++i)
+            {
+                poison_found = poison_found && !out.finite[i];
+            }
+            CHECK(poison_found && out.finite.back(), "a single NaN or infinity must fail the finite checks");
+        }
+
+        // Values whose scaled product lands exactly on .5 must round away from
+        // zero in every variant, matching lround().
+        std::vector<float> ties;
+        for (int k = -32767; k < 32767; k += 97)
+        {
+            float x = (static_cast<float>(k) + 0.5f) / 32767.0f;
+            for (int step = 0; step < 8; ++step, x = std::nextafter(x, 2.0f))
+            {
+                if (x * 32767.0f == static_cast<float>(k) + 0.5f)
+                {
+                    ties.push_back(x);
+                }
+            }
+        }
+        ties.insert(ties.end(), {-1.0f, 1.0f, -1.5f, 7.0f, -0.0f, 0.0f, std::nextafter(-1.0f, 0.0f)});
+        std::vector<int16_t> expected_ties(ties.size());
+        for (size_t i = 0; i < ties.size(); ++i)
+        {
+            const float clamped = std::clamp(ties[i], -1.0f, 1.0f);
+            expected_ties[i] = static_cast<int16_t>(clamped == -1.0f ? -32768 : std::lround(clamped * 32767.0f));
+        }
+        CHECK(ties.size() > 16, "the tie search must find exactly representable halves");
+        std::vector<int16_t> scalar_ties(ties.size());
+        runtime::encode_pcm(runtime::PcmEncoding::kSigned16, ties.data(), scalar_ties.data(), ties.size());
+        CHECK(scalar_ties == expected_ties, "the scalar int16 encoder must round halves away from zero");
+
+        size_t forced = 0;
+        for (SimdLevel level : {SimdLevel::kSse41,
+                                SimdLevel::kAvx2,
+                                SimdLevel::kAvx512,
+                                SimdLevel::kNeon})
+        {
+            if (!runtime::simd_level_supported(level))
+            {
+                CHECK(!runtime::force_simd_level(level), "an unsupported level must be refused");
+                CHECK(runtime::active_simd_level() == SimdLevel::kScalar,
+                      "a refused level must leave the selection unchanged");
+                continue;
+            }
+            CHECK(runtime::force_simd_level(level), "a supported level must be selectable");
+            CHECK(runtime::active_simd_level() == level, "a forced level must become active");
+            ++forced;
+            bool exact = true;
+            bool scans = true;
+            bool pcm_exact = true;
+            double mix_error = 0.0;
+            for (size_t frames = 0; frames <= kMaxFrames; ++frames)
+            {
+                const Outputs out = run_kernels(frames);
+                const Outputs &expected = reference[frames];
+                exact = exact && out.gained == expected.gained && out.left == expected.left &&
+                        out.right == expected.right && out.interleaved == expected.interleaved;
+                scans = scans && same_scan(out.scan, expected.scan) &&
+                        same_scan(out.scan_against, expected.scan_against) && out.finite == expected.finite;
+                exact = exact && out.crossfade_aliased;
+                pcm_exact = pcm_exact && out.decoded == expected.decoded && out.encoded == expected.encoded &&
+                            out.reencoded == expected.reencoded &&
+                            out.reencode_changed == expected.reencode_changed;
+                for (size_t i = 0; i < out.mixed.size(); ++i)
+                {
+                    // The scalar loop may be contracted into a fused multiply-add.
+                    mix_error = std::max(mix_error, static_cast<double>(std::fabs(out.mixed[i] - expected.mixed[i])));
+                    mix_error = std::max(mix_error,
+                                         static_cast<double>(std::fabs(out.crossfaded[i] - expected.crossfaded[i])));
+                }
+            }
+            std::vector<int16_t> encoded_ties(ties.size());
+            runtime::encode_pcm(runtime::PcmEncoding::kSigned16, ties.data(), encoded_ties.data(), ties.size());
+            pcm_exact = pcm_exact && encoded_ties == expected_ties;
+            CHECK(exact, "gain and (de)interleave kernels must match the scalar variant exactly");
+            CHECK(mix_error < 1e-6, "mix_in and crossfade must match the scalar variant");
+            CHECK(scans, "block scans must match the scalar variant");
+            CHECK(pcm_exact, "int16 conversions must match the scalar variant exactly");
+            runtime::force_simd_level(SimdLevel::kScalar);
+        }
+        CHECK(forced > 0 || detected == SimdLevel::kScalar, "a vector level was probed but none was testable");
+
+        CHECK(runtime::force_simd_level(detected), "restoring the probed level must succeed");
+    }
+
+    // --- PCM codec ------------------------------------------------------------
+    void test_pcm_codec()
+    {
+        using echidna::dsp::runtime::PcmEncoding;
+        using echidna::dsp::runtime::SimdLevel;
+        namespace runtime = echidna::dsp::runtime;
+
+        constexpr PcmEncoding kEncodings[] = {PcmEncoding::kUnsigned8,
+                                              PcmEncoding::kSigned16,
+                                              PcmEncoding::kSigned24Packed,
+                                              PcmEncoding::kSigned32,
+                                              PcmEncoding::kFloat32};
+        constexpr size_t kWidths[] = {1, 2, 3, 4, 4};
+        for (size_t e = 0; e < std::size(kEncodings); ++e)
+        {
+            CHECK(runtime::pcm_bytes_per_sample(kEncodings[e]) == kWidths[e], "sample widths must match the encodings");
+        }
+        const auto unknown = static_cast<PcmEncoding>(runtime::kPcmEncodingCount);
+        float unused[1] = {0.0f};
+        CHECK(runtime::pcm_bytes_per_sample(unknown) == 0, "an unknown encoding must have no width");
+        CHECK(!runtime::decode_pcm(unknown, unused, unused, 1), "an unknown encoding must not decode");
+
+        // The per-sample converters the capture routes used before the shared
+        // codec; every variant must reproduce them byte for byte.
+        auto reference_decode = [](PcmEncoding encoding, const uint8_t *bytes, float *out, size_t samples)
+        {
+            for (size_t i = 0; i < samples; ++i)
+            {
+                float sample = 0.0f;
+                switch (encoding)
+                {
+                case PcmEncoding::kUnsigned8:
+                    sample = (static_cast<float>(bytes[i]) - 128.0f) * (1.0f / 128.0f);
+                    break;
+                case PcmEncoding::kSigned16:
+                {
+                    int16_t value = 0;
+                    std::memcpy(&value, bytes + i * sizeof(value), sizeof(value));
+                    sample = static_cast<float>(value) * (1.0f / 32768.0f);
+                    break;
+                }
+                case PcmEncoding::kSigned24Packed:
+                {
+                    const size_t offset = i * 3;
+                    uint32_t value = static_cast<uint32_t>(bytes[offset]) |
+                                     (static_cast<uint32_t>(bytes[offset + 1]) << 8) |
+                                     (static_cast<uint32_t>(bytes[offset + 2]) << 16);
+                    if ((value & 0x00800000u) != 0)
+                    {
+                        value |= 0xff000000u;
+                    }
+                    sample = static_cast<float>(static_cast<int32_t>(value)) * (1.0f / 8388608.0f);
+                    break;
+                }
+                case PcmEncoding::kSigned32:
+                {
+                    int32_t value = 0;
+                    std::memcpy(&value, bytes + i * sizeof(value), sizeof(value));
+                    sample = static_cast<float>(value) * (1.0f / 2147483648.0f);
+                    break;
+                }
+                case PcmEncoding::kFloat32:
+                    std::memcpy(&sample, bytes + i * sizeof(sample), sizeof(sample));
+                    break;
+                }
+                if (!std::isfinite(sample))
+                {
+                    return false;
+                }
+                out[i] = sample;
+            }
+            return true;
+        };
+        auto reference_encode = [](PcmEncoding encoding, const float *input, uint8_t *bytes, size_t samples)
+        {
+            for (size_t i = 0; i < samples; ++i)
+            {
+                switch (encoding)
+                {
+                case PcmEncoding::kUnsigned8:
+                {
+                    const float clamped = std::clamp(input[i], -1.0f, 1.0f);
+                    const long encoded = std::lround((clamped * 127.5f) + 127.5f);
+                    bytes[i] = static_cast<uint8_t>(std::clamp(encoded, 0l, 255l));
+                    break;
+                }
+                case PcmEncoding::kSigned16:
+                {
+                    const float clamped = std::clamp(input[i], -1.0f, 1.0f);
+                    const int16_t value = clamped <= -1.0f ? std::numeric_limits<int16_t>::min()
+                                                           : static_cast<int16_t>(std::lround(clamped * 32767.0f));
+                    std::memcpy(bytes + i * sizeof(value), &value, sizeof(value));
+                    break;
+                }
+                case PcmEncoding::kSigned24Packed:
+                {
+                    const float clamped = std::clamp(input[i], -1.0f, 1.0f);
+                    const uint32_t value = static_cast<uint32_t>(
+                        clamped <= -1.0f ? -8388608 : static_cast<int32_t>(std::lround(clamped * 8388607.0f)));
+                    bytes[i * 3] = static_cast<uint8_t>(value & 0xffu);
+                    bytes[i * 3 + 1] = static_cast<uint8_t>((value >> 8) & 0xffu);
+                    bytes[i * 3 + 2] = static_cast<uint8_t>((value >> 16) & 0xffu);
+                    break;
+                }
+                case PcmEncoding::kSigned32:
+                {
+                    const double clamped = std::clamp(static_cast<double>(input[i]), -1.0, 1.0);
+                    const int32_t value = clamped <= -1.0
+                                              ? std::numeric_limits<int32_t>::min()
+                                              : static_cast<int32_t>(std::llround(clamped * 2147483647.0));
+                    std::memcpy(bytes + i * sizeof(value), &value, sizeof(value));
+                    break;
+                }
+                case PcmEncoding::kFloat32:
+                    std::memcpy(bytes + i * sizeof(float), input + i, sizeof(float));
+                    break;
+                }
+            }
+        };
+
+        uint32_t seed = 0xc0dec0deu;
+        auto next = [&]()
+        {
+            seed = seed * 1664525u + 1013904223u;
+            return seed;
+        };
+        // Overdriven noise, the clamp edges, and products that land exactly on
+        // a rounding half for each integer width.
+        std::vector<float> floats;
+        for (size_t i = 0; i < 512; ++i)
+        {
+            floats.push_back(1.25f * (static_cast<float>(next() >> 8) / 8388608.0f - 1.0f));
+        }
+        floats.insert(floats.end(),
+                      {-1.0f, 1.0f, -1.5f, 7.0f, -0.0f, 0.0f, std::nextafter(-1.0f, 0.0f), std::nextafter(1.0f, 0.0f),
+                       std::numeric_limits<float>::denorm_min(), -std::numeric_limits<float>::max()});
+        for (int k = 0; k < 255; ++k)
+        {
+            const float tie = (static_cast<float>(k) + 0.5f - 127.5f) / 127.5f;
+            if ((tie * 127.5f) + 127.5f == static_cast<float>(k) + 0.5f)
+            {
+                floats.push_back(tie);
+            }
+        }
+        for (int k = -32767; k < 32767; k += 251)
+        {
+            floats.push_back((static_cast<float>(k) + 0.5f) / 32767.0f);
+        }
+        for (int k = -8388607; k < 8388607; k += 65521)
+        {
+            const float tie = (static_cast<float>(k) + 0.5f) / 8388607.0f;
+            if (tie * 8388607.0f == static_cast<float>(k) + 0.5f)
+            {
+                floats.push_back(tie);
+            }
+        }
+        std::vector<uint8_t> raw(4 * floats.size() + 8);
+        for (uint8_t &byte : raw)
+        {
+            byte = static_cast<uint8_t>(next() >> 24);
+        }
+        // Codes at both ends of every integer range.
+        const uint8_t extremes[] = {0x00, 0x00, 0x00, 0x80, 0xff, 0xff, 0xff, 0x7f, 0x01, 0x00, 0x00, 0x80};
+        std::memcpy(raw.data(), extremes, sizeof(extremes));
+
+        // Float32 input is the encoded noise, so it decodes finite.
+        std::vector<uint8_t> float_bytes(4 * floats.size() + 8);
+        reference_encode(PcmEncoding::kFloat32, floats.data(), float_bytes.data(), floats.size());
+
+        const SimdLevel detected = runtime::detected_simd_level();
+        size_t tested = 0;
+        for (SimdLevel level : {SimdLevel::kScalar,
+                                SimdLevel::kSse41,
+                                SimdLevel::kAvx2,
+                                SimdLevel::kAvx512,
+                                SimdLevel::kNeon})
+        {
+            if (!runtime::force_simd_level(level))
+            {
+                continue;
+            }
+            ++tested;
+            bool decode_exact = true;
+            bool encode_exact = true;
+            bool poison_rejected = true;
+            for (size_t e = 0; e < std::size(kEncodings); ++e)
+            {
+                const PcmEncoding encoding = kEncodings[e];
+                const size_t width = kWidths[e];
+                const std::vector<uint8_t> &codes = encoding == PcmEncoding::kFloat32 ? float_bytes : raw;
+                // Lengths around every vector width, from misaligned offsets
+                // as JNI byte buffers arrive.
+                for (size_t samples : {size_t{0}, size_t{1}, size_t{7}, size_t{17}, size_t{35}, size_t{66}, floats.size() - 3})
+                {
+                    for (size_t offset = 0; offset < 4; ++offset)
+                    {
+                        std::vector<uint8_t> shifted(offset + samples * width);
+                        std::memcpy(shifted.data() + offset, codes.data(), samples * width);
+                        std::vector<float> expected(samples + 1, -2.0f);
+                        std::vector<float> decoded(samples + 1, -2.0f);
+                        const bool expected_ok =
+                            reference_decode(encoding, shifted.data() + offset, expected.data(), samples);
+                        const bool decoded_ok =
+                            runtime::decode_pcm(encoding, shifted.data() + offset, decoded.data(), samples);
+                        decode_exact = decode_exact && expected_ok && decoded_ok && expected == decoded;
+
+                        std::vector<uint8_t> expected_bytes(samples * width + 5, 0xa5);
+                        std::vector<uint8_t> encoded_bytes(samples * width + 5, 0xa5);
+                        reference_encode(encoding, floats.data() + offset, expected_bytes.data() + offset, samples);
+                        runtime::encode_pcm(encoding, floats.data() + offset, encoded_bytes.data() + offset, samples);
+                        encode_exact = encode_exact && expected_bytes == encoded_bytes;
+                    }
+                }
+            }
+            for (size_t poison = 0; poison < 40; ++poison)
+            {
+                std::vector<uint8_t> poisoned(float_bytes.begin(), float_bytes.begin() + 4 * 40);
+                const float bad = (poison % 2) == 0 ? std::numeric_limits<float>::quiet_NaN()
+                                                    : std::numeric_limits<float>::infinity();
+                std::memcpy(poisoned.data() + 4 * poison, &bad, sizeof(bad));
+                std::vector<float> decoded(40);
+                poison_rejected = poison_rejected &&
+                                  !runtime::decode_pcm(PcmEncoding::kFloat32, poisoned.data(), decoded.data(), 40);
+            }
+            CHECK(decode_exact, "PCM decode must match the per-sample converters exactly");
+            CHECK(encode_exact, "PCM encode must match the per-sample converters byte for byte");
+            CHECK(poison_rejected, "float32 decode must reject a NaN or infinity at any position");
+        }
+        CHECK(tested > 1 || detected == SimdLevel::kScalar, "a vector level was probed but none was testable");
+        CHECK(runtime::force_simd_level(detected), "restoring the probed level must succeed");
+    }
+
+    void test_real_fft()
+    {
+        using echidna::dsp::runtime::RealFft;
+
+        RealFft rejected;
+        CHECK(!rejected.prepare(32), "FFT sizes below the minimum must be rejected");
+        CHECK(!rejected.prepare(16384), "FFT sizes above the maximum must be rejected");
+        CHECK(!rejected.prepare(1000), "non power-of-two FFT sizes must be rejected");
+        CHECK(rejected.size() == 0, "a rejected FFT must stay unprepared");
+
+        uint32_t seed = 12345u;
+        auto noise = [&]()
+        {
+            seed = seed * 1664525u + 1013904223u;
+            return static_cast<float>(seed >> 8) / 8388608.0f - 1.0f;
+        };
+
+        for (size_t size = RealFft::kMinSize; size <= RealFft::kMaxSize; size *= 2)
+        {
+            RealFft fft;
+            CHECK(fft.prepare(size), "power-of-two FFT sizes in range must be accepted");
+            std::vector<float> input(size);
+            for (float &sample : input)
+            {
+                sample = noise();
+            }
+            std::vector<float> re(fft.bins());
+            std::vector<float> im(fft.bins());
+            fft.forward(input.data(), re.data(), im.data());
+
+            // Direct DFT in double precision as the reference.
+            std::vector<double> cos_table(size);
+            std::vector<double> sin_table(size);
+            for (size_t n = 0; n < size; ++n)
+            {
+                const double angle = -2.0 * kPi * static_cast<double>(n) / static_cast<double>(size);
+                cos_table[n] = std::cos(angle);
+                sin_table[n] = std::sin(angle);
+            }
+            double error = 0.0;
+            double energy = 0.0;
+            for (size_t k = 0; k < fft.bins(); ++k)
+            {
+                double ref_re = 0.0;
+                double ref_im = 0.0;
+                for (size_t n = 0; n < size; ++n)
+                {
+                    const size_t index = (k * n) % size;
+                    ref_re += input[n] * cos_table[index];
+                    ref_im += input[n] * sin_table[index];
+                }
+                error += (re[k] - ref_re) * (re[k] - ref_re) + (im[k] - ref_im) * (im[k] - ref_im);
+                energy += ref_re * ref_re + ref_im * ref_im;
+            }
+            CHECK(std::sqrt(error / energy) < 1e-5, "FFT must match the direct DFT");
+
+            std::vector<float> output(size);
+            fft.inverse(re.data(), im.data(), output.data());
+            double max_diff = 0.0;
+            for (size_t n = 0; n < size; ++n)
+            {
+                max_diff = std::max(max_diff, static_cast<double>(std::fabs(output[n] - input[n])));
+            }
+            CHECK(max_diff < 1e-5, "inverse FFT must reproduce the input");
+        }
+    }
+
+    // --- Cross-correlation kernel -------------------------------------------
+    void test_cross_correlation()
+    {
+        uint32_t seed = 777u;
+        auto noise = [&]()
+        {
+            seed = seed * 1664525u + 1013904223u;
+            return static_cast<float>(seed >> 8) / 8388608.0f - 1.0f;
+        };
+
+        // Lag counts cover the two-vector body, the one-vector step and the
+        // scalar tail.
+        for (size_t lags : {1u, 3u, 4u, 7u, 8u, 13u, 64u})
+        {
+            const size_t length = 37;
+            std::vector<float> reference(length);
+            std::vector<float> signal(lags + length - 1);
+            for (float &sample : reference)
+            {
+                sample = noise();
+            }
+            for (float &sample : signal)
+            {
+                sample = noise();
+            }
+            std::vector<float> out(lags);
+            echidna::dsp::runtime::cross_correlation(reference.data(), signal.data(), length, lags,
+                                                     out.data());
+            double max_diff = 0.0;
+            for (size_t lag = 0; lag < lags; ++lag)
+            {
+                double expected = 0.0;
+                for (size_t i = 0; i < length; ++i)
+                {
+                    expected += static_cast<double>(reference[i]) * signal[lag + i];
+                }
+                max_diff = std::max(max_diff, std::fabs(expected - out[lag]));
+            }
+            CHECK(max_diff < 1e-4, "cross-correlation must match the direct sum");
+        }
+    }
+
+    // --- Pitch detector -----------------------------------------------------
+    void test_pitch_detector()
+    {
+        using echidna::dsp::runtime::PitchDetectorSettings;
+        using echidna::dsp::runtime::YinPitchDetector;
+        const uint32_t sr = static_cast<uint32_t>(kSampleRate);
+
+        PitchDetectorSettings full_rate;
+        full_rate.analysis_rate_hz = 0;
+        const PitchDetectorSettings decimated{};
+
+        YinPitchDetector rejected;
+        PitchDetectorSettings inverted;
+        inverted.min_hz = 500.0f;
+        inverted.max_hz = 100.0f;
+        CHECK(!rejected.prepare(sr, inverted), "an empty search range must be rejected");
+        CHECK(rejected.estimate() == 0.0f, "an unprepared detector must report unvoiced");
+
+        // A harmonic-rich tone (fundamental plus two weaker harmonics) fed in
+        // 10 ms blocks, as Auto-Tune does.
+        auto detect = [&](const PitchDetectorSettings &settings, double hz)
+        {
+            YinPitchDetector detector;
+            detector.prepare(sr, settings);
+            std::vector<float> block(480);
+            size_t t = 0;
+            for (int callback = 0; callback < 12; ++callback)
+            {
+                for (float &sample : block)
+                {
+                    const double phase = 2.0 * kPi * hz * static_cast<double>(t++) / kSampleRate;
+                    sample = static_cast<float>(0.4 * std::sin(phase) + 0.2 * std::sin(2.0 * phase) +
+                                                0.1 * std::sin(3.0 * phase));
+                }
+                detector.push(block.data(), block.size());
+            }
+            return static_cast<double>(detector.estimate());
+        };
+        for (double hz : {82.4, 196.0, 440.0, 880.0})
+        {
+            CHECK_BETWEEN(cents(detect(full_rate, hz), hz), -3.0, 3.0);
+            CHECK_BETWEEN(cents(detect(decimated, hz), hz), -5.0, 5.0);
+        }
+
+        YinPitchDetector detector;
+        detector.prepare(sr, decimated);
+        CHECK(detector.analysis_rate() == 12000.0f, "48 kHz input must be analysed at 12 kHz");
+        std::vector<float> noise(sr / 10);
+        uint32_t state = 0xBEEFu;
+        for (float &sample : noise)
+        {
+            state = state * 1664525u + 1013904223u;
+            sample = 0.3f * (static_cast<float>(state >> 8) / 8388608.0f - 1.0f);
+        }
+        detector.push(noise.data(), noise.size());
+        CHECK(detector.estimate() == 0.0f, "white noise must be unvoiced");
+        std::vector<float> silence(sr / 10, 0.0f);
+        detector.push(silence.data(), silence.size());
+        CHECK(detector.estimate() == 0.0f, "silence must be unvoiced");
+        detector.reset();
+        CHECK(detector.estimate() == 0.0f, "reset must clear the analysis window");
+    }
+
+    // --- Shared spectral analysis bus ----------------------------------------
+    void test_spectral_analysis()
+    {
+        using echidna::dsp::runtime::SpectralAnalysis;
+        const uint32_t sr = static_cast<uint32_t>(kSampleRate);
+
+        SpectralAnalysis unprepared;
+        CHECK(!unprepared.prepared() && !unprepared.prepare(0), "a zero rate must be rejected");
+
+        SpectralAnalysis bus;
+        CHECK(bus.prepare(sr), "analysis bus must prepare at 48 kHz");
+        CHECK(bus.hop_frames() == 480 && bus.fft_size() == 1024, "10 ms hops of 1024-point frames");
+
+        // 200 Hz harmonics under a spectral peak at 1.2 kHz, fed in blocks
+        // that do not divide the hop.
+        auto voice = [&](size_t frames)
+        {
+            std::vector<float> out(frames);
+            for (size_t t = 0; t < frames; ++t)
+            {
+                double sample = 0.0;
+                for (int harmonic = 1; harmonic <= 20; ++harmonic)
+                {
+                    const double hz = 200.0 * harmonic;
+                    const double gain = std::exp(-std::pow((hz - 1200.0) / 500.0, 2.0));
+                    sample += 0.1 * gain * std::sin(2.0 * kPi * hz * static_cast<double>(t) / kSampleRate);
+                }
+                out[t] = static_cast<float>(sample);
+            }
+            return out;
+        };
+        const size_t frames = sr / 4;
+        const auto signal = voice(frames);
+        constexpr size_t block = 333;
+        const uint32_t all = SpectralAnalysis::kPitch | SpectralAnalysis::kEnvelope;
+        for (size_t offset = 0; offset < frames; offset += block)
+        {
+            const float *channel = signal.data() + offset;
+            bus.analyze(&channel, 1, std::min(block, frames - offset), all);
+        }
+        CHECK(bus.hop_count() == frames / bus.hop_frames(), "one analysis per completed hop");
+        CHECK(bus.features() == (all | SpectralAnalysis::kSpectrum), "the envelope implies the spectrum");
+        CHECK_BETWEEN(cents(bus.pitch_hz(), 200.0), -5.0, 5.0);
+
+        size_t magnitude_peak = 0;
+        size_t envelope_peak = 1;
+        for (size_t k = 1; k < bus.bins(); ++k)
+        {
+            magnitude_peak = bus.magnitude()[k] > bus.magnitude()[magnitude_peak] ? k : magnitude_peak;
+            envelope_peak = bus.envelope()[k] > bus.envelope()[envelope_peak] ? k : envelope_peak;
+        }
+        CHECK_BETWEEN(static_cast<double>(magnitude_peak) * bus.bin_hz(), 1150.0, 1250.0);
+        CHECK_BETWEEN(static_cast<double>(envelope_peak) * bus.bin_hz(), 1000.0, 1400.0);
+        // Liftering removes the harmonic comb: between two harmonics the
+        // envelope stays close to its value on them.
+        const size_t on_harmonic = static_cast<size_t>(std::lround(1200.0 / bus.bin_hz()));
+        const size_t between = static_cast<size_t>(std::lround(1300.0 / bus.bin_hz()));
+        CHECK(bus.magnitude()[between] < 0.1f * bus.magnitude()[on_harmonic],
+              "the STFT magnitude must resolve the harmonics");
+        CHECK(bus.envelope()[between] > 0.5f * bus.envelope()[on_harmonic],
+              "the envelope must smooth over the harmonics");
+
+        // Only requested features are computed.
+        SpectralAnalysis pitch_only;
+        pitch_only.prepare(sr);
+        const float *channel = signal.data();
+        pitch_only.analyze(&channel, 1, frames, SpectralAnalysis::kPitch);
+        CHECK(pitch_only.features() == SpectralAnalysis::kPitch, "pitch-only analysis");
+        CHECK(pitch_only.pitch_hz() > 0.0f && pitch_only.magnitude()[on_harmonic] == 0.0f,
+              "an unrequested spectrum must not be computed");
+
+        // Channels are averaged: opposite-polarity channels cancel.
+        std::vector<float> inverted(signal);
+        for (float &sample : inverted)
+        {
+            sample = -sample;
+        }
+        const float *pair[2] = {signal.data(), inverted.data()};
+        bus.reset();
+        CHECK(bus.hop_count() == 0 && bus.pitch_hz() == 0.0f, "reset must clear the frame");
+        bus.analyze(pair, 2, frames, all);
+        CHECK(bus.pitch_hz() == 0.0f && bus.magnitude()[on_harmonic] == 0.0f,
+              "the bus must analyse the channel average");
+    }
+
+    // --- Feedback delay network reverb ----------------------------------------
+    void test_reverb()
+    {
+        const uint32_t sr = static_cast<uint32_t>(kSampleRate);
+        const size_t n = sr * 2;
+        auto impulse_response = [&](const ReverbParameters &params, size_t block)
+        {
+            Reverb r;
+            r.set_parameters(params);
+            r.prepare(sr, 1);
+            r.set_enabled(true);
+            r.reset();
+            std::vector<float> buf(n, 0.0f);
+            buf[0] = 1.0f;
+            for (size_t offset = 0; offset < n; offset += block)
+            {
+                ProcessContext ctx{buf.data() + offset, std::min(block, n - offset), 1, sr};
+                r.process(ctx);
+            }
+            return buf;
+        };
+        auto energy = [](const std::vector<float> &v, size_t begin, size_t end)
+        {
+            double sum = 0.0;
+            for (size_t i = begin; i < end; ++i)
+            {
+                sum += static_cast<double>(v[i]) * v[i];
+            }
+            return sum;
+        };
+        const size_t quarter = sr / 4;
+
+        // Mix 0 is the dry signal, bit for bit.
+        {
+            const auto out = impulse_response(ReverbParameters{50.0f, 30.0f, 10.0f, 0.0f}, 480);
+            CHECK(out[0] == 1.0f && energy(out, 1, n) == 0.0, "mix 0 must pass the input through");
+        }
+
+        // The tail decays, and decays more slowly in a larger room.
+        const auto small = impulse_response(ReverbParameters{20.0f, 30.0f, 0.0f, 50.0f}, 480);
+        const auto large = impulse_response(ReverbParameters{80.0f, 30.0f, 0.0f, 50.0f}, 480);
+        CHECK(all_finite(small) && all_finite(large), "reverb tail must stay finite");
+        const double small_early = energy(small, 1, quarter);
+        const double large_early = energy(large, 1, quarter);
+        CHECK(small_early > 1e-4, "reverb must produce a tail");
+        CHECK(energy(small, 4 * quarter, 6 * quarter) < 1e-4 * small_early,
+              "a small room must have decayed by 40 dB after a second");
+        CHECK(energy(large, quarter, 2 * quarter) / large_early >
+                  10.0 * energy(small, quarter, 2 * quarter) / small_early,
+              "a larger room must decay more slowly");
+
+        // Block size does not change the result (partial lane groups included).
+        {
+            const auto frame_by_frame = impulse_response(ReverbParameters{20.0f, 30.0f, 0.0f, 50.0f}, 1);
+            const auto odd = impulse_response(ReverbParameters{20.0f, 30.0f, 0.0f, 50.0f}, 333);
+            CHECK(frame_by_frame == small && odd == small, "reverb output must not depend on block size");
+        }
+
+        // Nothing comes back before the pre-delay plus the shortest line.
+        {
+            const ReverbParameters params{50.0f, 30.0f, 20.0f, 50.0f};
+            Reverb probe;
+            probe.set_parameters(params);
+            probe.prepare(sr, 1);
+            size_t shortest = probe.line_length(0);
+            for (size_t i = 1; i < Reverb::kLines; ++i)
+            {
+                shortest = std::min(shortest, probe.line_length(i));
+            }
+            const size_t first = sr / 50 + shortest;
+            const auto out = impulse_response(params, 480);
+            CHECK(energy(out, 1, first) == 0.0 && out[first] != 0.0f,
+                  "the first reflection must arrive after the pre-delay and shortest line");
+        }
+
+        // Damping removes high frequencies from the tail.
+        {
+            auto brightness = [&](const std::vector<float> &v)
+            {
+                double diff = 0.0;
+                for (size_t i = quarter / 2; i < 2 * quarter; ++i)
+                {
+                    const double d = static_cast<double>(v[i]) - v[i - 1];
+                    diff += d * d;
+                }
+                return diff / energy(v, quarter / 2, 2 * quarter);
+            };
+            const auto bright = impulse_response(ReverbParameters{60.0f, 0.0f, 0.0f, 50.0f}, 480);
+            const auto dark = impulse_response(ReverbParameters{60.0f, 90.0f, 0.0f, 50.0f}, 480);
+            CHECK(brightness(dark) < 0.5 * brightness(bright), "damping must darken the tail");
+        }
+
+        // Stereo channels are independent; damping keeps the arena and the
+        // tail, a new room size rebuilds and clears it.
+        {
+            Reverb r;
+            r.set_parameters(ReverbParameters{50.0f, 30.0f, 5.0f, 50.0f});
+            r.prepare(sr, 2);
+            r.set_enabled(true);
+            r.reset();
+            const size_t frames = 480;
+            std::vector<float> buf(frames * 2, 0.0f);
+            buf[0] = 1.0f;
+            auto run = [&]()
+            {
+                ProcessContext ctx{buf.data(), frames, 2, sr};
+                r.process(ctx);
+                double left = 0.0;
+                double right = 0.0;
+                for (size_t i = 0; i < frames; ++i)
+                {
+                    left += static_cast<double>(buf[2 * i]) * buf[2 * i];
+                    right += static_cast<double>(buf[2 * i + 1]) * buf[2 * i + 1];
+                }
+                std::fill(buf.begin(), buf.end(), 0.0f);
+                return std::pair<double, double>{left, right};
+            };
+            for (int i = 0; i < 4; ++i)
+            {
+                run();
+            }
+            const size_t arena = r.arena_size();
+            const size_t length = r.line_length(0);
+            r.set_parameters(ReverbParameters{50.0f, 80.0f, 5.0f, 50.0f});
+            CHECK(r.arena_size() == arena && r.line_length(0) == length,
+                  "a damping change must not touch the delay lines");
+            const auto tail = run();
+            CHECK(tail.first > 0.0 && tail.second == 0.0,
+                  "the tail must survive a damping change and stay in its channel");
+            r.set_parameters(ReverbParameters{90.0f, 80.0f, 5.0f, 50.0f});
+            CHECK(r.line_length(0) > length, "a larger room must lengthen the lines");
+            CHECK(run().first == 0.0, "a room size change must clear the lines");
+        }
+
+        // Full-scale noise into the longest, undamped room stays bounded.
+        {
+            Reverb r;
+            r.set_parameters(ReverbParameters{100.0f, 0.0f, 40.0f, 50.0f});
+            r.prepare(sr, 1);
+            r.set_enabled(true);
+            r.reset();
+            std::vector<float> buf(n);
+            uint32_t state = 0x5EEDu;
+            for (float &sample : buf)
+            {
+                state = state * 1664525u + 1013904223u;
+                sample = static_cast<float>(state >> 8) / 8388608.0f - 1.0f;
+            }
+            ProcessContext ctx{buf.data(), n, 1, sr};
+            r.process(ctx);
+            CHECK(all_finite(buf), "reverb must stay finite on noise");
+            CHECK_BETWEEN(rms(buf, n / 2, n), 0.1, 2.0);
+        }
+    }
+
+    // --- Partitioned convolution reverb --------------------------------------
+    void test_convolution_reverb()
+    {
+        using echidna::dsp::runtime::ImpulseResponseLibrary;
+        const uint32_t sr = static_cast<uint32_t>(kSampleRate);
+        ImpulseResponseLibrary &library = ImpulseResponseLibrary::instance();
+        const size_t partition = ConvolutionReverb::partition_frames(sr);
+        CHECK(partition == 256, "partitions are about 5 ms at 48 kHz");
+
+        // Two taps of unit total energy, the second beyond many partitions.
+        constexpr size_t kFirstTap = 300;
+        constexpr size_t kSecondTap = 5000;
+        std::vector<float> taps(kSecondTap + 1, 0.0f);
+        taps[kFirstTap] = 0.6f;
+        taps[kSecondTap] = 0.8f;
+        CHECK(library.add("test_taps", taps.data(), taps.size(), sr), "a valid response must register");
+
+        const auto spectra = library.partitioned("test_taps", sr, partition);
+        CHECK(spectra != nullptr && spectra->partitions == (kSecondTap + partition) / partition,
+              "the response must split into whole partitions");
+        CHECK(library.partitioned("test_taps", sr, partition) == spectra, "spectra must be computed once");
+        const auto resampled = library.partitioned("test_taps", sr / 2, partition / 2);
+        CHECK(resampled != nullptr && resampled != spectra && resampled->frames == (taps.size() + 1) / 2,
+              "another rate gets its own resampled spectra");
+        CHECK(library.partitioned("no_such_ir", sr, partition) == nullptr, "unknown ids have no spectra");
+        CHECK(library.contains("room") && library.contains("plate") && library.contains("hall"),
+              "the built-in responses must be registered");
+        CHECK(library.partitioned("hall", sr, partition)->partitions >
+                  library.partitioned("room", sr, partition)->partitions,
+              "the hall must ring longer than the room");
+        const float bad[2] = {0.5f, std::nanf("")};
+        const float silent[2] = {0.0f, 0.0f};
+        CHECK(!library.add("", taps.data(), taps.size(), sr) && !library.add("bad", bad, 2, sr) &&
+                  !library.add("silent", silent, 2, sr),
+              "invalid responses must be rejected");
+
+        // Wet output is the linear convolution, one partition (or the
+        // pre-delay, if longer) late, for any block size and both layouts.
+        const size_t n = 12000;
+        std::vector<float> left(n);
+        std::vector<float> right(n);
+        uint32_t state = 0xC0DEu;
+        for (size_t i = 0; i < n; ++i)
+        {
+            state = state * 1664525u + 1013904223u;
+            left[i] = static_cast<float>(state >> 8) / 8388608.0f - 1.0f;
+            right[i] = 0.25f * std::sin(static_cast<float>(i) * 0.01f);
+        }
+        auto expected = [&](const std::vector<float> &x, size_t i, size_t delay)
+        {
+            double wet = 0.0;
+            if (i >= delay + kFirstTap)
+            {
+                wet += 0.6 * x[i - delay - kFirstTap];
+            }
+            if (i >= delay + kSecondTap)
+            {
+                wet += 0.8 * x[i - delay - kSecondTap];
+            }
+            return 0.6 * x[i] + 0.4 * wet;
+        };
+        auto run = [&](float pre_delay_ms, size_t block, bool planar)
+        {
+            ConvolutionReverb c;
+            c.set_parameters(ReverbParameters{50.0f, 30.0f, pre_delay_ms, 40.0f});
+            c.prepare(sr, 2);
+            c.set_impulse_response(spectra);
+            c.set_enabled(true);
+            std::vector<float> l = left;
+            std::vector<float> r = right;
+            std::vector<float> interleaved(2 * n);
+            for (size_t i = 0; i < n; ++i)
+            {
+                interleaved[2 * i] = l[i];
+                interleaved[2 * i + 1] = r[i];
+            }
+            for (size_t offset = 0; offset < n; offset += block)
+            {
+                const size_t frames = std::min(block, n - offset);
+                float *channels[2] = {l.data() + offset, r.data() + offset};
+                ProcessContext ctx{interleaved.data() + 2 * offset, frames, 2, sr};
+                if (planar)
+                {
+                    ctx.buffer = nullptr;
+                    ctx.planar = channels;
+                }
+                c.process(ctx);
+            }
+            if (!planar)
+            {
+                for (size_t i = 0; i < n; ++i)
+                {
+                    l[i] = interleaved[2 * i];
+                    r[i] = interleaved[2 * i + 1];
+                }
+            }
+            const size_t delay = c.wet_delay_frames();
+            double error = 0.0;
+            for (size_t i = 0; i < n; ++i)
+            {
+                error = std::max(error, std::fabs(l[i] - expected(left, i, delay)));
+                error = std::max(error, std::fabs(r[i] - expected(right, i, delay)));
+            }
+            return std::pair<size_t, double>{delay, error};
+        };
+        const auto aligned = run(0.0f, 256, false);
+        CHECK(aligned.first == partition, "the wet path trails by one partition");
+        CHECK_BETWEEN(aligned.second, 0.0, 1e-4);
+        const auto odd = run(0.0f, 333, true);
+        CHECK_BETWEEN(odd.second, 0.0, 1e-4);
+        const auto delayed = run(20.0f, 97, false);
+        CHECK(delayed.first == sr / 50, "a pre-delay longer than a partition absorbs it");
+        CHECK_BETWEEN(delayed.second, 0.0, 1e-4);
+
+        // Without a response the input passes through untouched.
+        {
+            ConvolutionReverb c;
+            c.set_parameters(ReverbParameters{});
+            c.prepare(sr, 1);
+            c.set_impulse_response(library.partitioned("no_such_ir", sr, partition));
+            c.set_enabled(true);
+            std::vector<float> buf = left;
+            ProcessContext ctx{buf.data(), n, 1, sr};
+            c.process(ctx);
+            CHECK(buf == left && c.partitions() == 0, "a missing response must bypass");
+        }
+
+        // Replacing a response drops its cached spectra; holders keep theirs.
+        taps[kFirstTap] = 0.0f;
+        CHECK(library.add("test_taps", taps.data(), taps.size(), sr), "a response must be replaceable");
+        const auto replaced = library.partitioned("test_taps", sr, partition);
+        CHECK(replaced != nullptr && replaced != spectra && spectra->re.size() == replaced->re.size(),
+              "replacing a response must rebuild its spectra");
+    }
+
+    // --- Parametric EQ coefficient glide ------------------------------------
+    void test_parametric_eq_glide()
+    {
+        const uint32_t sr = static_cast<uint32_t>(kSampleRate);
+        const size_t block = 240;
+        const size_t blocks = 20;
+        const size_t change_block = 8;
+        const size_t n = block * blocks;
+
+        ParametricEQ e;
+        e.set_bands({EqBand{1000.0f, 0.0f, 1.0f}});
+        e.prepare(sr, 1);
+        e.set_enabled(true);
+        auto in = make_sine(1000.0, n, 0.2);
+        auto buf = in;
+        for (size_t b = 0; b < blocks; ++b)
+        {
+            if (b == change_block)
+            {
+                e.set_bands({EqBand{1000.0f, 12.0f, 1.0f}});
+            }
+            ProcessContext ctx{buf.data() + b * block, block, 1, sr};
+            e.process(ctx);
+        }
+
+        // The boost fades in over the 10 ms glide instead of stepping: the
+        // first millisecond after the change is still close to unity, and no
+        // sample-to-sample jump exceeds what the boosted tone itself has.
+        const size_t change = change_block * block;
+        const double early = peak(buf, change, change + 48) / 0.2;
+        CHECK_BETWEEN(early, 0.9, 1.6);
+        double max_step = 0.0;
+        for (size_t i = change; i < n; ++i)
+        {
+            max_step = std::max(max_step, static_cast<double>(std::fabs(buf[i] - buf[i - 1])));
+        }
+        const double boosted_step = 2.0 * kPi * 1000.0 / kSampleRate * 0.2 * 3.98;
+        CHECK(max_step < boosted_step * 1.1, "EQ parameter change must not click");
+        CHECK_BETWEEN(peak(buf, n - 960, n) / 0.2, 3.5, 4.4);
+    }
+
+    /**
+     * Run a stereo signal through two instances built by @p make, one with
+     * interleaved and one with planar contexts, over several blocks, and
+     * return the largest sample difference.
+     */
+    template <typename MakeEffect>
+    double planar_mismatch(MakeEffect make)
+    {
+        const uint32_t sr = static_cast<uint32_t>(kSampleRate);
+        const size_t block = 256;
+        const size_t blocks = 8;
+        const size_t n = block * blocks;
+        auto left = make_sine(220.0, n, 0.4);
+        auto right = make_sine(1250.0, n, 0.05);
+        std::vector<float> interleaved(n * 2);
+        for (size_t i = 0; i < n; ++i)
+        {
+            interleaved[i * 2] = left[i];
+            interleaved[i * 2 + 1] = right[i];
+        }
+
+        std::unique_ptr<EffectProcessor> interleaved_effect = make();
+        std::unique_ptr<EffectProcessor> planar_effect = make();
+        for (size_t b = 0; b < blocks; ++b)
+        {
+            ProcessContext ctx{interleaved.data() + b * block * 2, block, 2, sr};
+            interleaved_effect->process(ctx);
+            float *spans[2] = {left.data() + b * block, right.data() + b * block};
+            ProcessContext planar_ctx{nullptr, block, 2, sr, spans};
+            planar_effect->process(planar_ctx);
+        }
+
+        double max_diff = 0.0;
+        for (size_t i = 0; i < n; ++i)
+        {
+            max_diff = std::max(max_diff, static_cast<double>(std::fabs(interleaved[i * 2] - left[i])));
+            max_diff = std::max(max_diff, static_cast<double>(std::fabs(interleaved[i * 2 + 1] - right[i])));
+        }
+        return max_diff;
+    }
+
+    /** Every effect must produce identical output from a planar context. */
+    void test_planar_layout()
+    {
+        const uint32_t sr = static_cast<uint32_t>(kSampleRate);
+
+        {
+            auto make = [&]() -> std::unique_ptr<EffectProcessor>
+            {
+                auto e = std::make_unique<GateProcessor>();
+                e->set_parameters(GateParameters{-20.0f, 5.0f, 80.0f, 3.0f});
+                e->prepare(sr, 2);
+                e->set_enabled(true);
+                return e;
+            };
+            CHECK(planar_mismatch(make) == 0.0, "gate planar output must match interleaved");
+        }
+
+        {
+            auto make = [&]() -> std::unique_ptr<EffectProcessor>
+            {
+                auto e = std::make_unique<ParametricEQ>();
+                e->set_bands({EqBand{1000.0f, 9.0f, 1.0f}, EqBand{200.0f, -6.0f, 0.7f}});
+                e->prepare(sr, 2);
+                e->set_enabled(true);
+                return e;
+            };
+            CHECK(planar_mismatch(make) == 0.0, "EQ planar output must match interleaved");
+        }
+
+        {
+            auto make = [&]() -> std::unique_ptr<EffectProcessor>
+            {
+                auto e = std::make_unique<Compressor>();
+                e->prepare(sr, 2);
+                e->set_enabled(true);
+                return e;
+            };
+            CHECK(planar_mismatch(make) == 0.0, "compressor planar output must match interleaved");
+        }
+
+        {
+            auto make = [&]() -> std::unique_ptr<EffectProcessor>
+            {
+                auto e = std::make_unique<PitchShifter>();
+                e->prepare(sr, 2);
+                e->set_parameters(PitchParameters{3.0f, 0.0f, PitchQuality::kLowLatency, false});
+                e->set_enabled(true);
+                return e;
+            };
+            CHECK(planar_mismatch(make) == 0.0, "pitch shifter planar output must match interleaved");
+        }
+
+        {
+            auto make = [&]() -> std::unique_ptr<EffectProcessor>
+            {
+                auto e = std::make_unique<FormantShifter>();
+                e->prepare(sr, 2);
+                e->set_parameters(FormantParameters{-200.0f, true});
+                e->set_enabled(true);
+                return e;
+            };
+            CHECK(planar_mismatch(make) == 0.0, "formant shifter planar output must match interleaved");
+        }
+
+        {
+            auto make = [&]() -> std::unique_ptr<EffectProcessor>
+            {
+                auto e = std::make_unique<AutoTune>();
+                e->prepare(sr, 2);
+                e->prepare_realtime(256);
+                AutoTuneParameters parameters;
+                parameters.formant_preserve = true;
+                e->set_parameters(parameters);
+                e->set_enabled(true);
+                return e;
+            };
+            CHECK(planar_mismatch(make) == 0.0, "auto-tune planar output must match interleaved");
+        }
+
+        {
+            auto make = [&]() -> std::unique_ptr<EffectProcessor>
+            {
+                auto e = std::make_unique<Reverb>();
+                e->set_parameters(ReverbParameters{70.0f, 40.0f, 12.0f, 40.0f});
+                e->prepare(sr, 2);
+                e->set_enabled(true);
+                return e;
+            };
+            CHECK(planar_mismatch(make) == 0.0, "reverb planar output must match interleaved");
+        }
+
+        {
+            auto make = [&]() -> std::unique_ptr<EffectProcessor>
+            {
+                auto e = std::make_unique<MixBus>();
+                e->set_parameters(MixParameters{100.0f, -3.0f});
+                e->prepare(sr, 2);
+                e->set_enabled(true);
+                return e;
+            };
+            CHECK(planar_mismatch(make) == 0.0, "mix bus planar output must match interleaved");
+        }
+    }
+
 } // namespace
 
 int main()
@@ -799,7 +2432,19 @@ int main()
     test_auto_tune();
     test_gate();
     test_compressor();
+    test_dynamics_core();
     test_parametric_eq();
+    test_biquad_cascade();
+    test_simd_dispatch();
+    test_pcm_codec();
+    test_real_fft();
+    test_cross_correlation();
+    test_pitch_detector();
+    test_spectral_analysis();
+    test_reverb();
+    test_convolution_reverb();
+    test_parametric_eq_glide();
+    test_planar_layout();
 
     if (g_failures != 0)
     {
@@ -1,8 +1,13 @@
 #include "echidna/dsp/api.h"
+#include "engine.h"
 
+#include <atomic>
 #include <cassert>
+#include <chrono>
+#include <cmath>
 #include <cstring>
 #include <string>
+#include <thread>
 #include <vector>
 
 namespace
@@ -23,8 +28,359 @@ namespace
         ]
     })";
 
+    const char *kHybridPassThroughPreset = R"({
+        "name": "HybridPassthrough",
+        "engine": {"latencyMode": "HQ", "blockMs": 20},
+        "modules": [
+            {"id": "gate", "enabled": false},
+            {"id": "eq", "enabled": false, "bands": []},
+            {"id": "comp", "enabled": false},
+            {"id": "pitch", "enabled": false},
+            {"id": "formant", "enabled": false},
+            {"id": "autotune", "enabled": false},
+            {"id": "reverb", "enabled": false},
+            {"id": "mix", "wet": 100.0, "outGain": 0.0}
+        ]
+    })";
+
+    // Same as kHybridPassThroughPreset apart from the mix bus output gain, so
+    // the worker's output is distinguishable from the dry fallback.
+    const char *kHybridAttenuatedPreset = R"({
+        "name": "HybridAttenuated",
+        "engine": {"latencyMode": "HQ", "blockMs": 20},
+        "modules": [
+            {"id": "gate", "enabled": false},
+            {"id": "eq", "enabled": false, "bands": []},
+            {"id": "comp", "enabled": false},
+            {"id": "pitch", "enabled": false},
+            {"id": "formant", "enabled": false},
+            {"id": "autotune", "enabled": false},
+            {"id": "reverb", "enabled": false},
+            {"id": "mix", "wet": 100.0, "outGain": -6.0}
+        ]
+    })";
+
+    const char *kAttenuatedPreset = R"({
+        "name": "Attenuated",
+        "engine": {"latencyMode": "Balanced", "blockMs": 20},
+        "modules": [
+            {"id": "gate", "enabled": false},
+            {"id": "eq", "enabled": false, "bands": []},
+            {"id": "comp", "enabled": false},
+            {"id": "pitch", "enabled": false},
+            {"id": "formant", "enabled": false},
+            {"id": "autotune", "enabled": false},
+            {"id": "reverb", "enabled": false},
+            {"id": "mix", "wet": 100.0, "outGain": -6.0}
+        ]
+    })";
+
+    const char *kReverbPreset = R"({
+        "name": "Room",
+        "engine": {"latencyMode": "Balanced", "blockMs": 20},
+        "modules": [
+            {"id": "gate", "enabled": false},
+            {"id": "eq", "enabled": false, "bands": []},
+            {"id": "comp", "enabled": false},
+            {"id": "pitch", "enabled": false},
+            {"id": "formant", "enabled": false},
+            {"id": "autotune", "enabled": false},
+            {"id": "reverb", "enabled": true, "room": 80.0, "damp": 30.0, "predelayMs": 0.0, "mix": 50.0},
+            {"id": "mix", "wet": 100.0, "outGain": 0.0}
+        ]
+    })";
+
+    // Same as kReverbPreset apart from the mix bus output gain.
+    const char *kReverbLouderPreset = R"({
+        "name": "Room louder",
+        "engine": {"latencyMode": "Balanced", "blockMs": 20},
+        "modules": [
+            {"id": "gate", "enabled": false},
+            {"id": "eq", "enabled": false, "bands": []},
+            {"id": "comp", "enabled": false},
+            {"id": "pitch", "enabled": false},
+            {"id": "formant", "enabled": false},
+            {"id": "autotune", "enabled": false},
+            {"id": "reverb", "enabled": true, "room": 80.0, "damp": 30.0, "predelayMs": 0.0, "mix": 50.0},
+            {"id": "mix", "wet": 100.0, "outGain": 3.0}
+        ]
+    })";
+
+    // A gate ahead of the reverb; the two presets only differ in the gate
+    // threshold.
+    const char *kGatedReverbPreset = R"({
+        "name": "Gated room",
+        "engine": {"latencyMode": "Balanced", "blockMs": 20},
+        "modules": [
+            {"id": "gate", "enabled": true, "threshold": -70.0, "attackMs": 1.0, "releaseMs": 20.0, "hysteresis": 0.0},
+            {"id": "reverb", "enabled": true, "room": 80.0, "damp": 30.0, "predelayMs": 0.0, "mix": 50.0},
+            {"id": "mix", "wet": 100.0, "outGain": 0.0}
+        ]
+    })";
+
+    const char *kGatedReverbTweakedPreset = R"({
+        "name": "Gated room tweaked",
+        "engine": {"latencyMode": "Balanced", "blockMs": 20},
+        "modules": [
+            {"id": "gate", "enabled": true, "threshold": -65.0, "attackMs": 1.0, "releaseMs": 20.0, "hysteresis": 0.0},
+            {"id": "reverb", "enabled": true, "room": 80.0, "damp": 30.0, "predelayMs": 0.0, "mix": 50.0},
+            {"id": "mix", "wet": 100.0, "outGain": 0.0}
+        ]
+    })";
+
+    // Parallel mix bus: the reverb output is blended with the untouched dry
+    // input, so the engine has to keep a dry signal for the whole block.
+    const char *kParallelReverbPreset = R"({
+        "name": "Parallel room",
+        "engine": {"latencyMode": "Balanced", "blockMs": 20},
+        "modules": [
+            {"id": "gate", "enabled": false},
+            {"id": "eq", "enabled": false, "bands": []},
+            {"id": "comp", "enabled": false},
+            {"id": "pitch", "enabled": false},
+            {"id": "formant", "enabled": false},
+            {"id": "autotune", "enabled": false},
+            {"id": "reverb", "enabled": true, "room": 80.0, "damp": 30.0, "predelayMs": 0.0, "mix": 100.0},
+            {"id": "mix", "wet": 50.0, "outGain": 0.0}
+        ]
+    })";
+
+    // A -46 dB tone stays below the gate threshold unless the +12 dB EQ band
+    // runs first, so the two orders produce silence and signal respectively.
+    const char *kGateFirstPreset = R"({
+        "name": "Gate first",
+        "engine": {"latencyMode": "Balanced", "blockMs": 20},
+        "modules": [
+            {"id": "gate", "enabled": true, "threshold": -40.0, "attackMs": 5.0, "releaseMs": 20.0, "hysteresis": 0.0},
+            {"id": "eq", "enabled": true, "bands": [{"f": 1000.0, "g": 12.0, "q": 1.0}]},
+            {"id": "mix", "wet": 100.0, "outGain": 0.0}
+        ]
+    })";
+
+    const char *kEqFirstPreset = R"({
+        "name": "EQ first",
+        "engine": {"latencyMode": "Balanced", "blockMs": 20, "order": ["eq", "gate"]},
+        "modules": [
+            {"id": "gate", "enabled": true, "threshold": -40.0, "attackMs": 5.0, "releaseMs": 20.0, "hysteresis": 0.0},
+            {"id": "eq", "enabled": true, "bands": [{"f": 1000.0, "g": 12.0, "q": 1.0}]},
+            {"id": "mix", "wet": 100.0, "outGain": 0.0}
+        ]
+    })";
+
+    float ToneEnergyAfterSettling(const char *preset, uint32_t sample_rate, uint32_t channels, size_t frames)
+    {
+        assert(ech_dsp_update_config(preset, std::strlen(preset)) == ECH_DSP_STATUS_OK);
+        std::vector<float> tone(frames * channels);
+        std::vector<float> output(frames * channels);
+        float energy = 0.0f;
+        size_t phase = 0;
+        for (int block = 0; block < 40; ++block)
+        {
+            for (size_t frame = 0; frame < frames; ++frame, ++phase)
+            {
+                const float sample = 0.005f * std::sin(2.0f * 3.14159265f * 1000.0f *
+                                                       static_cast<float>(phase) /
+                                                       static_cast<float>(sample_rate));
+                for (uint32_t ch = 0; ch < channels; ++ch)
+                {
+                    tone[frame * channels + ch] = sample;
+                }
+            }
+            assert(ech_dsp_process_block(tone.data(), output.data(), frames) == ECH_DSP_STATUS_OK);
+            energy = 0.0f;
+            for (float sample : output)
+            {
+                energy += sample * sample;
+            }
+        }
+        return energy;
+    }
+
     const char *kInvalidPreset = R"({"name":"bad","modules":[]})";
 
+    // Hybrid presets are pipelined: the call submitting block N returns block
+    // N - k, and the first k calls return the silent prefix of that delay. The
+    // blocks shrink and then grow mid-stream; the output stays one continuous
+    // stream of the input, interrupted only by the silence a larger block has
+    // to pad, and the preset attenuates so worker output and the dry fallback
+    // differ. A dry block is only accepted if the engine counted an underrun.
+    void CheckHybridPipeline(uint32_t sample_rate, uint32_t channels, size_t frames, bool prepared)
+    {
+        echidna::dsp::DspEngineOptions options;
+        options.load_plugins = false;
+        echidna::dsp::DspEngine engine(sample_rate, channels, ECH_DSP_QUALITY_BALANCED, options);
+        auto loaded = echidna::dsp::config::LoadPresetFromJson(kHybridAttenuatedPreset);
+        assert(loaded.ok);
+        assert(engine.UpdatePreset(loaded.preset) == ECH_DSP_STATUS_OK);
+        if (prepared)
+        {
+            assert(engine.PrepareRealtime(frames * 2) == ECH_DSP_STATUS_OK);
+        }
+        uint32_t latency_blocks = 0;
+        size_t latency_frames = 0;
+        assert(engine.GetLatency(&latency_blocks, nullptr) == ECH_DSP_STATUS_OK);
+        assert(latency_blocks >= 1);
+
+        const float attenuation = std::pow(10.0f, -6.0f / 20.0f);
+        const auto period = std::chrono::microseconds(frames * 1000000 / sample_rate);
+        std::vector<float> submitted;
+        std::vector<float> emitted;
+        // More blocks than the pool holds, so indices must be recycled.
+        for (size_t block = 0; block < 48; ++block)
+        {
+            const size_t block_frames = block < 16 ? frames : block < 32 ? frames / 2 : frames * 2;
+            const size_t samples = block_frames * channels;
+            std::vector<float> hybrid_input(samples);
+            for (size_t i = 0; i < samples; ++i)
+            {
+                hybrid_input[i] = static_cast<float>(submitted.size() + i + 1) * 1.0e-5f;
+            }
+            submitted.insert(submitted.end(), hybrid_input.begin(), hybrid_input.end());
+            std::vector<float> hybrid_output(samples, 5.0f);
+            assert(engine.ProcessBlock(hybrid_input.data(), hybrid_output.data(), block_frames) ==
+                   ECH_DSP_STATUS_OK);
+            emitted.insert(emitted.end(), hybrid_output.begin(), hybrid_output.end());
+            if (block == 0)
+            {
+                assert(engine.GetLatency(nullptr, &latency_frames) == ECH_DSP_STATUS_OK);
+                assert(latency_frames == frames * latency_blocks);
+            }
+            // Leave the worker the callback period it gets in production.
+            std::this_thread::sleep_for(period);
+        }
+        assert(engine.GetLatency(nullptr, &latency_frames) == ECH_DSP_STATUS_OK);
+        assert(latency_frames == frames * 2 * latency_blocks);
+
+        // Priming pads k blocks, growing to twice the size pads the difference
+        // between the new size and the leftover of the smaller blocks.
+        const size_t expected_silence = (frames * latency_blocks + frames) * channels;
+        size_t silence = 0;
+        size_t next = 0;
+        size_t dry = 0;
+        for (float sample : emitted)
+        {
+            if (sample == 0.0f)
+            {
+                ++silence;
+                continue;
+            }
+            const float source = submitted[next++];
+            if (std::fabs(sample - source) <= 1.0e-7f)
+            {
+                ++dry;
+                continue;
+            }
+            assert(std::fabs(sample - source * attenuation) <= 1.0e-6f);
+        }
+        assert(silence == expected_silence);
+        assert(next + frames * 2 * latency_blocks * channels == submitted.size());
+        assert(dry == 0 || engine.hybrid_underruns() > 0);
+        assert(dry < next / 2);
+
+        // An idle hybrid worker parks on the queue futex instead of spinning;
+        // it only returns from the wait when the idle timeout fires.
+        const uint64_t wakeups = engine.worker_wakeups();
+        std::this_thread::sleep_for(std::chrono::milliseconds(300));
+        assert(engine.worker_wakeups() - wakeups < 32);
+    }
+
+    // Engines processing the same signal in place and into a separate buffer
+    // stay sample-identical, and the separate call leaves its input intact.
+    void CheckEngineAliasing(uint32_t sample_rate, uint32_t channels, size_t frames)
+    {
+        const size_t samples = frames * channels;
+        ech_dsp_engine_t *in_place_engine = nullptr;
+        ech_dsp_engine_t *disjoint_engine = nullptr;
+        assert(ech_dsp_engine_create(sample_rate, channels, ECH_DSP_QUALITY_BALANCED, frames, kParallelReverbPreset,
+                                     std::strlen(kParallelReverbPreset), &in_place_engine) == ECH_DSP_STATUS_OK);
+        assert(ech_dsp_engine_create(sample_rate, channels, ECH_DSP_QUALITY_BALANCED, frames, kParallelReverbPreset,
+                                     std::strlen(kParallelReverbPreset), &disjoint_engine) == ECH_DSP_STATUS_OK);
+        std::vector<float> block(samples);
+        std::vector<float> output(samples);
+        float energy = 0.0f;
+        for (size_t index = 0; index < 8; ++index)
+        {
+            for (size_t i = 0; i < samples; ++i)
+            {
+                block[i] = 0.25f * std::sin(0.01f * static_cast<float>(index * samples + i));
+            }
+            const std::vector<float> original = block;
+            assert(ech_dsp_engine_process(disjoint_engine, block.data(), output.data(), frames) ==
+                   ECH_DSP_STATUS_OK);
+            assert(block == original);
+            assert(ech_dsp_engine_process(in_place_engine, block.data(), block.data(), frames) ==
+                   ECH_DSP_STATUS_OK);
+            assert(block == output);
+            for (size_t i = 0; i < samples; ++i)
+            {
+                energy += (output[i] - original[i]) * (output[i] - original[i]);
+            }
+        }
+        // The reverb is audible, so the bus really mixed a wet and a dry path.
+        assert(energy > 0.0f);
+        ech_dsp_engine_destroy(in_place_engine);
+        ech_dsp_engine_destroy(disjoint_engine);
+    }
+
+    // A reset engine keeps its preset but none of the audio it has heard: the
+    // reverb tail stops, and a hybrid engine emits no queued block.
+    void CheckEngineReset(uint32_t sample_rate, uint32_t channels, size_t frames)
+    {
+        const size_t samples = frames * channels;
+        std::vector<float> tone(samples);
+        for (size_t i = 0; i < samples; ++i)
+        {
+            tone[i] = 0.25f * std::sin(0.01f * static_cast<float>(i));
+        }
+        const std::vector<float> silence(samples, 0.0f);
+        std::vector<float> output(samples);
+        auto silent = [&output]()
+        {
+            for (float sample : output)
+            {
+                if (sample != 0.0f)
+                {
+                    return false;
+                }
+            }
+            return true;
+        };
+
+        ech_dsp_engine_t *engine = nullptr;
+        assert(ech_dsp_engine_create(sample_rate, channels, ECH_DSP_QUALITY_BALANCED, frames, kParallelReverbPreset,
+                                     std::strlen(kParallelReverbPreset), &engine) == ECH_DSP_STATUS_OK);
+        assert(ech_dsp_engine_reset(nullptr) == ECH_DSP_STATUS_INVALID_ARGUMENT);
+        // Long enough for the first reflections to come back.
+        for (size_t block = 0; block < 8; ++block)
+        {
+            assert(ech_dsp_engine_process(engine, tone.data(), output.data(), frames) == ECH_DSP_STATUS_OK);
+        }
+        assert(ech_dsp_engine_process(engine, silence.data(), output.data(), frames) == ECH_DSP_STATUS_OK);
+        assert(!silent());
+        assert(ech_dsp_engine_reset(engine) == ECH_DSP_STATUS_OK);
+        assert(ech_dsp_engine_process(engine, silence.data(), output.data(), frames) == ECH_DSP_STATUS_OK);
+        assert(silent());
+        assert(ech_dsp_engine_process(engine, tone.data(), output.data(), frames) == ECH_DSP_STATUS_OK);
+        assert(!silent());
+        ech_dsp_engine_destroy(engine);
+
+        echidna::dsp::DspEngineOptions options;
+        options.load_plugins = false;
+        echidna::dsp::DspEngine hybrid(sample_rate, channels, ECH_DSP_QUALITY_BALANCED, options);
+        auto loaded = echidna::dsp::config::LoadPresetFromJson(kHybridAttenuatedPreset);
+        assert(loaded.ok);
+        assert(hybrid.UpdatePreset(loaded.preset) == ECH_DSP_STATUS_OK);
+        assert(hybrid.PrepareRealtime(frames) == ECH_DSP_STATUS_OK);
+        for (size_t block = 0; block < 4; ++block)
+        {
+            assert(hybrid.ProcessBlock(tone.data(), output.data(), frames) == ECH_DSP_STATUS_OK);
+        }
+        assert(!silent());
+        hybrid.Reset();
+        assert(hybrid.ProcessBlock(silence.data(), output.data(), frames) == ECH_DSP_STATUS_OK);
+        assert(silent());
+    }
+
 } // namespace
 
 int main()
@@ -52,10 +408,168 @@ int main()
     assert(output.size() == samples);
     assert(output[0] != 0.0f); // impulse should survive through mix
 
+    // A neutral preset compiles to an empty plan with an identity mix, so the
+    // block is copied through unchanged, in place or not.
+    std::vector<float> ramp(samples);
+    for (size_t i = 0; i < samples; ++i)
+    {
+        ramp[i] = static_cast<float>(i) / static_cast<float>(samples) - 0.5f;
+    }
+    process_status = ech_dsp_process_block(ramp.data(), output.data(), frames);
+    assert(process_status == ECH_DSP_STATUS_OK);
+    assert(output == ramp);
+    std::vector<float> in_place = ramp;
+    process_status = ech_dsp_process_block(in_place.data(), in_place.data(), frames);
+    assert(process_status == ECH_DSP_STATUS_OK);
+    assert(in_place == ramp);
+
+    CheckEngineAliasing(sample_rate, channels, frames);
+    CheckEngineReset(sample_rate, channels, frames);
+
+    // engine.order is honoured by the compiled plan.
+    const float gate_first_energy =
+        ToneEnergyAfterSettling(kGateFirstPreset, sample_rate, channels, frames);
+    const float eq_first_energy =
+        ToneEnergyAfterSettling(kEqFirstPreset, sample_rate, channels, frames);
+    assert(eq_first_energy > 1.0e-3f);
+    assert(gate_first_energy < 1.0e-3f * eq_first_energy);
+    preset_status = ech_dsp_update_config(kPassThroughPreset, std::strlen(kPassThroughPreset));
+    assert(preset_status == ECH_DSP_STATUS_OK);
+    process_status = ech_dsp_process_block(ramp.data(), output.data(), frames);
+    assert(process_status == ECH_DSP_STATUS_OK);
+
     // Invalid preset should be rejected.
     auto invalid_status = ech_dsp_update_config(kInvalidPreset, std::strlen(kInvalidPreset));
     assert(invalid_status == ECH_DSP_STATUS_INVALID_ARGUMENT);
 
+    uint32_t latency_blocks = 1;
+    size_t latency_frames = 1;
+    assert(ech_dsp_get_latency(&latency_blocks, &latency_frames) == ECH_DSP_STATUS_OK);
+    assert(latency_blocks == 0 && latency_frames == 0);
+
+    // A preset update on a running engine is published to a standby chain and
+    // crossfaded over exactly one block.
+    const float attenuation = std::pow(10.0f, -6.0f / 20.0f);
+    std::vector<float> constant(samples, 0.5f);
+    preset_status = ech_dsp_update_config(kAttenuatedPreset, std::strlen(kAttenuatedPreset));
+    assert(preset_status == ECH_DSP_STATUS_OK);
+    process_status = ech_dsp_process_block(constant.data(), output.data(), frames);
+    assert(process_status == ECH_DSP_STATUS_OK);
+    for (size_t frame = 1; frame < frames; ++frame)
+    {
+        assert(output[frame * channels] <= output[(frame - 1) * channels]);
+        assert(output[frame * channels] >= 0.5f * attenuation - 1.0e-6f);
+    }
+    assert(output[0] > 0.5f * attenuation);
+    assert(std::fabs(output[samples - 1] - 0.5f * attenuation) < 1.0e-6f);
+    process_status = ech_dsp_process_block(constant.data(), output.data(), frames);
+    assert(process_status == ECH_DSP_STATUS_OK);
+    for (float sample : output)
+    {
+        assert(std::fabs(sample - 0.5f * attenuation) < 1.0e-6f);
+    }
+
+    // Callbacks keep succeeding while another thread pushes presets.
+    std::atomic<bool> updating{true};
+    std::thread updater([&updating]()
+                        {
+        for (int i = 0; i < 200; ++i)
+        {
+            const char *json = (i % 2 == 0) ? kPassThroughPreset : kAttenuatedPreset;
+            assert(ech_dsp_update_config(json, std::strlen(json)) == ECH_DSP_STATUS_OK);
+        }
+        updating.store(false); });
+    size_t concurrent_blocks = 0;
+    while (updating.load() || concurrent_blocks < 64)
+    {
+        process_status = ech_dsp_process_block(constant.data(), output.data(), frames);
+        assert(process_status == ECH_DSP_STATUS_OK);
+        for (float sample : output)
+        {
+            assert(sample >= 0.5f * attenuation - 1.0e-6f && sample <= 0.5f + 1.0e-6f);
+        }
+        ++concurrent_blocks;
+    }
+    updater.join();
+
+    // A preset that only changes the mix bus keeps the live reverb instance,
+    // so its tail carries on past the swap instead of being reset.
+    preset_status = ech_dsp_update_config(kReverbPreset, std::strlen(kReverbPreset));
+    assert(preset_status == ECH_DSP_STATUS_OK);
+    std::vector<float> silence(samples, 0.0f);
+    for (int block = 0; block < 2; ++block)
+    {
+        process_status = ech_dsp_process_block(silence.data(), output.data(), frames);
+        assert(process_status == ECH_DSP_STATUS_OK);
+    }
+    process_status = ech_dsp_process_block(input.data(), output.data(), frames);
+    assert(process_status == ECH_DSP_STATUS_OK);
+    preset_status = ech_dsp_update_config(kReverbLouderPreset, std::strlen(kReverbLouderPreset));
+    assert(preset_status == ECH_DSP_STATUS_OK);
+    // The first comb echo arrives ~30 ms after the impulse, well after the
+    // crossfade block.
+    float tail_energy = 0.0f;
+    for (int block = 0; block < 8; ++block)
+    {
+        process_status = ech_dsp_process_block(silence.data(), output.data(), frames);
+        assert(process_status == ECH_DSP_STATUS_OK);
+        for (float sample : output)
+        {
+            tail_energy += block > 0 ? sample * sample : 0.0f;
+        }
+    }
+    assert(tail_energy > 0.0f);
+
+    // Tweaking a stage ahead of the reverb keeps the reverb instance too; it
+    // runs once on the crossfaded gate output, so its tail carries on.
+    preset_status = ech_dsp_update_config(kGatedReverbPreset, std::strlen(kGatedReverbPreset));
+    assert(preset_status == ECH_DSP_STATUS_OK);
+    for (int block = 0; block < 4; ++block)
+    {
+        process_status = ech_dsp_process_block(silence.data(), output.data(), frames);
+        assert(process_status == ECH_DSP_STATUS_OK);
+    }
+    process_status = ech_dsp_process_block(constant.data(), output.data(), frames);
+    assert(process_status == ECH_DSP_STATUS_OK);
+    preset_status =
+        ech_dsp_update_config(kGatedReverbTweakedPreset, std::strlen(kGatedReverbTweakedPreset));
+    assert(preset_status == ECH_DSP_STATUS_OK);
+    tail_energy = 0.0f;
+    for (int block = 0; block < 8; ++block)
+    {
+        process_status = ech_dsp_process_block(silence.data(), output.data(), frames);
+        assert(process_status == ECH_DSP_STATUS_OK);
+        for (float sample : output)
+        {
+            tail_energy += block > 0 ? sample * sample : 0.0f;
+        }
+    }
+    assert(tail_energy > 0.0f);
+
+    // Fade back to passthrough; the hybrid preset below only differs from it
+    // in engine settings, so switching to it swaps no module.
+    preset_status = ech_dsp_update_config(kPassThroughPreset, std::strlen(kPassThroughPreset));
+    assert(preset_status == ECH_DSP_STATUS_OK);
+    process_status = ech_dsp_process_block(silence.data(), output.data(), frames);
+    assert(process_status == ECH_DSP_STATUS_OK);
+
+    // The C API reports the pipeline delay of a hybrid preset.
+    preset_status =
+        ech_dsp_update_config(kHybridPassThroughPreset, std::strlen(kHybridPassThroughPreset));
+    assert(preset_status == ECH_DSP_STATUS_OK);
+    assert(ech_dsp_prepare_realtime(frames) == ECH_DSP_STATUS_OK);
+    process_status = ech_dsp_process_block(ramp.data(), output.data(), frames);
+    assert(process_status == ECH_DSP_STATUS_OK);
+    assert(ech_dsp_get_latency(&latency_blocks, &latency_frames) == ECH_DSP_STATUS_OK);
+    assert(latency_blocks >= 1);
+    assert(latency_frames == static_cast<size_t>(latency_blocks) * frames);
+    assert(ech_dsp_get_latency(nullptr, nullptr) == ECH_DSP_STATUS_INVALID_ARGUMENT);
+
+    CheckHybridPipeline(sample_rate, channels, frames, false);
+    // The preallocated block pool keeps hybrid processing pipelined instead
+    // of falling back to synchronous.
+    CheckHybridPipeline(sample_rate, channels, frames, true);
+
     ech_dsp_shutdown();
     return 0;
 }
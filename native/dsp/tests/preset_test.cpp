@@ -1,5 +1,6 @@
 #include "config/preset_loader.h"
 
+#include <array>
 #include <cassert>
 #include <string>
 #include <vector>
@@ -57,6 +58,88 @@ int main()
     auto flood_result = echidna::dsp::config::LoadPresetFromJson(too_many_modules);
     assert(!flood_result.ok);
 
+    // engine.order moves the listed stages to the front; the rest keep their
+    // default relative order.
+    using echidna::dsp::config::EffectStage;
+    assert(result.preset.stage_order == echidna::dsp::config::kDefaultStageOrder);
+    const std::string reordered = R"({
+        "name": "Reordered",
+        "engine": {"latencyMode": "LL", "blockMs": 15, "order": ["reverb", "eq"]},
+        "modules": [{"id": "mix", "wet": 100.0, "outGain": 0.0}]
+    })";
+    auto reordered_result = echidna::dsp::config::LoadPresetFromJson(reordered);
+    assert(reordered_result.ok);
+    const std::array<EffectStage, echidna::dsp::config::kEffectStageCount> expected_order{
+        EffectStage::kReverb,
+        EffectStage::kEq,
+        EffectStage::kGate,
+        EffectStage::kCompressor,
+        EffectStage::kPitch,
+        EffectStage::kFormant,
+        EffectStage::kAutoTune};
+    assert(reordered_result.preset.stage_order == expected_order);
+
+    // Compressor detection is stereo-linked unless the preset opts out.
+    assert(result.preset.compressor.params.stereo_link);
+    const std::string unlinked = R"({
+        "name": "Unlinked",
+        "engine": {"latencyMode": "LL", "blockMs": 15},
+        "modules": [
+            {"id": "comp", "enabled": true, "threshold": -30.0, "ratio": 4.0, "stereoLink": false},
+            {"id": "mix", "wet": 100.0, "outGain": 0.0}
+        ]
+    })";
+    auto unlinked_result = echidna::dsp::config::LoadPresetFromJson(unlinked);
+    assert(unlinked_result.ok);
+    assert(!unlinked_result.preset.compressor.params.stereo_link);
+
+    // Pitch quality accepts LL, Balanced and HQ.
+    const std::string balanced = R"({
+        "name": "Balanced pitch",
+        "engine": {"latencyMode": "Balanced", "blockMs": 20},
+        "modules": [
+            {"id": "pitch", "enabled": true, "semitones": 3.0, "quality": "Balanced"},
+            {"id": "mix", "wet": 100.0, "outGain": 0.0}
+        ]
+    })";
+    auto balanced_result = echidna::dsp::config::LoadPresetFromJson(balanced);
+    assert(balanced_result.ok);
+    assert(balanced_result.preset.pitch.params.quality == echidna::dsp::effects::PitchQuality::kBalanced);
+
+    // Unknown, duplicate or non-string stage ids are rejected.
+    for (const char *order : {R"(["eq", "eq"])", R"(["mix"])", R"(["delay"])", R"([1])", R"("eq")"})
+    {
+        const std::string bad_order =
+            std::string(R"({"name":"BadOrder","engine":{"latencyMode":"LL","blockMs":15,"order":)") +
+            order + R"(},"modules":[]})";
+        auto bad_order_result = echidna::dsp::config::LoadPresetFromJson(bad_order);
+        assert(!bad_order_result.ok);
+    }
+
+    // Convolution reverb names its impulse response; the mode defaults to algorithmic.
+    const std::string convolution = R"({
+        "name": "Hall",
+        "engine": {"latencyMode": "LL", "blockMs": 15},
+        "modules": [
+            {"id": "reverb", "enabled": true, "mode": "convolution", "ir": "hall", "mix": 20},
+            {"id": "mix", "wet": 100.0, "outGain": 0.0}
+        ]
+    })";
+    auto convolution_result = echidna::dsp::config::LoadPresetFromJson(convolution);
+    assert(convolution_result.ok);
+    assert(convolution_result.preset.reverb.mode == echidna::dsp::config::ReverbMode::kConvolution);
+    assert(convolution_result.preset.reverb.impulse_response == "hall");
+    assert(result.preset.reverb.mode == echidna::dsp::config::ReverbMode::kAlgorithmic);
+    for (const char *module : {R"({"id":"reverb","enabled":true,"mode":"convolution"})",
+                               R"({"id":"reverb","enabled":true,"mode":"spring","ir":"hall"})",
+                               R"({"id":"reverb","enabled":true,"mode":"convolution","ir":""})"})
+    {
+        const std::string bad_reverb =
+            std::string(R"({"name":"BadReverb","engine":{"latencyMode":"LL","blockMs":15},"modules":[)") +
+            module + "]}";
+        assert(!echidna::dsp::config::LoadPresetFromJson(bad_reverb).ok);
+    }
+
     // Reject oversized input before parsing it. This bounds parser CPU/memory
     // consumption and covers the size check that used to be duplicated after
     // JsonParser::parse().
@@ -1,5 +1,8 @@
 #include "effect_context.h"
 
+#include "runtime/pcm_codec.h"
+#include "runtime/simd.h"
+
 #include <algorithm>
 #include <bit>
 #include <cerrno>
@@ -622,13 +625,17 @@ namespace echidna::effects::legacy
     void EffectContext::ConvertInput(const audio_buffer_t &input,
                                      size_t samples) noexcept
     {
+        namespace runtime = dsp::runtime;
         if (config_.inputCfg.format == AUDIO_FORMAT_PCM_16_BIT)
         {
-            constexpr float kPcm16Scale = 1.0f / 32768.0f;
-            for (size_t index = 0; index < samples; ++index)
-            {
-                input_float_[index] = static_cast<float>(input.s16[index]) * kPcm16Scale;
-            }
+            runtime::decode_pcm(runtime::PcmEncoding::kSigned16, input.s16, input_float_.data(), samples);
+            return;
+        }
+        // In-range blocks are the common case and copy straight through.
+        const runtime::BlockScan scan = runtime::scan_block(input.f32, samples, nullptr);
+        if (scan.finite && scan.peak <= 1.0f)
+        {
+            std::memcpy(input_float_.data(), input.f32, samples * sizeof(float));
             return;
         }
         for (size_t index = 0; index < samples; ++index)
@@ -652,23 +659,46 @@ namespace echidna::effects::legacy
                                        audio_buffer_t &output,
                                        size_t samples) noexcept
     {
+        namespace runtime = dsp::runtime;
+        const runtime::BlockScan scan = runtime::scan_block(output_float_.data(), samples, nullptr);
+        if (!scan.finite || scan.peak > 1.0f)
+        {
+            for (size_t index = 0; index < samples; ++index)
+            {
+                float value = output_float_[index];
+                if (!std::isfinite(value))
+                {
+                    value = input_float_[index];
+                    Increment(counters_.sanitized_samples);
+                }
+                if (value < -1.0f || value > 1.0f)
+                {
+                    value = std::clamp(value, -1.0f, 1.0f);
+                    Increment(counters_.sanitized_samples);
+                }
+                output_float_[index] = value;
+            }
+        }
+
+        const bool accumulate = config_.outputCfg.accessMode == EFFECT_BUFFER_ACCESS_ACCUMULATE;
+        if (config_.outputCfg.format == AUDIO_FORMAT_PCM_16_BIT && !accumulate)
+        {
+            // Samples the engine left bit-identical keep their original
+            // value; the rest go through the shared int16 encoder.
+            return runtime::reencode_s16(output_float_.data(),
+                                         input_float_.data(),
+                                         input.s16,
+                                         output.s16,
+                                         samples);
+        }
+
         bool mutated = false;
         for (size_t index = 0; index < samples; ++index)
         {
             float value = output_float_[index];
-            if (!std::isfinite(value))
-            {
-                value = input_float_[index];
-                Increment(counters_.sanitized_samples);
-            }
-            if (value < -1.0f || value > 1.0f)
-            {
-                value = std::clamp(value, -1.0f, 1.0f);
-                Increment(counters_.sanitized_samples);
-            }
             if (config_.outputCfg.format == AUDIO_FORMAT_PCM_FLOAT)
             {
-                if (config_.outputCfg.accessMode == EFFECT_BUFFER_ACCESS_ACCUMULATE)
+                if (accumulate)
                 {
                     float existing = output.f32[index];
                     if (!std::isfinite(existing))
@@ -692,25 +722,16 @@ namespace echidna::effects::legacy
 
             const int16_t input_sample = input.s16[index];
             const bool unchanged = !DifferentFloatBits(value, input_float_[index]);
-            const int16_t processed_sample = unchanged
-                                                 ? input_sample
-                                                 : SaturatingPcm16(
-                                                       static_cast<int32_t>(std::lround(value * 32767.0f)));
-            if (config_.outputCfg.accessMode == EFFECT_BUFFER_ACCESS_ACCUMULATE)
-            {
-                const int16_t existing = output.s16[index];
-                const int16_t identity = SaturatingPcm16(
-                    static_cast<int32_t>(existing) + input_sample);
-                const int16_t processed = SaturatingPcm16(
-                    static_cast<int32_t>(existing) + processed_sample);
-                mutated = mutated || processed != identity;
-                output.s16[index] = processed;
-            }
-            else
-            {
-                mutated = mutated || processed_sample != input_sample;
-                output.s16[index] = processed_sample;
-            }
+            const int16_t processed_sample =
+                unchanged ? input_sample
+                          : runtime::PcmTraits<runtime::PcmEncoding::kSigned16>::quantize(value);
+            const int16_t existing = output.s16[index];
+            const int16_t identity = SaturatingPcm16(
+                static_cast<int32_t>(existing) + input_sample);
+            const int16_t processed = SaturatingPcm16(
+                static_cast<int32_t>(existing) + processed_sample);
+            mutated = mutated || processed != identity;
+            output.s16[index] = processed;
         }
         return mutated;
     }
@@ -96,8 +96,10 @@ extern "C"
     /**
      * @brief Processes an interleaved float audio block through the DSP engine.
      *
-     * The stream must first be prepared with echidna_prepare_stream(). If output
-     * is null or aliases input, lifecycle-preallocated scratch is used.
+     * The stream must first be prepared with echidna_prepare_stream(). Each
+     * calling thread is served by its own engine lane, so concurrent capture
+     * streams do not fail each other's blocks. Output may alias input; if it
+     * is null the block is processed into lifecycle-preallocated scratch.
      *
      * @param input Non-null interleaved float samples.
      * @param output Optional output buffer (same length as input).
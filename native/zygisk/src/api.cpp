@@ -8,8 +8,6 @@
 
 #include <algorithm>
 #include <atomic>
-#include <bit>
-#include <cmath>
 #include <cstdlib>
 #include <cstring>
 #include <dlfcn.h>
@@ -23,10 +21,11 @@
 #include <time.h>
 #include <string>
 #include <string_view>
-#include <vector>
 
 #include "echidna/dsp/api.h"
+#include "dsp/legacy_engine_lanes.h"
 #include "dsp/stream_handle_registry.h"
+#include "runtime/simd.h"
 #include "state/shared_state.h"
 #include "utils/telemetry_accumulator.h"
 
@@ -42,12 +41,7 @@ namespace
 
     struct DspBridge
     {
-        using InitFn = ech_dsp_status_t (*)(uint32_t, uint32_t, ech_dsp_quality_mode_t);
         using VersionFn = uint32_t (*)(void);
-        using UpdateFn = ech_dsp_status_t (*)(const char *, size_t);
-        using PrepareFn = ech_dsp_status_t (*)(size_t);
-        using ProcessFn = ech_dsp_status_t (*)(const float *, float *, size_t);
-        using ShutdownFn = void (*)(void);
         using EngineCreateFn = ech_dsp_status_t (*)(uint32_t,
                                                     uint32_t,
                                                     ech_dsp_quality_mode_t,
@@ -60,23 +54,17 @@ namespace
                                                      float *,
                                                      size_t);
         using EngineDestroyFn = void (*)(ech_dsp_engine_t *);
+        using EngineResetFn = ech_dsp_status_t (*)(ech_dsp_engine_t *);
 
         void *handle{nullptr};
         VersionFn version{nullptr};
-        InitFn init{nullptr};
-        UpdateFn update{nullptr};
-        PrepareFn prepare{nullptr};
-        ProcessFn process{nullptr};
-        ShutdownFn shutdown{nullptr};
         EngineCreateFn engine_create{nullptr};
         EngineProcessFn engine_process{nullptr};
         EngineDestroyFn engine_destroy{nullptr};
-        uint32_t sample_rate{0};
-        uint32_t channels{0};
-        ech_dsp_quality_mode_t quality{ECH_DSP_QUALITY_BALANCED};
-        bool initialised{false};
+        // Optional: legacy lanes clear a lane's effects with it when the
+        // lane passes to a new capture thread.
+        EngineResetFn engine_reset{nullptr};
         std::string pending_preset;
-        std::vector<float> scratch_output;
     };
 
     struct WatchdogConfig
@@ -98,6 +86,7 @@ namespace
         return bridge;
     }
 
+    /** Serialises DSP lifecycle work; the audio path never takes it. */
     std::mutex &DspMutex()
     {
         static std::mutex mutex;
@@ -110,6 +99,12 @@ namespace
         return registry;
     }
 
+    echidna::dsp_runtime::LegacyEngineLanes &GetLegacyLanes()
+    {
+        static echidna::dsp_runtime::LegacyEngineLanes lanes;
+        return lanes;
+    }
+
     void LogWarn(const char *format, const char *detail)
     {
 #ifdef __ANDROID__
@@ -167,73 +162,6 @@ namespace
         return state;
     }
 
-    /** Convert DSP status codes to echidna API result codes. */
-    echidna_result_t ToEchidnaResult(ech_dsp_status_t status)
-    {
-        switch (status)
-        {
-        case ECH_DSP_STATUS_OK:
-            return ECHIDNA_RESULT_OK;
-        case ECH_DSP_STATUS_INVALID_ARGUMENT:
-            return ECHIDNA_RESULT_INVALID_ARGUMENT;
-        case ECH_DSP_STATUS_NOT_INITIALISED:
-            return ECHIDNA_RESULT_NOT_INITIALISED;
-        default:
-            return ECHIDNA_RESULT_ERROR;
-        }
-    }
-
-    /** Convert linear amplitude to decibels-safe lower bound. */
-    float LinearToDb(float value)
-    {
-        if (value <= 0.0f)
-        {
-            return -120.0f;
-        }
-        return 20.0f * std::log10(value);
-    }
-
-    struct LevelStats
-    {
-        float rms_db{-120.0f};
-        float peak_db{-120.0f};
-        bool finite{true};
-        bool changed{false};
-    };
-
-    /** Compute levels while folding finite and mutation checks into the same pass. */
-    LevelStats CalculateLevels(const float *data,
-                               size_t samples,
-                               const float *reference = nullptr)
-    {
-        if (!data || samples == 0)
-        {
-            return {};
-        }
-        LevelStats stats;
-        double sum_squares = 0.0;
-        float peak = 0.0f;
-        for (size_t i = 0; i < samples; ++i)
-        {
-            const float sample = data[i];
-            if (!std::isfinite(sample))
-            {
-                return {-120.0f, -120.0f, false, false};
-            }
-            if (reference &&
-                std::bit_cast<uint32_t>(sample) != std::bit_cast<uint32_t>(reference[i]))
-            {
-                stats.changed = true;
-            }
-            peak = std::max(peak, std::fabs(sample));
-            sum_squares += static_cast<double>(sample) * static_cast<double>(sample);
-        }
-        const float rms = static_cast<float>(std::sqrt(sum_squares / samples));
-        stats.rms_db = LinearToDb(rms);
-        stats.peak_db = LinearToDb(peak);
-        return stats;
-    }
-
     bool ComputeSampleCount(uint32_t frames, uint32_t channels, size_t *out)
     {
         if (frames == 0 || channels == 0 || out == nullptr)
@@ -290,9 +218,7 @@ namespace
     {
         if (dsp.handle)
         {
-            return dsp.version && dsp.init && dsp.update && dsp.prepare && dsp.process &&
-                   dsp.shutdown && dsp.engine_create && dsp.engine_process &&
-                   dsp.engine_destroy;
+            return dsp.version && dsp.engine_create && dsp.engine_process && dsp.engine_destroy;
         }
         const char *candidates[] = {
             "libech_dsp.so",
@@ -329,40 +255,39 @@ namespace
         }
         dsp.version =
             reinterpret_cast<DspBridge::VersionFn>(dlsym(dsp.handle, "ech_dsp_api_get_version"));
-        dsp.init = reinterpret_cast<DspBridge::InitFn>(dlsym(dsp.handle, "ech_dsp_initialize"));
-        dsp.update =
-            reinterpret_cast<DspBridge::UpdateFn>(dlsym(dsp.handle, "ech_dsp_update_config"));
-        dsp.prepare = reinterpret_cast<DspBridge::PrepareFn>(
-            dlsym(dsp.handle, "ech_dsp_prepare_realtime"));
-        dsp.process =
-            reinterpret_cast<DspBridge::ProcessFn>(dlsym(dsp.handle, "ech_dsp_process_block"));
-        dsp.shutdown = reinterpret_cast<DspBridge::ShutdownFn>(dlsym(dsp.handle, "ech_dsp_shutdown"));
         dsp.engine_create = reinterpret_cast<DspBridge::EngineCreateFn>(
             dlsym(dsp.handle, "ech_dsp_engine_create"));
         dsp.engine_process = reinterpret_cast<DspBridge::EngineProcessFn>(
             dlsym(dsp.handle, "ech_dsp_engine_process"));
         dsp.engine_destroy = reinterpret_cast<DspBridge::EngineDestroyFn>(
             dlsym(dsp.handle, "ech_dsp_engine_destroy"));
-        if (!dsp.version || dsp.version() != ECH_DSP_API_VERSION || !dsp.init || !dsp.update ||
-            !dsp.prepare || !dsp.process || !dsp.shutdown || !dsp.engine_create ||
+        dsp.engine_reset = reinterpret_cast<DspBridge::EngineResetFn>(
+            dlsym(dsp.handle, "ech_dsp_engine_reset"));
+        if (!dsp.version || dsp.version() != ECH_DSP_API_VERSION || !dsp.engine_create ||
             !dsp.engine_process || !dsp.engine_destroy)
         {
             dlclose(dsp.handle);
             dsp.handle = nullptr;
             dsp.version = nullptr;
-            dsp.init = nullptr;
-            dsp.update = nullptr;
-            dsp.prepare = nullptr;
-            dsp.process = nullptr;
-            dsp.shutdown = nullptr;
             dsp.engine_create = nullptr;
             dsp.engine_process = nullptr;
             dsp.engine_destroy = nullptr;
+            dsp.engine_reset = nullptr;
             return false;
         }
         return true;
     }
 
+    echidna::dsp_runtime::StreamDspBackend BackendOf(const DspBridge &dsp)
+    {
+        echidna::dsp_runtime::StreamDspBackend backend;
+        backend.create = dsp.engine_create;
+        backend.process = dsp.engine_process;
+        backend.destroy = dsp.engine_destroy;
+        backend.reset = dsp.engine_reset;
+        return backend;
+    }
+
     bool GetStreamBackend(echidna::dsp_runtime::StreamDspBackend *backend)
     {
         if (!backend)
@@ -375,12 +300,11 @@ namespace
         {
             return false;
         }
-        backend->create = dsp.engine_create;
-        backend->process = dsp.engine_process;
-        backend->destroy = dsp.engine_destroy;
+        *backend = BackendOf(dsp);
         return true;
     }
 
+    /** Build the legacy engine lanes for a format, applying any pending preset. */
     echidna_result_t EnsureInitialisedLocked(DspBridge &dsp,
                                              uint32_t sample_rate,
                                              uint32_t channels)
@@ -389,105 +313,29 @@ namespace
         {
             return ECHIDNA_RESULT_NOT_AVAILABLE;
         }
-        if (dsp.initialised && dsp.sample_rate == sample_rate && dsp.channels == channels)
-        {
-            return ECHIDNA_RESULT_OK;
-        }
-        if (dsp.initialised && dsp.shutdown)
-        {
-            try
-            {
-                dsp.shutdown();
-            }
-            catch (...)
-            {
-                dsp.initialised = false;
-                return ECHIDNA_RESULT_ERROR;
-            }
-        }
-        dsp.sample_rate = sample_rate;
-        dsp.channels = channels;
-        ech_dsp_status_t init_status = ECH_DSP_STATUS_ERROR;
-        try
-        {
-            init_status = dsp.init(sample_rate, channels, dsp.quality);
-        }
-        catch (...)
-        {
-            dsp.initialised = false;
-            return ECHIDNA_RESULT_ERROR;
-        }
-        if (init_status != ECH_DSP_STATUS_OK)
-        {
-            dsp.initialised = false;
-            return ToEchidnaResult(init_status);
-        }
-        dsp.initialised = true;
-        if (!dsp.pending_preset.empty())
-        {
-            ech_dsp_status_t update_status = ECH_DSP_STATUS_ERROR;
-            try
-            {
-                update_status =
-                    dsp.update(dsp.pending_preset.data(), dsp.pending_preset.size());
-            }
-            catch (...)
-            {
-                return ECHIDNA_RESULT_ERROR;
-            }
-            if (update_status != ECH_DSP_STATUS_OK)
-            {
-                return ToEchidnaResult(update_status);
-            }
-        }
-        const size_t max_frames = kMaxRealtimeSamples / channels;
-        if (max_frames == 0 || dsp.prepare(max_frames) != ECH_DSP_STATUS_OK)
-        {
-            dsp.initialised = false;
-            return ECHIDNA_RESULT_ERROR;
-        }
-        try
-        {
-            dsp.scratch_output.resize(kMaxRealtimeSamples);
-        }
-        catch (...)
+        const bool has_preset = !dsp.pending_preset.empty();
+        const echidna_result_t result =
+            GetLegacyLanes().prepare(sample_rate,
+                                     channels,
+                                     has_preset ? dsp.pending_preset.data() : nullptr,
+                                     has_preset ? dsp.pending_preset.size() : 0,
+                                     BackendOf(dsp));
+        if (result != ECHIDNA_RESULT_OK)
         {
-            dsp.initialised = false;
-            return ECHIDNA_RESULT_ERROR;
+            return result;
         }
         (void)GetWatchdogConfig();
         return ECHIDNA_RESULT_OK;
     }
 
-    /** Apply a preset into an already loaded DSP bridge (io locked). */
+    /** Publish a preset to the prepared lanes (io locked). */
     echidna_result_t ApplyPresetLocked(DspBridge &dsp, const char *json, size_t length)
     {
         if (!LoadDspLocked(dsp))
         {
             return ECHIDNA_RESULT_NOT_AVAILABLE;
         }
-        if (!dsp.initialised)
-        {
-            try
-            {
-                dsp.pending_preset.assign(json, length);
-            }
-            catch (...)
-            {
-                return ECHIDNA_RESULT_ERROR;
-            }
-            return ECHIDNA_RESULT_OK;
-        }
-        ech_dsp_status_t status = ECH_DSP_STATUS_ERROR;
-        try
-        {
-            status = dsp.update(json, length);
-        }
-        catch (...)
-        {
-            return ECHIDNA_RESULT_ERROR;
-        }
-        return ToEchidnaResult(status);
+        return GetLegacyLanes().update(json, length, BackendOf(dsp));
     }
 
     uint32_t UpdateWatchdog(uint32_t wall_us, uint64_t now_ns, SharedState &state)
@@ -602,19 +450,19 @@ echidna_result_t echidna_process_block(const float *input,
 
     echidna_result_t result = ECHIDNA_RESULT_OK;
     auto telemetry_outcome = echidna::utils::TelemetryBlockOutcome::kUnchanged;
-    LevelStats input_levels = CalculateLevels(input, sample_count);
-    if (!input_levels.finite)
-    {
-        state.setStatus(echidna::state::InternalStatus::kError);
-        state.telemetry().recordBlock(echidna::utils::CurrentTelemetryRoute(),
-                                      frames,
-                                      echidna::utils::TelemetryBlockOutcome::kFailure);
-        return ECHIDNA_RESULT_INVALID_ARGUMENT;
-    }
     const bool bypassed = state.isBypassed(MonotonicNowNs());
+    bool passed_dry = false;
 
     if (bypassed)
     {
+        if (!echidna::dsp::runtime::all_finite(input, sample_count))
+        {
+            state.setStatus(echidna::state::InternalStatus::kError);
+            state.telemetry().recordBlock(echidna::utils::CurrentTelemetryRoute(),
+                                          frames,
+                                          echidna::utils::TelemetryBlockOutcome::kFailure);
+            return ECHIDNA_RESULT_INVALID_ARGUMENT;
+        }
         telemetry_outcome = echidna::utils::TelemetryBlockOutcome::kBypassed;
         if (output && output != input)
         {
@@ -623,86 +471,25 @@ echidna_result_t echidna_process_block(const float *input,
     }
     else
     {
-        std::unique_lock lock(DspMutex(), std::try_to_lock);
-        if (!lock.owns_lock())
+        // Each capture thread runs on its own engine lane, so concurrent
+        // streams no longer collide; a thread that finds every lane held gets
+        // its block back dry. That block is counted as contention and as
+        // unchanged, not as a failure. The lanes reject non-finite input and
+        // output and leave the original block in place.
+        bool mutated = false;
+        bool contended = false;
+        result = GetLegacyLanes().process(
+            input, output, frames, sample_rate, channel_count, &mutated, &contended);
+        if (contended)
         {
-            state.telemetry().recordBlock(echidna::utils::CurrentTelemetryRoute(),
-                                          frames,
-                                          echidna::utils::TelemetryBlockOutcome::kFailure);
-            return ECHIDNA_RESULT_NOT_AVAILABLE;
-        }
-        auto &dsp = GetDspBridge();
-        result = dsp.initialised && dsp.sample_rate == sample_rate &&
-                         dsp.channels == channel_count
-                     ? ECHIDNA_RESULT_OK
-                     : ECHIDNA_RESULT_NOT_INITIALISED;
-        if (result != ECHIDNA_RESULT_OK)
-        {
-            telemetry_outcome = echidna::utils::TelemetryBlockOutcome::kFailure;
-        }
-        else
-        {
-            const size_t samples = sample_count;
-            float *process_output = output;
-            if (!output || output == input)
-            {
-                process_output = dsp.scratch_output.size() >= samples
-                                     ? dsp.scratch_output.data()
-                                     : nullptr;
-            }
-            if (process_output)
-            {
-                ech_dsp_status_t dsp_status = ECH_DSP_STATUS_ERROR;
-                try
-                {
-                    dsp_status = dsp.process(input, process_output, static_cast<size_t>(frames));
-                }
-                catch (...)
-                {
-                    dsp_status = ECH_DSP_STATUS_ERROR;
-                }
-                result = ToEchidnaResult(dsp_status);
-                if (result != ECHIDNA_RESULT_OK)
-                {
-                    telemetry_outcome = echidna::utils::TelemetryBlockOutcome::kFailure;
-                    if (output && output != input)
-                    {
-                        std::memcpy(output, input, sizeof(float) * sample_count);
-                    }
-                }
-                else
-                {
-                    const LevelStats output_levels =
-                        CalculateLevels(process_output, sample_count, input);
-                    if (!output_levels.finite)
-                    {
-                        result = ECHIDNA_RESULT_ERROR;
-                        telemetry_outcome =
-                            echidna::utils::TelemetryBlockOutcome::kFailure;
-                        if (output && output != input)
-                        {
-                            std::memcpy(output, input, sizeof(float) * sample_count);
-                        }
-                    }
-                    else
-                    {
-                        telemetry_outcome = output_levels.changed
-                                                ? echidna::utils::TelemetryBlockOutcome::kMutated
-                                                : echidna::utils::TelemetryBlockOutcome::kUnchanged;
-                    }
-                    if (output_levels.finite && output && process_output != output)
-                    {
-                        std::memcpy(output, process_output, sizeof(float) * sample_count);
-                    }
-                }
-            }
-            else if (output && output != input)
-            {
-                std::memcpy(output, input, sizeof(float) * sample_count);
-                result = ECHIDNA_RESULT_ERROR;
-                telemetry_outcome = echidna::utils::TelemetryBlockOutcome::kFailure;
-            }
+            state.telemetry().recordContention(echidna::utils::CurrentTelemetryRoute());
         }
+        passed_dry = contended && result == ECHIDNA_RESULT_NOT_AVAILABLE;
+        telemetry_outcome = result != ECHIDNA_RESULT_OK && !passed_dry
+                                ? echidna::utils::TelemetryBlockOutcome::kFailure
+                            : mutated
+                                ? echidna::utils::TelemetryBlockOutcome::kMutated
+                                : echidna::utils::TelemetryBlockOutcome::kUnchanged;
     }
 
     clock_gettime(CLOCK_THREAD_CPUTIME_ID, &cpu_end);
@@ -738,7 +525,8 @@ echidna_result_t echidna_process_block(const float *input,
     {
         state.setStatus(echidna::state::InternalStatus::kHooked);
     }
-    else if (state.status() != static_cast<int>(echidna::state::InternalStatus::kDisabled))
+    else if (!passed_dry &&
+             state.status() != static_cast<int>(echidna::state::InternalStatus::kDisabled))
     {
         state.setStatus(echidna::state::InternalStatus::kError);
     }
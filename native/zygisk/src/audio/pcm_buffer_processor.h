@@ -47,6 +47,12 @@ namespace echidna::audio
                              uint32_t channels,
                              BufferLayout *layout);
 
+    /**
+     * Decodes `buffer` into `input_scratch`, runs `process_block` and writes
+     * the result back, leaving `buffer` untouched unless kProcessed is
+     * returned. Aligned float32 buffers are passed to `process_block` as its
+     * output directly; every other layout goes through `output_scratch`.
+     */
     BufferProcessResult ProcessPcmBufferInPlace(void *buffer,
                                                 size_t byte_count,
                                                 PcmFormat format,
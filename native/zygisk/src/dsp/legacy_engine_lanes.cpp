@@ -0,0 +1,299 @@
+#include "dsp/legacy_engine_lanes.h"
+
+#include <chrono>
+#include <cstring>
+
+namespace echidna::dsp_runtime
+{
+    namespace
+    {
+        constexpr size_t kMaxRealtimeSamples = 32768;
+
+        std::atomic<uint64_t> g_next_thread_token{1};
+
+        /** Nonzero and unique to the calling thread. */
+        uint64_t ThreadToken()
+        {
+            thread_local const uint64_t token = g_next_thread_token.fetch_add(1, std::memory_order_relaxed);
+            return token;
+        }
+
+        /** The lane a thread holds; released when the thread exits. */
+        struct LaneBinding
+        {
+            std::weak_ptr<LegacyEngineLanes::LaneOwners> owners;
+            const LegacyEngineLanes::LaneOwners *key{nullptr};
+            size_t lane{LegacyEngineLanes::kLaneCount};
+
+            void release()
+            {
+                if (lane == LegacyEngineLanes::kLaneCount)
+                {
+                    return;
+                }
+                if (const auto held = owners.lock())
+                {
+                    uint64_t token = ThreadToken();
+                    held->owner[lane].compare_exchange_strong(token, 0, std::memory_order_acq_rel);
+                }
+                owners.reset();
+                key = nullptr;
+                lane = LegacyEngineLanes::kLaneCount;
+            }
+
+            ~LaneBinding() { release(); }
+        };
+
+        thread_local LaneBinding t_binding;
+
+        /** last_used_ns of a lane whose owner is inside a block. */
+        constexpr uint64_t kLaneBusy = UINT64_MAX;
+
+        uint64_t MonotonicNowNs()
+        {
+            return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                             std::chrono::steady_clock::now().time_since_epoch())
+                                             .count());
+        }
+    } // namespace
+
+    LegacyEngineLanes::LegacyEngineLanes()
+        : registry_(ECH_DSP_QUALITY_BALANCED),
+          owners_(std::make_shared<LaneOwners>())
+    {
+    }
+
+    LegacyEngineLanes::~LegacyEngineLanes()
+    {
+        reset();
+    }
+
+    uint64_t LegacyEngineLanes::packFormat(uint32_t sample_rate, uint32_t channels)
+    {
+        return (static_cast<uint64_t>(sample_rate) << 32) | channels;
+    }
+
+    bool LegacyEngineLanes::prepared(uint32_t sample_rate, uint32_t channels) const
+    {
+        return format_.load() == packFormat(sample_rate, channels);
+    }
+
+    void LegacyEngineLanes::reset()
+    {
+        // Withdraw the format first so a block that already read a handle
+        // fails its format re-check, then quiesce and destroy each stream.
+        format_.store(0);
+        for (Lane &lane : lanes_)
+        {
+            const echidna_stream_handle_t handle = lane.handle.exchange(0);
+            if (handle != 0)
+            {
+                (void)registry_.destroy(handle);
+            }
+        }
+    }
+
+    echidna_result_t LegacyEngineLanes::prepare(uint32_t sample_rate,
+                                                uint32_t channels,
+                                                const char *profile_json,
+                                                size_t length,
+                                                const StreamDspBackend &backend)
+    {
+        if (channels == 0 || (profile_json == nullptr) != (length == 0))
+        {
+            return ECHIDNA_RESULT_INVALID_ARGUMENT;
+        }
+        if (prepared(sample_rate, channels))
+        {
+            return ECHIDNA_RESULT_OK;
+        }
+        reset();
+
+        echidna_stream_config_t config{};
+        config.struct_size = sizeof(config);
+        config.sample_rate = sample_rate;
+        config.channel_count = channels;
+        config.max_frames = static_cast<uint32_t>(kMaxRealtimeSamples / channels);
+        config.format = ECHIDNA_PCM_FORMAT_FLOAT_32;
+        const uint64_t profile_generation = profile_generation_ + 1;
+        for (Lane &lane : lanes_)
+        {
+            try
+            {
+                lane.scratch.resize(kMaxRealtimeSamples);
+            }
+            catch (...)
+            {
+                reset();
+                return ECHIDNA_RESULT_ERROR;
+            }
+            echidna_stream_handle_t handle = 0;
+            echidna_result_t result = registry_.create(config, backend, &handle);
+            if (result == ECHIDNA_RESULT_OK && profile_json)
+            {
+                result = registry_.update(handle, profile_json, length, profile_generation, backend);
+            }
+            if (result != ECHIDNA_RESULT_OK)
+            {
+                if (handle != 0)
+                {
+                    (void)registry_.destroy(handle);
+                }
+                reset();
+                return result;
+            }
+            lane.handle.store(handle);
+        }
+        profile_generation_ = profile_generation;
+        format_.store(packFormat(sample_rate, channels));
+        return ECHIDNA_RESULT_OK;
+    }
+
+    echidna_result_t LegacyEngineLanes::update(const char *profile_json,
+                                               size_t length,
+                                               const StreamDspBackend &backend)
+    {
+        if (!profile_json || length == 0)
+        {
+            return ECHIDNA_RESULT_INVALID_ARGUMENT;
+        }
+        if (format_.load() == 0)
+        {
+            return ECHIDNA_RESULT_OK;
+        }
+        const uint64_t profile_generation = profile_generation_ + 1;
+        echidna_result_t result = ECHIDNA_RESULT_OK;
+        for (Lane &lane : lanes_)
+        {
+            const echidna_result_t lane_result = registry_.update(
+                lane.handle.load(), profile_json, length, profile_generation, backend);
+            if (lane_result != ECHIDNA_RESULT_OK && result == ECHIDNA_RESULT_OK)
+            {
+                result = lane_result;
+            }
+        }
+        profile_generation_ = profile_generation;
+        return result;
+    }
+
+    size_t LegacyEngineLanes::bindLane(uint64_t now_ns, bool *claimed)
+    {
+        *claimed = false;
+        LaneOwners &owners = *owners_;
+        const uint64_t token = ThreadToken();
+        if (t_binding.key == &owners &&
+            owners.owner[t_binding.lane].load(std::memory_order_acquire) == token)
+        {
+            return t_binding.lane;
+        }
+        // The thread lost its lane to an idle takeover, or is moving from
+        // another instance; drop that binding first.
+        t_binding.release();
+
+        auto bind = [&](size_t lane)
+        {
+            t_binding.owners = owners_;
+            t_binding.key = &owners;
+            t_binding.lane = lane;
+            *claimed = true;
+            return lane;
+        };
+        for (size_t lane = 0; lane < kLaneCount; ++lane)
+        {
+            uint64_t expected = 0;
+            if (owners.owner[lane].compare_exchange_strong(expected, token, std::memory_order_acq_rel))
+            {
+                return bind(lane);
+            }
+        }
+        // Every lane is held. A thread that stopped calling without exiting
+        // gives its lane up once it has been idle long enough; a lane in the
+        // middle of a block reads as kLaneBusy and is never idle.
+        for (size_t lane = 0; lane < kLaneCount; ++lane)
+        {
+            uint64_t holder = owners.owner[lane].load(std::memory_order_acquire);
+            const uint64_t last_used = owners.last_used_ns[lane].load(std::memory_order_relaxed);
+            if (now_ns >= last_used && now_ns - last_used >= kIdleReclaimNs &&
+                owners.owner[lane].compare_exchange_strong(holder, token, std::memory_order_acq_rel))
+            {
+                return bind(lane);
+            }
+        }
+        return kLaneCount;
+    }
+
+    echidna_result_t LegacyEngineLanes::process(const float *input,
+                                                float *output,
+                                                uint32_t frames,
+                                                uint32_t sample_rate,
+                                                uint32_t channels,
+                                                bool *mutated,
+                                                bool *contended)
+    {
+        if (mutated)
+        {
+            *mutated = false;
+        }
+        const bool overlapped = in_flight_.fetch_add(1, std::memory_order_acq_rel) != 0;
+        if (contended)
+        {
+            *contended = overlapped;
+        }
+
+        echidna_result_t result = ECHIDNA_RESULT_NOT_INITIALISED;
+        const uint64_t format = packFormat(sample_rate, channels);
+        if (input && frames != 0 && format_.load() == format)
+        {
+            // With every lane held by a live caller the block is passed
+            // through dry rather than run on another stream's lane.
+            const uint64_t now_ns = MonotonicNowNs();
+            bool claimed = false;
+            const size_t index = bindLane(now_ns, &claimed);
+            Lane *lane = nullptr;
+            if (index == kLaneCount)
+            {
+                // Every lane held is contention even if no block overlaps.
+                result = ECHIDNA_RESULT_NOT_AVAILABLE;
+                if (contended)
+                {
+                    *contended = true;
+                }
+            }
+            else
+            {
+                owners_->last_used_ns[index].store(kLaneBusy, std::memory_order_relaxed);
+                lane = &lanes_[index];
+            }
+            const echidna_stream_handle_t handle = lane ? lane->handle.load() : 0;
+            if (handle != 0 && format_.load() == format)
+            {
+                if (claimed)
+                {
+                    // A new owner starts from clean effect state.
+                    (void)registry_.reset(handle);
+                }
+                result = registry_.process(handle,
+                                           input,
+                                           output ? output : lane->scratch.data(),
+                                           frames,
+                                           ECHIDNA_PCM_FORMAT_FLOAT_32,
+                                           false,
+                                           mutated);
+            }
+            if (lane)
+            {
+                owners_->last_used_ns[index].store(now_ns, std::memory_order_relaxed);
+            }
+        }
+        if (result != ECHIDNA_RESULT_OK && input && output && output != input)
+        {
+            std::memcpy(output,
+                        input,
+                        sizeof(float) * static_cast<size_t>(frames) * static_cast<size_t>(channels));
+        }
+
+        in_flight_.fetch_sub(1, std::memory_order_acq_rel);
+        return result;
+    }
+
+} // namespace echidna::dsp_runtime
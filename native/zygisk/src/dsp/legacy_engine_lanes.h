@@ -0,0 +1,122 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "dsp/stream_handle_registry.h"
+
+namespace echidna::dsp_runtime
+{
+
+    /**
+     * @brief Engines behind the legacy echidna_process_block() entry point.
+     *
+     * That entry point carries no stream handle, so it is served by a small
+     * pool of float32 streams ("lanes") on a private StreamHandleRegistry, all
+     * sharing one format and preset. Each capture thread claims a free lane on
+     * its first block and keeps it, so its effect state stays continuous and
+     * up to kLaneCount concurrent callers each get their own engine. A lane is
+     * released when its thread exits, or taken over once it has been idle for
+     * kIdleReclaimNs, and its engine is reset for the new owner so no stream
+     * hears another's history. Only when every lane is held by a live caller
+     * is a block passed through dry; it never borrows another stream's lane.
+     *
+     * prepare(), update() and reset() are lifecycle operations that may
+     * allocate and must be serialised by the caller. process() takes no lock
+     * and does not allocate.
+     */
+    class LegacyEngineLanes
+    {
+    public:
+        static constexpr size_t kLaneCount = 4;
+        /** A lane whose owner has not processed for this long may be taken over. */
+        static constexpr uint64_t kIdleReclaimNs = 1000000000ull;
+
+        LegacyEngineLanes();
+        ~LegacyEngineLanes();
+
+        LegacyEngineLanes(const LegacyEngineLanes &) = delete;
+        LegacyEngineLanes &operator=(const LegacyEngineLanes &) = delete;
+
+        /**
+         * @brief Rebuilds every lane for a format, applying `profile_json`
+         * when it is non-empty. Lanes already built for the same format are
+         * kept as they are.
+         */
+        echidna_result_t prepare(uint32_t sample_rate,
+                                 uint32_t channels,
+                                 const char *profile_json,
+                                 size_t length,
+                                 const StreamDspBackend &backend);
+
+        /** Publishes a preset to every lane; a no-op before prepare(). */
+        echidna_result_t update(const char *profile_json,
+                                size_t length,
+                                const StreamDspBackend &backend);
+
+        /**
+         * @brief Processes one interleaved float block on the calling
+         * thread's lane.
+         *
+         * Input and output may alias. A null output processes into lane
+         * scratch and discards the result. On any failure, including finding
+         * every lane held by another live caller (NOT_AVAILABLE), a disjoint
+         * output receives the unmodified input. `contended` reports whether
+         * another block was in flight when this one arrived, or every lane
+         * was held.
+         */
+        echidna_result_t process(const float *input,
+                                 float *output,
+                                 uint32_t frames,
+                                 uint32_t sample_rate,
+                                 uint32_t channels,
+                                 bool *mutated = nullptr,
+                                 bool *contended = nullptr);
+
+        /** True once the lanes are built for this format. */
+        bool prepared(uint32_t sample_rate, uint32_t channels) const;
+
+        /** Destroys every lane, quiescing in-flight blocks first. */
+        void reset();
+
+        /**
+         * @brief Which thread holds each lane. Shared so a thread can release
+         * its lane on exit even if it outlives the LegacyEngineLanes.
+         */
+        struct LaneOwners
+        {
+            /** Thread token of each lane's owner; 0 while free. */
+            std::array<std::atomic<uint64_t>, kLaneCount> owner{};
+            /** Monotonic start time of each lane's last finished block. */
+            std::array<std::atomic<uint64_t>, kLaneCount> last_used_ns{};
+        };
+
+    private:
+        static uint64_t packFormat(uint32_t sample_rate, uint32_t channels);
+
+        /**
+         * @brief The calling thread's lane, claiming a free or idle one if it
+         * holds none; kLaneCount when every lane is held by a live caller.
+         * `claimed` is set when the lane was newly claimed.
+         */
+        size_t bindLane(uint64_t now_ns, bool *claimed);
+
+        struct Lane
+        {
+            std::atomic<echidna_stream_handle_t> handle{0};
+            std::vector<float> scratch;
+        };
+
+        StreamHandleRegistry registry_;
+        std::array<Lane, kLaneCount> lanes_{};
+        std::shared_ptr<LaneOwners> owners_;
+        std::atomic<uint64_t> format_{0};
+        std::atomic<uint32_t> in_flight_{0};
+        uint64_t profile_generation_{0};
+    };
+
+} // namespace echidna::dsp_runtime
@@ -1,8 +1,8 @@
 #include "dsp/stream_handle_registry.h"
+#include "runtime/pcm_codec.h"
+#include "runtime/simd.h"
 
 #include <algorithm>
-#include <bit>
-#include <cmath>
 #include <cstring>
 #include <iterator>
 #include <limits>
@@ -18,6 +18,14 @@ namespace echidna::dsp_runtime
         constexpr uint64_t kMaxProfileGeneration =
             static_cast<uint64_t>(std::numeric_limits<int64_t>::max());
 
+        /** True when the two `bytes`-long ranges share any byte. */
+        bool BlocksOverlap(const void *a, const void *b, size_t bytes)
+        {
+            const auto first = reinterpret_cast<uintptr_t>(a);
+            const auto second = reinterpret_cast<uintptr_t>(b);
+            return first < second + bytes && second < first + bytes;
+        }
+
         echidna_result_t ConvertStatus(ech_dsp_status_t status)
         {
             switch (status)
@@ -32,16 +40,6 @@ namespace echidna::dsp_runtime
                 return ECHIDNA_RESULT_ERROR;
             }
         }
-
-        int16_t EncodeSigned16(float sample)
-        {
-            const float clamped = sample < -1.0f ? -1.0f : (sample > 1.0f ? 1.0f : sample);
-            if (clamped <= -1.0f)
-            {
-                return std::numeric_limits<int16_t>::min();
-            }
-            return static_cast<int16_t>(std::lround(clamped * 32767.0f));
-        }
     } // namespace
 
     static_assert(std::atomic<uint32_t>::is_always_lock_free,
@@ -49,6 +47,11 @@ namespace echidna::dsp_runtime
     static_assert(StreamHandleRegistry::kMaxStreams == 64,
                   "stream token layout reserves exactly six slot bits");
 
+    StreamHandleRegistry::StreamHandleRegistry(ech_dsp_quality_mode_t quality)
+        : quality_(quality)
+    {
+    }
+
     StreamHandleRegistry::EngineState::~EngineState()
     {
         if (engine && destroy)
@@ -141,7 +144,7 @@ namespace echidna::dsp_runtime
         const char *profile_json,
         size_t length,
         const StreamDspBackend &backend,
-        echidna_result_t *result)
+        echidna_result_t *result) const
     {
         if (result)
         {
@@ -165,7 +168,7 @@ namespace echidna::dsp_runtime
             state->output_scratch.resize(samples);
             const ech_dsp_status_t status = backend.create(config.sample_rate,
                                                            config.channel_count,
-                                                           ECH_DSP_QUALITY_LOW_LATENCY,
+                                                           quality_,
                                                            config.max_frames,
                                                            profile_json,
                                                            length,
@@ -180,6 +183,7 @@ namespace echidna::dsp_runtime
             }
             state->process = backend.process;
             state->destroy = backend.destroy;
+            state->reset = backend.reset;
             state->sample_rate = config.sample_rate;
             state->channels = config.channel_count;
             state->max_frames = config.max_frames;
@@ -350,78 +354,73 @@ namespace echidna::dsp_runtime
         else
         {
             const size_t samples = static_cast<size_t>(frames) * state->channels;
+            const float *engine_input = state->input_scratch.data();
+            float *engine_output = state->output_scratch.data();
+            bool restore_from_scratch = false;
+            bool accepted = true;
             if (format == ECHIDNA_PCM_FORMAT_SIGNED_16)
             {
-                const auto *source = static_cast<const int16_t *>(input);
-                for (size_t i = 0; i < samples; ++i)
-                {
-                    state->input_scratch[i] = static_cast<float>(source[i]) / 32768.0f;
-                }
+                dsp::runtime::decode_pcm(
+                    dsp::runtime::PcmEncoding::kSigned16, input, state->input_scratch.data(), samples);
             }
             else
             {
-                const auto *source = static_cast<const float *>(input);
-                for (size_t i = 0; i < samples; ++i)
+                // Float blocks are processed straight into `output`. A disjoint
+                // input is only scanned; an in-place block is copied first so
+                // a rejected block can be restored.
+                engine_output = static_cast<float *>(output);
+                if (BlocksOverlap(input, output, samples * sizeof(float)))
                 {
-                    if (!std::isfinite(source[i]))
-                    {
-                        result = ECHIDNA_RESULT_INVALID_ARGUMENT;
-                        break;
-                    }
-                    state->input_scratch[i] = source[i];
+                    accepted = dsp::runtime::decode_pcm(
+                        dsp::runtime::PcmEncoding::kFloat32, input, state->input_scratch.data(), samples);
+                    restore_from_scratch = true;
                 }
+                else
+                {
+                    engine_input = static_cast<const float *>(input);
+                    accepted = dsp::runtime::all_finite(engine_input, samples);
+                }
+            }
+            if (!accepted)
+            {
+                result = ECHIDNA_RESULT_INVALID_ARGUMENT;
             }
 
             if (result == ECHIDNA_RESULT_OK)
             {
-                result = ConvertStatus(state->process(state->engine,
-                                                      state->input_scratch.data(),
-                                                      state->output_scratch.data(),
-                                                      frames));
+                result = ConvertStatus(state->process(state->engine, engine_input, engine_output, frames));
             }
             if (result == ECHIDNA_RESULT_OK)
             {
                 bool changed = false;
                 if (format == ECHIDNA_PCM_FORMAT_SIGNED_16)
                 {
-                    const auto *source = static_cast<const int16_t *>(input);
-                    auto *destination = static_cast<int16_t *>(output);
-                    for (size_t i = 0; i < samples; ++i)
+                    // Samples the engine left bit-identical keep their
+                    // original int16 value instead of a lossy re-encode.
+                    if (!dsp::runtime::all_finite(engine_output, samples))
+                    {
+                        result = ECHIDNA_RESULT_ERROR;
+                    }
+                    else
                     {
-                        const int16_t original = source[i];
-                        const float processed = state->output_scratch[i];
-                        if (!std::isfinite(processed))
-                        {
-                            result = ECHIDNA_RESULT_ERROR;
-                            break;
-                        }
-                        const bool float_changed =
-                            std::bit_cast<uint32_t>(processed) !=
-                            std::bit_cast<uint32_t>(state->input_scratch[i]);
-                        const int16_t encoded =
-                            float_changed ? EncodeSigned16(processed) : original;
-                        changed = changed || encoded != original;
-                        destination[i] = encoded;
+                        changed = dsp::runtime::reencode_s16(engine_output,
+                                                             engine_input,
+                                                             static_cast<const int16_t *>(input),
+                                                             static_cast<int16_t *>(output),
+                                                             samples);
                     }
                 }
                 else
                 {
-                    const auto *source = static_cast<const float *>(input);
-                    auto *destination = static_cast<float *>(output);
-                    for (size_t i = 0; i < samples; ++i)
+                    const dsp::runtime::BlockScan scan =
+                        dsp::runtime::scan_block(engine_output, samples, engine_input);
+                    if (!scan.finite)
                     {
-                        const uint32_t original_bits =
-                            std::bit_cast<uint32_t>(source[i]);
-                        const float processed = state->output_scratch[i];
-                        if (!std::isfinite(processed))
-                        {
-                            result = ECHIDNA_RESULT_ERROR;
-                            break;
-                        }
-                        changed = changed ||
-                                  std::bit_cast<uint32_t>(processed) !=
-                                      original_bits;
-                        destination[i] = processed;
+                        result = ECHIDNA_RESULT_ERROR;
+                    }
+                    else
+                    {
+                        changed = scan.changed;
                     }
                 }
                 if (mutated && result == ECHIDNA_RESULT_OK)
@@ -431,7 +430,14 @@ namespace echidna::dsp_runtime
             }
             if (result != ECHIDNA_RESULT_OK)
             {
-                copyBypass(*state, input, output, frames);
+                if (restore_from_scratch)
+                {
+                    std::memcpy(output, engine_input, samples * sizeof(float));
+                }
+                else
+                {
+                    copyBypass(*state, input, output, frames);
+                }
             }
         }
 
@@ -440,6 +446,41 @@ namespace echidna::dsp_runtime
         return result;
     }
 
+    echidna_result_t StreamHandleRegistry::reset(echidna_stream_handle_t handle)
+    {
+        size_t index = 0;
+        uint32_t generation = 0;
+        if (!decodeHandle(handle, &index, &generation))
+        {
+            return ECHIDNA_RESULT_INVALID_ARGUMENT;
+        }
+        Slot &slot = slots_[index];
+        if (!acquire(slot, generation))
+        {
+            return ECHIDNA_RESULT_NOT_INITIALISED;
+        }
+        // The gate keeps update() from replacing the state underneath us.
+        uint32_t expected = 0;
+        if (!slot.callback_gate.compare_exchange_strong(expected,
+                                                        kCallbackProcessing,
+                                                        std::memory_order_acq_rel,
+                                                        std::memory_order_relaxed))
+        {
+            release(slot);
+            return ECHIDNA_RESULT_NOT_AVAILABLE;
+        }
+
+        echidna_result_t result = ECHIDNA_RESULT_NOT_AVAILABLE;
+        EngineState *state = slot.state;
+        if (slot.generation.load(std::memory_order_acquire) == generation && state && state->reset)
+        {
+            result = ConvertStatus(state->reset(state->engine));
+        }
+        slot.callback_gate.store(0, std::memory_order_release);
+        release(slot);
+        return result;
+    }
+
     echidna_result_t StreamHandleRegistry::update(echidna_stream_handle_t handle,
                                                   const char *profile_json,
                                                   size_t length,
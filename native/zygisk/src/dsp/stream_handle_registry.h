@@ -26,10 +26,13 @@ namespace echidna::dsp_runtime
                                                float *,
                                                size_t);
         using DestroyFn = void (*)(ech_dsp_engine_t *);
+        using ResetFn = ech_dsp_status_t (*)(ech_dsp_engine_t *);
 
         CreateFn create{nullptr};
         ProcessFn process{nullptr};
         DestroyFn destroy{nullptr};
+        /** Optional; without it reset() reports NOT_AVAILABLE. */
+        ResetFn reset{nullptr};
 
         bool complete() const { return create && process && destroy; }
     };
@@ -40,6 +43,10 @@ namespace echidna::dsp_runtime
         static constexpr size_t kMaxStreams = 64;
         static constexpr uint32_t kMaxHandleGeneration = 0x03FFFFFFU;
 
+        /** Engines are built in `quality` mode; capture streams use low latency. */
+        explicit StreamHandleRegistry(
+            ech_dsp_quality_mode_t quality = ECH_DSP_QUALITY_LOW_LATENCY);
+
         echidna_result_t create(const echidna_stream_config_t &config,
                                 const StreamDspBackend &backend,
                                 echidna_stream_handle_t *handle);
@@ -57,6 +64,13 @@ namespace echidna::dsp_runtime
                                 uint64_t profile_generation,
                                 const StreamDspBackend &backend);
         echidna_result_t destroy(echidna_stream_handle_t handle);
+        /**
+         * @brief Clears a stream's effect history, keeping its preset.
+         *
+         * Callback-safe: takes no lock and does not allocate. A stream whose
+         * block is in flight answers NOT_AVAILABLE.
+         */
+        echidna_result_t reset(echidna_stream_handle_t handle);
 
 #if defined(ECHIDNA_STREAM_REGISTRY_TESTING)
         bool setGenerationForTesting(size_t slot, uint32_t generation);
@@ -75,6 +89,7 @@ namespace echidna::dsp_runtime
             ech_dsp_engine_t *engine{nullptr};
             StreamDspBackend::ProcessFn process{nullptr};
             StreamDspBackend::DestroyFn destroy{nullptr};
+            StreamDspBackend::ResetFn reset{nullptr};
             uint32_t sample_rate{0};
             uint32_t channels{0};
             uint32_t max_frames{0};
@@ -113,11 +128,11 @@ namespace echidna::dsp_runtime
                                  size_t *slot,
                                  uint32_t *generation);
         static echidna_stream_handle_t makeHandle(size_t slot, uint32_t generation);
-        static EngineState *buildState(const echidna_stream_config_t &config,
-                                       const char *profile_json,
-                                       size_t length,
-                                       const StreamDspBackend &backend,
-                                       echidna_result_t *result);
+        EngineState *buildState(const echidna_stream_config_t &config,
+                                const char *profile_json,
+                                size_t length,
+                                const StreamDspBackend &backend,
+                                echidna_result_t *result) const;
         bool acquire(Slot &slot, uint32_t generation);
         static void release(Slot &slot);
         static void copyBypass(const EngineState &state,
@@ -127,6 +142,7 @@ namespace echidna::dsp_runtime
         void lockMaintenance();
         void unlockMaintenance();
 
+        ech_dsp_quality_mode_t quality_;
         std::atomic<uint32_t> maintenance_gate_{0};
         std::array<Slot, kMaxStreams> slots_{};
     };
@@ -17,6 +17,8 @@ namespace echidna::hooks
                   "AAudio stream admission requires lock-free 32-bit atomics");
     static_assert(std::atomic<void *>::is_always_lock_free,
                   "AAudio stream lookup requires lock-free pointer atomics");
+    static_assert(AAudioStreamRegistry::kMaxStreams <= StreamSlotIndex::kMaxSlots,
+                  "every AAudio stream slot must fit the slot index");
 
     AAudioStreamRegistry::MaintenanceGuard::MaintenanceGuard(
         AAudioStreamRegistry &registry)
@@ -120,6 +122,18 @@ namespace echidna::hooks
         slot.usage.fetch_sub(1, std::memory_order_acq_rel);
     }
 
+    AAudioStreamRegistry::Slot *AAudioStreamRegistry::acquireIndexed(void *stream)
+    {
+        // The index only names a candidate slot; acquireSlot() re-checks the
+        // slot's own key after taking the in-flight reference.
+        const uint32_t index = index_.find(reinterpret_cast<uintptr_t>(stream));
+        if (index == StreamSlotIndex::kNoSlot || !acquireSlot(slots_[index], stream))
+        {
+            return nullptr;
+        }
+        return &slots_[index];
+    }
+
     void AAudioStreamRegistry::stopAdmission()
     {
         admission_usage_.fetch_and(~kActiveMask, std::memory_order_acq_rel);
@@ -139,15 +153,13 @@ namespace echidna::hooks
             return false;
         }
         MaintenanceGuard guard(*this);
-        for (const Slot &slot : slots_)
+        if (index_.find(reinterpret_cast<uintptr_t>(stream)) != StreamSlotIndex::kNoSlot)
         {
-            if (slot.allocated && slot.stream.load(std::memory_order_acquire) == stream)
-            {
-                return false;
-            }
+            return false;
         }
-        for (Slot &slot : slots_)
+        for (uint32_t index = 0; index < kMaxStreams; ++index)
         {
+            Slot &slot = slots_[index];
             if (slot.allocated || slot.usage.load(std::memory_order_acquire) != 0)
             {
                 continue;
@@ -202,6 +214,7 @@ namespace echidna::hooks
             }
             slot.stream.store(stream, std::memory_order_relaxed);
             slot.usage.store(kActiveMask, std::memory_order_release);
+            (void)index_.insert(reinterpret_cast<uintptr_t>(stream), index);
             return ready;
         }
         return false;
@@ -222,13 +235,9 @@ namespace echidna::hooks
         }
 
         AAudioProcessResult result = AAudioProcessResult::kUnavailable;
-        for (Slot &slot : slots_)
+        if (Slot *indexed = acquireIndexed(stream))
         {
-            if (slot.stream.load(std::memory_order_acquire) != stream ||
-                !acquireSlot(slot, stream))
-            {
-                continue;
-            }
+            Slot &slot = *indexed;
             const uint32_t requested_owner = static_cast<uint32_t>(owner);
             if (slot.owner != requested_owner)
             {
@@ -255,7 +264,6 @@ namespace echidna::hooks
                              : AAudioProcessResult::kProcessorError;
             }
             releaseSlot(slot);
-            break;
         }
         releaseAdmission();
         return result;
@@ -284,13 +292,9 @@ namespace echidna::hooks
         }
         else
         {
-            for (Slot &slot : slots_)
+            if (Slot *indexed = acquireIndexed(stream))
             {
-                if (slot.stream.load(std::memory_order_acquire) != stream ||
-                    !acquireSlot(slot, stream))
-                {
-                    continue;
-                }
+                Slot &slot = *indexed;
                 if (slot.owner != static_cast<uint32_t>(AAudioProcessOwner::kCallback))
                 {
                     result = AAudioProcessResult::kNotOwner;
@@ -353,12 +357,11 @@ namespace echidna::hooks
             return;
         }
         MaintenanceGuard guard(*this);
-        for (Slot &slot : slots_)
+        const uint32_t index = index_.find(reinterpret_cast<uintptr_t>(stream));
+        if (index != StreamSlotIndex::kNoSlot && slots_[index].allocated)
         {
-            if (!slot.allocated || slot.stream.load(std::memory_order_acquire) != stream)
-            {
-                continue;
-            }
+            Slot &slot = slots_[index];
+            index_.erase(reinterpret_cast<uintptr_t>(stream));
             slot.usage.fetch_and(~kActiveMask, std::memory_order_acq_rel);
             slot.stream.store(nullptr, std::memory_order_release);
             while ((slot.usage.load(std::memory_order_acquire) & kInFlightMask) != 0)
@@ -383,7 +386,6 @@ namespace echidna::hooks
             slot.scratch_bytes = 0;
             slot.allocated = false;
             slot.usage.store(0, std::memory_order_release);
-            return;
         }
     }
 
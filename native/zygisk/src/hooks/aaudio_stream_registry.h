@@ -9,6 +9,7 @@
 #include <string_view>
 
 #include "echidna_api.h"
+#include "hooks/stream_slot_index.h"
 
 namespace echidna::hooks
 {
@@ -144,6 +145,7 @@ namespace echidna::hooks
         void releaseAdmission();
         static bool acquireSlot(Slot &slot, void *stream);
         static void releaseSlot(Slot &slot);
+        Slot *acquireIndexed(void *stream);
         void stopAdmission();
         void lockMaintenance();
         void unlockMaintenance();
@@ -151,6 +153,7 @@ namespace echidna::hooks
         std::atomic<uint32_t> maintenance_gate_{0};
         std::atomic<uint32_t> admission_usage_{0};
         std::array<Slot, kMaxStreams> slots_{};
+        StreamSlotIndex index_;
         uint64_t snapshot_generation_{0};
         uint64_t publication_{0};
         bool has_snapshot_{false};
@@ -11,6 +11,8 @@ namespace echidna::hooks
                   "OpenSL stream admission requires lock-free 32-bit atomics");
     static_assert(std::atomic<uintptr_t>::is_always_lock_free,
                   "OpenSL recorder lookup requires lock-free identity atomics");
+    static_assert(OpenSlStreamRegistry::kMaxRecorders <= StreamSlotIndex::kMaxSlots,
+                  "every OpenSL recorder slot must fit the slot index");
 
     OpenSlStreamRegistry::MaintenanceGuard::MaintenanceGuard(
         OpenSlStreamRegistry &registry)
@@ -114,6 +116,18 @@ namespace echidna::hooks
         slot.usage.fetch_sub(1, std::memory_order_acq_rel);
     }
 
+    OpenSlStreamRegistry::Slot *OpenSlStreamRegistry::acquireIndexed(uintptr_t recorder)
+    {
+        // The index only names a candidate slot; acquireSlot() re-checks the
+        // slot's own key after taking the in-flight reference.
+        const uint32_t index = index_.find(recorder);
+        if (index == StreamSlotIndex::kNoSlot || !acquireSlot(slots_[index], recorder))
+        {
+            return nullptr;
+        }
+        return &slots_[index];
+    }
+
     void OpenSlStreamRegistry::stopAdmission()
     {
         admission_usage_.fetch_and(~kActiveMask, std::memory_order_acq_rel);
@@ -132,15 +146,13 @@ namespace echidna::hooks
             return false;
         }
         MaintenanceGuard guard(*this);
-        for (const Slot &slot : slots_)
+        if (index_.find(recorder) != StreamSlotIndex::kNoSlot)
         {
-            if (slot.allocated && slot.recorder.load(std::memory_order_acquire) == recorder)
-            {
-                return false;
-            }
+            return false;
         }
-        for (Slot &slot : slots_)
+        for (uint32_t index = 0; index < kMaxRecorders; ++index)
         {
+            Slot &slot = slots_[index];
             if (slot.allocated || slot.usage.load(std::memory_order_acquire) != 0)
             {
                 continue;
@@ -170,6 +182,7 @@ namespace echidna::hooks
             slot.destroy = api.destroy;
             slot.recorder.store(recorder, std::memory_order_relaxed);
             slot.usage.store(kActiveMask, std::memory_order_release);
+            (void)index_.insert(recorder, index);
             return ready;
         }
         return false;
@@ -189,13 +202,9 @@ namespace echidna::hooks
         }
 
         OpenSlProcessResult result = OpenSlProcessResult::kUnavailable;
-        for (Slot &slot : slots_)
+        if (Slot *indexed = acquireIndexed(recorder))
         {
-            if (slot.recorder.load(std::memory_order_acquire) != recorder ||
-                !acquireSlot(slot, recorder))
-            {
-                continue;
-            }
+            Slot &slot = *indexed;
             if (slot.handle == 0 || !slot.process)
             {
                 result = OpenSlProcessResult::kUnavailable;
@@ -211,7 +220,6 @@ namespace echidna::hooks
                              : OpenSlProcessResult::kProcessorError;
             }
             releaseSlot(slot);
-            break;
         }
         releaseAdmission();
         return result;
@@ -224,13 +232,11 @@ namespace echidna::hooks
             return;
         }
         MaintenanceGuard guard(*this);
-        for (Slot &slot : slots_)
+        const uint32_t index = index_.find(recorder);
+        if (index != StreamSlotIndex::kNoSlot && slots_[index].allocated)
         {
-            if (!slot.allocated ||
-                slot.recorder.load(std::memory_order_acquire) != recorder)
-            {
-                continue;
-            }
+            Slot &slot = slots_[index];
+            index_.erase(recorder);
             slot.usage.fetch_and(~kActiveMask, std::memory_order_acq_rel);
             slot.recorder.store(0, std::memory_order_release);
             while ((slot.usage.load(std::memory_order_acquire) & kInFlightMask) != 0)
@@ -247,7 +253,6 @@ namespace echidna::hooks
             slot.destroy = nullptr;
             slot.allocated = false;
             slot.usage.store(0, std::memory_order_release);
-            return;
         }
     }
 
@@ -8,6 +8,7 @@
 #include <string_view>
 
 #include "echidna_api.h"
+#include "hooks/stream_slot_index.h"
 
 namespace echidna::hooks
 {
@@ -96,6 +97,7 @@ namespace echidna::hooks
         void releaseAdmission();
         static bool acquireSlot(Slot &slot, uintptr_t recorder);
         static void releaseSlot(Slot &slot);
+        Slot *acquireIndexed(uintptr_t recorder);
         void stopAdmission();
         void lockMaintenance();
         void unlockMaintenance();
@@ -103,6 +105,7 @@ namespace echidna::hooks
         std::atomic<uint32_t> maintenance_gate_{0};
         std::atomic<uint32_t> admission_usage_{0};
         std::array<Slot, kMaxRecorders> slots_{};
+        StreamSlotIndex index_;
         uint64_t snapshot_generation_{0};
         uint64_t publication_{0};
         bool has_snapshot_{false};
@@ -0,0 +1,28 @@
+#include "hooks/stream_slot_index.h"
+
+/**
+ * @file stream_slot_index.cpp
+ * @brief Translation-unit anchor and compile-time invariant checks for the
+ * header-only StreamSlotIndex.
+ *
+ * Like FdVerdictCache, the index is header-only so the registries' callback
+ * paths can inline the lookup. This unit gives the header a standalone
+ * compile and pins the invariants its encoding relies on. It defines no
+ * out-of-line symbols, so the module does not link it.
+ */
+
+namespace echidna::hooks
+{
+    namespace
+    {
+        static_assert((StreamSlotIndex::kCapacity & (StreamSlotIndex::kCapacity - 1)) == 0,
+                      "kCapacity must be a power of two for the probe mask");
+        static_assert(StreamSlotIndex::kCapacity >= 2 * StreamSlotIndex::kMaxSlots,
+                      "the load factor must stay at or below one half");
+        static_assert(StreamSlotIndex::kMaxSlots <= 0xFF,
+                      "slot numbers must fit the low byte of the bucket tag");
+        static_assert(std::atomic<uintptr_t>::is_always_lock_free &&
+                          std::atomic<uint32_t>::is_always_lock_free,
+                      "callback lookups must not fall back to a locked atomic");
+    } // namespace
+} // namespace echidna::hooks
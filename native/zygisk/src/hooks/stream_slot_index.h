@@ -0,0 +1,283 @@
+#pragma once
+
+/**
+ * @file stream_slot_index.h
+ * @brief Lock-free stream-pointer -> registry-slot index for the capture
+ * callback hot path.
+ *
+ * The AAudio, OpenSL ES and tinyalsa stream registries each hold up to 64
+ * slots. Before this index, every capture callback found its slot with a
+ * linear scan that loaded the key of each 64-byte slot in turn — up to 64
+ * cache lines per callback once many streams are open. The index maps the
+ * native stream pointer straight to its slot number, so a callback touches
+ * one or two index cache lines and then only its own slot.
+ *
+ * ## Structure
+ * An open-addressed table of kCapacity buckets (twice the slot count, so the
+ * load factor never exceeds 1/2) with linear probing. Each bucket holds the
+ * key and a tag word that packs the slot number in the low byte and a
+ * per-bucket generation in the upper 24 bits. Removed keys leave a tombstone
+ * so probe chains stay intact. A tombstone run that reaches an empty bucket
+ * is cleared back to empty, so the table does not silt up under open/close
+ * churn.
+ *
+ * ## Concurrency
+ * find() is lock-free, does not allocate, and may run on any number of
+ * callback threads. insert(), erase() and clear() must be serialised by the
+ * caller; the registries already do that with their maintenance gate.
+ *
+ * Every change to a bucket bumps its generation. A writer that reuses a
+ * bucket first retires the old key, then publishes the new tag, then the new
+ * key. A reader loads the tag, the key, and the tag again; it only trusts
+ * the pair when both tags match, so it never pairs a key with a slot number
+ * written for a different key.
+ *
+ * The index is a hint, not the ownership record. A caller must still claim
+ * the slot through its registry's in-flight counter and re-check the slot's
+ * own key. A lookup that races a close therefore fails that check instead of
+ * processing a retired slot.
+ */
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace echidna::hooks
+{
+
+    /**
+     * @brief Bounded open-addressed map from a native stream pointer to a
+     * registry slot number.
+     */
+    class StreamSlotIndex
+    {
+    public:
+        /// Largest number of live keys; matches the registries' slot arrays.
+        static constexpr size_t kMaxSlots = 64;
+        /// Bucket count. A power of two and twice kMaxSlots.
+        static constexpr size_t kCapacity = kMaxSlots * 2;
+        /// Returned by find() when the key is not indexed.
+        static constexpr uint32_t kNoSlot = 0xFFFFFFFFU;
+
+        StreamSlotIndex() = default;
+        StreamSlotIndex(const StreamSlotIndex &) = delete;
+        StreamSlotIndex &operator=(const StreamSlotIndex &) = delete;
+
+        /**
+         * @brief Returns the slot indexed for `key`, or kNoSlot.
+         *
+         * Lock-free and allocation-free. A bucket that a writer keeps
+         * changing is skipped after a few re-reads, so a lookup racing the
+         * insert or erase of its own key may miss it; callers treat that as
+         * "stream not ready".
+         */
+        uint32_t find(uintptr_t key) const noexcept
+        {
+            if (!indexable(key))
+            {
+                return kNoSlot;
+            }
+            size_t position = home(key);
+            for (size_t probe = 0; probe < kCapacity; ++probe)
+            {
+                const Bucket &bucket = buckets_[position];
+                uintptr_t stored = kEmpty;
+                uint32_t tag = 0;
+                // A bucket that keeps changing under the read belongs to a
+                // key being inserted or erased; probe past it like a tombstone.
+                const bool stable = readBucket(bucket, &stored, &tag);
+                if (stable && stored == key)
+                {
+                    return tag & kSlotMask;
+                }
+                if (stable && stored == kEmpty)
+                {
+                    return kNoSlot;
+                }
+                position = (position + 1) & kMask;
+            }
+            return kNoSlot;
+        }
+
+        /**
+         * @brief Indexes `key` at `slot`. Writer side; callers serialise.
+         *
+         * Fails when the key cannot be indexed, is already present, the slot
+         * number is out of range, or the table is full.
+         */
+        bool insert(uintptr_t key, uint32_t slot) noexcept
+        {
+            if (!indexable(key) || slot >= kMaxSlots)
+            {
+                return false;
+            }
+            size_t position = home(key);
+            size_t target = kCapacity;
+            for (size_t probe = 0; probe < kCapacity; ++probe)
+            {
+                const uintptr_t stored = buckets_[position].key.load(std::memory_order_relaxed);
+                if (stored == key)
+                {
+                    return false;
+                }
+                if (stored == kTombstone && target == kCapacity)
+                {
+                    target = position;
+                }
+                if (stored == kEmpty)
+                {
+                    if (target == kCapacity)
+                    {
+                        target = position;
+                    }
+                    break;
+                }
+                position = (position + 1) & kMask;
+            }
+            if (target == kCapacity || live_ >= kMaxSlots)
+            {
+                return false;
+            }
+
+            Bucket &bucket = buckets_[target];
+            if (bucket.key.load(std::memory_order_relaxed) != kEmpty)
+            {
+                // Reusing a tombstone: it already reads as "not this key".
+                bucket.key.store(kTombstone, std::memory_order_relaxed);
+            }
+            bucket.tag.store(nextTag(bucket, slot), std::memory_order_release);
+            bucket.key.store(key, std::memory_order_release);
+            ++live_;
+            return true;
+        }
+
+        /** Removes `key` if it is indexed. Writer side; callers serialise. */
+        void erase(uintptr_t key) noexcept
+        {
+            if (!indexable(key))
+            {
+                return;
+            }
+            size_t position = home(key);
+            for (size_t probe = 0; probe < kCapacity; ++probe)
+            {
+                Bucket &bucket = buckets_[position];
+                const uintptr_t stored = bucket.key.load(std::memory_order_relaxed);
+                if (stored == kEmpty)
+                {
+                    return;
+                }
+                if (stored == key)
+                {
+                    bucket.key.store(kTombstone, std::memory_order_release);
+                    bucket.tag.store(nextTag(bucket, kSlotMask), std::memory_order_release);
+                    --live_;
+                    reclaimTombstones(position);
+                    return;
+                }
+                position = (position + 1) & kMask;
+            }
+        }
+
+        /** Empties the index. Writer side; callers serialise. */
+        void clear() noexcept
+        {
+            for (Bucket &bucket : buckets_)
+            {
+                if (bucket.key.load(std::memory_order_relaxed) != kEmpty)
+                {
+                    bucket.key.store(kTombstone, std::memory_order_release);
+                    bucket.tag.store(nextTag(bucket, kSlotMask), std::memory_order_release);
+                }
+            }
+            for (Bucket &bucket : buckets_)
+            {
+                bucket.key.store(kEmpty, std::memory_order_release);
+            }
+            live_ = 0;
+        }
+
+        /** Number of indexed keys. Writer side. */
+        size_t size() const noexcept
+        {
+            return live_;
+        }
+
+    private:
+        static constexpr uintptr_t kEmpty = 0;
+        // All-ones is never the address of a live stream object.
+        static constexpr uintptr_t kTombstone = ~uintptr_t{0};
+        static constexpr size_t kMask = kCapacity - 1;
+        static constexpr uint32_t kSlotMask = 0xFFU;
+        static constexpr uint32_t kGenerationStep = 0x100U;
+        static constexpr int kReadAttempts = 4;
+
+        struct Bucket
+        {
+            std::atomic<uintptr_t> key{kEmpty};
+            std::atomic<uint32_t> tag{kSlotMask};
+        };
+
+        static bool indexable(uintptr_t key) noexcept
+        {
+            return key != kEmpty && key != kTombstone;
+        }
+
+        static size_t home(uintptr_t key) noexcept
+        {
+            // Stream objects are heap pointers whose low bits are alignment
+            // zeros; a Fibonacci multiply spreads the remaining bits.
+            const uint64_t mixed = static_cast<uint64_t>(key) * 0x9E3779B97F4A7C15ULL;
+            return static_cast<size_t>(mixed >> 32) & kMask;
+        }
+
+        static uint32_t nextTag(const Bucket &bucket, uint32_t slot) noexcept
+        {
+            const uint32_t generation =
+                (bucket.tag.load(std::memory_order_relaxed) & ~kSlotMask) + kGenerationStep;
+            return generation | (slot & kSlotMask);
+        }
+
+        static bool readBucket(const Bucket &bucket, uintptr_t *key, uint32_t *tag) noexcept
+        {
+            for (int attempt = 0; attempt < kReadAttempts; ++attempt)
+            {
+                const uint32_t before = bucket.tag.load(std::memory_order_acquire);
+                const uintptr_t stored = bucket.key.load(std::memory_order_acquire);
+                if (bucket.tag.load(std::memory_order_acquire) == before)
+                {
+                    *key = stored;
+                    *tag = before;
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        void reclaimTombstones(size_t position) noexcept
+        {
+            // A tombstone directly followed by an empty bucket ends every
+            // probe chain through it, so it and the tombstones before it can
+            // become empty without hiding a live key from a reader.
+            if (buckets_[(position + 1) & kMask].key.load(std::memory_order_relaxed) != kEmpty)
+            {
+                return;
+            }
+            for (size_t cleared = 0; cleared < kCapacity; ++cleared)
+            {
+                Bucket &bucket = buckets_[position];
+                if (bucket.key.load(std::memory_order_relaxed) != kTombstone)
+                {
+                    return;
+                }
+                bucket.key.store(kEmpty, std::memory_order_release);
+                position = (position + kCapacity - 1) & kMask;
+            }
+        }
+
+        std::array<Bucket, kCapacity> buckets_{};
+        size_t live_{0};
+    };
+
+} // namespace echidna::hooks
@@ -9,6 +9,8 @@ namespace echidna::hooks
                   "tinyalsa RT admission requires lock-free 32-bit atomics");
     static_assert(std::atomic<void *>::is_always_lock_free,
                   "tinyalsa RT lookup requires lock-free pointer atomics");
+    static_assert(TinyAlsaStreamRegistry::kMaxStreams <= StreamSlotIndex::kMaxSlots,
+                  "every tinyalsa stream slot must fit the slot index");
 
     TinyAlsaStreamRegistry::MaintenanceGuard::MaintenanceGuard(
         TinyAlsaStreamRegistry &registry)
@@ -113,6 +115,29 @@ namespace echidna::hooks
         slot.usage.fetch_sub(1, std::memory_order_acq_rel);
     }
 
+    TinyAlsaStreamRegistry::Slot *TinyAlsaStreamRegistry::acquireIndexed(void *pcm)
+    {
+        // The index only names a candidate slot; acquireSlot() re-checks the
+        // slot's own key after taking the in-flight reference.
+        const uint32_t index = index_.find(reinterpret_cast<uintptr_t>(pcm));
+        if (index == StreamSlotIndex::kNoSlot || !acquireSlot(slots_[index], pcm))
+        {
+            return nullptr;
+        }
+        return &slots_[index];
+    }
+
+    void TinyAlsaStreamRegistry::retireIndexed(void *pcm)
+    {
+        const uint32_t index = index_.find(reinterpret_cast<uintptr_t>(pcm));
+        if (index == StreamSlotIndex::kNoSlot || !slots_[index].allocated)
+        {
+            return;
+        }
+        index_.erase(reinterpret_cast<uintptr_t>(pcm));
+        retireSlot(slots_[index]);
+    }
+
     void TinyAlsaStreamRegistry::retireSlot(Slot &slot)
     {
         slot.usage.fetch_and(~kActiveMask, std::memory_order_acq_rel);
@@ -153,18 +178,13 @@ namespace echidna::hooks
             return false;
         }
         MaintenanceGuard guard(*this);
-        for (Slot &slot : slots_)
-        {
-            if (slot.allocated && slot.pcm.load(std::memory_order_acquire) == pcm)
-            {
-                retireSlot(slot);
-                break;
-            }
-        }
+        retireIndexed(pcm);
 
+        uint32_t index = 0;
         Slot *target = nullptr;
-        for (Slot &slot : slots_)
+        for (; index < kMaxStreams; ++index)
         {
+            Slot &slot = slots_[index];
             if (!slot.allocated && slot.usage.load(std::memory_order_acquire) == 0)
             {
                 target = &slot;
@@ -204,6 +224,7 @@ namespace echidna::hooks
         target->allocated = true;
         target->pcm.store(pcm, std::memory_order_relaxed);
         target->usage.store(kActiveMask, std::memory_order_release);
+        (void)index_.insert(reinterpret_cast<uintptr_t>(pcm), index);
         return true;
     }
 
@@ -227,13 +248,9 @@ namespace echidna::hooks
         {
             return false;
         }
-        for (Slot &slot : slots_)
+        if (Slot *indexed = acquireIndexed(pcm))
         {
-            if (slot.pcm.load(std::memory_order_acquire) != pcm ||
-                !acquireSlot(slot, pcm))
-            {
-                continue;
-            }
+            Slot &slot = *indexed;
             const uint32_t bytes_per_frame = slot.contract.bytes_per_frame;
             const bool valid = bytes_per_frame != 0 &&
                                bytes % bytes_per_frame == 0 &&
@@ -274,26 +291,22 @@ namespace echidna::hooks
         }
 
         TinyAlsaProcessResult result = TinyAlsaProcessResult::kUnavailable;
-        for (Slot &slot : slots_)
+        if (Slot *indexed = acquireIndexed(pcm))
         {
-            if (slot.pcm.load(std::memory_order_acquire) != pcm ||
-                !acquireSlot(slot, pcm))
-            {
-                continue;
-            }
+            Slot &slot = *indexed;
             uint32_t frames = amount;
-            if (amount_is_bytes)
+            const bool whole_frames = !amount_is_bytes ||
+                                      (slot.contract.bytes_per_frame != 0 &&
+                                       amount % slot.contract.bytes_per_frame == 0);
+            if (amount_is_bytes && whole_frames)
             {
-                if (slot.contract.bytes_per_frame == 0 ||
-                    amount % slot.contract.bytes_per_frame != 0)
-                {
-                    result = TinyAlsaProcessResult::kProcessorError;
-                    releaseSlot(slot);
-                    break;
-                }
                 frames = amount / slot.contract.bytes_per_frame;
             }
-            if (slot.handle == 0 || !slot.process)
+            if (!whole_frames)
+            {
+                result = TinyAlsaProcessResult::kProcessorError;
+            }
+            else if (slot.handle == 0 || !slot.process)
             {
                 result = TinyAlsaProcessResult::kUnavailable;
             }
@@ -313,7 +326,6 @@ namespace echidna::hooks
                              : TinyAlsaProcessResult::kProcessorError;
             }
             releaseSlot(slot);
-            break;
         }
         releaseAdmission();
         return result;
@@ -326,14 +338,7 @@ namespace echidna::hooks
             return;
         }
         MaintenanceGuard guard(*this);
-        for (Slot &slot : slots_)
-        {
-            if (slot.allocated && slot.pcm.load(std::memory_order_acquire) == pcm)
-            {
-                retireSlot(slot);
-                return;
-            }
-        }
+        retireIndexed(pcm);
     }
 
     bool TinyAlsaStreamRegistry::publishProfile(
@@ -8,6 +8,7 @@
 #include <string_view>
 
 #include "echidna_api.h"
+#include "hooks/stream_slot_index.h"
 #include "hooks/tinyalsa_contract.h"
 
 namespace echidna::hooks
@@ -104,6 +105,8 @@ namespace echidna::hooks
         static bool acquireSlot(Slot &slot, void *pcm);
         static void releaseSlot(Slot &slot);
         static void retireSlot(Slot &slot);
+        Slot *acquireIndexed(void *pcm);
+        void retireIndexed(void *pcm);
         void stopAdmission();
         void lockMaintenance();
         void unlockMaintenance();
@@ -115,6 +118,7 @@ namespace echidna::hooks
         std::atomic<uint32_t> maintenance_gate_{0};
         std::atomic<uint32_t> admission_usage_{0};
         std::array<Slot, kMaxStreams> slots_{};
+        StreamSlotIndex index_;
         uint64_t snapshot_generation_{0};
         uint64_t publication_{0};
         bool has_snapshot_{false};
@@ -106,6 +106,73 @@ namespace echidna::runtime
             }
             return "installed";
         }
+
+        // v3 and v4 share one frame layout; v4 appends the contention edge
+        // to the v3 deltas.
+        std::string EncodeEvidenceFrame(const utils::TelemetryDelta &delta,
+                                        uint32_t sequence,
+                                        uint64_t sender_monotonic_ms,
+                                        std::string_view process,
+                                        uint64_t generation,
+                                        bool with_contention)
+        {
+            if (!delta.pending() || sequence == 0 || process.empty() || generation == 0 ||
+                sender_monotonic_ms > static_cast<uint64_t>(std::numeric_limits<int64_t>::max()) ||
+                generation > static_cast<uint64_t>(std::numeric_limits<int64_t>::max()))
+            {
+                return {};
+            }
+
+            // v3 is a strict superset of the v2 frame: every v2 field is emitted in
+            // the same order, then the additional evidence fields are appended so
+            // they ride INSIDE the same authenticated envelope (peer-credential
+            // socket + strict exact-key-set validation + replay/generation checks)
+            // as the v2 fields. The new deltas carry the drainable edges the
+            // accumulator already tracks (bypasses/installEvents/installFailures);
+            // the latched route-presence level is a root boolean (installed). No v2
+            // field is removed or reordered. v4 only appends `contended`.
+            std::string payload;
+            payload.reserve(640);
+            payload.append(with_contention ? R"({"schemaVersion":4)" : R"({"schemaVersion":3)");
+            payload.append(R"(,"type":"telemetry","sequence":)");
+            payload.append(std::to_string(sequence));
+            payload.append(R"(,"senderMonotonicMs":)");
+            payload.append(std::to_string(sender_monotonic_ms));
+            payload.append(R"(,"process":)");
+            AppendJsonString(&payload, process);
+            payload.append(R"(,"route":")");
+            payload.append(utils::TelemetryRouteName(delta.route));
+            payload.append(R"(","generation":)");
+            payload.append(std::to_string(generation));
+            payload.append(R"(,"state":")");
+            payload.append(StateFor(delta));
+            payload.append(R"(","deltas":{"blocks":)");
+            payload.append(std::to_string(delta.blocks));
+            payload.append(R"(,"frames":)");
+            payload.append(std::to_string(delta.frames));
+            payload.append(R"(,"failures":)");
+            payload.append(std::to_string(delta.failures));
+            payload.append(R"(,"mutations":)");
+            payload.append(std::to_string(delta.mutations));
+            payload.append(R"(,"bypasses":)");
+            payload.append(std::to_string(delta.bypasses));
+            payload.append(R"(,"installEvents":)");
+            payload.append(std::to_string(delta.install_events));
+            payload.append(R"(,"installFailures":)");
+            payload.append(std::to_string(delta.install_failures));
+            if (with_contention)
+            {
+                payload.append(R"(,"contended":)");
+                payload.append(std::to_string(delta.contended));
+            }
+            payload.append(R"(},"installed":)");
+            payload.append(delta.installed ? "true}" : "false}");
+            if (payload.size() > kTelemetryV2MaxFrameBytes)
+            {
+                return {};
+            }
+            return payload;
+        }
     } // namespace
 
     bool RebindTelemetryPendingEpoch(uint64_t evidence_epoch,
@@ -175,55 +242,16 @@ namespace echidna::runtime
                                   std::string_view process,
                                   uint64_t generation)
     {
-        if (!delta.pending() || sequence == 0 || process.empty() || generation == 0 ||
-            sender_monotonic_ms > static_cast<uint64_t>(std::numeric_limits<int64_t>::max()) ||
-            generation > static_cast<uint64_t>(std::numeric_limits<int64_t>::max()))
-        {
-            return {};
-        }
+        return EncodeEvidenceFrame(delta, sequence, sender_monotonic_ms, process, generation, false);
+    }
 
-        // v3 is a strict superset of the v2 frame: every v2 field is emitted in the
-        // same order, then the additional evidence fields are appended so they ride
-        // INSIDE the same authenticated envelope (peer-credential socket + strict
-        // exact-key-set validation + replay/generation checks) as the v2 fields.
-        // The new deltas carry the drainable edges the accumulator already tracks
-        // (bypasses/installEvents/installFailures); the latched route-presence level
-        // is a root boolean (installed). No v2 field is removed or reordered.
-        std::string payload;
-        payload.reserve(640);
-        payload.append(R"({"schemaVersion":3,"type":"telemetry","sequence":)");
-        payload.append(std::to_string(sequence));
-        payload.append(R"(,"senderMonotonicMs":)");
-        payload.append(std::to_string(sender_monotonic_ms));
-        payload.append(R"(,"process":)");
-        AppendJsonString(&payload, process);
-        payload.append(R"(,"route":")");
-        payload.append(utils::TelemetryRouteName(delta.route));
-        payload.append(R"(","generation":)");
-        payload.append(std::to_string(generation));
-        payload.append(R"(,"state":")");
-        payload.append(StateFor(delta));
-        payload.append(R"(","deltas":{"blocks":)");
-        payload.append(std::to_string(delta.blocks));
-        payload.append(R"(,"frames":)");
-        payload.append(std::to_string(delta.frames));
-        payload.append(R"(,"failures":)");
-        payload.append(std::to_string(delta.failures));
-        payload.append(R"(,"mutations":)");
-        payload.append(std::to_string(delta.mutations));
-        payload.append(R"(,"bypasses":)");
-        payload.append(std::to_string(delta.bypasses));
-        payload.append(R"(,"installEvents":)");
-        payload.append(std::to_string(delta.install_events));
-        payload.append(R"(,"installFailures":)");
-        payload.append(std::to_string(delta.install_failures));
-        payload.append(R"(},"installed":)");
-        payload.append(delta.installed ? "true}" : "false}");
-        if (payload.size() > kTelemetryV2MaxFrameBytes)
-        {
-            return {};
-        }
-        return payload;
+    std::string EncodeTelemetryV4(const utils::TelemetryDelta &delta,
+                                  uint32_t sequence,
+                                  uint64_t sender_monotonic_ms,
+                                  std::string_view process,
+                                  uint64_t generation)
+    {
+        return EncodeEvidenceFrame(delta, sequence, sender_monotonic_ms, process, generation, true);
     }
 
     std::string EncodeCaptureOwnerAckV1(std::string_view process,
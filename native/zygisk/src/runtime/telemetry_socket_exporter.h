@@ -48,6 +48,17 @@ namespace echidna::runtime
                                                 std::string_view process,
                                                 uint64_t generation);
 
+    /**
+     * Encodes the schema-v4 telemetry frame: the v3 frame plus the `contended`
+     * delta, which counts blocks that entered echidna_process_block while
+     * another block was in flight there.
+     */
+    [[nodiscard]] std::string EncodeTelemetryV4(const utils::TelemetryDelta &delta,
+                                                uint32_t sequence,
+                                                uint64_t sender_monotonic_ms,
+                                                std::string_view process,
+                                                uint64_t generation);
+
     /** Encodes the process-bound acknowledgement used by capture-owner handoffs. */
     [[nodiscard]] std::string EncodeCaptureOwnerAckV1(std::string_view process,
                                                       uint64_t generation,
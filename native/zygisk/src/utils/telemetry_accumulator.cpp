@@ -24,6 +24,7 @@ namespace echidna::utils
         bypasses += other.bypasses;
         install_events += other.install_events;
         install_failures += other.install_failures;
+        contended += other.contended;
         installed = other.installed;
     }
 
@@ -36,6 +37,7 @@ namespace echidna::utils
         bypasses = 0;
         install_events = 0;
         install_failures = 0;
+        contended = 0;
     }
 
     void TelemetryAccumulator::recordBlock(TelemetryRoute route,
@@ -75,6 +77,11 @@ namespace echidna::utils
         }
     }
 
+    void TelemetryAccumulator::recordContention(TelemetryRoute route) noexcept
+    {
+        counters_[RouteIndex(route)].contended.fetch_add(1, std::memory_order_relaxed);
+    }
+
     TelemetryDelta TelemetryAccumulator::take(TelemetryRoute route) noexcept
     {
         const TelemetryRoute normalized =
@@ -89,6 +96,7 @@ namespace echidna::utils
         delta.bypasses = counters.bypasses.exchange(0, std::memory_order_acq_rel);
         delta.install_events = counters.install_events.exchange(0, std::memory_order_acq_rel);
         delta.install_failures = counters.install_failures.exchange(0, std::memory_order_acq_rel);
+        delta.contended = counters.contended.exchange(0, std::memory_order_acq_rel);
         delta.installed = counters.installed.load(std::memory_order_relaxed) != 0;
         return delta;
     }
@@ -47,12 +47,18 @@ namespace echidna::utils
         // consumer can tell "the route never attached" from "a block failed to
         // process". This is an edge (drained by take()), like install_events.
         uint32_t install_failures{0};
+        // Blocks that entered echidna_process_block while another block was
+        // still in flight there. Under the old single global DSP lock each of
+        // these was dropped; they now run on their own thread's engine lane.
+        // An edge, exported by the v4 wire frame only.
+        uint32_t contended{0};
         bool installed{false};
 
         [[nodiscard]] bool pending() const noexcept
         {
             return blocks != 0 || frames != 0 || failures != 0 || mutations != 0 ||
-                   bypasses != 0 || install_events != 0 || install_failures != 0;
+                   bypasses != 0 || install_events != 0 || install_failures != 0 ||
+                   contended != 0;
         }
 
         void merge(const TelemetryDelta &other) noexcept;
@@ -68,6 +74,7 @@ namespace echidna::utils
                          uint32_t frames,
                          TelemetryBlockOutcome outcome) noexcept;
         void recordInstall(TelemetryRoute route, bool success) noexcept;
+        void recordContention(TelemetryRoute route) noexcept;
         [[nodiscard]] TelemetryDelta take(TelemetryRoute route) noexcept;
 
     private:
@@ -80,6 +87,7 @@ namespace echidna::utils
             std::atomic<uint32_t> bypasses{0};
             std::atomic<uint32_t> install_events{0};
             std::atomic<uint32_t> install_failures{0};
+            std::atomic<uint32_t> contended{0};
             std::atomic<uint32_t> installed{0};
         };
 
@@ -521,6 +521,41 @@ namespace
         CHECK(all_processed, "RT path remains available under churn");
         CHECK(gAllocationCount.load(std::memory_order_relaxed) == before,
               "AAudio lookup/process path allocates no memory");
+
+        // Close every other stream so the slot index carries tombstones, then
+        // prove each survivor and each reopened stream still resolves.
+        for (size_t i = 0; i < echidna::hooks::AAudioStreamRegistry::kMaxStreams; i += 2)
+        {
+            registry.close(reinterpret_cast<void *>(uintptr_t{i + 1}));
+        }
+        bool routed = true;
+        for (size_t i = 0; i < echidna::hooks::AAudioStreamRegistry::kMaxStreams; ++i)
+        {
+            const auto expected = i % 2 == 0 ? echidna::hooks::AAudioProcessResult::kUnavailable
+                                             : echidna::hooks::AAudioProcessResult::kProcessed;
+            routed = routed && registry.process(reinterpret_cast<void *>(uintptr_t{i + 1}),
+                                                echidna::hooks::AAudioProcessOwner::kRead,
+                                                &sample,
+                                                1) == expected;
+        }
+        CHECK(routed, "closed streams miss while their neighbours keep processing");
+        for (size_t i = 0; i < echidna::hooks::AAudioStreamRegistry::kMaxStreams; i += 2)
+        {
+            CHECK(registry.open(reinterpret_cast<void *>(uintptr_t{i + 1}),
+                                Config(48000, 1, ECHIDNA_PCM_FORMAT_FLOAT_32),
+                                echidna::hooks::AAudioProcessOwner::kRead,
+                                api),
+                  "a closed stream reopens into its freed slot");
+        }
+        routed = true;
+        for (size_t i = 0; i < echidna::hooks::AAudioStreamRegistry::kMaxStreams; ++i)
+        {
+            routed = routed && registry.process(reinterpret_cast<void *>(uintptr_t{i + 1}),
+                                                echidna::hooks::AAudioProcessOwner::kRead,
+                                                &sample,
+                                                1) == echidna::hooks::AAudioProcessResult::kProcessed;
+        }
+        CHECK(routed, "every reopened stream resolves through the slot index");
         for (size_t i = 0; i < echidna::hooks::AAudioStreamRegistry::kMaxStreams; ++i)
         {
             registry.close(reinterpret_cast<void *>(uintptr_t{i + 1}));
@@ -102,6 +102,18 @@ namespace
         return ECHIDNA_RESULT_OK;
     }
 
+    const float *g_last_output = nullptr;
+
+    echidna_result_t RecordOutput(const float *input,
+                                  float *output,
+                                  uint32_t frames,
+                                  uint32_t sample_rate,
+                                  uint32_t channels)
+    {
+        g_last_output = output;
+        return HalfGain(input, output, frames, sample_rate, channels);
+    }
+
     std::vector<int16_t> MakeInt16Tone(double freq, size_t frames, double amp)
     {
         std::vector<int16_t> pcm(frames);
@@ -343,6 +355,25 @@ namespace
               "non-finite DSP output must be rejected");
         CHECK(pcm == original, "non-finite DSP output must not partially commit");
 
+        // Float32 is processed in the caller's buffer, so a rejected block
+        // must be restored rather than merely left unwritten.
+        std::vector<float> samples{7.0f, -0.5f, 0.25f, 0.0f, -0.125f, 0.5f, 9.0f};
+        const auto original_samples = samples;
+        CHECK(!ProcessWithScratch(samples,
+                                  sizeof(float),
+                                  5 * sizeof(float),
+                                  echidna::audio::PcmFormat::kFloat32,
+                                  PartialThenFail),
+              "float DSP failure must be reported");
+        CHECK(samples == original_samples, "float DSP failure must restore the whole region");
+        CHECK(!ProcessWithScratch(samples,
+                                  sizeof(float),
+                                  5 * sizeof(float),
+                                  echidna::audio::PcmFormat::kFloat32,
+                                  ProduceNan),
+              "non-finite float DSP output must be rejected");
+        CHECK(samples == original_samples, "non-finite float DSP output must be rolled back");
+
         std::vector<float> small_input(2);
         std::vector<float> small_output(2);
         const auto result = echidna::audio::ProcessPcmBufferInPlace(
@@ -360,6 +391,31 @@ namespace
         CHECK(pcm == original, "scratch failure must preserve input");
     }
 
+    void TestFloatProcessesCallerBuffer()
+    {
+        std::vector<float> samples{0.5f, -0.5f, 0.25f, -0.25f};
+        CHECK(ProcessWithScratch(samples,
+                                 0,
+                                 samples.size() * sizeof(float),
+                                 echidna::audio::PcmFormat::kFloat32,
+                                 RecordOutput),
+              "aligned float PCM must process");
+        CHECK(g_last_output == samples.data(), "aligned float PCM must be processed in the caller's buffer");
+        CHECK(samples[0] == 0.25f && samples[3] == -0.125f, "in-place float output must be committed");
+
+        // A misaligned byte buffer cannot be handed out as float storage.
+        std::vector<uint8_t> bytes(4 * sizeof(float) + 1);
+        const float values[4] = {0.5f, -0.5f, 0.25f, -0.25f};
+        std::memcpy(bytes.data() + 1, values, sizeof(values));
+        CHECK(ProcessWithScratch(bytes, 1, sizeof(values), echidna::audio::PcmFormat::kFloat32, RecordOutput),
+              "misaligned float PCM must process");
+        CHECK(reinterpret_cast<const uint8_t *>(g_last_output) != bytes.data() + 1,
+              "misaligned float PCM must be processed through scratch");
+        float committed[4] = {};
+        std::memcpy(committed, bytes.data() + 1, sizeof(committed));
+        CHECK(committed[0] == 0.25f && committed[3] == -0.125f, "misaligned float output must be committed");
+    }
+
     void TestFrameAlignmentFailsClosed()
     {
         std::vector<int16_t> pcm{100, 200, 300};
@@ -544,6 +600,7 @@ int main()
     TestAndroidEncodingContract();
     TestFormatMatrixAndSentinelBounds();
     TestFailuresNeverCommitPartialOutput();
+    TestFloatProcessesCallerBuffer();
     TestFrameAlignmentFailsClosed();
     TestRouterRealtimePathAllocatesNothing();
     TestScratchExhaustionFailsClosedUnchanged();
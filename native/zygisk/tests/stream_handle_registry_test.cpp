@@ -1,3 +1,4 @@
+#include "dsp/legacy_engine_lanes.h"
 #include "dsp/stream_handle_registry.h"
 
 #include <algorithm>
@@ -679,6 +680,222 @@ namespace
         Check(exhausted.destroy(next) == ECHIDNA_RESULT_OK, "destroy post-exhaustion slot");
     }
 
+    std::atomic<bool> g_fake_held{false};
+
+    // Holds only the first block to arrive until released; later blocks pass.
+    ech_dsp_status_t FakeProcessHoldFirst(ech_dsp_engine_t *engine,
+                                          const float *input,
+                                          float *output,
+                                          size_t frames)
+    {
+        auto *fake = reinterpret_cast<FakeEngine *>(engine);
+        if (!g_fake_held.exchange(true))
+        {
+            g_fake_entered = true;
+            while (!g_fake_release.load(std::memory_order_acquire))
+            {
+                std::this_thread::yield();
+            }
+        }
+        std::memcpy(output, input, frames * fake->channels * sizeof(float));
+        return ECH_DSP_STATUS_OK;
+    }
+
+    std::atomic<uint32_t> g_fake_resets{0};
+
+    ech_dsp_status_t FakeReset(ech_dsp_engine_t *)
+    {
+        g_fake_resets.fetch_add(1, std::memory_order_acq_rel);
+        return ECH_DSP_STATUS_OK;
+    }
+
+    // The legacy entry point used to fail a block whenever another thread held
+    // the one global engine. Each caller now claims a free lane and gives it
+    // back when it exits, so up to kLaneCount live callers never collide, no
+    // matter how many threads came before them. Only a caller that finds every
+    // lane held gets its block back dry, and a new owner never inherits the
+    // effect state of the thread that held its lane before.
+    void TestLegacyLanesServeConcurrentCallers()
+    {
+        using echidna::dsp_runtime::LegacyEngineLanes;
+        std::array<float, 16> samples{};
+        samples.fill(0.5f);
+        {
+            LegacyEngineLanes lanes;
+            Check(lanes.prepare(48000,
+                                1,
+                                nullptr,
+                                0,
+                                {FakeCreate, FakeProcessHoldFirst, FakeDestroy, FakeReset}) == ECHIDNA_RESULT_OK,
+                  "lanes prepare");
+            Check(g_fake_quality.load(std::memory_order_acquire) == ECH_DSP_QUALITY_BALANCED,
+                  "legacy lanes keep the balanced quality of the old global engine");
+            g_fake_held = false;
+            g_fake_entered = false;
+            g_fake_release = false;
+            std::array<float, 16> blocked_output{};
+            std::atomic<echidna_result_t> blocked_result{ECHIDNA_RESULT_ERROR};
+            std::thread blocked([&]
+                                { blocked_result = lanes.process(samples.data(), blocked_output.data(), 16, 48000, 1); });
+            while (!g_fake_entered.load(std::memory_order_acquire))
+            {
+                std::this_thread::yield();
+            }
+
+            // Short-lived threads, as AAudio creates one per stream, hand
+            // their lane back on exit; each new one is reset exactly once.
+            for (size_t i = 0; i < 4 * LegacyEngineLanes::kLaneCount; ++i)
+            {
+                const uint32_t resets = g_fake_resets.load(std::memory_order_acquire);
+                std::array<float, 16> output{};
+                echidna_result_t first = ECHIDNA_RESULT_ERROR;
+                echidna_result_t second = ECHIDNA_RESULT_ERROR;
+                std::thread caller([&]
+                                   {
+                    first = lanes.process(samples.data(), output.data(), 16, 48000, 1);
+                    second = lanes.process(samples.data(), output.data(), 16, 48000, 1); });
+                caller.join();
+                Check(first == ECHIDNA_RESULT_OK && second == ECHIDNA_RESULT_OK && output == samples,
+                      "a new thread always finds a lane its predecessors gave back");
+                Check(g_fake_resets.load(std::memory_order_acquire) == resets + 1,
+                      "a lane is reset once for each new owner");
+            }
+
+            // With the held lane, kLaneCount callers are live at once.
+            std::atomic<bool> leave{false};
+            std::atomic<size_t> ready{0};
+            std::atomic<size_t> served{0};
+            std::vector<std::thread> live;
+            auto hold_lane = [&]
+            {
+                std::array<float, 16> output{};
+                if (lanes.process(samples.data(), output.data(), 16, 48000, 1) == ECHIDNA_RESULT_OK)
+                {
+                    served.fetch_add(1, std::memory_order_acq_rel);
+                }
+                ready.fetch_add(1, std::memory_order_acq_rel);
+                while (!leave.load(std::memory_order_acquire))
+                {
+                    std::this_thread::yield();
+                }
+            };
+            for (size_t i = 1; i < LegacyEngineLanes::kLaneCount; ++i)
+            {
+                live.emplace_back(hold_lane);
+            }
+            while (ready.load(std::memory_order_acquire) < LegacyEngineLanes::kLaneCount - 1)
+            {
+                std::this_thread::yield();
+            }
+            Check(served.load(std::memory_order_acquire) == LegacyEngineLanes::kLaneCount - 1,
+                  "kLaneCount live callers never collide");
+
+            auto extra_caller = [&](echidna_result_t expected, const char *message)
+            {
+                std::array<float, 16> output{};
+                output.fill(9.0f);
+                echidna_result_t result = ECHIDNA_RESULT_ERROR;
+                bool contended = false;
+                std::chrono::steady_clock::duration elapsed{};
+                std::thread caller([&]
+                                   {
+                    const auto start = std::chrono::steady_clock::now();
+                    result = lanes.process(samples.data(), output.data(), 16, 48000, 1, nullptr, &contended);
+                    elapsed = std::chrono::steady_clock::now() - start; });
+                caller.join();
+                Check(elapsed < std::chrono::milliseconds(100), "a caller never waits for a busy lane");
+                Check(contended, "an overlapping block is reported as contended");
+                Check(result == expected && output == samples, message);
+            };
+            extra_caller(ECHIDNA_RESULT_NOT_AVAILABLE,
+                         "a caller that finds every lane held gets its block back dry");
+
+            // A lane whose owner stopped calling without exiting is taken over.
+            const uint32_t resets = g_fake_resets.load(std::memory_order_acquire);
+            std::this_thread::sleep_for(std::chrono::nanoseconds(LegacyEngineLanes::kIdleReclaimNs) +
+                                        std::chrono::milliseconds(100));
+            extra_caller(ECHIDNA_RESULT_OK, "an idle lane is taken over by a new caller");
+            Check(g_fake_resets.load(std::memory_order_acquire) == resets + 1,
+                  "a taken-over lane is reset for its new owner");
+
+            leave = true;
+            for (std::thread &thread : live)
+            {
+                thread.join();
+            }
+            g_fake_release = true;
+            blocked.join();
+            Check(blocked_result == ECHIDNA_RESULT_OK && blocked_output == samples,
+                  "the blocked lane completes");
+            bool contended = true;
+            std::array<float, 16> output{};
+            Check(lanes.process(samples.data(), output.data(), 16, 48000, 1, nullptr, &contended) ==
+                          ECHIDNA_RESULT_OK &&
+                      !contended,
+                  "a lone block is not contended");
+        }
+
+        LegacyEngineLanes lanes;
+        const auto backend = RealBackend();
+        std::vector<float> input(256);
+        for (size_t i = 0; i < input.size(); ++i)
+        {
+            input[i] = 0.25f * std::sin(0.05f * static_cast<float>(i));
+        }
+        std::vector<float> processed(input.size(), 9.0f);
+        Check(lanes.process(input.data(), processed.data(), 128, 48000, 2) ==
+                      ECHIDNA_RESULT_NOT_INITIALISED &&
+                  processed == input,
+              "unprepared lanes pass the block through");
+        Check(lanes.update(kGainPreset, std::strlen(kGainPreset), backend) == ECHIDNA_RESULT_OK &&
+                  !lanes.prepared(48000, 2),
+              "a preset before prepare is left to the caller");
+        Check(lanes.prepare(48000, 2, kGainPreset, std::strlen(kGainPreset), backend) ==
+                  ECHIDNA_RESULT_OK,
+              "lanes prepare with a preset");
+        Check(lanes.prepared(48000, 2) && !lanes.prepared(44100, 2), "lanes track their format");
+
+        bool mutated = false;
+        Check(lanes.process(input.data(), processed.data(), 128, 48000, 2, &mutated) ==
+                      ECHIDNA_RESULT_OK &&
+                  mutated && processed != input,
+              "prepared lanes apply the preset");
+        std::vector<float> in_place = input;
+        Check(lanes.process(in_place.data(), in_place.data(), 128, 48000, 2) == ECHIDNA_RESULT_OK &&
+                  in_place != input,
+              "lanes process in place");
+        Check(lanes.process(input.data(), nullptr, 128, 48000, 2) == ECHIDNA_RESULT_OK,
+              "a null output is processed into lane scratch");
+        std::fill(processed.begin(), processed.end(), 9.0f);
+        Check(lanes.process(input.data(), processed.data(), 128, 44100, 2) ==
+                      ECHIDNA_RESULT_NOT_INITIALISED &&
+                  processed == input,
+              "a format mismatch passes the block through");
+
+        g_allocations = 0;
+        g_count_allocations = true;
+        for (size_t i = 0; i < 50; ++i)
+        {
+            Check(lanes.process(input.data(), processed.data(), 128, 48000, 2) == ECHIDNA_RESULT_OK,
+                  "lane allocation process");
+        }
+        g_count_allocations = false;
+        Check(g_allocations == 0, "lane processing allocates no memory");
+
+        Check(lanes.update(kPassThroughPreset, std::strlen(kPassThroughPreset), backend) ==
+                  ECHIDNA_RESULT_OK,
+              "lanes publish a new preset");
+        Check(lanes.process(input.data(), processed.data(), 128, 48000, 2, &mutated) ==
+                      ECHIDNA_RESULT_OK &&
+                  !mutated && processed == input,
+              "every lane runs the updated preset");
+        Check(lanes.prepare(44100, 1, nullptr, 0, backend) == ECHIDNA_RESULT_OK &&
+                  lanes.prepared(44100, 1) && !lanes.prepared(48000, 2),
+              "a new format rebuilds the lanes");
+        Check(lanes.process(input.data(), processed.data(), 128, 44100, 1) == ECHIDNA_RESULT_OK,
+              "rebuilt lanes process the new format");
+    }
+
     // ---- §10 DSP correctness / quality --------------------------------------
 
     // Non-finite INPUT on the float path must be rejected and the ORIGINAL input
@@ -844,6 +1061,20 @@ namespace
         Check(!mutated && !bypassed &&
                   std::memcmp(output.data(), input.data(), sizeof(input)) == 0,
               "engine failure restores original input");
+
+        // In place the engine writes the caller's buffer directly, so the
+        // original must come back from the registry's copy.
+        std::array<float, 16> in_place = input;
+        Check(registry.process(handle,
+                               in_place.data(),
+                               in_place.data(),
+                               8,
+                               ECHIDNA_PCM_FORMAT_FLOAT_32,
+                               false,
+                               &mutated,
+                               &bypassed) == ECHIDNA_RESULT_ERROR,
+              "in-place engine failure yields ERROR");
+        Check(!mutated && !bypassed && in_place == input, "in-place engine failure restores original input");
         Check(registry.destroy(handle) == ECHIDNA_RESULT_OK, "failure-preserve destroy");
     }
 
@@ -1226,6 +1457,7 @@ int main()
     TestExactInPlaceAndOutOfPlaceMutationTruth();
     TestExhaustionAndDestroyRace();
     TestNoCallbackAllocationsAndGenerationExhaustion();
+    TestLegacyLanesServeConcurrentCallers();
     TestNonFiniteInputRejectedFloat();
     TestNonFiniteOutputPreservesOriginal();
     TestProcessingFailurePreservesOriginal();
@@ -0,0 +1,241 @@
+#include "hooks/stream_slot_index.h"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <map>
+#include <thread>
+#include <vector>
+
+// Host harness for the stream-pointer -> slot index shared by the AAudio,
+// OpenSL ES and tinyalsa registries. It proves the properties the callback
+// paths rely on: an indexed key always resolves to its own slot, removed keys
+// miss, tombstones neither hide live keys nor exhaust the table under
+// open/close churn, and a reader racing the writer never gets a slot number
+// that belongs to a different key. Mirrors fd_verdict_cache_test.cpp.
+
+namespace
+{
+    using echidna::hooks::StreamSlotIndex;
+
+    int gFailures = 0;
+    void Check(bool condition, const char *expression, int line, const char *message)
+    {
+        if (!condition)
+        {
+            std::fprintf(stderr, "FAIL: %s [line %d] %s\n", expression, line, message);
+            ++gFailures;
+        }
+    }
+
+#define CHECK(condition, message) Check((condition), #condition, __LINE__, (message))
+
+    // Stream objects are heap allocations, so fake keys look like 64-byte
+    // aligned heap addresses rather than small integers.
+    uintptr_t StreamKey(uint32_t id)
+    {
+        return static_cast<uintptr_t>(0x7A000000U) + static_cast<uintptr_t>(id) * 64U;
+    }
+
+    uint32_t Next(uint32_t &rng)
+    {
+        rng ^= rng << 13;
+        rng ^= rng >> 17;
+        rng ^= rng << 5;
+        return rng;
+    }
+
+    void TestInsertFindErase()
+    {
+        StreamSlotIndex index;
+        CHECK(index.find(StreamKey(1)) == StreamSlotIndex::kNoSlot,
+              "an empty index misses");
+        CHECK(index.insert(StreamKey(1), 5), "a new key is indexed");
+        CHECK(index.find(StreamKey(1)) == 5, "an indexed key resolves to its slot");
+        CHECK(!index.insert(StreamKey(1), 6), "a duplicate key is rejected");
+        CHECK(index.find(StreamKey(1)) == 5, "a rejected duplicate keeps the original slot");
+        CHECK(index.find(StreamKey(2)) == StreamSlotIndex::kNoSlot,
+              "an unknown key misses");
+
+        index.erase(StreamKey(1));
+        CHECK(index.find(StreamKey(1)) == StreamSlotIndex::kNoSlot, "an erased key misses");
+        CHECK(index.size() == 0, "erase drops the live count");
+        index.erase(StreamKey(1));
+        CHECK(index.size() == 0, "erasing a missing key is a no-op");
+
+        CHECK(!index.insert(0, 1), "a null stream is never indexed");
+        CHECK(!index.insert(~uintptr_t{0}, 1), "the tombstone encoding is never indexed");
+        CHECK(index.insert(1, 2), "small opaque handles are indexed like pointers");
+        CHECK(index.find(1) == 2, "a small opaque handle resolves to its slot");
+        CHECK(!index.insert(StreamKey(3), StreamSlotIndex::kMaxSlots),
+              "an out-of-range slot is rejected");
+        CHECK(index.find(0) == StreamSlotIndex::kNoSlot, "a null stream misses");
+    }
+
+    void TestFullTableAndClear()
+    {
+        StreamSlotIndex index;
+        for (uint32_t slot = 0; slot < StreamSlotIndex::kMaxSlots; ++slot)
+        {
+            CHECK(index.insert(StreamKey(slot + 100), slot), "every registry slot fits");
+        }
+        CHECK(!index.insert(StreamKey(999), 0), "the index holds no more than kMaxSlots keys");
+        bool all_found = true;
+        for (uint32_t slot = 0; slot < StreamSlotIndex::kMaxSlots; ++slot)
+        {
+            all_found = all_found && index.find(StreamKey(slot + 100)) == slot;
+        }
+        CHECK(all_found, "a full index still resolves every key");
+
+        index.clear();
+        CHECK(index.size() == 0, "clear drops every key");
+        CHECK(index.find(StreamKey(100)) == StreamSlotIndex::kNoSlot, "a cleared key misses");
+        CHECK(index.insert(StreamKey(100), 3), "a cleared index accepts keys again");
+        CHECK(index.find(StreamKey(100)) == 3, "a re-inserted key resolves to its new slot");
+    }
+
+    void TestChurnMatchesReferenceMap()
+    {
+        // Random open/close churn against a reference map. Keys outlive many
+        // tombstone cycles, so this also proves tombstones never hide a live
+        // key and are reclaimed well enough that the table never fills up.
+        StreamSlotIndex index;
+        std::map<uintptr_t, uint32_t> reference;
+        std::array<bool, StreamSlotIndex::kMaxSlots> slot_used{};
+        uint32_t rng = 0x12345678U;
+        bool consistent = true;
+        for (int step = 0; step < 200000; ++step)
+        {
+            const uintptr_t key = StreamKey(Next(rng) % 512U);
+            const auto existing = reference.find(key);
+            if (existing != reference.end())
+            {
+                index.erase(key);
+                slot_used[existing->second] = false;
+                reference.erase(existing);
+            }
+            else if (reference.size() < StreamSlotIndex::kMaxSlots)
+            {
+                uint32_t slot = 0;
+                while (slot_used[slot])
+                {
+                    ++slot;
+                }
+                consistent = consistent && index.insert(key, slot);
+                slot_used[slot] = true;
+                reference.emplace(key, slot);
+            }
+            if (step % 997 == 0)
+            {
+                for (uint32_t id = 0; id < 512U; ++id)
+                {
+                    const auto expected = reference.find(StreamKey(id));
+                    const uint32_t found = index.find(StreamKey(id));
+                    consistent = consistent &&
+                                 found == (expected == reference.end()
+                                               ? StreamSlotIndex::kNoSlot
+                                               : expected->second);
+                }
+            }
+        }
+        CHECK(consistent, "the index agrees with a reference map under open/close churn");
+        CHECK(index.size() == reference.size(), "the live count tracks the reference map");
+    }
+
+    void TestConcurrentReadersNeverSeeForeignSlots()
+    {
+        // One writer (the registries' maintenance gate serialises writers)
+        // churns half the keys while readers look everything up. A stable key
+        // must always resolve; a churned key may miss but must never resolve
+        // to a slot written for another key.
+        constexpr uint32_t kStable = 16;
+        constexpr uint32_t kChurned = 48;
+        const auto slot_of = [](uint32_t id)
+        { return id % StreamSlotIndex::kMaxSlots; };
+
+        StreamSlotIndex index;
+        for (uint32_t id = 0; id < kStable; ++id)
+        {
+            CHECK(index.insert(StreamKey(id), slot_of(id)), "stable keys are indexed");
+        }
+
+        std::atomic<bool> stop{false};
+        std::atomic<uint64_t> reads{0};
+        std::atomic<uint64_t> stable_misses{0};
+        std::atomic<uint64_t> foreign{0};
+
+        std::thread writer([&]()
+                           {
+            uint32_t rng = 0xC0FFEEU;
+            std::array<bool, kChurned> present{};
+            while (!stop.load(std::memory_order_acquire))
+            {
+                const uint32_t pick = Next(rng) % kChurned;
+                const uint32_t id = kStable + pick;
+                if (present[pick])
+                {
+                    index.erase(StreamKey(id));
+                }
+                else
+                {
+                    (void)index.insert(StreamKey(id), slot_of(id));
+                }
+                present[pick] = !present[pick];
+            } });
+
+        std::vector<std::thread> readers;
+        for (int t = 0; t < 4; ++t)
+        {
+            readers.emplace_back([&]()
+                                 {
+                while (!stop.load(std::memory_order_acquire))
+                {
+                    for (uint32_t id = 0; id < kStable + kChurned; ++id)
+                    {
+                        const uint32_t found = index.find(StreamKey(id));
+                        reads.fetch_add(1, std::memory_order_relaxed);
+                        if (id < kStable && found != slot_of(id))
+                        {
+                            stable_misses.fetch_add(1, std::memory_order_relaxed);
+                        }
+                        if (found != StreamSlotIndex::kNoSlot && found != slot_of(id))
+                        {
+                            foreign.fetch_add(1, std::memory_order_relaxed);
+                        }
+                    }
+                } });
+        }
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(150));
+        stop.store(true, std::memory_order_release);
+        writer.join();
+        for (auto &reader : readers)
+        {
+            reader.join();
+        }
+
+        CHECK(reads.load(std::memory_order_relaxed) > 0, "the concurrency test actually ran");
+        CHECK(stable_misses.load(std::memory_order_relaxed) == 0,
+              "churn on other keys never hides a stable key");
+        CHECK(foreign.load(std::memory_order_relaxed) == 0,
+              "a lookup never returns a slot that belongs to a different key");
+    }
+} // namespace
+
+int main()
+{
+    TestInsertFindErase();
+    TestFullTableAndClear();
+    TestChurnMatchesReferenceMap();
+    TestConcurrentReadersNeverSeeForeignSlots();
+    if (gFailures != 0)
+    {
+        std::fprintf(stderr, "stream_slot_index_test: %d failure(s)\n", gFailures);
+        return 1;
+    }
+    std::fprintf(stderr, "stream_slot_index_test: all checks passed\n");
+    return 0;
+}
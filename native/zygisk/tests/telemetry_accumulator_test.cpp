@@ -84,6 +84,18 @@ int main()
     Check(install_fail.mutations == 1,
           "install failures must not disturb block-outcome counters");
 
+    // Contention is its own edge: it neither counts as a block nor as a
+    // failure, and drains with the rest of the delta.
+    accumulator.recordBlock(TelemetryRoute::kApi, 8, TelemetryBlockOutcome::kMutated);
+    accumulator.recordContention(TelemetryRoute::kApi);
+    accumulator.recordContention(TelemetryRoute::kApi);
+    const TelemetryDelta contention = accumulator.take(TelemetryRoute::kApi);
+    Check(contention.contended == 2 && contention.blocks == 1 && contention.failures == 0,
+          "contended blocks must be counted separately from block outcomes");
+    accumulator.recordContention(TelemetryRoute::kApi);
+    Check(accumulator.take(TelemetryRoute::kApi).pending(),
+          "a contention edge alone must leave the delta pending");
+
     {
         ScopedTelemetryRoute outer(TelemetryRoute::kTinyAlsa);
         Check(CurrentTelemetryRoute() == TelemetryRoute::kTinyAlsa,
@@ -108,11 +120,13 @@ int main()
     newer.blocks = 2;
     newer.mutations = 1;
     newer.install_failures = 4;
+    newer.contended = 5;
     pending.merge(newer);
     Check(pending.blocks == 1 && pending.mutations == 1,
           "coalesced unsent deltas must use documented modulo arithmetic");
     Check(pending.install_failures == 7,
           "merge must sum the install-failure edge across coalesced deltas");
+    Check(pending.contended == 5, "merge must sum the contention edge");
 
     if (g_failures != 0)
     {
@@ -227,6 +227,33 @@ int main()
     Check(runtime::EncodeTelemetryV3({}, 11, 1236, "com.example", 42).empty(),
           "an empty (non-pending) v3 delta must fail closed like v2");
 
+    // --- Schema v4: lane contention ----------------------------------------------
+    // v4 adds the `contended` delta after installFailures. A delta whose only
+    // evidence is contention is pending and must encode a non-empty frame.
+    utils::TelemetryDelta v4_delta = v3_delta;
+    v4_delta.contended = 6;
+    const std::string v4 =
+        runtime::EncodeTelemetryV4(v4_delta, 13, 1238, "com.example:capture", 42);
+    Check(v4.find(R"("schemaVersion":4)") != std::string::npos,
+          "v4 frame must advertise schemaVersion 4");
+    Check(v4.find(R"("installFailures":5,"contended":6})") != std::string::npos,
+          "v4 must append the contended delta after installFailures");
+    Check(v4.find(R"(,"installed":true})") != std::string::npos,
+          "v4 must keep the latched installed level at the root");
+    Check(runtime::EncodeTelemetryV3(v4_delta, 13, 1238, "com.example", 42).find("contended") ==
+              std::string::npos,
+          "v3 frame must stay the exact v3 key-set (no v4 keys leak)");
+
+    utils::TelemetryDelta contention_only;
+    contention_only.route = utils::TelemetryRoute::kApi;
+    contention_only.contended = 1;
+    Check(contention_only.pending(), "contention alone is exportable evidence");
+    Check(runtime::EncodeTelemetryV4(contention_only, 14, 1239, "com.example", 42)
+                  .find(R"("contended":1)") != std::string::npos,
+          "a contention-only delta must not encode an empty v4 frame");
+    Check(runtime::EncodeTelemetryV4({}, 14, 1239, "com.example", 42).empty(),
+          "an empty (non-pending) v4 delta must fail closed like v3");
+
     if (g_failures != 0)
     {
         return 1;
@@ -1029,7 +1029,7 @@ namespace
                       "formant",
                       "multi_tone",
                       passed,
-                      passed ? "formant stage changes phase while preserving bounded energy"
+                      passed ? "formant envelope warp reshapes the spectrum while preserving energy"
                              : "enabled formant stage did not measurably alter the waveform",
                       {{"correlation", correlation},
                        {"mean_abs_delta", delta},
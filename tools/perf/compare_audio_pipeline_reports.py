@@ -22,6 +22,7 @@ REPORT_SCHEMA = REPO_ROOT / "tools/perf/audio_pipeline_result.schema.json"
 DSP_API_HEADER = REPO_ROOT / "native/dsp/include/echidna/dsp/api.h"
 PRODUCTION_SOURCE_ROOTS = (
     REPO_ROOT / "native/dsp/CMakeLists.txt",
+    REPO_ROOT / "native/dsp/simd_kernels.cmake",
     REPO_ROOT / "native/dsp/include",
     REPO_ROOT / "native/dsp/src",
     REPO_ROOT / "native/include/echidna_api.h",
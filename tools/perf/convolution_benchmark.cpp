@@ -0,0 +1,151 @@
+#include "effects/convolution_reverb.h"
+#include "runtime/impulse_response.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <numeric>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+    using echidna::dsp::effects::ConvolutionReverb;
+    using echidna::dsp::effects::ProcessContext;
+    using echidna::dsp::effects::ReverbParameters;
+    using echidna::dsp::runtime::ImpulseResponseLibrary;
+
+    constexpr uint32_t kSampleRate = 48000;
+    constexpr uint32_t kChannels = 2;
+
+    inline void DoNotOptimizeBuffer(const void *data)
+    {
+#if defined(__GNUC__) || defined(__clang__)
+        __asm__ __volatile__("" : : "r"(data) : "memory");
+#else
+        (void)data;
+#endif
+    }
+
+    struct Result
+    {
+        size_t partitions{0};
+        double mean_ns{0.0};
+        double median_ns{0.0};
+        double p99_ns{0.0};
+    };
+
+    /** Register `seconds` of decaying noise as `id`. */
+    void RegisterResponse(const std::string &id, double seconds)
+    {
+        std::vector<float> samples(static_cast<size_t>(seconds * kSampleRate));
+        uint32_t seed = 0x434f4e56u;
+        for (size_t n = 0; n < samples.size(); ++n)
+        {
+            seed = seed * 1664525u + 1013904223u;
+            const double decay = std::pow(10.0, -3.0 * static_cast<double>(n) / static_cast<double>(samples.size()));
+            samples[n] = static_cast<float>(decay) * (static_cast<float>(seed >> 8) / 8388608.0f - 1.0f);
+        }
+        ImpulseResponseLibrary::instance().add(id, samples.data(), samples.size(), kSampleRate);
+    }
+
+    /**
+     * Cost of ConvolutionReverb::process on a stereo noise block. Only the
+     * blocks that complete a partition do the transforms and the spectral
+     * multiply-accumulate, so the mean is the sustained CPU share and the
+     * p99 the worst callback.
+     */
+    Result Measure(const std::string &id, size_t block, size_t iterations)
+    {
+        ConvolutionReverb reverb;
+        reverb.set_parameters(ReverbParameters{50.0f, 30.0f, 0.0f, 30.0f});
+        reverb.prepare(kSampleRate, kChannels);
+        reverb.set_impulse_response(ImpulseResponseLibrary::instance().partitioned(
+            id, kSampleRate, ConvolutionReverb::partition_frames(kSampleRate)));
+        reverb.set_enabled(true);
+
+        std::vector<float> source(block * kChannels);
+        uint32_t seed = 0x45434849u;
+        for (float &sample : source)
+        {
+            seed = seed * 1664525u + 1013904223u;
+            sample = 0.5f * (static_cast<float>(seed >> 8) / 8388608.0f - 1.0f);
+        }
+        std::vector<float> buffer(source.size());
+        auto run_block = [&]()
+        {
+            std::copy(source.begin(), source.end(), buffer.begin());
+            ProcessContext ctx{buffer.data(), block, kChannels, kSampleRate};
+            reverb.process(ctx);
+            DoNotOptimizeBuffer(buffer.data());
+        };
+
+        for (size_t warmup = 0; warmup < iterations / 10 + 1; ++warmup)
+        {
+            run_block();
+        }
+        std::vector<double> samples(iterations);
+        for (double &sample : samples)
+        {
+            const auto start = Clock::now();
+            run_block();
+            sample = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+        }
+        Result result;
+        result.partitions = reverb.partitions();
+        result.mean_ns = std::accumulate(samples.begin(), samples.end(), 0.0) / static_cast<double>(iterations);
+        std::sort(samples.begin(), samples.end());
+        result.median_ns = samples[iterations / 2];
+        result.p99_ns = samples[std::min(iterations - 1, iterations * 99 / 100)];
+        return result;
+    }
+} // namespace
+
+int main(int argc, char **argv)
+{
+    size_t iterations = 2000;
+    for (int arg = 1; arg < argc; ++arg)
+    {
+        const std::string_view option(argv[arg]);
+        if (option == "--iterations" && arg + 1 < argc)
+        {
+            iterations = std::max<size_t>(1, std::strtoull(argv[++arg], nullptr, 10));
+        }
+        else
+        {
+            std::cerr << "Usage: dsp_convolution_benchmark [--iterations N]\n";
+            return 64;
+        }
+    }
+
+    const double lengths[] = {0.25, 0.5, 1.0, 2.0, 4.0};
+    const size_t blocks[] = {240, 480};
+
+    std::cout << "| IR (s) | Partitions | Block (frames) | Mean (ns) | Median (ns) | p99 (ns) "
+                 "| Mean % of block period | p99 % of block period |\n"
+              << "| ---: | ---: | ---: | ---: | ---: | ---: | ---: | ---: |\n";
+    for (double seconds : lengths)
+    {
+        const std::string id = "benchmark_" + std::to_string(static_cast<int>(seconds * 1000)) + "ms";
+        RegisterResponse(id, seconds);
+        for (size_t block : blocks)
+        {
+            const Result result = Measure(id, block, iterations);
+            const double period_ns = 1e9 * static_cast<double>(block) / kSampleRate;
+            std::cout << "| " << std::fixed << std::setprecision(2) << seconds << " | "
+                      << result.partitions << " | " << block << " | " << std::setprecision(0)
+                      << result.mean_ns << " | " << result.median_ns << " | " << result.p99_ns << " | "
+                      << std::setprecision(2) << 100.0 * result.mean_ns / period_ns << " | "
+                      << 100.0 * result.p99_ns / period_ns << " |\n"
+                      << std::defaultfloat;
+        }
+    }
+    return 0;
+}
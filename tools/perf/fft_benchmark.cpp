@@ -0,0 +1,126 @@
+#include "runtime/fft.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string_view>
+#include <vector>
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+    using echidna::dsp::runtime::RealFft;
+
+    inline void DoNotOptimizeBuffer(const void *data)
+    {
+#if defined(__GNUC__) || defined(__clang__)
+        __asm__ __volatile__("" : : "r"(data) : "memory");
+#else
+        (void)data;
+#endif
+    }
+
+    struct Result
+    {
+        size_t size{0};
+        double forward_ns{0.0};
+        double inverse_ns{0.0};
+        double roundtrip_error{0.0};
+    };
+
+    /** Median of per-call times over `iterations` timed calls of `fn`. */
+    template <typename Fn>
+    double MedianNanoseconds(size_t iterations, Fn &&fn)
+    {
+        std::vector<double> samples(iterations);
+        for (double &sample : samples)
+        {
+            const auto start = Clock::now();
+            fn();
+            sample = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+        }
+        std::nth_element(samples.begin(), samples.begin() + static_cast<std::ptrdiff_t>(iterations / 2),
+                         samples.end());
+        return samples[iterations / 2];
+    }
+
+    Result Measure(size_t size, size_t iterations)
+    {
+        RealFft fft;
+        fft.prepare(size);
+        std::vector<float> input(size);
+        uint32_t seed = 0x45434849u;
+        for (float &sample : input)
+        {
+            seed = seed * 1664525u + 1013904223u;
+            sample = static_cast<float>(seed >> 8) / 8388608.0f - 1.0f;
+        }
+        std::vector<float> re(fft.bins());
+        std::vector<float> im(fft.bins());
+        std::vector<float> output(size);
+
+        for (size_t warmup = 0; warmup < iterations / 10 + 1; ++warmup)
+        {
+            fft.forward(input.data(), re.data(), im.data());
+            fft.inverse(re.data(), im.data(), output.data());
+        }
+
+        Result result;
+        result.size = size;
+        result.forward_ns = MedianNanoseconds(iterations, [&]()
+                                              {
+                                                  fft.forward(input.data(), re.data(), im.data());
+                                                  DoNotOptimizeBuffer(re.data());
+                                              });
+        result.inverse_ns = MedianNanoseconds(iterations, [&]()
+                                              {
+                                                  fft.inverse(re.data(), im.data(), output.data());
+                                                  DoNotOptimizeBuffer(output.data());
+                                              });
+        for (size_t n = 0; n < size; ++n)
+        {
+            result.roundtrip_error =
+                std::max(result.roundtrip_error, static_cast<double>(std::fabs(output[n] - input[n])));
+        }
+        return result;
+    }
+} // namespace
+
+int main(int argc, char **argv)
+{
+    size_t iterations = 2000;
+    for (int arg = 1; arg < argc; ++arg)
+    {
+        const std::string_view option(argv[arg]);
+        if (option == "--iterations" && arg + 1 < argc)
+        {
+            iterations = std::max<size_t>(1, std::strtoull(argv[++arg], nullptr, 10));
+        }
+        else
+        {
+            std::cerr << "Usage: dsp_fft_benchmark [--iterations N]\n";
+            return 64;
+        }
+    }
+
+    std::cout << "| Size | Forward (ns) | Inverse (ns) | Forward ns / (N log2 N) | Round-trip max error |\n"
+              << "| ---: | ---: | ---: | ---: | ---: |\n";
+    bool accurate = true;
+    for (size_t size = RealFft::kMinSize; size <= RealFft::kMaxSize; size *= 2)
+    {
+        const Result result = Measure(size, iterations);
+        const double n_log_n = static_cast<double>(size) * std::log2(static_cast<double>(size));
+        std::cout << "| " << result.size << " | " << std::fixed << std::setprecision(0)
+                  << result.forward_ns << " | " << result.inverse_ns << " | "
+                  << std::setprecision(3) << result.forward_ns / n_log_n << " | "
+                  << std::scientific << std::setprecision(2) << result.roundtrip_error << " |\n"
+                  << std::defaultfloat;
+        accurate = accurate && result.roundtrip_error < 1e-5;
+    }
+    return accurate ? 0 : 1;
+}
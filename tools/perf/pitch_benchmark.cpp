@@ -0,0 +1,215 @@
+#include "effects/auto_tune.h"
+#include "effects/formant_shifter.h"
+#include "effects/pitch_shifter.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string_view>
+#include <vector>
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+    using echidna::dsp::effects::AutoTune;
+    using echidna::dsp::effects::AutoTuneParameters;
+    using echidna::dsp::effects::FormantParameters;
+    using echidna::dsp::effects::FormantShifter;
+    using echidna::dsp::effects::PitchParameters;
+    using echidna::dsp::effects::PitchQuality;
+    using echidna::dsp::effects::PitchShifter;
+    using echidna::dsp::effects::ProcessContext;
+    using echidna::dsp::effects::ScaleType;
+
+    constexpr uint32_t kSampleRate = 48000;
+    constexpr uint32_t kChannels = 2;
+
+    inline void DoNotOptimizeBuffer(const void *data)
+    {
+#if defined(__GNUC__) || defined(__clang__)
+        __asm__ __volatile__("" : : "r"(data) : "memory");
+#else
+        (void)data;
+#endif
+    }
+
+    struct Result
+    {
+        double median_ns{0.0};
+        double p99_ns{0.0};
+    };
+
+    /**
+     * Median and p99 cost of `effect.process` on a stereo noise block. Blocks
+     * are timed individually, so hop-aligned work (WSOLA and phase vocoder
+     * hops, Auto-Tune detection) shows up in the p99 column rather than
+     * being averaged away.
+     */
+    template <typename Effect>
+    Result TimeBlocks(Effect &effect, size_t block, size_t iterations)
+    {
+        std::vector<float> source(block * kChannels);
+        uint32_t seed = 0x45434849u;
+        for (float &sample : source)
+        {
+            seed = seed * 1664525u + 1013904223u;
+            sample = 0.5f * (static_cast<float>(seed >> 8) / 8388608.0f - 1.0f);
+        }
+        // A voiced component so Auto-Tune detects a pitch and corrects it.
+        for (size_t frame = 0; frame < block; ++frame)
+        {
+            const float tone = 0.4f * std::sin(6.2831853f * 233.0f * static_cast<float>(frame) / kSampleRate);
+            for (uint32_t ch = 0; ch < kChannels; ++ch)
+            {
+                source[frame * kChannels + ch] = 0.1f * source[frame * kChannels + ch] + tone;
+            }
+        }
+        std::vector<float> buffer(source.size());
+        auto run_block = [&]()
+        {
+            std::copy(source.begin(), source.end(), buffer.begin());
+            ProcessContext ctx{buffer.data(), block, kChannels, kSampleRate};
+            effect.process(ctx);
+            DoNotOptimizeBuffer(buffer.data());
+        };
+
+        for (size_t warmup = 0; warmup < iterations / 10 + 1; ++warmup)
+        {
+            run_block();
+        }
+        std::vector<double> samples(iterations);
+        for (double &sample : samples)
+        {
+            const auto start = Clock::now();
+            run_block();
+            sample = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+        }
+        std::sort(samples.begin(), samples.end());
+        Result result;
+        result.median_ns = samples[iterations / 2];
+        result.p99_ns = samples[std::min(iterations - 1, iterations * 99 / 100)];
+        return result;
+    }
+
+    /**
+     * A +3 semitone shift at `quality`. With `streaming_ratio` the ratio is
+     * driven through set_realtime_ratio(), as Auto-Tune does, which runs the
+     * granular backend on its delay line.
+     */
+    Result MeasurePitch(PitchQuality quality, bool streaming_ratio, size_t block, size_t iterations)
+    {
+        PitchShifter shifter;
+        shifter.prepare(kSampleRate, kChannels);
+        shifter.prepare_realtime(block);
+        shifter.set_enabled(true);
+        PitchParameters params;
+        params.semitones = 3.0f;
+        params.quality = quality;
+        shifter.set_parameters(params);
+        if (streaming_ratio)
+        {
+            shifter.set_realtime_ratio(std::pow(2.0f, 3.0f / 12.0f));
+        }
+        return TimeBlocks(shifter, block, iterations);
+    }
+
+    /**
+     * A -250 cent formant shift computing its own envelope every frame, the
+     * costlier of its two paths (the engine hands it the bus envelope).
+     */
+    Result MeasureFormant(size_t block, size_t iterations)
+    {
+        FormantShifter formant;
+        formant.prepare(kSampleRate, kChannels);
+        formant.set_enabled(true);
+        formant.set_parameters(FormantParameters{-250.0f, true});
+        return TimeBlocks(formant, block, iterations);
+    }
+
+    /** Auto-Tune to C major, detection and correction included. */
+    Result MeasureAutoTune(size_t block, size_t iterations)
+    {
+        AutoTune tune;
+        tune.prepare(kSampleRate, kChannels);
+        tune.prepare_realtime(block);
+        tune.set_enabled(true);
+        AutoTuneParameters params;
+        params.scale = ScaleType::kMajor;
+        tune.set_parameters(params);
+        return TimeBlocks(tune, block, iterations);
+    }
+} // namespace
+
+int main(int argc, char **argv)
+{
+    size_t iterations = 2000;
+    for (int arg = 1; arg < argc; ++arg)
+    {
+        const std::string_view option(argv[arg]);
+        if (option == "--iterations" && arg + 1 < argc)
+        {
+            iterations = std::max<size_t>(1, std::strtoull(argv[++arg], nullptr, 10));
+        }
+        else
+        {
+            std::cerr << "Usage: dsp_pitch_benchmark [--iterations N]\n";
+            return 64;
+        }
+    }
+
+    enum class Stage
+    {
+        kPitch,
+        kStreamingPitch,
+        kFormant,
+        kAutoTune
+    };
+    struct Row
+    {
+        Stage stage;
+        PitchQuality quality;
+        const char *name;
+    };
+    const Row rows[] = {
+        {Stage::kPitch, PitchQuality::kLowLatency, "low-latency"},
+        {Stage::kStreamingPitch, PitchQuality::kLowLatency, "low-latency, streaming ratio"},
+        {Stage::kPitch, PitchQuality::kBalanced, "balanced"},
+        {Stage::kPitch, PitchQuality::kHighQuality, "high-quality"},
+        {Stage::kFormant, PitchQuality::kLowLatency, "formant"},
+        {Stage::kAutoTune, PitchQuality::kLowLatency, "auto-tune"},
+    };
+    const size_t blocks[] = {256, 480, 960};
+
+    std::cout << "| Stage | Block (frames) | Median (ns) | p99 (ns) | Median % of block period |\n"
+              << "| --- | ---: | ---: | ---: | ---: |\n";
+    for (const Row &row : rows)
+    {
+        for (size_t block : blocks)
+        {
+            auto measure = [&]()
+            {
+                switch (row.stage)
+                {
+                case Stage::kFormant:
+                    return MeasureFormant(block, iterations);
+                case Stage::kAutoTune:
+                    return MeasureAutoTune(block, iterations);
+                default:
+                    return MeasurePitch(row.quality, row.stage == Stage::kStreamingPitch, block, iterations);
+                }
+            };
+            const Result result = measure();
+            const double period_ns = 1e9 * static_cast<double>(block) / kSampleRate;
+            std::cout << "| " << row.name << " | " << block << " | " << std::fixed
+                      << std::setprecision(0) << result.median_ns << " | " << result.p99_ns << " | "
+                      << std::setprecision(2) << 100.0 * result.median_ns / period_ns << " |\n"
+                      << std::defaultfloat;
+        }
+    }
+    return 0;
+}
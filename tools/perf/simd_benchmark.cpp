@@ -0,0 +1,193 @@
+#include "runtime/pcm_codec.h"
+#include "runtime/simd.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <numeric>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+    using echidna::dsp::runtime::SimdLevel;
+    namespace runtime = echidna::dsp::runtime;
+
+    constexpr size_t kFrames = 480;
+    constexpr size_t kChannels = 2;
+    constexpr size_t kSamples = kFrames * kChannels;
+    constexpr uint32_t kSampleRate = 48000;
+
+    inline void DoNotOptimizeBuffer(const void *data)
+    {
+#if defined(__GNUC__) || defined(__clang__)
+        __asm__ __volatile__("" : : "r"(data) : "memory");
+#else
+        (void)data;
+#endif
+    }
+
+    struct Result
+    {
+        double median_ns{0.0};
+        double p99_ns{0.0};
+    };
+
+    /** Buffers shared by every kernel so each one reads warm cache lines. */
+    struct Buffers
+    {
+        std::vector<float> dry = std::vector<float>(kSamples);
+        std::vector<float> wet = std::vector<float>(kSamples);
+        std::vector<float> output = std::vector<float>(kSamples);
+        std::vector<float> left = std::vector<float>(kFrames);
+        std::vector<float> right = std::vector<float>(kFrames);
+        std::vector<int16_t> pcm = std::vector<int16_t>(kSamples);
+        std::vector<int16_t> pcm_out = std::vector<int16_t>(kSamples);
+        std::vector<uint8_t> packed = std::vector<uint8_t>(4 * kSamples);
+    };
+
+    struct Kernel
+    {
+        std::string name;
+        std::function<void(Buffers &)> run;
+    };
+
+    /** Median and p99 of `iterations` calls on a 480-frame stereo block. */
+    Result Measure(const Kernel &kernel, Buffers &buffers, size_t iterations)
+    {
+        for (size_t warmup = 0; warmup < iterations / 10 + 1; ++warmup)
+        {
+            kernel.run(buffers);
+        }
+        std::vector<double> samples(iterations);
+        for (double &sample : samples)
+        {
+            const auto start = Clock::now();
+            kernel.run(buffers);
+            sample = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+            DoNotOptimizeBuffer(buffers.output.data());
+            DoNotOptimizeBuffer(buffers.pcm_out.data());
+            DoNotOptimizeBuffer(buffers.packed.data());
+        }
+        std::sort(samples.begin(), samples.end());
+        Result result;
+        result.median_ns = samples[iterations / 2];
+        result.p99_ns = samples[std::min(iterations - 1, iterations * 99 / 100)];
+        return result;
+    }
+} // namespace
+
+int main(int argc, char **argv)
+{
+    size_t iterations = 20000;
+    for (int arg = 1; arg < argc; ++arg)
+    {
+        const std::string_view option(argv[arg]);
+        if (option == "--iterations" && arg + 1 < argc)
+        {
+            iterations = std::max<size_t>(1, std::strtoull(argv[++arg], nullptr, 10));
+        }
+        else
+        {
+            std::cerr << "Usage: dsp_simd_benchmark [--iterations N]\n";
+            return 64;
+        }
+    }
+
+    Buffers buffers;
+    uint32_t seed = 0x53494d44u;
+    for (size_t i = 0; i < kSamples; ++i)
+    {
+        seed = seed * 1664525u + 1013904223u;
+        buffers.dry[i] = 0.8f * (static_cast<float>(seed >> 8) / 8388608.0f - 1.0f);
+        seed = seed * 1664525u + 1013904223u;
+        buffers.wet[i] = 0.8f * (static_cast<float>(seed >> 8) / 8388608.0f - 1.0f);
+        buffers.pcm[i] = static_cast<int16_t>(buffers.dry[i] * 32767.0f);
+    }
+    runtime::encode_pcm(runtime::PcmEncoding::kSigned32, buffers.dry.data(), buffers.packed.data(), kSamples);
+
+    // The scan result is folded into a sink so the call cannot be elided.
+    float sink = 0.0f;
+    std::vector<Kernel> kernels{
+        {"apply_gain", [](Buffers &b) { runtime::apply_gain(b.output.data(), kSamples, 0.999f); }},
+        {"mix_in", [](Buffers &b) { runtime::mix_in(b.output.data(), b.wet.data(), kSamples, 0.5f); }},
+        {"crossfade",
+         [](Buffers &b)
+         { runtime::crossfade(b.dry.data(), b.wet.data(), b.output.data(), kSamples, 0.7f, 0.3f, 0.9f); }},
+        {"scan_block",
+         [&sink](Buffers &b) { sink += runtime::scan_block(b.wet.data(), kSamples, b.dry.data()).peak; }},
+        {"all_finite",
+         [&sink](Buffers &b) { sink += runtime::all_finite(b.wet.data(), kSamples) ? 1.0f : 0.0f; }},
+        {"reencode_s16",
+         [](Buffers &b)
+         { runtime::reencode_s16(b.wet.data(), b.dry.data(), b.pcm.data(), b.pcm_out.data(), kSamples); }},
+        {"deinterleave",
+         [](Buffers &b)
+         {
+             float *planar[kChannels] = {b.left.data(), b.right.data()};
+             runtime::deinterleave(b.dry.data(), planar, kFrames, kChannels);
+         }},
+        {"interleave",
+         [](Buffers &b)
+         {
+             const float *const planar[kChannels] = {b.left.data(), b.right.data()};
+             runtime::interleave(planar, b.output.data(), kFrames, kChannels);
+         }},
+    };
+
+    // The codecs share one packed buffer filled as s32; reinterpreting it as
+    // another encoding does not change the work a block costs.
+    const std::pair<runtime::PcmEncoding, const char *> codecs[] = {
+        {runtime::PcmEncoding::kUnsigned8, "u8"},
+        {runtime::PcmEncoding::kSigned16, "s16"},
+        {runtime::PcmEncoding::kSigned24Packed, "s24"},
+        {runtime::PcmEncoding::kSigned32, "s32"},
+        {runtime::PcmEncoding::kFloat32, "f32"},
+    };
+    for (const auto &[encoding, suffix] : codecs)
+    {
+        kernels.push_back({std::string("decode_pcm_") + suffix,
+                           [encoding, &sink](Buffers &b)
+                           { sink += runtime::decode_pcm(encoding, b.packed.data(), b.output.data(), kSamples); }});
+        kernels.push_back({std::string("encode_pcm_") + suffix,
+                           [encoding](Buffers &b)
+                           { runtime::encode_pcm(encoding, b.wet.data(), b.packed.data(), kSamples); }});
+    }
+
+    const SimdLevel detected = runtime::detected_simd_level();
+    std::cout << "Detected level: " << runtime::simd_level_name(detected) << "\n\n"
+              << "| Kernel | Level | Median (ns) | p99 (ns) | Samples/ns | Median % of block period |\n"
+              << "| --- | --- | ---: | ---: | ---: | ---: |\n";
+    const double period_ns = 1e9 * static_cast<double>(kFrames) / kSampleRate;
+    for (const Kernel &kernel : kernels)
+    {
+        for (SimdLevel level : {SimdLevel::kScalar,
+                                SimdLevel::kSse41,
+                                SimdLevel::kAvx2,
+                                SimdLevel::kAvx512,
+                                SimdLevel::kNeon})
+        {
+            if (!runtime::force_simd_level(level))
+            {
+                continue;
+            }
+            const Result result = Measure(kernel, buffers, iterations);
+            std::cout << "| " << kernel.name << " | " << runtime::simd_level_name(level) << " | "
+                      << std::fixed << std::setprecision(0) << result.median_ns << " | " << result.p99_ns
+                      << " | " << std::setprecision(2) << static_cast<double>(kSamples) / result.median_ns
+                      << " | " << std::setprecision(3) << 100.0 * result.median_ns / period_ns << " |\n"
+                      << std::defaultfloat;
+        }
+    }
+    runtime::force_simd_level(detected);
+    DoNotOptimizeBuffer(&sink);
+    return 0;
+}